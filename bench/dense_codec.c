@@ -0,0 +1,112 @@
+/* Measures the rANS dense compression (STRUCT_VERSION 4) for a range of
+ * cardinalities. For each cardinality it reports the average compressed size
+ * and the time it takes to decode the registers (including building the
+ * decoding table) and the time it takes to encode them.
+ *
+ * The registers are filled the same way hll_add_hash_dense() does for the
+ * default counter (b=14, binbits=6) from uniformly distributed 64-bit hashes.
+ *
+ * Build and run with
+ *
+ *     make bench/dense_codec && ./bench/dense_codec
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "rans.h"
+
+#define INDEX_BITS 14
+#define M (1 << INDEX_BITS)
+#define BINBITS 6
+#define ROUNDS 200
+#define SAMPLES 10
+
+static uint64_t state = 0x9e3779b97f4a7c15ULL;
+
+/* splitmix64 */
+static uint64_t
+next_hash(void)
+{
+    uint64_t z = (state += 0x9e3779b97f4a7c15ULL);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+}
+
+static void
+generate(uint8_t * registers, long n)
+{
+    long i;
+    uint64_t hash;
+    uint8_t rho;
+
+    memset(registers, 0, M);
+    for (i = 0; i < n; i++){
+        hash = next_hash();
+        rho = __builtin_clzll(hash << INDEX_BITS | (1ULL << (INDEX_BITS - 1))) + 1;
+        if (rho > registers[hash >> (64 - INDEX_BITS)]){
+            registers[hash >> (64 - INDEX_BITS)] = rho;
+        }
+    }
+}
+
+static double
+now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+int
+main(void)
+{
+    static const long counts[] = {1021, 5000, 10000, 100000, 1000000, 10000000};
+    static uint8_t registers[M], decoded[M], encoded[RANS_MAX_ENCODED_SIZE(M)];
+    int c, s, r;
+    uint32_t size = 0;
+    long total_size;
+    double t, encode_ns, decode_ns;
+
+    printf("| cardinality | bit-packed bytes | rANS bytes | bits/register | encode us | decode us |\n");
+    printf("|------------:|-----------------:|-----------:|--------------:|----------:|----------:|\n");
+
+    for (c = 0; c < (int) (sizeof(counts) / sizeof(counts[0])); c++){
+        total_size = 0;
+        encode_ns = decode_ns = 0;
+
+        for (s = 0; s < SAMPLES; s++){
+            generate(registers, counts[c]);
+
+            t = now_ns();
+            for (r = 0; r < ROUNDS; r++){
+                size = rans_encode_registers(registers, M, encoded, sizeof(encoded));
+            }
+            encode_ns += now_ns() - t;
+            total_size += size;
+
+            t = now_ns();
+            for (r = 0; r < ROUNDS; r++){
+                if (rans_decode_registers(encoded, size, decoded, M, (1 << BINBITS) - 1) != 0){
+                    fprintf(stderr, "decoding failed\n");
+                    return 1;
+                }
+            }
+            decode_ns += now_ns() - t;
+
+            if (memcmp(registers, decoded, M) != 0){
+                fprintf(stderr, "rANS roundtrip failed for cardinality %ld\n", counts[c]);
+                return 1;
+            }
+        }
+
+        printf("| %11ld | %16d | %10.1f | %13.2f | %9.1f | %9.1f |\n",
+               counts[c], M * BINBITS / 8, (double) total_size / SAMPLES,
+               (double) total_size * 8 / SAMPLES / M,
+               encode_ns / SAMPLES / ROUNDS / 1000, decode_ns / SAMPLES / ROUNDS / 1000);
+    }
+
+    return 0;
+}
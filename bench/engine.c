@@ -0,0 +1,379 @@
+/* Micro-benchmark of the counter engine, to catch performance regressions
+ * before a new build is deployed. For every precision from 10 to 18 it
+ * measures the time per operation of
+ *
+ * - hll_add_element on small sets, sparse and dense counters, with keys of
+ *   4, 8, 16 and 64 bytes
+ * - hll_merge for every pair of small set, sparse, bit-packed, unpacked and
+ *   NIBBLE dense counters, and hll_merge_compressed of two compressed sparse
+ *   ones
+ * - hll_estimate of small sets, sparse and dense counters
+ * - hll_compress, hll_decompress and hll_unpack
+ *
+ * It's built against libhll.a (see lib/hll.h), no server is needed. Like the
+ * SQL functions the operations that return a new counter work on copies
+ * (hll_copy) and merges and estimates unpack the registers first
+ * (hll_unpack), the time includes the copies, unpacking and freeing
+ * everything the operation allocated. Adds to small sets and sparse counters start from a
+ * copy of a counter that was just upgraded to that encoding and stop halfway
+ * to the next one, the time is per added item.
+ *
+ * Every measurement is the median of SAMPLES runs of at least the given
+ * number of milliseconds (20 by default). The output is CSV
+ *
+ *     operation,variant,precision,operations,ns_per_op
+ *
+ * Build and run with
+ *
+ *     make bench
+ *
+ * or make bench/engine && ./bench/engine [ms] > results.csv
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <math.h>
+
+#include "postgres.h"
+#include "utils/memutils.h"
+#include "hyperloglog.h"
+#include "hllutils.h"
+
+#define SAMPLES 3
+#define MIN_PRECISION 10
+#define MAX_PRECISION 18
+#define MAX_KEY_BYTES 64
+
+/* counters of one precision (in TopMemoryContext) */
+typedef struct Counters
+{
+    HLLCounter small;
+    HLLCounter sparse;
+    HLLCounter packed;
+    HLLCounter unpacked;
+    HLLCounter nibble;
+    HLLCounter compressed_small;
+    HLLCounter compressed_sparse;
+    HLLCounter compressed_dense;
+    HLLCounter compressed_nibble;
+
+    /* items added per run to small sets and sparse counters */
+    int small_items;
+    int sparse_items;
+
+    /* counters just upgraded to small set and sparse encoding */
+    HLLCounter small_start;
+    HLLCounter sparse_start;
+} Counters;
+
+/* arguments of a single benchmark */
+typedef struct BenchCase
+{
+    HLLCounter counter1;
+    HLLCounter counter2;
+    int key_bytes;
+    int items;
+} BenchCase;
+
+static double min_seconds = 0.02;
+static uint64_t next_key = 1;
+static char key[MAX_KEY_BYTES];
+
+/* ---------------------- function definitions --------------------------- */
+
+static double
+now(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static int
+cmp_double(const void * a, const void * b)
+{
+    double x = *(const double *) a, y = *(const double *) b;
+    return (x > y) - (x < y);
+}
+
+/* adds a new distinct key of 'key_bytes' bytes (the first 8 bytes hold a
+ * counter, the rest is constant) */
+static HLLCounter
+add_key(HLLCounter hloglog, int key_bytes)
+{
+    uint64_t value = next_key++;
+
+    memcpy(key, &value, key_bytes < 8 ? key_bytes : 8);
+    return hll_add_element(hloglog, key, key_bytes);
+}
+
+static HLLCounter
+add_keys(HLLCounter hloglog, int items, int key_bytes)
+{
+    int i;
+
+    for (i = 0; i < items; i++){
+        hloglog = add_key(hloglog, key_bytes);
+    }
+
+    return hloglog;
+}
+
+/* creates an empty counter of the given precision (error rate slightly above
+ * the one of 2^b registers) */
+static HLLCounter
+create(int b, uint8_t format)
+{
+    HLLCounter hloglog = hll_create(pow(2, 63), sqrt(1.0816 / (0.9 * pow(2, b))), format);
+
+    if (hloglog->b != b){
+        fprintf(stderr, "counter has precision %d instead of %d\n", hloglog->b, b);
+        exit(1);
+    }
+
+    return hloglog;
+}
+
+static void
+build_counters(Counters *counters, int b)
+{
+    MemoryContext old = MemoryContextSwitchTo(TopMemoryContext);
+    HLLCounter hloglog;
+    int n;
+
+    counters->small_start = add_key(create(b, PACKED), 8);
+
+    /* small set -> sparse */
+    hloglog = hll_copy(counters->small_start);
+    for (n = 1; HLL_IS_SMALL_SET(hloglog); n++){
+        hloglog = add_key(hloglog, 8);
+    }
+    counters->sparse_start = hloglog;
+    counters->small_items = n / 2;
+
+    /* sparse -> dense */
+    hloglog = hll_copy(counters->sparse_start);
+    for (n = 0; hloglog->idx != -1; n++){
+        hloglog = add_key(hloglog, 8);
+    }
+    counters->sparse_items = n / 2;
+
+    counters->small = add_keys(hll_copy(counters->small_start), counters->small_items, 8);
+    counters->sparse = add_keys(hll_copy(counters->sparse_start), counters->sparse_items, 8);
+    counters->packed = hll_fixed(add_keys(hloglog, 4 * POW2(b), 8), PACKED);
+    counters->unpacked = hll_fixed(hll_copy(counters->packed), UNPACKED);
+
+    /* the NIBBLE layout isn't a fixed size one, it's built by adding keys */
+    hloglog = create(b, NIBBLE);
+    while (hloglog->idx != -1){
+        hloglog = add_key(hloglog, 8);
+    }
+    counters->nibble = add_keys(hloglog, 4 * POW2(b), 8);
+
+    counters->compressed_small = hll_compress(hll_copy(counters->small));
+    counters->compressed_sparse = hll_compress(hll_copy(counters->sparse));
+    counters->compressed_dense = hll_compress(hll_copy(counters->packed));
+    counters->compressed_nibble = hll_compress(hll_copy(counters->nibble));
+
+    MemoryContextSwitchTo(old);
+}
+
+/* runs the benchmark and prints the median time per operation */
+static void
+measure(const char *operation, const char *variant, int b, long (*run)(BenchCase *), BenchCase *bc)
+{
+    double samples[SAMPLES], start, elapsed;
+    long iterations = 1, operations = 0, i;
+    int s;
+
+    for (s = 0; s < SAMPLES; s++){
+        do {
+            /* doubles the iterations until a run takes long enough (only
+             * while measuring the first sample) */
+            if (s == 0 && operations > 0){
+                iterations *= 2;
+            }
+
+            start = now();
+            operations = 0;
+            for (i = 0; i < iterations; i++){
+                operations += run(bc);
+                MemoryContextReset(CurrentMemoryContext);
+            }
+            elapsed = now() - start;
+        } while (s == 0 && elapsed < min_seconds);
+
+        samples[s] = elapsed * 1e9 / operations;
+    }
+
+    qsort(samples, SAMPLES, sizeof(double), cmp_double);
+    printf("%s,%s,%d,%ld,%.1f\n", operation, variant, b, operations, samples[SAMPLES / 2]);
+    fflush(stdout);
+}
+
+static long
+run_add(BenchCase *bc)
+{
+    add_keys(hll_copy(bc->counter1), bc->items, bc->key_bytes);
+    return bc->items;
+}
+
+/* the dense counter is updated in place */
+static long
+run_add_dense(BenchCase *bc)
+{
+    add_keys(bc->counter1, bc->items, bc->key_bytes);
+    return bc->items;
+}
+
+/* hll_merge works on unpacked registers */
+static long
+run_merge(BenchCase *bc)
+{
+    hll_merge(hll_unpack(hll_copy(bc->counter1)), hll_unpack(hll_copy(bc->counter2)));
+    return 1;
+}
+
+static long
+run_merge_compressed(BenchCase *bc)
+{
+    hll_merge_compressed(hll_copy(bc->counter1), hll_copy(bc->counter2));
+    return 1;
+}
+
+static long
+run_estimate(BenchCase *bc)
+{
+    hll_estimate(hll_unpack(hll_copy(bc->counter1)));
+    return 1;
+}
+
+static long
+run_compress(BenchCase *bc)
+{
+    hll_compress(hll_copy(bc->counter1));
+    return 1;
+}
+
+static long
+run_decompress(BenchCase *bc)
+{
+    hll_decompress(hll_copy(bc->counter1));
+    return 1;
+}
+
+static long
+run_unpack(BenchCase *bc)
+{
+    hll_unpack(hll_copy(bc->counter1));
+    return 1;
+}
+
+static void
+bench_precision(int b)
+{
+    static const int key_bytes[] = {4, 8, 16, 64};
+    static const char *names[] = {"small", "sparse", "packed", "unpacked", "nibble"};
+    Counters counters1, counters2;
+    HLLCounter representations1[5], representations2[5];
+    BenchCase bc;
+    char variant[64];
+    int i, j;
+
+    build_counters(&counters1, b);
+    build_counters(&counters2, b);
+
+    for (i = 0; i < lengthof(key_bytes); i++){
+        memset(&bc, 0, sizeof(bc));
+        bc.key_bytes = key_bytes[i];
+
+        snprintf(variant, sizeof(variant), "small/%d", key_bytes[i]);
+        bc.counter1 = counters1.small_start;
+        bc.items = counters1.small_items;
+        measure("add", variant, b, run_add, &bc);
+
+        snprintf(variant, sizeof(variant), "sparse/%d", key_bytes[i]);
+        bc.counter1 = counters1.sparse_start;
+        bc.items = counters1.sparse_items;
+        measure("add", variant, b, run_add, &bc);
+
+        snprintf(variant, sizeof(variant), "dense/%d", key_bytes[i]);
+        bc.counter1 = counters1.packed;
+        bc.items = 1000;
+        measure("add", variant, b, run_add_dense, &bc);
+
+        snprintf(variant, sizeof(variant), "nibble/%d", key_bytes[i]);
+        bc.counter1 = counters1.nibble;
+        measure("add", variant, b, run_add_dense, &bc);
+    }
+
+    representations1[0] = counters1.small;
+    representations1[1] = counters1.sparse;
+    representations1[2] = counters1.packed;
+    representations1[3] = counters1.unpacked;
+    representations1[4] = counters1.nibble;
+    representations2[0] = counters2.small;
+    representations2[1] = counters2.sparse;
+    representations2[2] = counters2.packed;
+    representations2[3] = counters2.unpacked;
+    representations2[4] = counters2.nibble;
+
+    memset(&bc, 0, sizeof(bc));
+    for (i = 0; i < lengthof(names); i++){
+        for (j = 0; j < lengthof(names); j++){
+            snprintf(variant, sizeof(variant), "%s/%s", names[i], names[j]);
+            bc.counter1 = representations1[i];
+            bc.counter2 = representations2[j];
+            measure("merge", variant, b, run_merge, &bc);
+        }
+    }
+
+    bc.counter1 = counters1.compressed_sparse;
+    bc.counter2 = counters2.compressed_sparse;
+    measure("merge_compressed", "sparse/sparse", b, run_merge_compressed, &bc);
+
+    for (i = 0; i < lengthof(names); i++){
+        bc.counter1 = representations1[i];
+        measure("estimate", names[i], b, run_estimate, &bc);
+    }
+
+    for (i = 0; i < lengthof(names); i++){
+        bc.counter1 = representations1[i];
+        measure("compress", names[i], b, run_compress, &bc);
+    }
+
+    bc.counter1 = counters1.compressed_small;
+    measure("decompress", "small", b, run_decompress, &bc);
+    bc.counter1 = counters1.compressed_sparse;
+    measure("decompress", "sparse", b, run_decompress, &bc);
+    bc.counter1 = counters1.compressed_dense;
+    measure("decompress", "packed", b, run_decompress, &bc);
+    bc.counter1 = counters1.compressed_nibble;
+    measure("decompress", "nibble", b, run_decompress, &bc);
+
+    bc.counter1 = counters1.packed;
+    measure("unpack", "packed", b, run_unpack, &bc);
+    bc.counter1 = counters1.compressed_dense;
+    measure("unpack", "compressed", b, run_unpack, &bc);
+}
+
+int
+main(int argc, char **argv)
+{
+    int b;
+
+    if (argc > 1){
+        min_seconds = atof(argv[1]) / 1000;
+    }
+
+    memset(key, 0x5a, sizeof(key));
+
+    printf("operation,variant,precision,operations,ns_per_op\n");
+    for (b = MIN_PRECISION; b <= MAX_PRECISION; b++){
+        bench_precision(b);
+    }
+
+    return 0;
+}
@@ -0,0 +1,22 @@
+-- Shows the memory used by hyperloglog_accum in a hash aggregate with many
+-- small groups (:groups groups of 3 distinct values each). Run with
+--
+--     psql -X -v groups=10000000 -f bench/group_by.sql
+--
+-- and look at the Memory Usage (and Batches / Disk Usage once it exceeds
+-- work_mem) reported for the HashAggregate node.
+\set ON_ERROR_STOP on
+\if :{?groups}
+\else
+\set groups 1000000
+\endif
+
+SET search_path = public, pg_catalog;
+SET work_mem = '4GB';
+SET enable_sort = off;
+
+EXPLAIN (ANALYZE, COSTS OFF, TIMING OFF)
+    SELECT g, hyperloglog_accum(g * 10 + i) FROM generate_series(1, :groups) g, generate_series(1, 3) i GROUP BY g;
+
+RESET enable_sort;
+RESET work_mem;
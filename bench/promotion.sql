@@ -0,0 +1,52 @@
+-- Compares the two sparse to dense promotion policies (hyperloglog.promotion
+-- = fixed and size) for the default counter at cardinalities from 100 to
+-- 100000. For each cardinality :groups counters of distinct integers are
+-- built with hyperloglog_accum under each policy. Run with
+--
+--     psql -X -v groups=100 -f bench/promotion.sql
+--
+-- The timings of the two CREATE TABLE statements are the build times, the
+-- final query reports the average compressed size, how many counters ended up
+-- sparse and the average relative error of the estimates per cardinality.
+\set ON_ERROR_STOP on
+\if :{?groups}
+\else
+\set groups 20
+\endif
+
+SET search_path = public, pg_catalog;
+
+DROP TABLE IF EXISTS bench_promotion_fixed;
+DROP TABLE IF EXISTS bench_promotion_size;
+
+CREATE TEMP TABLE bench_cardinalities (n int);
+INSERT INTO bench_cardinalities VALUES (100), (300), (1000), (3000), (10000), (30000), (100000);
+
+\timing on
+SET hyperloglog.promotion = fixed;
+CREATE UNLOGGED TABLE bench_promotion_fixed AS
+    SELECT n, g, hyperloglog_accum(g * 1000000 + i) counter
+    FROM bench_cardinalities, generate_series(1, :groups) g, generate_series(1, n) i GROUP BY n, g;
+
+SET hyperloglog.promotion = size;
+CREATE UNLOGGED TABLE bench_promotion_size AS
+    SELECT n, g, hyperloglog_accum(g * 1000000 + i) counter
+    FROM bench_cardinalities, generate_series(1, :groups) g, generate_series(1, n) i GROUP BY n, g;
+\timing off
+
+RESET hyperloglog.promotion;
+
+SELECT f.n,
+       round(avg(length(f.counter))) fixed_bytes,
+       round(avg(length(s.counter))) size_bytes,
+       count(*) FILTER (WHERE hyperloglog_info(f.counter) LIKE '%encoding: sparse%') fixed_sparse,
+       count(*) FILTER (WHERE hyperloglog_info(s.counter) LIKE '%encoding: sparse%') size_sparse,
+       round(100 * avg(abs(hyperloglog_get_estimate(f.counter) - f.n) / f.n)::numeric, 2) fixed_error_percent,
+       round(100 * avg(abs(hyperloglog_get_estimate(s.counter) - s.n) / s.n)::numeric, 2) size_error_percent
+FROM bench_promotion_fixed f JOIN bench_promotion_size s USING (n, g)
+GROUP BY f.n
+ORDER BY f.n;
+
+DROP TABLE bench_promotion_fixed;
+DROP TABLE bench_promotion_size;
+DROP TABLE bench_cardinalities;
@@ -0,0 +1,151 @@
+/* Compares the sparse compression formats: group varint (STRUCT_VERSION 2)
+ * and Stream VByte (STRUCT_VERSION 3). For a range of sparse entry counts it
+ * reports the compressed size of both encodings and the time it takes to
+ * decode them.
+ *
+ * The entries are generated the same way encode_hash() does for the default
+ * counter (b=14, binbits=6) from uniformly distributed 64-bit hashes, then
+ * sorted and deduped just like hll_compress_sparse() does.
+ *
+ * Build and run with
+ *
+ *     make bench/sparse_codec && ./bench/sparse_codec
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "varint.h"
+#include "streamvbyte.h"
+
+#define BINBITS 6
+#define INDEX_BITS 14
+#define SPARSE_INDEX_BITS (32 - 1 - BINBITS)
+#define ROUNDS 20000
+#define SAMPLES 50
+
+static uint64_t state = 0x9e3779b97f4a7c15ULL;
+
+/* splitmix64 */
+static uint64_t
+next_hash(void)
+{
+    uint64_t z = (state += 0x9e3779b97f4a7c15ULL);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+}
+
+/* same layout as encode_hash() in hyperloglog.c */
+static uint32_t
+encode(uint64_t hash)
+{
+    uint32_t idx = hash >> (64 - SPARSE_INDEX_BITS);
+    uint32_t rho;
+
+    if (idx & ((1 << (SPARSE_INDEX_BITS - INDEX_BITS)) - 1)){
+        return idx << 1;
+    }
+
+    rho = __builtin_clzll(hash << SPARSE_INDEX_BITS | 1) + 1;
+    return (((idx << BINBITS) + rho) << 1) + 1;
+}
+
+static int
+cmp_uint32(const void * a, const void * b)
+{
+    uint32_t x = *(const uint32_t *) a, y = *(const uint32_t *) b;
+    return (x > y) - (x < y);
+}
+
+static int
+generate(uint32_t * values, int n)
+{
+    int i, j;
+
+    for (i = 0; i < n; i++){
+        values[i] = encode(next_hash());
+    }
+
+    qsort(values, n, sizeof(uint32_t), cmp_uint32);
+
+    for (i = 1, j = 1; i < n; i++){
+        if (values[i] != values[j - 1]){
+            values[j++] = values[i];
+        }
+    }
+
+    return (n > 0) ? j : 0;
+}
+
+static double
+now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+int
+main(void)
+{
+    static const int counts[] = {16, 64, 128, 256, 512, 1020, 4092, 16380};
+    int c, s, r, n;
+    uint32_t * values = malloc(16380 * sizeof(uint32_t));
+    uint32_t * decoded = malloc(16380 * sizeof(uint32_t));
+    uint8_t * gv = malloc(SVB_MAX_ENCODED_SIZE(16380) + 16380);
+    uint8_t * svb = malloc(SVB_MAX_ENCODED_SIZE(16380));
+    double t, gv_ns, svb_ns;
+    long gv_size, svb_size, entries;
+    volatile uint32_t sink = 0;
+
+    printf("| entries | group varint bytes | stream vbyte bytes | group varint ns/entry | stream vbyte ns/entry | speedup |\n");
+    printf("|--------:|-------------------:|-------------------:|----------------------:|----------------------:|--------:|\n");
+
+    for (c = 0; c < (int) (sizeof(counts) / sizeof(counts[0])); c++){
+        gv_ns = svb_ns = 0;
+        gv_size = svb_size = entries = 0;
+
+        for (s = 0; s < SAMPLES; s++){
+            n = generate(values, counts[c]);
+            entries += n;
+
+            gv_size += group_encode_sorted(values, n, gv);
+            svb_size += svb_encode_sorted(values, n, svb);
+
+            t = now_ns();
+            for (r = 0; r < ROUNDS / SAMPLES; r++){
+                group_decode_sorted(gv, n, decoded);
+                sink += decoded[n - 1];
+            }
+            gv_ns += now_ns() - t;
+
+            t = now_ns();
+            for (r = 0; r < ROUNDS / SAMPLES; r++){
+                svb_decode_sorted(svb, n, decoded);
+                sink += decoded[n - 1];
+            }
+            svb_ns += now_ns() - t;
+
+            if (memcmp(values, decoded, n * sizeof(uint32_t)) != 0){
+                fprintf(stderr, "stream vbyte roundtrip failed for %d entries\n", n);
+                return 1;
+            }
+        }
+
+        gv_ns /= (double) entries * (ROUNDS / SAMPLES);
+        svb_ns /= (double) entries * (ROUNDS / SAMPLES);
+
+        printf("| %7d | %18.1f | %18.1f | %21.2f | %21.2f | %6.2fx |\n",
+               counts[c], (double) gv_size / SAMPLES, (double) svb_size / SAMPLES,
+               gv_ns, svb_ns, gv_ns / svb_ns);
+    }
+
+    free(values);
+    free(decoded);
+    free(gv);
+    free(svb);
+
+    return (int) (sink & 0);
+}
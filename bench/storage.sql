@@ -0,0 +1,60 @@
+-- Compares bulk load and read throughput of counters stored as
+-- hyperloglog_estimator (STORAGE = EXTENDED, TOAST tries to pglz compress the
+-- already compressed counters) and hyperloglog_estimator_raw (STORAGE =
+-- EXTERNAL, counters are moved out of line as they are).
+--
+-- Each table gets :n rows of sparse counters (1000 distinct values each,
+-- ~2.6KB compressed) and :n / 100 rows of dense counters (100000 distinct
+-- values each, ~5.9KB compressed), both above the TOAST threshold. Run
+-- with
+--
+--     psql -X -v n=100000000 -f bench/storage.sql
+--
+-- and compare the timings of the INSERT and SELECT statements. The default of
+-- 1000000 rows takes a couple of minutes.
+\set ON_ERROR_STOP on
+\if :{?n}
+\else
+\set n 1000000
+\endif
+\timing on
+
+SET search_path = public, pg_catalog;
+
+DROP TABLE IF EXISTS bench_counters_src;
+DROP TABLE IF EXISTS bench_extended;
+DROP TABLE IF EXISTS bench_raw;
+
+-- a few distinct counters to copy from, building them isn't what's measured
+CREATE UNLOGGED TABLE bench_counters_src AS
+    SELECT g, hyperloglog_accum(g * 1000000 + i) counter
+    FROM generate_series(1, 10) g, generate_series(1, 1000) s(i) GROUP BY g
+    UNION ALL
+    SELECT 10 + g, hyperloglog_accum(g * 1000000 + i)
+    FROM generate_series(1, 10) g, generate_series(1, 100000) s(i) GROUP BY g;
+
+CREATE UNLOGGED TABLE bench_extended (id bigint, counter hyperloglog_estimator);
+CREATE UNLOGGED TABLE bench_raw (id bigint, counter hyperloglog_estimator_raw);
+
+-- bulk load
+INSERT INTO bench_extended SELECT i, counter FROM generate_series(1, :n) i JOIN bench_counters_src ON g = 1 + i % 10;
+INSERT INTO bench_extended SELECT i, counter FROM generate_series(1, :n / 100) i JOIN bench_counters_src ON g = 11 + i % 10;
+
+INSERT INTO bench_raw SELECT i, counter FROM generate_series(1, :n) i JOIN bench_counters_src ON g = 1 + i % 10;
+INSERT INTO bench_raw SELECT i, counter FROM generate_series(1, :n / 100) i JOIN bench_counters_src ON g = 11 + i % 10;
+
+-- on disk sizes
+SELECT pg_size_pretty(pg_total_relation_size('bench_extended')) extended_size,
+       pg_size_pretty(pg_total_relation_size('bench_raw')) raw_size;
+
+-- read throughput (detoast and estimate every counter)
+SELECT sum(hyperloglog_get_estimate(counter)) FROM bench_extended;
+SELECT sum(hyperloglog_get_estimate(counter)) FROM bench_raw;
+
+-- read throughput (merge every counter)
+SELECT hyperloglog_get_estimate(hyperloglog_merge(counter)) FROM bench_extended;
+SELECT hyperloglog_get_estimate(hyperloglog_merge(counter)) FROM bench_raw;
+
+DROP TABLE bench_counters_src;
+DROP TABLE bench_extended;
+DROP TABLE bench_raw;
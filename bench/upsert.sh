@@ -0,0 +1,64 @@
+#!/bin/sh
+# Compares update throughput and table bloat of counters that are merged with
+# || and compressed again (so their size changes with every update) and of
+# fixed size counters merged with hyperloglog_upsert().
+#
+# Each variant runs the same pgbench workload against its own table: every
+# transaction merges a counter of 10 random values into a random row. The
+# counters use an error rate of 0.03 (precision 11) so fixed size counters
+# (1552 bytes) are stored inline, larger precisions are moved out of line
+# by TOAST either way.
+#
+# Usage: bench/upsert.sh [rows] [clients] [seconds]
+#
+# Connection settings are taken from the usual PG* environment variables.
+set -e
+
+ROWS=${1:-10000}
+CLIENTS=${2:-8}
+SECONDS_=${3:-60}
+WORKDIR=$(mktemp -d)
+trap 'rm -rf "$WORKDIR"' EXIT
+
+psql -X -q -v ON_ERROR_STOP=1 <<EOF
+DROP TABLE IF EXISTS bench_upsert_merge;
+DROP TABLE IF EXISTS bench_upsert_fixed;
+
+CREATE TABLE bench_upsert_merge (id int PRIMARY KEY, counter hyperloglog_estimator_raw) WITH (fillfactor = 70);
+CREATE TABLE bench_upsert_fixed (id int PRIMARY KEY, counter hyperloglog_estimator_raw) WITH (fillfactor = 70);
+
+INSERT INTO bench_upsert_merge
+    SELECT id, hyperloglog_accum(id * 1000 + i, 0.03::real) FROM generate_series(1, $ROWS) id, generate_series(1, 100) i GROUP BY id;
+INSERT INTO bench_upsert_fixed
+    SELECT id, hyperloglog_fixed(counter) FROM bench_upsert_merge;
+
+VACUUM ANALYZE bench_upsert_merge;
+VACUUM ANALYZE bench_upsert_fixed;
+EOF
+
+cat > "$WORKDIR/merge.sql" <<EOF
+\set id random(1, $ROWS)
+UPDATE bench_upsert_merge SET counter = hyperloglog_comp(counter || (SELECT hyperloglog_accum(random(), 0.03::real) FROM generate_series(1, 10))) WHERE id = :id;
+EOF
+
+cat > "$WORKDIR/fixed.sql" <<EOF
+\set id random(1, $ROWS)
+UPDATE bench_upsert_fixed SET counter = hyperloglog_upsert(counter, (SELECT hyperloglog_accum(random(), 0.03::real) FROM generate_series(1, 10))) WHERE id = :id;
+EOF
+
+for variant in merge fixed; do
+    echo "== $variant"
+    pgbench -n -c "$CLIENTS" -j "$CLIENTS" -T "$SECONDS_" -f "$WORKDIR/$variant.sql" | grep -E '^(tps|latency average)'
+done
+
+psql -X <<EOF
+SELECT relname,
+       n_tup_upd,
+       n_tup_hot_upd,
+       round(100.0 * n_tup_hot_upd / greatest(n_tup_upd, 1), 1) hot_percent,
+       pg_size_pretty(pg_relation_size(relid)) heap_size,
+       pg_size_pretty(pg_total_relation_size(relid) - pg_relation_size(relid) - pg_indexes_size(relid)) toast_size
+FROM pg_stat_user_tables
+WHERE relname IN ('bench_upsert_merge', 'bench_upsert_fixed')
+ORDER BY relname;
+EOF
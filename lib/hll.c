@@ -0,0 +1,314 @@
+/* C API of libhll.a (see hll.h), a thin layer over the engine of the
+ * extension that does what the SQL functions of hyperloglog_counter.c do. */
+#include <strings.h>
+
+#include "postgres.h"
+#include "utils/memutils.h"
+#include "hyperloglog.h"
+#include "upgrade.h"
+#include "encoding.h"
+#include "hll.h"
+
+/* The counter is kept expanded (HLLData header), of the current version and
+ * in TopMemoryContext. It's uncompressed while items are added to it, like
+ * the transition state of the aggregates. */
+struct hll_counter
+{
+    HLLCounter hloglog;
+};
+
+/* Every API function runs the engine between HLL_API_BEGIN and HLL_API_END.
+ * An error jumps back to HLL_API_BEGIN which returns 'failure', and whatever
+ * the engine allocated in CurrentMemoryContext is freed either way. Only
+ * allocate in TopMemoryContext once nothing can fail anymore. */
+#define HLL_API_BEGIN(failure) \
+    jmp_buf api_jump; \
+    if (setjmp(api_jump) != 0){ \
+        hll_shim_exception_stack = NULL; \
+        MemoryContextReset(CurrentMemoryContext); \
+        return failure; \
+    } \
+    hll_shim_exception_stack = &api_jump
+
+#define HLL_API_END() \
+    do { \
+        hll_shim_exception_stack = NULL; \
+        MemoryContextReset(CurrentMemoryContext); \
+    } while (0)
+
+/* ---------------------- function definitions --------------------------- */
+
+/* copies a counter built in CurrentMemoryContext to TopMemoryContext */
+static HLLCounter
+keep(HLLCounter hloglog)
+{
+    HLLCounter kept = MemoryContextAlloc(TopMemoryContext, VARSIZE_ANY(hloglog));
+
+    memcpy(kept, hloglog, VARSIZE_ANY(hloglog));
+
+    return kept;
+}
+
+static hll_counter *
+new_counter(HLLCounter hloglog)
+{
+    hll_counter *counter = malloc(sizeof(hll_counter));
+
+    if (counter == NULL){
+        elog(ERROR, "out of memory");
+    }
+
+    counter->hloglog = hloglog;
+
+    return counter;
+}
+
+/* Reads a counter from outside like hyperloglog_recv, the data is copied */
+static HLLCounter
+read_counter(const char *data, size_t length)
+{
+    HLLCounter hloglog;
+
+    if (length == 0 || length > 0x3FFFFFFF - VARHDRSZ - HLL_COMPACT_MAX_HEADER){
+        elog(ERROR, "invalid counter length %zu", length);
+    }
+
+    /* zero padded, so a truncated compact header is caught by hll_expand */
+    hloglog = palloc0(VARHDRSZ + length + HLL_COMPACT_MAX_HEADER);
+    memcpy(VARDATA(hloglog), data, length);
+    SET_VARSIZE(hloglog, VARHDRSZ + length);
+
+    if (!HLL_IS_COMPACT(hloglog) && VARSIZE(hloglog) < offsetof(HLLData, data)){
+        elog(ERROR, "counter is too short");
+    }
+
+    hloglog = hll_expand(hloglog);
+    if (hloglog->version > STRUCT_VERSION){
+        elog(ERROR, "counter is version %u while the library is version %u", hloglog->version, STRUCT_VERSION);
+    } else if (hloglog->version < 4){
+        elog(ERROR, "counters older than version 4 are not supported");
+    }
+    hll_validate(hloglog);
+
+    if (hloglog->version != STRUCT_VERSION){
+        hloglog = hll_upgrade(hll_copy(hloglog));
+    }
+
+    return hloglog;
+}
+
+/* the counter as hyperloglog_comp returns it */
+static HLLCounter
+stored_counter(const hll_counter *counter)
+{
+    return hll_compact(hll_compress(hll_copy(counter->hloglog)));
+}
+
+hll_counter *
+hll_counter_create(double ndistinct, float error_rate, char format)
+{
+    HLLCounter hloglog;
+    hll_counter *counter;
+    HLL_API_BEGIN(NULL);
+
+    if (error_rate <= 0 || error_rate > 1){
+        elog(ERROR, "error rate has to be between 0 and 1");
+    }
+
+    /* the same formats as the aggregates */
+    if (format == 'u' || format == 'U'){
+        hloglog = hll_create(ndistinct, error_rate, PACKED_UNPACKED);
+    } else if (format == 'p' || format == 'P'){
+        hloglog = hll_create(ndistinct, error_rate, PACKED);
+    } else if (format == 'n' || format == 'N'){
+        hloglog = hll_create(ndistinct, error_rate, NIBBLE);
+    } else {
+        elog(ERROR, "improper format specification, must be U, P or N");
+    }
+
+    counter = new_counter(keep(hloglog));
+
+    HLL_API_END();
+    return counter;
+}
+
+hll_counter *
+hll_counter_copy(const hll_counter *counter)
+{
+    hll_counter *copy;
+    HLL_API_BEGIN(NULL);
+
+    copy = new_counter(keep(counter->hloglog));
+
+    HLL_API_END();
+    return copy;
+}
+
+void
+hll_counter_free(hll_counter *counter)
+{
+    if (counter == NULL){
+        return;
+    }
+
+    pfree(counter->hloglog);
+    free(counter);
+}
+
+int
+hll_counter_add(hll_counter *counter, const void *item, size_t length)
+{
+    HLLCounter hloglog;
+    HLL_API_BEGIN(-1);
+
+    hloglog = counter->hloglog;
+    if (hloglog->b < 0){
+        hloglog = hll_decompress(hloglog);
+    }
+
+    /* updated in place unless the sparse array grows or is promoted */
+    hloglog = hll_add_element(hloglog, item, length);
+    if (hloglog != counter->hloglog){
+        hloglog = keep(hloglog);
+        pfree(counter->hloglog);
+        counter->hloglog = hloglog;
+    }
+
+    HLL_API_END();
+    return 0;
+}
+
+int
+hll_counter_merge(hll_counter *counter, const hll_counter *other)
+{
+    HLLCounter hloglog;
+    HLL_API_BEGIN(-1);
+
+    /* checked before copying anything, the registers have to line up */
+    if (HLL_PRECISION(counter->hloglog) != HLL_PRECISION(other->hloglog)){
+        elog(ERROR, "index size (bit length) of estimators differs (%d != %d)",
+             HLL_PRECISION(counter->hloglog), HLL_PRECISION(other->hloglog));
+    } else if (counter->hloglog->binbits != other->hloglog->binbits){
+        elog(ERROR, "bin size of estimators differs (%d != %d)",
+             counter->hloglog->binbits, other->hloglog->binbits);
+    }
+
+    hloglog = hll_merge_compressed(hll_copy(counter->hloglog), hll_copy(other->hloglog));
+    hloglog = keep(hloglog);
+    pfree(counter->hloglog);
+    counter->hloglog = hloglog;
+
+    HLL_API_END();
+    return 0;
+}
+
+double
+hll_counter_estimate(const hll_counter *counter)
+{
+    double estimate;
+    HLL_API_BEGIN(-1);
+
+    estimate = hll_estimate(hll_unpack(hll_copy(counter->hloglog)));
+
+    HLL_API_END();
+    return estimate;
+}
+
+int
+hll_counter_serialize(const hll_counter *counter, unsigned char **data, size_t *length)
+{
+    HLLCounter hloglog;
+    unsigned char *result;
+    HLL_API_BEGIN(-1);
+
+    hloglog = stored_counter(counter);
+
+    result = malloc(VARSIZE(hloglog) - VARHDRSZ);
+    if (result == NULL){
+        elog(ERROR, "out of memory");
+    }
+    memcpy(result, VARDATA(hloglog), VARSIZE(hloglog) - VARHDRSZ);
+    *data = result;
+    *length = VARSIZE(hloglog) - VARHDRSZ;
+
+    HLL_API_END();
+    return 0;
+}
+
+hll_counter *
+hll_counter_deserialize(const void *data, size_t length)
+{
+    HLLCounter hloglog;
+    hll_counter *counter;
+    HLL_API_BEGIN(NULL);
+
+    hloglog = read_counter(data, length);
+
+    counter = new_counter(keep(hloglog));
+
+    HLL_API_END();
+    return counter;
+}
+
+char *
+hll_counter_to_text(const hll_counter *counter, int wrap)
+{
+    HLLCounter hloglog;
+    char *result;
+    int length;
+    HLL_API_BEGIN(NULL);
+
+    hloglog = stored_counter(counter);
+
+    length = b64_enc_len(VARDATA(hloglog), VARSIZE(hloglog) - VARHDRSZ);
+    result = malloc(length + 1);
+    if (result == NULL){
+        elog(ERROR, "out of memory");
+    }
+    length = hll_b64_encode(VARDATA(hloglog), VARSIZE(hloglog) - VARHDRSZ, result, wrap != 0);
+    result[length] = '\0';
+
+    HLL_API_END();
+    return result;
+}
+
+hll_counter *
+hll_counter_from_text(const char *text)
+{
+    HLLCounter hloglog;
+    hll_counter *counter;
+    char *data;
+    int length;
+    HLL_API_BEGIN(NULL);
+
+    length = strlen(text);
+    data = palloc(b64_dec_len(text, length));
+    length = hll_b64_decode(text, length, data);
+    hloglog = read_counter(data, length);
+
+    counter = new_counter(keep(hloglog));
+
+    HLL_API_END();
+    return counter;
+}
+
+int
+hll_set_promotion_policy(const char *policy)
+{
+    if (strcasecmp(policy, "fixed") == 0){
+        hll_promotion_policy = HLL_PROMOTION_FIXED;
+    } else if (strcasecmp(policy, "size") == 0){
+        hll_promotion_policy = HLL_PROMOTION_SIZE;
+    } else {
+        snprintf(hll_shim_error_message, sizeof(hll_shim_error_message), "improper promotion policy, must be fixed or size");
+        return -1;
+    }
+
+    return 0;
+}
+
+const char *
+hll_error(void)
+{
+    return hll_shim_error_message;
+}
@@ -0,0 +1,83 @@
+#ifndef _HLL_H_
+#define _HLL_H_
+/* C API of libhll.a, the counter engine of the extension built without
+ * PostgreSQL (make libhll.a). It builds, merges and estimates counters outside
+ * of the database, and reads and writes them in the formats the extension
+ * uses:
+ *
+ * - hll_counter_serialize/hll_counter_deserialize - the bytes of a stored
+ *   counter, as returned by hyperloglog_estimator::bytea or the binary
+ *   protocol (COPY BINARY, hyperloglog_send/hyperloglog_recv)
+ * - hll_counter_to_text/hll_counter_from_text - the base64 text format
+ *
+ * A counter built here is byte-identical to the one the aggregates return
+ * for the same items, error rate, ndistinct, format and promotion policy. The
+ * items are hashed as the database hashes the values of a column: integers
+ * and other fixed length types by value (little endian, e.g. 4 bytes for an
+ * integer and 8 for a bigint), text and other variable length types as their
+ * data bytes without the varlena header.
+ *
+ * Functions returning int return 0 on success and -1 on error, functions
+ * returning a pointer return NULL on error. hll_error() returns the message
+ * of the last error. The library keeps state between calls (the scratch
+ * arena of the engine, the promotion policy and the last error) so it's not
+ * thread safe, use it from a single thread at a time. */
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct hll_counter hll_counter;
+
+/* defaults of hyperloglog_init() / hyperloglog_accum() */
+#define HLL_DEFAULT_NDISTINCT 9223372036854775808.0
+#define HLL_DEFAULT_ERROR 0.008125
+
+/* creates an empty counter, format is 'P' (bit-packed, the default), 'U'
+ * (one byte per register) or 'N' (4-bit registers with a shared base) */
+hll_counter *hll_counter_create(double ndistinct, float error_rate, char format);
+
+/* copy of a counter, the original is unchanged */
+hll_counter *hll_counter_copy(const hll_counter *counter);
+
+void hll_counter_free(hll_counter *counter);
+
+/* adds an item (see above for how values are hashed) */
+int hll_counter_add(hll_counter *counter, const void *item, size_t length);
+
+/* merges other into counter like hyperloglog_merge(), both need the same
+ * error rate and ndistinct (counter is unchanged on error) */
+int hll_counter_merge(hll_counter *counter, const hll_counter *other);
+
+/* estimated number of distinct items, -1 on error */
+double hll_counter_estimate(const hll_counter *counter);
+
+/* Writes the counter as the database stores it (compressed, compact header)
+ * to a buffer allocated with malloc, the caller frees it. */
+int hll_counter_serialize(const hll_counter *counter, unsigned char **data, size_t *length);
+
+/* Reads a counter from the bytes of a stored or sent counter. They're checked
+ * like hyperloglog_recv does, older versions are upgraded. */
+hll_counter *hll_counter_deserialize(const void *data, size_t length);
+
+/* Writes the base64 text format (lines of 76 characters if wrap is set, see
+ * hyperloglog.output_wrap) as a string allocated with malloc. */
+char *hll_counter_to_text(const hll_counter *counter, int wrap);
+
+/* Reads a counter from its base64 text format */
+hll_counter *hll_counter_from_text(const char *text);
+
+/* Sets the sparse to dense promotion policy of the counters created
+ * afterwards, "fixed" (the default) or "size" (see hyperloglog.promotion) */
+int hll_set_promotion_policy(const char *policy);
+
+/* message of the last error */
+const char *hll_error(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
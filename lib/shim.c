@@ -0,0 +1,241 @@
+/* The PostgreSQL functions the engine needs when it's built into libhll.a
+ * (see lib/shim/postgres.h): memory contexts, error reporting and pglz
+ * decompression. */
+#include <stdarg.h>
+
+#include "postgres.h"
+#include "utils/memutils.h"
+#include "common/pg_lzcompress.h"
+
+/* Every chunk is linked into the list of its context so the whole context can
+ * be freed at once. The header is a multiple of the maximum alignment, so the
+ * chunks are aligned like the ones of malloc. */
+typedef struct MemoryChunk
+{
+    struct MemoryChunk *prev;
+    struct MemoryChunk *next;
+    MemoryContext context;
+    Size size;
+} MemoryChunk;
+
+typedef struct MemoryContextData
+{
+    MemoryChunk chunks;
+} MemoryContextData;
+
+static MemoryContextData top_context = {{&top_context.chunks, &top_context.chunks, NULL, 0}};
+static MemoryContextData call_context = {{&call_context.chunks, &call_context.chunks, NULL, 0}};
+
+MemoryContext TopMemoryContext = &top_context;
+MemoryContext CurrentMemoryContext = &call_context;
+
+jmp_buf *hll_shim_exception_stack = NULL;
+char hll_shim_error_message[256];
+
+/* ---------------------------- memory ----------------------------------- */
+
+static void
+chunk_link(MemoryContext context, MemoryChunk *chunk)
+{
+    chunk->context = context;
+    chunk->prev = &context->chunks;
+    chunk->next = context->chunks.next;
+    chunk->next->prev = chunk;
+    context->chunks.next = chunk;
+}
+
+static void
+chunk_unlink(MemoryChunk *chunk)
+{
+    chunk->prev->next = chunk->next;
+    chunk->next->prev = chunk->prev;
+}
+
+void *
+MemoryContextAlloc(MemoryContext context, Size size)
+{
+    MemoryChunk *chunk = malloc(sizeof(MemoryChunk) + size);
+
+    if (chunk == NULL){
+        elog(ERROR, "out of memory (failed on request of size %zu)", size);
+    }
+
+    chunk->size = size;
+    chunk_link(context, chunk);
+
+    return chunk + 1;
+}
+
+void *
+palloc(Size size)
+{
+    return MemoryContextAlloc(CurrentMemoryContext, size);
+}
+
+void *
+palloc0(Size size)
+{
+    return memset(palloc(size), 0, size);
+}
+
+void *
+repalloc(void *pointer, Size size)
+{
+    MemoryChunk *chunk = ((MemoryChunk *) pointer) - 1;
+    MemoryContext context = chunk->context;
+
+    chunk_unlink(chunk);
+    pointer = realloc(chunk, sizeof(MemoryChunk) + size);
+    if (pointer == NULL){
+        /* the old chunk is still valid, keep it in its context */
+        chunk_link(context, chunk);
+        elog(ERROR, "out of memory (failed on request of size %zu)", size);
+    }
+
+    chunk = pointer;
+    chunk->size = size;
+    chunk_link(context, chunk);
+
+    return chunk + 1;
+}
+
+void
+pfree(void *pointer)
+{
+    MemoryChunk *chunk = ((MemoryChunk *) pointer) - 1;
+
+    chunk_unlink(chunk);
+    free(chunk);
+}
+
+void
+MemoryContextReset(MemoryContext context)
+{
+    MemoryChunk *chunk = context->chunks.next;
+
+    while (chunk != &context->chunks){
+        MemoryChunk *next = chunk->next;
+        free(chunk);
+        chunk = next;
+    }
+
+    context->chunks.prev = &context->chunks;
+    context->chunks.next = &context->chunks;
+}
+
+/* ---------------------------- errors ----------------------------------- */
+
+static void
+error_jump(void)
+{
+    /* every API function sets the jump target, an error outside of them is a
+     * bug in the library */
+    if (hll_shim_exception_stack == NULL){
+        fprintf(stderr, "libhll: %s\n", hll_shim_error_message);
+        abort();
+    }
+
+    longjmp(*hll_shim_exception_stack, 1);
+}
+
+void
+hll_shim_elog(int elevel, const char *fmt, ...)
+{
+    va_list args;
+
+    if (elevel < ERROR){
+        return;
+    }
+
+    va_start(args, fmt);
+    vsnprintf(hll_shim_error_message, sizeof(hll_shim_error_message), fmt, args);
+    va_end(args);
+
+    error_jump();
+}
+
+int
+hll_shim_errmsg(const char *fmt, ...)
+{
+    va_list args;
+
+    va_start(args, fmt);
+    vsnprintf(hll_shim_error_message, sizeof(hll_shim_error_message), fmt, args);
+    va_end(args);
+
+    return 0;
+}
+
+void
+hll_shim_errfinish(int elevel)
+{
+    if (elevel >= ERROR){
+        error_jump();
+    }
+}
+
+/* ----------------------------- pglz ------------------------------------ */
+
+static const PGLZ_Strategy strategy_default = {32, INT32_MAX, 25, 1024, 128, 10};
+static const PGLZ_Strategy strategy_always = {0, INT32_MAX, 0, INT32_MAX, 128, 6};
+
+const PGLZ_Strategy *const PGLZ_strategy_default = &strategy_default;
+const PGLZ_Strategy *const PGLZ_strategy_always = &strategy_always;
+
+/* Counters haven't been pglz compressed since version 4, reports the data as
+ * incompressible like pglz does for data it can't compress */
+int32
+pglz_compress(const char *source, int32 slen, char *dest, const PGLZ_Strategy *strategy)
+{
+    return -1;
+}
+
+/* The decompressor of PostgreSQL's pglz (src/common/pg_lzcompress.c): a
+ * control byte is followed by 8 items, a literal byte for a 0 bit or a 2-3
+ * byte back reference (length and offset) for a 1 bit. */
+int32
+pglz_decompress(const char *source, int32 slen, char *dest, int32 rawsize, bool check_complete)
+{
+    const unsigned char *sp = (const unsigned char *) source;
+    const unsigned char *srcend = sp + slen;
+    unsigned char *dp = (unsigned char *) dest;
+    unsigned char *destend = dp + rawsize;
+
+    while (sp < srcend && dp < destend){
+        unsigned char ctrl = *sp++;
+        int ctrlc;
+
+        for (ctrlc = 0; ctrlc < 8 && sp < srcend && dp < destend; ctrlc++){
+            if (ctrl & 1){
+                int32 len = (sp[0] & 0x0f) + 3;
+                int32 off = ((sp[0] & 0xf0) << 4) | sp[1];
+
+                sp += 2;
+                if (len == 18){
+                    len += *sp++;
+                }
+
+                if (sp > srcend || off == 0 || off > (dp - (unsigned char *) dest)){
+                    return -1;
+                }
+
+                /* the reference may overlap the bytes it produces */
+                len = Min(len, destend - dp);
+                while (len--){
+                    *dp = dp[-off];
+                    dp++;
+                }
+            } else {
+                *dp++ = *sp++;
+            }
+
+            ctrl >>= 1;
+        }
+    }
+
+    if (check_complete && (dp != destend || sp != srcend)){
+        return -1;
+    }
+
+    return (char *) dp - dest;
+}
@@ -0,0 +1,24 @@
+#ifndef _HLL_SHIM_PG_LZCOMPRESS_H_
+#define _HLL_SHIM_PG_LZCOMPRESS_H_
+/* pglz is only needed to upgrade counters of versions before 4, whose dense
+ * registers were pglz compressed. The library decompresses them (see
+ * lib/shim.c) but never compresses anything with pglz. */
+#include "postgres.h"
+
+typedef struct PGLZ_Strategy
+{
+    int32 min_input_size;
+    int32 max_input_size;
+    int32 min_comp_rate;
+    int32 first_success_by;
+    int32 match_size_good;
+    int32 match_size_drop;
+} PGLZ_Strategy;
+
+extern const PGLZ_Strategy *const PGLZ_strategy_default;
+extern const PGLZ_Strategy *const PGLZ_strategy_always;
+
+extern int32 pglz_compress(const char *source, int32 slen, char *dest, const PGLZ_Strategy *strategy);
+extern int32 pglz_decompress(const char *source, int32 slen, char *dest, int32 rawsize, bool check_complete);
+
+#endif
@@ -0,0 +1,114 @@
+#ifndef _HLL_SHIM_POSTGRES_H_
+#define _HLL_SHIM_POSTGRES_H_
+/* Stands in for postgres.h when the engine (src/hyperloglog.c, hllutils.c,
+ * upgrade.c, encoding.c and the codecs) is built into libhll.a. It only
+ * provides what the engine uses: the integer types, the varlena macros (with
+ * the same 4 byte header layout, so counters are byte-identical to the ones
+ * stored in the database), palloc/pfree on simple memory contexts and elog.
+ *
+ * elog(ERROR) doesn't return, it jumps back to the libhll.a function that was
+ * called (see lib/shim.c). Messages below ERROR are dropped. */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <setjmp.h>
+
+/* the engine checks the version for the pglz header layout only */
+#define PG_VERSION_NUM 150000
+
+#ifndef BYTE_ORDER
+#define BYTE_ORDER __BYTE_ORDER__
+#define LITTLE_ENDIAN __ORDER_LITTLE_ENDIAN__
+#define BIG_ENDIAN __ORDER_BIG_ENDIAN__
+#endif
+
+typedef int8_t int8;
+typedef int16_t int16;
+typedef int32_t int32;
+typedef int64_t int64;
+typedef uint8_t uint8;
+typedef uint16_t uint16;
+typedef uint32_t uint32;
+typedef uint64_t uint64;
+typedef size_t Size;
+
+/* ---------------------------- varlena ---------------------------------- */
+
+/* only the little endian 4 byte header (and reading the 1 byte one) is
+ * needed, the library never produces toasted or compressed datums */
+struct varlena
+{
+    char vl_len_[4];
+    char vl_dat[1];
+};
+
+typedef struct varlena bytea;
+typedef struct varlena text;
+
+#define VARHDRSZ ((int32) sizeof(int32))
+
+#define VARATT_IS_1B(PTR) ((((const uint8 *) (PTR))[0] & 0x01) == 0x01)
+#define VARSIZE_1B(PTR) ((((const uint8 *) (PTR))[0] >> 1) & 0x7F)
+#define VARSIZE_4B(PTR) ((*((const uint32 *) (PTR)) >> 2) & 0x3FFFFFFF)
+
+#define SET_VARSIZE(PTR, len) (*((uint32 *) (PTR)) = (((uint32) (len)) << 2))
+#define SET_VARSIZE_COMPRESSED(PTR, len) (*((uint32 *) (PTR)) = (((uint32) (len)) << 2) | 0x02)
+
+#define VARSIZE(PTR) VARSIZE_4B(PTR)
+#define VARDATA(PTR) (((char *) (PTR)) + VARHDRSZ)
+#define VARSIZE_ANY(PTR) (VARATT_IS_1B(PTR) ? VARSIZE_1B(PTR) : VARSIZE_4B(PTR))
+#define VARSIZE_ANY_EXHDR(PTR) (VARATT_IS_1B(PTR) ? VARSIZE_1B(PTR) - 1 : VARSIZE_4B(PTR) - VARHDRSZ)
+#define VARDATA_ANY(PTR) (VARATT_IS_1B(PTR) ? ((char *) (PTR)) + 1 : VARDATA(PTR))
+
+/* ----------------------------- memory ---------------------------------- */
+
+typedef struct MemoryContextData *MemoryContext;
+
+/* TopMemoryContext keeps the counters handed out by the API (and the scratch
+ * arena), CurrentMemoryContext is reset after every API call */
+extern MemoryContext TopMemoryContext;
+extern MemoryContext CurrentMemoryContext;
+
+extern void *MemoryContextAlloc(MemoryContext context, Size size);
+extern void *palloc(Size size);
+extern void *palloc0(Size size);
+extern void *repalloc(void *pointer, Size size);
+extern void pfree(void *pointer);
+
+/* ----------------------------- errors ---------------------------------- */
+
+#define DEBUG1 14
+#define LOG 15
+#define NOTICE 18
+#define WARNING 19
+#define ERROR 20
+#define FATAL 21
+
+#define ERRCODE_INVALID_PARAMETER_VALUE 0
+
+/* where elog(ERROR) jumps to (set by every API function, like
+ * PG_exception_stack) and the message of the last error */
+extern jmp_buf *hll_shim_exception_stack;
+extern char hll_shim_error_message[256];
+
+extern void hll_shim_elog(int elevel, const char *fmt, ...) __attribute__((format(printf, 2, 3)));
+extern int hll_shim_errmsg(const char *fmt, ...) __attribute__((format(printf, 1, 2)));
+extern void hll_shim_errfinish(int elevel);
+
+#define elog(elevel, ...) hll_shim_elog(elevel, __VA_ARGS__)
+#define ereport(elevel, rest) do { (void) rest; hll_shim_errfinish(elevel); } while (0)
+#define errcode(sqlerrcode) 0
+#define errmsg(...) hll_shim_errmsg(__VA_ARGS__)
+
+/* ------------------------------ misc ----------------------------------- */
+
+#define Assert(condition) ((void) 0)
+#define lengthof(array) (sizeof (array) / sizeof ((array)[0]))
+#define Min(x, y) ((x) < (y) ? (x) : (y))
+#define Max(x, y) ((x) > (y) ? (x) : (y))
+
+#endif
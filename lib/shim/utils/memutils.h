@@ -0,0 +1,17 @@
+#ifndef _HLL_SHIM_MEMUTILS_H_
+#define _HLL_SHIM_MEMUTILS_H_
+#include "postgres.h"
+
+/* frees every chunk allocated in the context */
+extern void MemoryContextReset(MemoryContext context);
+
+static inline MemoryContext
+MemoryContextSwitchTo(MemoryContext context)
+{
+    MemoryContext old = CurrentMemoryContext;
+
+    CurrentMemoryContext = context;
+    return old;
+}
+
+#endif
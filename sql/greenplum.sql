@@ -39,6 +39,45 @@ CREATE CAST (bytea as hyperloglog_estimator) WITHOUT FUNCTION AS ASSIGNMENT;
 -- allow cast from bytea to hyperloglog_estimator
 CREATE CAST (hyperloglog_estimator as bytea) WITHOUT FUNCTION AS ASSIGNMENT;
 
+-- Companion type for counters that are already compressed internally (see
+-- hyperloglog_comp). It uses STORAGE = EXTERNAL so TOAST moves large counters
+-- out of line without trying to pglz compress them again, which rarely saves
+-- anything and costs CPU on every write and read. It shares the binary
+-- representation and casts implicitly to hyperloglog_estimator so all the
+-- functions, operators and aggregates work on it as well.
+CREATE TYPE hyperloglog_estimator_raw;
+
+CREATE OR REPLACE FUNCTION hyperloglog_raw_in(value cstring) RETURNS hyperloglog_estimator_raw
+     AS '$libdir/hyperloglog_counter', 'hyperloglog_in'
+     LANGUAGE C STRICT IMMUTABLE;
+
+CREATE OR REPLACE FUNCTION hyperloglog_raw_out(counter hyperloglog_estimator_raw) RETURNS cstring
+     AS '$libdir/hyperloglog_counter', 'hyperloglog_out'
+     LANGUAGE C STRICT IMMUTABLE;
+
+CREATE OR REPLACE FUNCTION hyperloglog_raw_recv(internal) RETURNS hyperloglog_estimator_raw
+     AS '$libdir/hyperloglog_counter', 'hyperloglog_recv'
+     LANGUAGE C STRICT IMMUTABLE;
+
+CREATE OR REPLACE FUNCTION hyperloglog_raw_send(hyperloglog_estimator_raw) RETURNS bytea
+     AS '$libdir/hyperloglog_counter', 'hyperloglog_send'
+     LANGUAGE C STRICT IMMUTABLE;
+
+CREATE TYPE hyperloglog_estimator_raw (
+    INPUT = hyperloglog_raw_in,
+    OUTPUT = hyperloglog_raw_out,
+    STORAGE = EXTERNAL,
+    ALIGNMENT = int4,
+    INTERNALLENGTH = VARIABLE,
+    SEND = hyperloglog_raw_send,
+    RECEIVE = hyperloglog_raw_recv
+);
+
+-- the representation is the same so the casts don't need a function
+CREATE CAST (hyperloglog_estimator_raw as hyperloglog_estimator) WITHOUT FUNCTION AS IMPLICIT;
+
+CREATE CAST (hyperloglog_estimator as hyperloglog_estimator_raw) WITHOUT FUNCTION AS ASSIGNMENT;
+
 CREATE OR REPLACE FUNCTION hyperloglog_to_text(hyperloglog_estimator) RETURNS text
 AS $$ select pg_catalog.encode($1::bytea, 'base64'); $$ LANGUAGE SQL IMMUTABLE;
 
@@ -65,6 +104,27 @@ CREATE OR REPLACE FUNCTION hyperloglog_unpack(counter hyperloglog_estimator) RET
      LANGUAGE C IMMUTABLE STRICT;
 COMMENT ON FUNCTION hyperloglog_unpack(counter hyperloglog_estimator) IS 'Return an unpacked version of the hyperloglog_estimator';
 
+/* fixed size counters for frequently updated columns */
+CREATE OR REPLACE FUNCTION hyperloglog_fixed(counter hyperloglog_estimator) RETURNS hyperloglog_estimator
+     AS '$libdir/hyperloglog_counter', 'hyperloglog_fixed'
+     LANGUAGE C IMMUTABLE STRICT;
+COMMENT ON FUNCTION hyperloglog_fixed(counter hyperloglog_estimator) IS 'Returns a dense, uncompressed and bitpacked version of the hyperloglog_estimator whose size only depends on its precision';
+
+CREATE OR REPLACE FUNCTION hyperloglog_fixed(counter hyperloglog_estimator, format text) RETURNS hyperloglog_estimator
+     AS '$libdir/hyperloglog_counter', 'hyperloglog_fixed_format'
+     LANGUAGE C IMMUTABLE STRICT;
+COMMENT ON FUNCTION hyperloglog_fixed(counter hyperloglog_estimator, format text) IS 'Returns a dense and uncompressed version of the hyperloglog_estimator whose size only depends on its precision, either bitpacked (P) or unpacked (U)';
+
+CREATE OR REPLACE FUNCTION hyperloglog_upsert(counter hyperloglog_estimator, other hyperloglog_estimator) RETURNS hyperloglog_estimator
+     AS '$libdir/hyperloglog_counter', 'hyperloglog_upsert'
+     LANGUAGE C IMMUTABLE;
+COMMENT ON FUNCTION hyperloglog_upsert(counter hyperloglog_estimator, other hyperloglog_estimator) IS 'Merges the second hyperloglog_estimator into the first one keeping the result fixed size (see hyperloglog_fixed) so updates of a column never change its size';
+
+CREATE OR REPLACE FUNCTION hyperloglog_promotion(counter hyperloglog_estimator, policy text) RETURNS hyperloglog_estimator
+     AS '$libdir/hyperloglog_counter', 'hyperloglog_promotion'
+     LANGUAGE C IMMUTABLE STRICT;
+COMMENT ON FUNCTION hyperloglog_promotion(counter hyperloglog_estimator, policy text) IS 'Sets the sparse to dense promotion policy of the hyperloglog_estimator, either fixed (promote at a fixed number of entries) or size (promote once the compressed sparse counter would be larger than the compressed dense one)';
+
 /* Utility functions */
 -- upgrades old counters into the new version
 CREATE OR REPLACE FUNCTION  hyperloglog_update(counter hyperloglog_estimator) RETURNS hyperloglog_estimator
@@ -83,6 +143,21 @@ CREATE OR REPLACE FUNCTION  hyperloglog_info() RETURNS TEXT
      LANGUAGE C IMMUTABLE;
 COMMENT ON FUNCTION hyperloglog_info() IS 'Provides general plugin information and settings';
 
+CREATE OR REPLACE FUNCTION hyperloglog_info_record(counter hyperloglog_estimator, OUT representation text, OUT compressed boolean, OUT format text, OUT promotion text, OUT index_bits integer, OUT binbits integer, OUT version integer, OUT stored_bytes bigint, OUT memory_bytes bigint, OUT sparse_entries integer, OUT nonzero_registers integer, OUT register_histogram integer[], OUT estimate double precision) RETURNS record
+     AS '$libdir/hyperloglog_counter', 'hyperloglog_info_record'
+     LANGUAGE C IMMUTABLE STRICT;
+COMMENT ON FUNCTION hyperloglog_info_record(counter hyperloglog_estimator) IS 'Provides the details of hyperloglog_info() as a record (representation, format, sizes, register histogram, estimate)';
+
+CREATE OR REPLACE FUNCTION hyperloglog_stats(OUT name text, OUT value bigint) RETURNS SETOF record
+     AS '$libdir/hyperloglog_counter', 'hyperloglog_stats'
+     LANGUAGE C VOLATILE;
+COMMENT ON FUNCTION hyperloglog_stats() IS 'Counters of what the plugin did in the current backend (adds, merges, promotions, compression, ...), on the master only';
+
+CREATE OR REPLACE FUNCTION hyperloglog_stats_reset() RETURNS void
+     AS '$libdir/hyperloglog_counter', 'hyperloglog_stats_reset'
+     LANGUAGE C VOLATILE;
+COMMENT ON FUNCTION hyperloglog_stats_reset() IS 'Resets the counters of hyperloglog_stats() in the current backend';
+
 -- get estimator size for the default error_rate 0.8125% and default 2^64 ndistinct
 CREATE OR REPLACE FUNCTION hyperloglog_size() RETURNS int
      AS '$libdir/hyperloglog_counter', 'hyperloglog_size_default'
@@ -153,6 +228,12 @@ CREATE OR REPLACE FUNCTION length(counter hyperloglog_estimator) RETURNS int
      AS '$libdir/hyperloglog_counter', 'hyperloglog_length'
      LANGUAGE C STRICT IMMUTABLE;
 COMMENT ON FUNCTION length(counter hyperloglog_estimator) IS 'Returns the length of the provided hyperloglog_estimator which is equivalent to its size in bytes';
+
+-- number of index bits of the estimator (only reads the counter header)
+CREATE OR REPLACE FUNCTION hyperloglog_precision(counter hyperloglog_estimator) RETURNS int
+     AS '$libdir/hyperloglog_counter', 'hyperloglog_precision'
+     LANGUAGE C STRICT IMMUTABLE;
+COMMENT ON FUNCTION hyperloglog_precision(counter hyperloglog_estimator) IS 'Returns the number of index bits (precision) of the provided hyperloglog_estimator, the number of bins is 2^precision';
      
 /* functions for set operations */
 CREATE OR REPLACE FUNCTION hyperloglog_equal(counter1 hyperloglog_estimator, counter2 hyperloglog_estimator) RETURNS bool
@@ -185,6 +266,16 @@ CREATE OR REPLACE FUNCTION hyperloglog_symmetric_diff(counter1 hyperloglog_estim
      LANGUAGE C IMMUTABLE;
 COMMENT ON FUNCTION hyperloglog_symmetric_diff(counter1 hyperloglog_estimator, counter2 hyperloglog_estimator) IS 'Uses the inclusion-exclusion principle to estimate the symmetric difference of two hyperloglog_estimators. Its worth noting that the error will be relative to the largest hyperloglog_estimator provided.';
 
+CREATE OR REPLACE FUNCTION hyperloglog_jaccard(counter1 hyperloglog_estimator, counter2 hyperloglog_estimator) RETURNS double precision
+     AS '$libdir/hyperloglog_counter', 'hyperloglog_jaccard'
+     LANGUAGE C STRICT IMMUTABLE;
+COMMENT ON FUNCTION hyperloglog_jaccard(counter1 hyperloglog_estimator, counter2 hyperloglog_estimator) IS 'Estimates the Jaccard similarity of two hyperloglog_estimators of the same precision with a joint maximum likelihood estimate of their registers. Unlike inclusion-exclusion the error of the intersection does not grow with the union.';
+
+CREATE OR REPLACE FUNCTION hyperloglog_containment(counter1 hyperloglog_estimator, counter2 hyperloglog_estimator) RETURNS double precision
+     AS '$libdir/hyperloglog_counter', 'hyperloglog_containment'
+     LANGUAGE C STRICT IMMUTABLE;
+COMMENT ON FUNCTION hyperloglog_containment(counter1 hyperloglog_estimator, counter2 hyperloglog_estimator) IS 'Estimates the fraction of the items of the first hyperloglog_estimator that are in the second one, like hyperloglog_jaccard.';
+
 /* functions for aggregate functions */
 
 CREATE OR REPLACE FUNCTION hyperloglog_add_item_agg(counter hyperloglog_estimator, item anyelement, error_rate real, ndistinct double precision) RETURNS hyperloglog_estimator
@@ -634,3 +725,374 @@ CREATE OPERATOR <= (
 );
 COMMENT ON OPERATOR <= (NUMERIC,hyperloglog_estimator) IS 'Returns true if the cardinality of the left numeric is less than or equal to the right hyperloglog_estimator';
 
+
+/* Sliding window counters */
+CREATE TYPE hyperloglog_sliding;
+
+CREATE OR REPLACE FUNCTION hyperloglog_sliding_in(value cstring) RETURNS hyperloglog_sliding
+     AS '$libdir/hyperloglog_counter', 'hyperloglog_sliding_in'
+     LANGUAGE C STRICT IMMUTABLE;
+
+CREATE OR REPLACE FUNCTION hyperloglog_sliding_out(counter hyperloglog_sliding) RETURNS cstring
+     AS '$libdir/hyperloglog_counter', 'hyperloglog_sliding_out'
+     LANGUAGE C STRICT IMMUTABLE;
+
+CREATE OR REPLACE FUNCTION hyperloglog_sliding_recv(internal) RETURNS hyperloglog_sliding
+     AS '$libdir/hyperloglog_counter', 'hyperloglog_sliding_recv'
+     LANGUAGE C STRICT IMMUTABLE;
+
+CREATE OR REPLACE FUNCTION hyperloglog_sliding_send(hyperloglog_sliding) RETURNS bytea
+     AS '$libdir/hyperloglog_counter', 'hyperloglog_sliding_send'
+     LANGUAGE C STRICT IMMUTABLE;
+
+CREATE TYPE hyperloglog_sliding (
+    INPUT = hyperloglog_sliding_in,
+    OUTPUT = hyperloglog_sliding_out,
+    STORAGE = EXTENDED,
+    ALIGNMENT = double,
+    INTERNALLENGTH = VARIABLE,
+    SEND = hyperloglog_sliding_send,
+    RECEIVE = hyperloglog_sliding_recv
+);
+COMMENT ON TYPE hyperloglog_sliding IS 'Sliding window HyperLogLog counter, estimates the distinct items seen since any time within its window';
+
+CREATE OR REPLACE FUNCTION hyperloglog_sliding_init(window_width interval) RETURNS hyperloglog_sliding
+     AS '$libdir/hyperloglog_counter', 'hyperloglog_sliding_init'
+     LANGUAGE C IMMUTABLE STRICT;
+COMMENT ON FUNCTION hyperloglog_sliding_init(window_width interval) IS 'Creates an empty hyperloglog_sliding counter keeping the given window (0.8125% accuracy)';
+
+CREATE OR REPLACE FUNCTION hyperloglog_sliding_init(window_width interval, error_rate real) RETURNS hyperloglog_sliding
+     AS '$libdir/hyperloglog_counter', 'hyperloglog_sliding_init'
+     LANGUAGE C IMMUTABLE STRICT;
+COMMENT ON FUNCTION hyperloglog_sliding_init(window_width interval, error_rate real) IS 'Creates an empty hyperloglog_sliding counter keeping the given window with a specified accuracy';
+
+CREATE OR REPLACE FUNCTION hyperloglog_sliding_add(counter hyperloglog_sliding, item anyelement, seen_at timestamptz) RETURNS hyperloglog_sliding
+     AS '$libdir/hyperloglog_counter', 'hyperloglog_sliding_add'
+     LANGUAGE C IMMUTABLE;
+COMMENT ON FUNCTION hyperloglog_sliding_add(counter hyperloglog_sliding, item anyelement, seen_at timestamptz) IS 'Adds an item seen at the given time to a hyperloglog_sliding counter';
+
+CREATE OR REPLACE FUNCTION hyperloglog_sliding_add_agg(counter hyperloglog_sliding, item anyelement, seen_at timestamptz, window_width interval) RETURNS hyperloglog_sliding
+     AS '$libdir/hyperloglog_counter', 'hyperloglog_sliding_add_agg'
+     LANGUAGE C IMMUTABLE;
+
+CREATE OR REPLACE FUNCTION hyperloglog_sliding_add_agg(counter hyperloglog_sliding, item anyelement, seen_at timestamptz, window_width interval, error_rate real) RETURNS hyperloglog_sliding
+     AS '$libdir/hyperloglog_counter', 'hyperloglog_sliding_add_agg'
+     LANGUAGE C IMMUTABLE;
+
+CREATE OR REPLACE FUNCTION hyperloglog_sliding_merge(counter1 hyperloglog_sliding, counter2 hyperloglog_sliding) RETURNS hyperloglog_sliding
+     AS '$libdir/hyperloglog_counter', 'hyperloglog_sliding_merge'
+     LANGUAGE C IMMUTABLE;
+COMMENT ON FUNCTION hyperloglog_sliding_merge(counter1 hyperloglog_sliding, counter2 hyperloglog_sliding) IS 'Merges two hyperloglog_sliding counters, the result keeps the smaller window';
+
+CREATE OR REPLACE FUNCTION hyperloglog_sliding_comp(counter hyperloglog_sliding) RETURNS hyperloglog_sliding
+     AS '$libdir/hyperloglog_counter', 'hyperloglog_sliding_comp'
+     LANGUAGE C IMMUTABLE STRICT;
+
+CREATE OR REPLACE FUNCTION hyperloglog_sliding_estimate(counter hyperloglog_sliding, since timestamptz) RETURNS double precision
+     AS '$libdir/hyperloglog_counter', 'hyperloglog_sliding_estimate'
+     LANGUAGE C IMMUTABLE STRICT;
+COMMENT ON FUNCTION hyperloglog_sliding_estimate(counter hyperloglog_sliding, since timestamptz) IS 'Estimates the distinct items a hyperloglog_sliding counter has seen since the given time';
+
+CREATE OR REPLACE FUNCTION hyperloglog_sliding_counter(counter hyperloglog_sliding, since timestamptz) RETURNS hyperloglog_estimator
+     AS '$libdir/hyperloglog_counter', 'hyperloglog_sliding_counter'
+     LANGUAGE C IMMUTABLE STRICT;
+COMMENT ON FUNCTION hyperloglog_sliding_counter(counter hyperloglog_sliding, since timestamptz) IS 'Returns the items a hyperloglog_sliding counter has seen since the given time as a hyperloglog_estimator';
+
+DROP AGGREGATE IF EXISTS hyperloglog_sliding_accum(anyelement, timestamptz, interval);
+CREATE AGGREGATE hyperloglog_sliding_accum(anyelement, timestamptz, interval)
+(
+    sfunc = hyperloglog_sliding_add_agg,
+    stype = hyperloglog_sliding,
+    prefunc = hyperloglog_sliding_merge,
+    finalfunc = hyperloglog_sliding_comp
+);
+COMMENT ON AGGREGATE hyperloglog_sliding_accum(anyelement, timestamptz, interval) IS 'Builds a hyperloglog_sliding counter keeping the given window from items and the times they were seen (0.8125% accuracy)';
+
+DROP AGGREGATE IF EXISTS hyperloglog_sliding_accum(anyelement, timestamptz, interval, real);
+CREATE AGGREGATE hyperloglog_sliding_accum(anyelement, timestamptz, interval, real)
+(
+    sfunc = hyperloglog_sliding_add_agg,
+    stype = hyperloglog_sliding,
+    prefunc = hyperloglog_sliding_merge,
+    finalfunc = hyperloglog_sliding_comp
+);
+COMMENT ON AGGREGATE hyperloglog_sliding_accum(anyelement, timestamptz, interval, real) IS 'Builds a hyperloglog_sliding counter keeping the given window from items and the times they were seen with a specified accuracy';
+
+DROP AGGREGATE IF EXISTS hyperloglog_sliding_merge(hyperloglog_sliding);
+CREATE AGGREGATE hyperloglog_sliding_merge(hyperloglog_sliding)
+(
+    sfunc = hyperloglog_sliding_merge,
+    stype = hyperloglog_sliding,
+    prefunc = hyperloglog_sliding_merge,
+    finalfunc = hyperloglog_sliding_comp
+);
+COMMENT ON AGGREGATE hyperloglog_sliding_merge(hyperloglog_sliding) IS 'Merges hyperloglog_sliding counters into a single one';
+
+
+/* UltraLogLog counters */
+CREATE TYPE hyperloglog_ultra;
+
+CREATE OR REPLACE FUNCTION hyperloglog_ultra_in(value cstring) RETURNS hyperloglog_ultra
+     AS '$libdir/hyperloglog_counter', 'hyperloglog_ultra_in'
+     LANGUAGE C STRICT IMMUTABLE;
+
+CREATE OR REPLACE FUNCTION hyperloglog_ultra_out(counter hyperloglog_ultra) RETURNS cstring
+     AS '$libdir/hyperloglog_counter', 'hyperloglog_ultra_out'
+     LANGUAGE C STRICT IMMUTABLE;
+
+CREATE OR REPLACE FUNCTION hyperloglog_ultra_recv(internal) RETURNS hyperloglog_ultra
+     AS '$libdir/hyperloglog_counter', 'hyperloglog_ultra_recv'
+     LANGUAGE C STRICT IMMUTABLE;
+
+CREATE OR REPLACE FUNCTION hyperloglog_ultra_send(hyperloglog_ultra) RETURNS bytea
+     AS '$libdir/hyperloglog_counter', 'hyperloglog_ultra_send'
+     LANGUAGE C STRICT IMMUTABLE;
+
+CREATE TYPE hyperloglog_ultra (
+    INPUT = hyperloglog_ultra_in,
+    OUTPUT = hyperloglog_ultra_out,
+    STORAGE = EXTENDED,
+    ALIGNMENT = int4,
+    INTERNALLENGTH = VARIABLE,
+    SEND = hyperloglog_ultra_send,
+    RECEIVE = hyperloglog_ultra_recv
+);
+COMMENT ON TYPE hyperloglog_ultra IS 'UltraLogLog counter, the accuracy of a hyperloglog_estimator in a third less space';
+
+CREATE OR REPLACE FUNCTION hyperloglog_ultra_init() RETURNS hyperloglog_ultra
+     AS '$libdir/hyperloglog_counter', 'hyperloglog_ultra_init'
+     LANGUAGE C IMMUTABLE STRICT;
+COMMENT ON FUNCTION hyperloglog_ultra_init() IS 'Creates an empty hyperloglog_ultra counter (0.862% accuracy)';
+
+CREATE OR REPLACE FUNCTION hyperloglog_ultra_init(error_rate real) RETURNS hyperloglog_ultra
+     AS '$libdir/hyperloglog_counter', 'hyperloglog_ultra_init'
+     LANGUAGE C IMMUTABLE STRICT;
+COMMENT ON FUNCTION hyperloglog_ultra_init(error_rate real) IS 'Creates an empty hyperloglog_ultra counter with a specified accuracy';
+
+CREATE OR REPLACE FUNCTION hyperloglog_ultra_add(counter hyperloglog_ultra, item anyelement) RETURNS hyperloglog_ultra
+     AS '$libdir/hyperloglog_counter', 'hyperloglog_ultra_add'
+     LANGUAGE C IMMUTABLE;
+COMMENT ON FUNCTION hyperloglog_ultra_add(counter hyperloglog_ultra, item anyelement) IS 'Adds an item to a hyperloglog_ultra counter';
+
+CREATE OR REPLACE FUNCTION hyperloglog_ultra_add_agg(counter hyperloglog_ultra, item anyelement) RETURNS hyperloglog_ultra
+     AS '$libdir/hyperloglog_counter', 'hyperloglog_ultra_add_agg'
+     LANGUAGE C IMMUTABLE;
+
+CREATE OR REPLACE FUNCTION hyperloglog_ultra_add_agg(counter hyperloglog_ultra, item anyelement, error_rate real) RETURNS hyperloglog_ultra
+     AS '$libdir/hyperloglog_counter', 'hyperloglog_ultra_add_agg'
+     LANGUAGE C IMMUTABLE;
+
+CREATE OR REPLACE FUNCTION hyperloglog_ultra_merge(counter1 hyperloglog_ultra, counter2 hyperloglog_ultra) RETURNS hyperloglog_ultra
+     AS '$libdir/hyperloglog_counter', 'hyperloglog_ultra_merge'
+     LANGUAGE C IMMUTABLE;
+COMMENT ON FUNCTION hyperloglog_ultra_merge(counter1 hyperloglog_ultra, counter2 hyperloglog_ultra) IS 'Merges two hyperloglog_ultra counters into one';
+
+CREATE OR REPLACE FUNCTION hyperloglog_ultra_comp(counter hyperloglog_ultra) RETURNS hyperloglog_ultra
+     AS '$libdir/hyperloglog_counter', 'hyperloglog_ultra_comp'
+     LANGUAGE C IMMUTABLE STRICT;
+
+CREATE OR REPLACE FUNCTION hyperloglog_ultra_get_estimate(counter hyperloglog_ultra) RETURNS double precision
+     AS '$libdir/hyperloglog_counter', 'hyperloglog_ultra_get_estimate'
+     LANGUAGE C IMMUTABLE STRICT;
+COMMENT ON FUNCTION hyperloglog_ultra_get_estimate(counter hyperloglog_ultra) IS 'Estimates the cardinality of the provided hyperloglog_ultra counter';
+
+CREATE OR REPLACE FUNCTION hyperloglog_ultra_counter(counter hyperloglog_ultra) RETURNS hyperloglog_estimator
+     AS '$libdir/hyperloglog_counter', 'hyperloglog_ultra_counter'
+     LANGUAGE C IMMUTABLE STRICT;
+COMMENT ON FUNCTION hyperloglog_ultra_counter(counter hyperloglog_ultra) IS 'Returns the registers of a hyperloglog_ultra counter as a hyperloglog_estimator of the same precision';
+
+CREATE OR REPLACE FUNCTION hyperloglog_ultra_from_counter(counter hyperloglog_estimator) RETURNS hyperloglog_ultra
+     AS '$libdir/hyperloglog_counter', 'hyperloglog_ultra_from_counter'
+     LANGUAGE C IMMUTABLE STRICT;
+COMMENT ON FUNCTION hyperloglog_ultra_from_counter(counter hyperloglog_estimator) IS 'Converts a hyperloglog_estimator into a hyperloglog_ultra counter of the same precision';
+
+CREATE CAST (hyperloglog_ultra AS hyperloglog_estimator) WITH FUNCTION hyperloglog_ultra_counter(hyperloglog_ultra);
+
+CREATE CAST (hyperloglog_estimator AS hyperloglog_ultra) WITH FUNCTION hyperloglog_ultra_from_counter(hyperloglog_estimator);
+
+DROP AGGREGATE IF EXISTS hyperloglog_ultra_distinct(anyelement);
+CREATE AGGREGATE hyperloglog_ultra_distinct(anyelement)
+(
+    sfunc = hyperloglog_ultra_add_agg,
+    stype = hyperloglog_ultra,
+    prefunc = hyperloglog_ultra_merge,
+    finalfunc = hyperloglog_ultra_get_estimate
+);
+COMMENT ON AGGREGATE hyperloglog_ultra_distinct(anyelement) IS 'Uses a hyperloglog_ultra counter to estimate the distinct count of the column (0.862% accuracy)';
+
+DROP AGGREGATE IF EXISTS hyperloglog_ultra_distinct(anyelement, real);
+CREATE AGGREGATE hyperloglog_ultra_distinct(anyelement, real)
+(
+    sfunc = hyperloglog_ultra_add_agg,
+    stype = hyperloglog_ultra,
+    prefunc = hyperloglog_ultra_merge,
+    finalfunc = hyperloglog_ultra_get_estimate
+);
+COMMENT ON AGGREGATE hyperloglog_ultra_distinct(anyelement, real) IS 'Uses a hyperloglog_ultra counter to estimate the distinct count of the column with a specified accuracy';
+
+DROP AGGREGATE IF EXISTS hyperloglog_ultra_accum(anyelement);
+CREATE AGGREGATE hyperloglog_ultra_accum(anyelement)
+(
+    sfunc = hyperloglog_ultra_add_agg,
+    stype = hyperloglog_ultra,
+    prefunc = hyperloglog_ultra_merge,
+    finalfunc = hyperloglog_ultra_comp
+);
+COMMENT ON AGGREGATE hyperloglog_ultra_accum(anyelement) IS 'Builds a hyperloglog_ultra counter from the items (0.862% accuracy)';
+
+DROP AGGREGATE IF EXISTS hyperloglog_ultra_accum(anyelement, real);
+CREATE AGGREGATE hyperloglog_ultra_accum(anyelement, real)
+(
+    sfunc = hyperloglog_ultra_add_agg,
+    stype = hyperloglog_ultra,
+    prefunc = hyperloglog_ultra_merge,
+    finalfunc = hyperloglog_ultra_comp
+);
+COMMENT ON AGGREGATE hyperloglog_ultra_accum(anyelement, real) IS 'Builds a hyperloglog_ultra counter from the items with a specified accuracy';
+
+DROP AGGREGATE IF EXISTS hyperloglog_ultra_merge(hyperloglog_ultra);
+CREATE AGGREGATE hyperloglog_ultra_merge(hyperloglog_ultra)
+(
+    sfunc = hyperloglog_ultra_merge,
+    stype = hyperloglog_ultra,
+    prefunc = hyperloglog_ultra_merge,
+    finalfunc = hyperloglog_ultra_comp
+);
+COMMENT ON AGGREGATE hyperloglog_ultra_merge(hyperloglog_ultra) IS 'Merges hyperloglog_ultra counters into a single one';
+
+/* Theta sketches */
+CREATE TYPE hyperloglog_theta;
+
+CREATE OR REPLACE FUNCTION hyperloglog_theta_in(value cstring) RETURNS hyperloglog_theta
+     AS '$libdir/hyperloglog_counter', 'hyperloglog_theta_in'
+     LANGUAGE C STRICT IMMUTABLE;
+
+CREATE OR REPLACE FUNCTION hyperloglog_theta_out(sketch hyperloglog_theta) RETURNS cstring
+     AS '$libdir/hyperloglog_counter', 'hyperloglog_theta_out'
+     LANGUAGE C STRICT IMMUTABLE;
+
+CREATE OR REPLACE FUNCTION hyperloglog_theta_recv(internal) RETURNS hyperloglog_theta
+     AS '$libdir/hyperloglog_counter', 'hyperloglog_theta_recv'
+     LANGUAGE C STRICT IMMUTABLE;
+
+CREATE OR REPLACE FUNCTION hyperloglog_theta_send(hyperloglog_theta) RETURNS bytea
+     AS '$libdir/hyperloglog_counter', 'hyperloglog_theta_send'
+     LANGUAGE C STRICT IMMUTABLE;
+
+CREATE TYPE hyperloglog_theta (
+    INPUT = hyperloglog_theta_in,
+    OUTPUT = hyperloglog_theta_out,
+    STORAGE = EXTENDED,
+    ALIGNMENT = double,
+    INTERNALLENGTH = VARIABLE,
+    SEND = hyperloglog_theta_send,
+    RECEIVE = hyperloglog_theta_recv
+);
+COMMENT ON TYPE hyperloglog_theta IS 'Theta sketch (k minimum values), distinct counts with exact set operations on the samples';
+
+CREATE OR REPLACE FUNCTION hyperloglog_theta_init() RETURNS hyperloglog_theta
+     AS '$libdir/hyperloglog_counter', 'hyperloglog_theta_init'
+     LANGUAGE C IMMUTABLE STRICT;
+COMMENT ON FUNCTION hyperloglog_theta_init() IS 'Creates an empty hyperloglog_theta sketch (1.5625% accuracy)';
+
+CREATE OR REPLACE FUNCTION hyperloglog_theta_init(error_rate real) RETURNS hyperloglog_theta
+     AS '$libdir/hyperloglog_counter', 'hyperloglog_theta_init'
+     LANGUAGE C IMMUTABLE STRICT;
+COMMENT ON FUNCTION hyperloglog_theta_init(error_rate real) IS 'Creates an empty hyperloglog_theta sketch with a specified accuracy';
+
+CREATE OR REPLACE FUNCTION hyperloglog_theta_add(sketch hyperloglog_theta, item anyelement) RETURNS hyperloglog_theta
+     AS '$libdir/hyperloglog_counter', 'hyperloglog_theta_add'
+     LANGUAGE C IMMUTABLE;
+COMMENT ON FUNCTION hyperloglog_theta_add(sketch hyperloglog_theta, item anyelement) IS 'Adds an item to a hyperloglog_theta sketch';
+
+CREATE OR REPLACE FUNCTION hyperloglog_theta_add_agg(sketch hyperloglog_theta, item anyelement) RETURNS hyperloglog_theta
+     AS '$libdir/hyperloglog_counter', 'hyperloglog_theta_add_agg'
+     LANGUAGE C IMMUTABLE;
+
+CREATE OR REPLACE FUNCTION hyperloglog_theta_add_agg(sketch hyperloglog_theta, item anyelement, error_rate real) RETURNS hyperloglog_theta
+     AS '$libdir/hyperloglog_counter', 'hyperloglog_theta_add_agg'
+     LANGUAGE C IMMUTABLE;
+
+CREATE OR REPLACE FUNCTION hyperloglog_theta_merge(sketch1 hyperloglog_theta, sketch2 hyperloglog_theta) RETURNS hyperloglog_theta
+     AS '$libdir/hyperloglog_counter', 'hyperloglog_theta_merge'
+     LANGUAGE C IMMUTABLE;
+COMMENT ON FUNCTION hyperloglog_theta_merge(sketch1 hyperloglog_theta, sketch2 hyperloglog_theta) IS 'Returns the union of two hyperloglog_theta sketches';
+
+CREATE OR REPLACE FUNCTION hyperloglog_theta_intersect(sketch1 hyperloglog_theta, sketch2 hyperloglog_theta) RETURNS hyperloglog_theta
+     AS '$libdir/hyperloglog_counter', 'hyperloglog_theta_intersect'
+     LANGUAGE C IMMUTABLE;
+COMMENT ON FUNCTION hyperloglog_theta_intersect(sketch1 hyperloglog_theta, sketch2 hyperloglog_theta) IS 'Returns the intersection of two hyperloglog_theta sketches';
+
+CREATE OR REPLACE FUNCTION hyperloglog_theta_a_not_b(sketch1 hyperloglog_theta, sketch2 hyperloglog_theta) RETURNS hyperloglog_theta
+     AS '$libdir/hyperloglog_counter', 'hyperloglog_theta_a_not_b'
+     LANGUAGE C IMMUTABLE;
+COMMENT ON FUNCTION hyperloglog_theta_a_not_b(sketch1 hyperloglog_theta, sketch2 hyperloglog_theta) IS 'Returns the items of the first hyperloglog_theta sketch that are not in the second one';
+
+CREATE OR REPLACE FUNCTION hyperloglog_theta_comp(sketch hyperloglog_theta) RETURNS hyperloglog_theta
+     AS '$libdir/hyperloglog_counter', 'hyperloglog_theta_comp'
+     LANGUAGE C IMMUTABLE STRICT;
+
+CREATE OR REPLACE FUNCTION hyperloglog_theta_estimate(sketch hyperloglog_theta) RETURNS double precision
+     AS '$libdir/hyperloglog_counter', 'hyperloglog_theta_estimate'
+     LANGUAGE C IMMUTABLE STRICT;
+COMMENT ON FUNCTION hyperloglog_theta_estimate(sketch hyperloglog_theta) IS 'Estimates the cardinality of the provided hyperloglog_theta sketch';
+
+DROP AGGREGATE IF EXISTS hyperloglog_theta_distinct(anyelement);
+CREATE AGGREGATE hyperloglog_theta_distinct(anyelement)
+(
+    sfunc = hyperloglog_theta_add_agg,
+    stype = hyperloglog_theta,
+    prefunc = hyperloglog_theta_merge,
+    finalfunc = hyperloglog_theta_estimate
+);
+COMMENT ON AGGREGATE hyperloglog_theta_distinct(anyelement) IS 'Uses a hyperloglog_theta sketch to estimate the distinct count of the column (1.5625% accuracy)';
+
+DROP AGGREGATE IF EXISTS hyperloglog_theta_distinct(anyelement, real);
+CREATE AGGREGATE hyperloglog_theta_distinct(anyelement, real)
+(
+    sfunc = hyperloglog_theta_add_agg,
+    stype = hyperloglog_theta,
+    prefunc = hyperloglog_theta_merge,
+    finalfunc = hyperloglog_theta_estimate
+);
+COMMENT ON AGGREGATE hyperloglog_theta_distinct(anyelement, real) IS 'Uses a hyperloglog_theta sketch to estimate the distinct count of the column with a specified accuracy';
+
+DROP AGGREGATE IF EXISTS hyperloglog_theta_accum(anyelement);
+CREATE AGGREGATE hyperloglog_theta_accum(anyelement)
+(
+    sfunc = hyperloglog_theta_add_agg,
+    stype = hyperloglog_theta,
+    prefunc = hyperloglog_theta_merge,
+    finalfunc = hyperloglog_theta_comp
+);
+COMMENT ON AGGREGATE hyperloglog_theta_accum(anyelement) IS 'Builds a hyperloglog_theta sketch from the items (1.5625% accuracy)';
+
+DROP AGGREGATE IF EXISTS hyperloglog_theta_accum(anyelement, real);
+CREATE AGGREGATE hyperloglog_theta_accum(anyelement, real)
+(
+    sfunc = hyperloglog_theta_add_agg,
+    stype = hyperloglog_theta,
+    prefunc = hyperloglog_theta_merge,
+    finalfunc = hyperloglog_theta_comp
+);
+COMMENT ON AGGREGATE hyperloglog_theta_accum(anyelement, real) IS 'Builds a hyperloglog_theta sketch from the items with a specified accuracy';
+
+DROP AGGREGATE IF EXISTS hyperloglog_theta_merge(hyperloglog_theta);
+CREATE AGGREGATE hyperloglog_theta_merge(hyperloglog_theta)
+(
+    sfunc = hyperloglog_theta_merge,
+    stype = hyperloglog_theta,
+    prefunc = hyperloglog_theta_merge,
+    finalfunc = hyperloglog_theta_comp
+);
+COMMENT ON AGGREGATE hyperloglog_theta_merge(hyperloglog_theta) IS 'Returns the union of the hyperloglog_theta sketches';
+
+DROP AGGREGATE IF EXISTS hyperloglog_theta_intersect(hyperloglog_theta);
+CREATE AGGREGATE hyperloglog_theta_intersect(hyperloglog_theta)
+(
+    sfunc = hyperloglog_theta_intersect,
+    stype = hyperloglog_theta,
+    prefunc = hyperloglog_theta_intersect,
+    finalfunc = hyperloglog_theta_comp
+);
+COMMENT ON AGGREGATE hyperloglog_theta_intersect(hyperloglog_theta) IS 'Returns the intersection of the hyperloglog_theta sketches';
@@ -39,6 +39,45 @@ CREATE CAST (bytea as hyperloglog_estimator) WITHOUT FUNCTION AS ASSIGNMENT;
 -- allow cast from bytea to hyperloglog_estimator
 CREATE CAST (hyperloglog_estimator as bytea) WITHOUT FUNCTION AS ASSIGNMENT;
 
+-- Companion type for counters that are already compressed internally (see
+-- hyperloglog_comp). It uses STORAGE = EXTERNAL so TOAST moves large counters
+-- out of line without trying to pglz compress them again, which rarely saves
+-- anything and costs CPU on every write and read. It shares the binary
+-- representation and casts implicitly to hyperloglog_estimator so all the
+-- functions, operators and aggregates work on it as well.
+CREATE TYPE hyperloglog_estimator_raw;
+
+CREATE FUNCTION hyperloglog_raw_in(value cstring) RETURNS hyperloglog_estimator_raw
+     AS '$libdir/hyperloglog_counter', 'hyperloglog_in'
+     LANGUAGE C STRICT IMMUTABLE;
+
+CREATE FUNCTION hyperloglog_raw_out(counter hyperloglog_estimator_raw) RETURNS cstring
+     AS '$libdir/hyperloglog_counter', 'hyperloglog_out'
+     LANGUAGE C STRICT IMMUTABLE;
+
+CREATE FUNCTION hyperloglog_raw_recv(internal) RETURNS hyperloglog_estimator_raw
+     AS '$libdir/hyperloglog_counter', 'hyperloglog_recv'
+     LANGUAGE C STRICT IMMUTABLE;
+
+CREATE FUNCTION hyperloglog_raw_send(hyperloglog_estimator_raw) RETURNS bytea
+     AS '$libdir/hyperloglog_counter', 'hyperloglog_send'
+     LANGUAGE C STRICT IMMUTABLE;
+
+CREATE TYPE hyperloglog_estimator_raw (
+    INPUT = hyperloglog_raw_in,
+    OUTPUT = hyperloglog_raw_out,
+    STORAGE = EXTERNAL,
+    ALIGNMENT = int4,
+    INTERNALLENGTH = VARIABLE,
+    SEND = hyperloglog_raw_send,
+    RECEIVE = hyperloglog_raw_recv
+);
+
+-- the representation is the same so the casts don't need a function
+CREATE CAST (hyperloglog_estimator_raw as hyperloglog_estimator) WITHOUT FUNCTION AS IMPLICIT;
+
+CREATE CAST (hyperloglog_estimator as hyperloglog_estimator_raw) WITHOUT FUNCTION AS ASSIGNMENT;
+
 /* compress/decompress inner data funcitons */
 CREATE FUNCTION hyperloglog_comp(counter hyperloglog_estimator) RETURNS hyperloglog_estimator
      AS '$libdir/hyperloglog_counter', 'hyperloglog_comp'
@@ -48,6 +87,27 @@ CREATE FUNCTION hyperloglog_decomp(counter hyperloglog_estimator) RETURNS hyperl
      AS '$libdir/hyperloglog_counter', 'hyperloglog_decomp'
      LANGUAGE C IMMUTABLE STRICT;
 
+/* fixed size counters for frequently updated columns */
+-- dense and uncompressed counter whose size only depends on the precision (bit-packed)
+CREATE FUNCTION hyperloglog_fixed(counter hyperloglog_estimator) RETURNS hyperloglog_estimator
+     AS '$libdir/hyperloglog_counter', 'hyperloglog_fixed'
+     LANGUAGE C IMMUTABLE STRICT;
+
+-- same as above with the format of the registers (P - bit-packed, U - unpacked)
+CREATE FUNCTION hyperloglog_fixed(counter hyperloglog_estimator, format text) RETURNS hyperloglog_estimator
+     AS '$libdir/hyperloglog_counter', 'hyperloglog_fixed_format'
+     LANGUAGE C IMMUTABLE STRICT;
+
+-- merges the second counter into the first one keeping the result fixed size
+CREATE FUNCTION hyperloglog_upsert(counter hyperloglog_estimator, other hyperloglog_estimator) RETURNS hyperloglog_estimator
+     AS '$libdir/hyperloglog_counter', 'hyperloglog_upsert'
+     LANGUAGE C IMMUTABLE;
+
+-- sets the sparse to dense promotion policy of the counter (fixed or size)
+CREATE FUNCTION hyperloglog_promotion(counter hyperloglog_estimator, policy text) RETURNS hyperloglog_estimator
+     AS '$libdir/hyperloglog_counter', 'hyperloglog_promotion'
+     LANGUAGE C IMMUTABLE STRICT;
+
 /* Utility functions */
 -- upgrades old counters into the new version
 CREATE FUNCTION  hyperloglog_update(counter hyperloglog_estimator) RETURNS hyperloglog_estimator
@@ -63,6 +123,22 @@ CREATE FUNCTION  hyperloglog_info() RETURNS TEXT
      AS '$libdir/hyperloglog_counter', 'hyperloglog_info_noargs'
      LANGUAGE C IMMUTABLE;
 
+-- the details of hyperloglog_info(counter) as a record (representation, format,
+-- sizes, register histogram, estimate, ...)
+CREATE FUNCTION hyperloglog_info_record(counter hyperloglog_estimator, OUT representation text, OUT compressed boolean, OUT format text, OUT promotion text, OUT index_bits integer, OUT binbits integer, OUT version integer, OUT stored_bytes bigint, OUT memory_bytes bigint, OUT sparse_entries integer, OUT nonzero_registers integer, OUT register_histogram integer[], OUT estimate double precision) RETURNS record
+     AS '$libdir/hyperloglog_counter', 'hyperloglog_info_record'
+     LANGUAGE C IMMUTABLE STRICT;
+
+-- counters of what the extension did in the current backend (adds, merges,
+-- promotions, compression, ...) and a reset of them
+CREATE FUNCTION hyperloglog_stats(OUT name text, OUT value bigint) RETURNS SETOF record
+     AS '$libdir/hyperloglog_counter', 'hyperloglog_stats'
+     LANGUAGE C VOLATILE;
+
+CREATE FUNCTION hyperloglog_stats_reset() RETURNS void
+     AS '$libdir/hyperloglog_counter', 'hyperloglog_stats_reset'
+     LANGUAGE C VOLATILE;
+
 -- get estimator size for the default error_rate 0.8125% and default 2^64 ndistinct
 CREATE FUNCTION hyperloglog_size() RETURNS int
      AS '$libdir/hyperloglog_counter', 'hyperloglog_size_default'
@@ -122,6 +198,11 @@ CREATE FUNCTION hyperloglog_reset(counter hyperloglog_estimator) RETURNS void
 CREATE FUNCTION length(counter hyperloglog_estimator) RETURNS int
      AS '$libdir/hyperloglog_counter', 'hyperloglog_length'
      LANGUAGE C STRICT IMMUTABLE;
+
+-- number of index bits of the estimator (only reads the counter header)
+CREATE FUNCTION hyperloglog_precision(counter hyperloglog_estimator) RETURNS int
+     AS '$libdir/hyperloglog_counter', 'hyperloglog_precision'
+     LANGUAGE C STRICT IMMUTABLE;
      
 /* functions for set operations */
 CREATE FUNCTION hyperloglog_equal(counter1 hyperloglog_estimator, counter2 hyperloglog_estimator) RETURNS bool
@@ -148,6 +229,18 @@ CREATE FUNCTION hyperloglog_symmetric_diff(counter1 hyperloglog_estimator, count
      AS '$libdir/hyperloglog_counter', 'hyperloglog_symmetric_diff'
      LANGUAGE C IMMUTABLE;
 
+-- similarities from a joint estimate of both counters (one pass over their
+-- registers instead of inclusion-exclusion), the counters need the same
+-- precision
+CREATE FUNCTION hyperloglog_jaccard(counter1 hyperloglog_estimator, counter2 hyperloglog_estimator) RETURNS double precision
+     AS '$libdir/hyperloglog_counter', 'hyperloglog_jaccard'
+     LANGUAGE C STRICT IMMUTABLE;
+
+-- the fraction of the items of counter1 that are in counter2
+CREATE FUNCTION hyperloglog_containment(counter1 hyperloglog_estimator, counter2 hyperloglog_estimator) RETURNS double precision
+     AS '$libdir/hyperloglog_counter', 'hyperloglog_containment'
+     LANGUAGE C STRICT IMMUTABLE;
+
 /* functions for aggregate functions */
 
 CREATE FUNCTION hyperloglog_add_item_agg(counter hyperloglog_estimator, item anyelement, error_rate real, ndistinct double precision) RETURNS hyperloglog_estimator
@@ -163,7 +256,7 @@ CREATE FUNCTION hyperloglog_add_item_agg_default(counter hyperloglog_estimator,
      LANGUAGE C IMMUTABLE;
 
 CREATE FUNCTION hyperloglog_add_item_agg_default(counter hyperloglog_estimator, item anyelement, format text) RETURNS hyperloglog_estimator
-     AS '$libdir/hyperloglog_counter', 'hyperloglog_add_item_agg_default'
+     AS '$libdir/hyperloglog_counter', 'hyperloglog_add_item_agg_default_pack'
      LANGUAGE C IMMUTABLE;
      
 CREATE FUNCTION hyperloglog_get_estimate_bigint(hyperloglog_estimator) RETURNS bigint
@@ -329,3 +422,344 @@ CREATE OPERATOR <= (
     RESTRICT = scalarltsel, JOIN = scalarltjoinsel
 );
 
+
+/* Sliding window counters */
+-- counts the distinct items seen since any time within a window (e.g. the
+-- last 15 minutes) without keeping and merging a counter per minute
+CREATE TYPE hyperloglog_sliding;
+
+CREATE FUNCTION hyperloglog_sliding_in(value cstring) RETURNS hyperloglog_sliding
+     AS '$libdir/hyperloglog_counter', 'hyperloglog_sliding_in'
+     LANGUAGE C STRICT IMMUTABLE;
+
+CREATE FUNCTION hyperloglog_sliding_out(counter hyperloglog_sliding) RETURNS cstring
+     AS '$libdir/hyperloglog_counter', 'hyperloglog_sliding_out'
+     LANGUAGE C STRICT IMMUTABLE;
+
+CREATE FUNCTION hyperloglog_sliding_recv(internal) RETURNS hyperloglog_sliding
+     AS '$libdir/hyperloglog_counter', 'hyperloglog_sliding_recv'
+     LANGUAGE C STRICT IMMUTABLE;
+
+CREATE FUNCTION hyperloglog_sliding_send(hyperloglog_sliding) RETURNS bytea
+     AS '$libdir/hyperloglog_counter', 'hyperloglog_sliding_send'
+     LANGUAGE C STRICT IMMUTABLE;
+
+CREATE TYPE hyperloglog_sliding (
+    INPUT = hyperloglog_sliding_in,
+    OUTPUT = hyperloglog_sliding_out,
+    STORAGE = EXTENDED,
+    ALIGNMENT = double,
+    INTERNALLENGTH = VARIABLE,
+    SEND = hyperloglog_sliding_send,
+    RECEIVE = hyperloglog_sliding_recv
+);
+
+-- empty counter keeping the given window (default 0.8125% error rate)
+CREATE FUNCTION hyperloglog_sliding_init(window_width interval) RETURNS hyperloglog_sliding
+     AS '$libdir/hyperloglog_counter', 'hyperloglog_sliding_init'
+     LANGUAGE C IMMUTABLE STRICT;
+
+CREATE FUNCTION hyperloglog_sliding_init(window_width interval, error_rate real) RETURNS hyperloglog_sliding
+     AS '$libdir/hyperloglog_counter', 'hyperloglog_sliding_init'
+     LANGUAGE C IMMUTABLE STRICT;
+
+-- adds the item seen at the given time
+CREATE FUNCTION hyperloglog_sliding_add(counter hyperloglog_sliding, item anyelement, seen_at timestamptz) RETURNS hyperloglog_sliding
+     AS '$libdir/hyperloglog_counter', 'hyperloglog_sliding_add'
+     LANGUAGE C IMMUTABLE;
+
+CREATE FUNCTION hyperloglog_sliding_add_agg(counter hyperloglog_sliding, item anyelement, seen_at timestamptz, window_width interval) RETURNS hyperloglog_sliding
+     AS '$libdir/hyperloglog_counter', 'hyperloglog_sliding_add_agg'
+     LANGUAGE C IMMUTABLE;
+
+CREATE FUNCTION hyperloglog_sliding_add_agg(counter hyperloglog_sliding, item anyelement, seen_at timestamptz, window_width interval, error_rate real) RETURNS hyperloglog_sliding
+     AS '$libdir/hyperloglog_counter', 'hyperloglog_sliding_add_agg'
+     LANGUAGE C IMMUTABLE;
+
+-- merges two counters (the window of the result is the smaller one)
+CREATE FUNCTION hyperloglog_sliding_merge(counter1 hyperloglog_sliding, counter2 hyperloglog_sliding) RETURNS hyperloglog_sliding
+     AS '$libdir/hyperloglog_counter', 'hyperloglog_sliding_merge'
+     LANGUAGE C IMMUTABLE;
+
+CREATE FUNCTION hyperloglog_sliding_comp(counter hyperloglog_sliding) RETURNS hyperloglog_sliding
+     AS '$libdir/hyperloglog_counter', 'hyperloglog_sliding_comp'
+     LANGUAGE C IMMUTABLE STRICT;
+
+-- estimate of the distinct items seen since the given time
+CREATE FUNCTION hyperloglog_sliding_estimate(counter hyperloglog_sliding, since timestamptz) RETURNS double precision
+     AS '$libdir/hyperloglog_counter', 'hyperloglog_sliding_estimate'
+     LANGUAGE C IMMUTABLE STRICT;
+
+-- the items seen since the given time as a regular counter
+CREATE FUNCTION hyperloglog_sliding_counter(counter hyperloglog_sliding, since timestamptz) RETURNS hyperloglog_estimator
+     AS '$libdir/hyperloglog_counter', 'hyperloglog_sliding_counter'
+     LANGUAGE C IMMUTABLE STRICT;
+
+-- builds a sliding counter from items and the times they were seen
+CREATE AGGREGATE hyperloglog_sliding_accum(anyelement, timestamptz, interval)
+(
+    sfunc = hyperloglog_sliding_add_agg,
+    stype = hyperloglog_sliding,
+    finalfunc = hyperloglog_sliding_comp
+);
+
+CREATE AGGREGATE hyperloglog_sliding_accum(anyelement, timestamptz, interval, real)
+(
+    sfunc = hyperloglog_sliding_add_agg,
+    stype = hyperloglog_sliding,
+    finalfunc = hyperloglog_sliding_comp
+);
+
+-- merges all the sliding counters into a single one
+CREATE AGGREGATE hyperloglog_sliding_merge(hyperloglog_sliding)
+(
+    sfunc = hyperloglog_sliding_merge,
+    stype = hyperloglog_sliding,
+    finalfunc = hyperloglog_sliding_comp
+);
+
+
+/* UltraLogLog counters */
+-- the accuracy of a hyperloglog_estimator in a third less space (one byte
+-- registers, half as many of them)
+CREATE TYPE hyperloglog_ultra;
+
+CREATE FUNCTION hyperloglog_ultra_in(value cstring) RETURNS hyperloglog_ultra
+     AS '$libdir/hyperloglog_counter', 'hyperloglog_ultra_in'
+     LANGUAGE C STRICT IMMUTABLE;
+
+CREATE FUNCTION hyperloglog_ultra_out(counter hyperloglog_ultra) RETURNS cstring
+     AS '$libdir/hyperloglog_counter', 'hyperloglog_ultra_out'
+     LANGUAGE C STRICT IMMUTABLE;
+
+CREATE FUNCTION hyperloglog_ultra_recv(internal) RETURNS hyperloglog_ultra
+     AS '$libdir/hyperloglog_counter', 'hyperloglog_ultra_recv'
+     LANGUAGE C STRICT IMMUTABLE;
+
+CREATE FUNCTION hyperloglog_ultra_send(hyperloglog_ultra) RETURNS bytea
+     AS '$libdir/hyperloglog_counter', 'hyperloglog_ultra_send'
+     LANGUAGE C STRICT IMMUTABLE;
+
+CREATE TYPE hyperloglog_ultra (
+    INPUT = hyperloglog_ultra_in,
+    OUTPUT = hyperloglog_ultra_out,
+    STORAGE = EXTENDED,
+    ALIGNMENT = int4,
+    INTERNALLENGTH = VARIABLE,
+    SEND = hyperloglog_ultra_send,
+    RECEIVE = hyperloglog_ultra_recv
+);
+
+-- empty counter (default 0.862% error rate)
+CREATE FUNCTION hyperloglog_ultra_init() RETURNS hyperloglog_ultra
+     AS '$libdir/hyperloglog_counter', 'hyperloglog_ultra_init'
+     LANGUAGE C IMMUTABLE STRICT;
+
+CREATE FUNCTION hyperloglog_ultra_init(error_rate real) RETURNS hyperloglog_ultra
+     AS '$libdir/hyperloglog_counter', 'hyperloglog_ultra_init'
+     LANGUAGE C IMMUTABLE STRICT;
+
+-- adds the item to a copy of the counter
+CREATE FUNCTION hyperloglog_ultra_add(counter hyperloglog_ultra, item anyelement) RETURNS hyperloglog_ultra
+     AS '$libdir/hyperloglog_counter', 'hyperloglog_ultra_add'
+     LANGUAGE C IMMUTABLE;
+
+CREATE FUNCTION hyperloglog_ultra_add_agg(counter hyperloglog_ultra, item anyelement) RETURNS hyperloglog_ultra
+     AS '$libdir/hyperloglog_counter', 'hyperloglog_ultra_add_agg'
+     LANGUAGE C IMMUTABLE;
+
+CREATE FUNCTION hyperloglog_ultra_add_agg(counter hyperloglog_ultra, item anyelement, error_rate real) RETURNS hyperloglog_ultra
+     AS '$libdir/hyperloglog_counter', 'hyperloglog_ultra_add_agg'
+     LANGUAGE C IMMUTABLE;
+
+-- merges the second counter into a copy of the first one
+CREATE FUNCTION hyperloglog_ultra_merge(counter1 hyperloglog_ultra, counter2 hyperloglog_ultra) RETURNS hyperloglog_ultra
+     AS '$libdir/hyperloglog_counter', 'hyperloglog_ultra_merge'
+     LANGUAGE C IMMUTABLE;
+
+CREATE FUNCTION hyperloglog_ultra_comp(counter hyperloglog_ultra) RETURNS hyperloglog_ultra
+     AS '$libdir/hyperloglog_counter', 'hyperloglog_ultra_comp'
+     LANGUAGE C IMMUTABLE STRICT;
+
+-- evaluates the estimate of the counter
+CREATE FUNCTION hyperloglog_ultra_get_estimate(counter hyperloglog_ultra) RETURNS double precision
+     AS '$libdir/hyperloglog_counter', 'hyperloglog_ultra_get_estimate'
+     LANGUAGE C IMMUTABLE STRICT;
+
+-- the registers as a hyperloglog_estimator of the same precision (with its
+-- accuracy, the register bits of the smaller values are dropped)
+CREATE FUNCTION hyperloglog_ultra_counter(counter hyperloglog_ultra) RETURNS hyperloglog_estimator
+     AS '$libdir/hyperloglog_counter', 'hyperloglog_ultra_counter'
+     LANGUAGE C IMMUTABLE STRICT;
+
+-- a counter with the registers of a hyperloglog_estimator (the bits of the
+-- smaller values are filled in from its estimate)
+CREATE FUNCTION hyperloglog_ultra_from_counter(counter hyperloglog_estimator) RETURNS hyperloglog_ultra
+     AS '$libdir/hyperloglog_counter', 'hyperloglog_ultra_from_counter'
+     LANGUAGE C IMMUTABLE STRICT;
+
+CREATE CAST (hyperloglog_ultra AS hyperloglog_estimator) WITH FUNCTION hyperloglog_ultra_counter(hyperloglog_ultra);
+
+CREATE CAST (hyperloglog_estimator AS hyperloglog_ultra) WITH FUNCTION hyperloglog_ultra_from_counter(hyperloglog_estimator);
+
+-- estimates the distinct count of the column
+CREATE AGGREGATE hyperloglog_ultra_distinct(anyelement)
+(
+    sfunc = hyperloglog_ultra_add_agg,
+    stype = hyperloglog_ultra,
+    finalfunc = hyperloglog_ultra_get_estimate
+);
+
+CREATE AGGREGATE hyperloglog_ultra_distinct(anyelement, real)
+(
+    sfunc = hyperloglog_ultra_add_agg,
+    stype = hyperloglog_ultra,
+    finalfunc = hyperloglog_ultra_get_estimate
+);
+
+-- builds a counter from the items
+CREATE AGGREGATE hyperloglog_ultra_accum(anyelement)
+(
+    sfunc = hyperloglog_ultra_add_agg,
+    stype = hyperloglog_ultra,
+    finalfunc = hyperloglog_ultra_comp
+);
+
+CREATE AGGREGATE hyperloglog_ultra_accum(anyelement, real)
+(
+    sfunc = hyperloglog_ultra_add_agg,
+    stype = hyperloglog_ultra,
+    finalfunc = hyperloglog_ultra_comp
+);
+
+-- merges all the counters into a single one
+CREATE AGGREGATE hyperloglog_ultra_merge(hyperloglog_ultra)
+(
+    sfunc = hyperloglog_ultra_merge,
+    stype = hyperloglog_ultra,
+    finalfunc = hyperloglog_ultra_comp
+);
+
+/* Theta sketches */
+-- samples of the item hashes (k minimum values), larger than the counters
+-- but with exact set operations (intersections, differences) on them
+CREATE TYPE hyperloglog_theta;
+
+CREATE FUNCTION hyperloglog_theta_in(value cstring) RETURNS hyperloglog_theta
+     AS '$libdir/hyperloglog_counter', 'hyperloglog_theta_in'
+     LANGUAGE C STRICT IMMUTABLE;
+
+CREATE FUNCTION hyperloglog_theta_out(sketch hyperloglog_theta) RETURNS cstring
+     AS '$libdir/hyperloglog_counter', 'hyperloglog_theta_out'
+     LANGUAGE C STRICT IMMUTABLE;
+
+CREATE FUNCTION hyperloglog_theta_recv(internal) RETURNS hyperloglog_theta
+     AS '$libdir/hyperloglog_counter', 'hyperloglog_theta_recv'
+     LANGUAGE C STRICT IMMUTABLE;
+
+CREATE FUNCTION hyperloglog_theta_send(hyperloglog_theta) RETURNS bytea
+     AS '$libdir/hyperloglog_counter', 'hyperloglog_theta_send'
+     LANGUAGE C STRICT IMMUTABLE;
+
+CREATE TYPE hyperloglog_theta (
+    INPUT = hyperloglog_theta_in,
+    OUTPUT = hyperloglog_theta_out,
+    STORAGE = EXTENDED,
+    ALIGNMENT = double,
+    INTERNALLENGTH = VARIABLE,
+    SEND = hyperloglog_theta_send,
+    RECEIVE = hyperloglog_theta_recv
+);
+
+-- empty sketch (default 1.5625% error rate, 4096 hashes)
+CREATE FUNCTION hyperloglog_theta_init() RETURNS hyperloglog_theta
+     AS '$libdir/hyperloglog_counter', 'hyperloglog_theta_init'
+     LANGUAGE C IMMUTABLE STRICT;
+
+CREATE FUNCTION hyperloglog_theta_init(error_rate real) RETURNS hyperloglog_theta
+     AS '$libdir/hyperloglog_counter', 'hyperloglog_theta_init'
+     LANGUAGE C IMMUTABLE STRICT;
+
+-- adds the item to a copy of the sketch
+CREATE FUNCTION hyperloglog_theta_add(sketch hyperloglog_theta, item anyelement) RETURNS hyperloglog_theta
+     AS '$libdir/hyperloglog_counter', 'hyperloglog_theta_add'
+     LANGUAGE C IMMUTABLE;
+
+CREATE FUNCTION hyperloglog_theta_add_agg(sketch hyperloglog_theta, item anyelement) RETURNS hyperloglog_theta
+     AS '$libdir/hyperloglog_counter', 'hyperloglog_theta_add_agg'
+     LANGUAGE C IMMUTABLE;
+
+CREATE FUNCTION hyperloglog_theta_add_agg(sketch hyperloglog_theta, item anyelement, error_rate real) RETURNS hyperloglog_theta
+     AS '$libdir/hyperloglog_counter', 'hyperloglog_theta_add_agg'
+     LANGUAGE C IMMUTABLE;
+
+-- the union of the two sketches
+CREATE FUNCTION hyperloglog_theta_merge(sketch1 hyperloglog_theta, sketch2 hyperloglog_theta) RETURNS hyperloglog_theta
+     AS '$libdir/hyperloglog_counter', 'hyperloglog_theta_merge'
+     LANGUAGE C IMMUTABLE;
+
+-- the intersection of the two sketches
+CREATE FUNCTION hyperloglog_theta_intersect(sketch1 hyperloglog_theta, sketch2 hyperloglog_theta) RETURNS hyperloglog_theta
+     AS '$libdir/hyperloglog_counter', 'hyperloglog_theta_intersect'
+     LANGUAGE C IMMUTABLE;
+
+-- the items of the first sketch that aren't in the second one
+CREATE FUNCTION hyperloglog_theta_a_not_b(sketch1 hyperloglog_theta, sketch2 hyperloglog_theta) RETURNS hyperloglog_theta
+     AS '$libdir/hyperloglog_counter', 'hyperloglog_theta_a_not_b'
+     LANGUAGE C IMMUTABLE;
+
+CREATE FUNCTION hyperloglog_theta_comp(sketch hyperloglog_theta) RETURNS hyperloglog_theta
+     AS '$libdir/hyperloglog_counter', 'hyperloglog_theta_comp'
+     LANGUAGE C IMMUTABLE STRICT;
+
+-- evaluates the estimate of the sketch (only reads the header of stored
+-- sketches)
+CREATE FUNCTION hyperloglog_theta_estimate(sketch hyperloglog_theta) RETURNS double precision
+     AS '$libdir/hyperloglog_counter', 'hyperloglog_theta_estimate'
+     LANGUAGE C IMMUTABLE STRICT;
+
+-- estimates the distinct count of the column
+CREATE AGGREGATE hyperloglog_theta_distinct(anyelement)
+(
+    sfunc = hyperloglog_theta_add_agg,
+    stype = hyperloglog_theta,
+    finalfunc = hyperloglog_theta_estimate
+);
+
+CREATE AGGREGATE hyperloglog_theta_distinct(anyelement, real)
+(
+    sfunc = hyperloglog_theta_add_agg,
+    stype = hyperloglog_theta,
+    finalfunc = hyperloglog_theta_estimate
+);
+
+-- builds a sketch from the items
+CREATE AGGREGATE hyperloglog_theta_accum(anyelement)
+(
+    sfunc = hyperloglog_theta_add_agg,
+    stype = hyperloglog_theta,
+    finalfunc = hyperloglog_theta_comp
+);
+
+CREATE AGGREGATE hyperloglog_theta_accum(anyelement, real)
+(
+    sfunc = hyperloglog_theta_add_agg,
+    stype = hyperloglog_theta,
+    finalfunc = hyperloglog_theta_comp
+);
+
+-- the union of all the sketches
+CREATE AGGREGATE hyperloglog_theta_merge(hyperloglog_theta)
+(
+    sfunc = hyperloglog_theta_merge,
+    stype = hyperloglog_theta,
+    finalfunc = hyperloglog_theta_comp
+);
+
+-- the intersection of all the sketches
+CREATE AGGREGATE hyperloglog_theta_intersect(hyperloglog_theta)
+(
+    sfunc = hyperloglog_theta_intersect,
+    stype = hyperloglog_theta,
+    finalfunc = hyperloglog_theta_comp
+);
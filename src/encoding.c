@@ -1,6 +1,26 @@
 #include "postgres.h"
 #include "encoding.h"
 
+#if !defined(HLL_NO_SIMD) && defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define B64_SIMD 1
+#include <immintrin.h>
+#endif
+
+/* length of the lines of the wrapped output */
+#define B64_LINE_LENGTH 76
+
+/* ------------- function declarations for local functions --------------- */
+static inline char * b64_encode_group(const unsigned char *s, char *p);
+
+#ifdef B64_SIMD
+static int b64_have_ssse3(void);
+static int b64_have_avx2(void);
+static inline void b64_encode_ssse3(const char *src, char *dst);
+static inline void b64_encode_avx2(const char *src, char *dst);
+static inline int b64_decode_ssse3(const char *src, char *dst);
+static inline int b64_decode_avx2(const char *src, char *dst);
+#endif
+
 static const char _base64[] =
 "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
 
@@ -16,54 +36,74 @@ static const int8 b64lookup[128] = {
 };
 
 
+/* Encodes 'len' bytes, with a line break after every 76 characters if 'wrap'
+ * is set. Whole blocks of input (24 bytes with AVX2, 12 bytes with SSSE3) are
+ * encoded with the vector versions whenever the CPU supports them and the
+ * block doesn't cross a line break, the rest 3 bytes at a time. The output is
+ * the same either way. */
 int
-hll_b64_encode(const char *src, unsigned len, char *dst)
+hll_b64_encode(const char *src, unsigned len, char *dst, bool wrap)
 {
-	char	   *p,
-		*lend = dst + 76;
-	const char *s,
+	char	   *p = dst,
+		*lend = dst + B64_LINE_LENGTH;
+	const char *s = src,
 		*end = src + len;
-	int			pos = 2;
-	uint32		buf = 0;
-
-	s = src;
-	p = dst;
+	uint32		buf;
+#ifdef B64_SIMD
+	int			avx2 = b64_have_avx2(),
+				ssse3 = b64_have_ssse3();
+#endif
 
-
-	while (s < end)
+	while (end - s >= 3)
 	{
-		buf |= (unsigned char)*s << (pos << 3);
-		pos--;
-		s++;
-
-		/* write it out */
-		if (pos < 0)
+#ifdef B64_SIMD
+		/* the vector versions load 16 bytes per 12 bytes of input */
+		if (avx2 && end - s >= 28 && (!wrap || lend - p >= 32))
 		{
-			*p++ = _base64[(buf >> 18) & 0x3f];
-			*p++ = _base64[(buf >> 12) & 0x3f];
-			*p++ = _base64[(buf >> 6) & 0x3f];
-			*p++ = _base64[buf & 0x3f];
-
-			pos = 2;
-			buf = 0;
+			b64_encode_avx2(s, p);
+			s += 24;
+			p += 32;
 		}
-		if (p >= lend)
+		else if (ssse3 && end - s >= 16 && (!wrap || lend - p >= 16))
+		{
+			b64_encode_ssse3(s, p);
+			s += 12;
+			p += 16;
+		}
+		else
+#endif
+		{
+			p = b64_encode_group((const unsigned char *) s, p);
+			s += 3;
+		}
+
+		if (wrap && p >= lend)
 		{
 			*p++ = '\n';
-			lend = p + 76;
+			lend = p + B64_LINE_LENGTH;
 		}
 	}
-	if (pos != 2)
+
+	if (s < end)
 	{
+		buf = (unsigned char) s[0] << 16;
+		if (end - s == 2)
+			buf |= (unsigned char) s[1] << 8;
+
 		*p++ = _base64[(buf >> 18) & 0x3f];
 		*p++ = _base64[(buf >> 12) & 0x3f];
-		*p++ = (pos == 0) ? _base64[(buf >> 6) & 0x3f] : '=';
+		*p++ = (end - s == 2) ? _base64[(buf >> 6) & 0x3f] : '=';
 		*p++ = '=';
 	}
 
 	return p - dst;
 }
 
+/* Decodes the base64 text, whitespace is skipped. Whenever a whole block of
+ * input (32 characters with AVX2, 16 with SSSE3) starts at a group boundary
+ * and consists only of base64 characters it's decoded by the vector versions,
+ * everything else (line breaks, padding, invalid characters) goes through the
+ * scalar code below which also reports the errors. */
 int
 hll_b64_decode(const char *src, unsigned len, char *dst)
 {
@@ -75,10 +115,31 @@ hll_b64_decode(const char *src, unsigned len, char *dst)
 	uint32		buf = 0;
 	int			pos = 0,
 		end = 0;
-
+#ifdef B64_SIMD
+	int			avx2 = b64_have_avx2(),
+				ssse3 = b64_have_ssse3();
+#endif
 
 	while (s < srcend)
 	{
+#ifdef B64_SIMD
+		if (pos == 0 && end == 0)
+		{
+			if (avx2 && srcend - s >= 32 && b64_decode_avx2(s, p))
+			{
+				s += 32;
+				p += 24;
+				continue;
+			}
+			if (ssse3 && srcend - s >= 16 && b64_decode_ssse3(s, p))
+			{
+				s += 16;
+				p += 12;
+				continue;
+			}
+		}
+#endif
+
 		c = *s++;
 
 		if (c == ' ' || c == '\t' || c == '\n' || c == '\r')
@@ -133,7 +194,6 @@ hll_b64_decode(const char *src, unsigned len, char *dst)
 	return p - dst;
 }
 
-
 int
 b64_enc_len(const char *src, unsigned srclen)
 {
@@ -146,3 +206,213 @@ b64_dec_len(const char *src, unsigned srclen)
 {
 	return (srclen * 3) >> 2;
 }
+
+/* Encodes 3 bytes into 4 characters */
+static inline char *
+b64_encode_group(const unsigned char *s, char *p)
+{
+	uint32		buf = (s[0] << 16) | (s[1] << 8) | s[2];
+
+	*p++ = _base64[(buf >> 18) & 0x3f];
+	*p++ = _base64[(buf >> 12) & 0x3f];
+	*p++ = _base64[(buf >> 6) & 0x3f];
+	*p++ = _base64[buf & 0x3f];
+
+	return p;
+}
+
+#ifdef B64_SIMD
+/* Checks (once) whether the CPU supports SSSE3 */
+static int
+b64_have_ssse3(void)
+{
+	static int	supported = -1;
+
+	if (supported < 0)
+	{
+		__builtin_cpu_init();
+		supported = __builtin_cpu_supports("ssse3") ? 1 : 0;
+	}
+
+	return supported;
+}
+
+/* Checks (once) whether the CPU supports AVX2 */
+static int
+b64_have_avx2(void)
+{
+	static int	supported = -1;
+
+	if (supported < 0)
+	{
+		__builtin_cpu_init();
+		supported = __builtin_cpu_supports("avx2") ? 1 : 0;
+	}
+
+	return supported;
+}
+
+/*
+ * The vector versions follow "Faster Base64 Encoding and Decoding Using AVX2
+ * Instructions" by Wojciech Mula and Daniel Lemire. The encoder spreads each
+ * 3 bytes over the 4 bytes of a 32-bit lane, moves the 6-bit fields into
+ * place with two multiplications and maps the values 0-63 to the alphabet
+ * with a single shuffle of offsets. The decoder classifies the characters by
+ * their high and low nibbles (a character is valid if the bits looked up for
+ * both nibbles don't overlap), maps them back to 0-63 the same way and packs
+ * the 6-bit fields with two multiply-adds. The AVX2 versions do the same
+ * within each 128-bit lane.
+ */
+
+/* Encodes 12 bytes into 16 characters, reads 16 bytes */
+__attribute__((target("ssse3")))
+static inline void
+b64_encode_ssse3(const char *src, char *dst)
+{
+	__m128i		in, t0, t1, t2, t3, indices, result, less;
+
+	in = _mm_loadu_si128((const __m128i *) src);
+	in = _mm_shuffle_epi8(in, _mm_set_epi8(10, 11, 9, 10, 7, 8, 6, 7,
+										   4, 5, 3, 4, 1, 2, 0, 1));
+
+	t0 = _mm_and_si128(in, _mm_set1_epi32(0x0fc0fc00));
+	t1 = _mm_mulhi_epu16(t0, _mm_set1_epi32(0x04000040));
+	t2 = _mm_and_si128(in, _mm_set1_epi32(0x003f03f0));
+	t3 = _mm_mullo_epi16(t2, _mm_set1_epi32(0x01000010));
+	indices = _mm_or_si128(t1, t3);
+
+	/* 0-25 map to offset 13 ('A'), 26-51 to 0 ('a' - 26), 52-61 to 1-10
+	 * ('0' - 52), 62 and 63 to 11 and 12 */
+	result = _mm_subs_epu8(indices, _mm_set1_epi8(51));
+	less = _mm_cmpgt_epi8(_mm_set1_epi8(26), indices);
+	result = _mm_or_si128(result, _mm_and_si128(less, _mm_set1_epi8(13)));
+	result = _mm_shuffle_epi8(_mm_setr_epi8('a' - 26, '0' - 52, '0' - 52, '0' - 52,
+											'0' - 52, '0' - 52, '0' - 52, '0' - 52,
+											'0' - 52, '0' - 52, '0' - 52, '+' - 62,
+											'/' - 63, 'A', 0, 0), result);
+
+	_mm_storeu_si128((__m128i *) dst, _mm_add_epi8(result, indices));
+}
+
+/* Encodes 24 bytes into 32 characters, reads 28 bytes */
+__attribute__((target("avx2")))
+static inline void
+b64_encode_avx2(const char *src, char *dst)
+{
+	__m256i		in, t0, t1, t2, t3, indices, result, less;
+
+	in = _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_loadu_si128((const __m128i *) src)),
+								 _mm_loadu_si128((const __m128i *) (src + 12)), 1);
+	in = _mm256_shuffle_epi8(in, _mm256_set_epi8(10, 11, 9, 10, 7, 8, 6, 7,
+												 4, 5, 3, 4, 1, 2, 0, 1,
+												 10, 11, 9, 10, 7, 8, 6, 7,
+												 4, 5, 3, 4, 1, 2, 0, 1));
+
+	t0 = _mm256_and_si256(in, _mm256_set1_epi32(0x0fc0fc00));
+	t1 = _mm256_mulhi_epu16(t0, _mm256_set1_epi32(0x04000040));
+	t2 = _mm256_and_si256(in, _mm256_set1_epi32(0x003f03f0));
+	t3 = _mm256_mullo_epi16(t2, _mm256_set1_epi32(0x01000010));
+	indices = _mm256_or_si256(t1, t3);
+
+	result = _mm256_subs_epu8(indices, _mm256_set1_epi8(51));
+	less = _mm256_cmpgt_epi8(_mm256_set1_epi8(26), indices);
+	result = _mm256_or_si256(result, _mm256_and_si256(less, _mm256_set1_epi8(13)));
+	result = _mm256_shuffle_epi8(_mm256_setr_epi8('a' - 26, '0' - 52, '0' - 52, '0' - 52,
+												  '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+												  '0' - 52, '0' - 52, '0' - 52, '+' - 62,
+												  '/' - 63, 'A', 0, 0,
+												  'a' - 26, '0' - 52, '0' - 52, '0' - 52,
+												  '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+												  '0' - 52, '0' - 52, '0' - 52, '+' - 62,
+												  '/' - 63, 'A', 0, 0), result);
+
+	_mm256_storeu_si256((__m256i *) dst, _mm256_add_epi8(result, indices));
+}
+
+/* Decodes 16 characters into 12 bytes, returns 0 (writing nothing) if any of
+ * them isn't a base64 character */
+__attribute__((target("ssse3")))
+static inline int
+b64_decode_ssse3(const char *src, char *dst)
+{
+	__m128i		in, hi_nibbles, lo_nibbles, lo, hi, eq_2f, roll, merged;
+	const __m128i mask_2f = _mm_set1_epi8(0x2f);
+	char		out[16];
+
+	in = _mm_loadu_si128((const __m128i *) src);
+
+	hi_nibbles = _mm_and_si128(_mm_srli_epi32(in, 4), mask_2f);
+	lo_nibbles = _mm_and_si128(in, mask_2f);
+	lo = _mm_shuffle_epi8(_mm_setr_epi8(0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+										0x11, 0x11, 0x13, 0x1a, 0x1b, 0x1b, 0x1b, 0x1a), lo_nibbles);
+	hi = _mm_shuffle_epi8(_mm_setr_epi8(0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08,
+										0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10), hi_nibbles);
+
+	if (_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_and_si128(lo, hi), _mm_setzero_si128())) != 0xffff)
+		return 0;
+
+	eq_2f = _mm_cmpeq_epi8(in, mask_2f);
+	roll = _mm_shuffle_epi8(_mm_setr_epi8(0, 16, 19, 4, -65, -65, -71, -71,
+										  0, 0, 0, 0, 0, 0, 0, 0), _mm_add_epi8(eq_2f, hi_nibbles));
+	in = _mm_add_epi8(in, roll);
+
+	merged = _mm_maddubs_epi16(in, _mm_set1_epi32(0x01400140));
+	merged = _mm_madd_epi16(merged, _mm_set1_epi32(0x00011000));
+	merged = _mm_shuffle_epi8(merged, _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9,
+													8, 14, 13, 12, -1, -1, -1, -1));
+
+	/* only 12 of the 16 bytes are output */
+	_mm_storeu_si128((__m128i *) out, merged);
+	memcpy(dst, out, 12);
+
+	return 1;
+}
+
+/* Decodes 32 characters into 24 bytes, returns 0 (writing nothing) if any of
+ * them isn't a base64 character */
+__attribute__((target("avx2")))
+static inline int
+b64_decode_avx2(const char *src, char *dst)
+{
+	__m256i		in, hi_nibbles, lo_nibbles, lo, hi, eq_2f, roll, merged;
+	const __m256i mask_2f = _mm256_set1_epi8(0x2f);
+	char		out[32];
+
+	in = _mm256_loadu_si256((const __m256i *) src);
+
+	hi_nibbles = _mm256_and_si256(_mm256_srli_epi32(in, 4), mask_2f);
+	lo_nibbles = _mm256_and_si256(in, mask_2f);
+	lo = _mm256_shuffle_epi8(_mm256_setr_epi8(0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+											  0x11, 0x11, 0x13, 0x1a, 0x1b, 0x1b, 0x1b, 0x1a,
+											  0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+											  0x11, 0x11, 0x13, 0x1a, 0x1b, 0x1b, 0x1b, 0x1a), lo_nibbles);
+	hi = _mm256_shuffle_epi8(_mm256_setr_epi8(0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08,
+											  0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10,
+											  0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08,
+											  0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10), hi_nibbles);
+
+	if (!_mm256_testz_si256(lo, hi))
+		return 0;
+
+	eq_2f = _mm256_cmpeq_epi8(in, mask_2f);
+	roll = _mm256_shuffle_epi8(_mm256_setr_epi8(0, 16, 19, 4, -65, -65, -71, -71,
+												0, 0, 0, 0, 0, 0, 0, 0,
+												0, 16, 19, 4, -65, -65, -71, -71,
+												0, 0, 0, 0, 0, 0, 0, 0), _mm256_add_epi8(eq_2f, hi_nibbles));
+	in = _mm256_add_epi8(in, roll);
+
+	merged = _mm256_maddubs_epi16(in, _mm256_set1_epi32(0x01400140));
+	merged = _mm256_madd_epi16(merged, _mm256_set1_epi32(0x00011000));
+	merged = _mm256_shuffle_epi8(merged, _mm256_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9,
+														  8, 14, 13, 12, -1, -1, -1, -1,
+														  2, 1, 0, 6, 5, 4, 10, 9,
+														  8, 14, 13, 12, -1, -1, -1, -1));
+
+	/* 12 bytes out of each lane */
+	_mm256_storeu_si256((__m256i *) out, merged);
+	memcpy(dst, out, 12);
+	memcpy(dst + 12, out + 16, 12);
+
+	return 1;
+}
+#endif
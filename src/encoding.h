@@ -1,9 +1,13 @@
 #ifndef _ENCODING_H_
 #define _ENCODING_H_
 /* Provides encoding and decoding to convert the estimator bytes into a human
- * readable form. Currently only base 64 encoding is provided. */
+ * readable form. Currently only base 64 encoding is provided, using SSSE3 or
+ * AVX2 when the CPU supports them (detected at runtime). Compiling with
+ * -DHLL_NO_SIMD disables them altogether. */
 
-int hll_b64_encode(const char *src, unsigned len, char *dst);
+/* 'wrap' breaks the output into lines of 76 characters, the decoder skips
+ * any whitespace so it reads both */
+int hll_b64_encode(const char *src, unsigned len, char *dst, bool wrap);
 int hll_b64_decode(const char *src, unsigned len, char *dst);
 int b64_enc_len(const char *src, unsigned srclen);
 int b64_dec_len(const char *src, unsigned srclen);
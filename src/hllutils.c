@@ -4,8 +4,14 @@
 #include <math.h>
 
 #include "postgres.h"
+#include "utils/memutils.h"
 #include "hyperloglog.h"
 #include "hllutils.h"
+#include "probes.h"
+
+/* scratch arena shared by the compression and promotion code, see
+ * hll_scratch() */
+static char * scratch_arena = NULL;
 
 /* ---------------------- function definitions --------------------------- */
 
@@ -85,8 +91,12 @@ dedupe(uint32_t * sparse_data, int idx)
 {
     int i,j;
 
+    HLL_STAT_INC(HLL_STAT_DEDUPE_CALLS);
+
     for ( i=0; i < idx - 1; i++){
         if (sparse_data[i] > sparse_data[i+1]){
+            HLL_STAT_INC(HLL_STAT_DEDUPE_SORTS);
+            TRACE_HYPERLOGLOG_DEDUPE_SORT(idx);
             insertion_sort(sparse_data,idx);
             break;
         }
@@ -115,6 +125,23 @@ size_sparse_array(int8_t b)
     return  POW2(b-4) - ceil(sizeof(HLLData)/4.0);
 }
 
+/* Returns the per backend scratch arena (HLL_SCRATCH_SIZE bytes) used for
+ * the temporary buffers of the compression, decompression and promotion
+ * functions. It's allocated on first use in TopMemoryContext and kept for the
+ * lifetime of the backend, so those hot paths don't allocate (or free) any
+ * memory of their own and running out of memory is reported like any other
+ * palloc failure. The contents are only valid until the next call of one of
+ * those functions, none of them call each other while using it. */
+char *
+hll_scratch(void)
+{
+    if (scratch_arena == NULL){
+        scratch_arena = MemoryContextAlloc(TopMemoryContext, HLL_SCRATCH_SIZE);
+    }
+
+    return scratch_arena;
+}
+
 /* PGLZ Decompress wrapper for verison compatability */
 void pg_decompress(const PGLZ_Header *source, char *dest)
 {
@@ -1,4 +1,5 @@
 #include "hyperloglog.h"
+#include "rans.h"
 #if PG_VERSION_NUM >= 90500
 #include "common/pg_lzcompress.h"
 #else
@@ -9,6 +10,11 @@
 #define HLLUTILS_H
 #define POW2(a) (1 << (a))
 
+/* Size of the per backend scratch arena. It has to fit the unpacked registers
+ * plus their rANS encoding for the largest precision, which also covers the
+ * Stream VByte encoding of the largest sparse counter. */
+#define HLL_SCRATCH_SIZE (POW2(MAX_INDEX_BITS) + RANS_MAX_ENCODED_SIZE(POW2(MAX_INDEX_BITS)))
+
 #if PG_VERSION_NUM >= 90500
 typedef struct {
     int32 vl_len_;
@@ -20,6 +26,7 @@ typedef struct {
 void insertion_sort(uint32_t* a, int n);
 int dedupe(uint32_t* sparse_data, int idx);
 int size_sparse_array(int8_t b);
+char * hll_scratch(void);
 uint64_t MurmurHash64A (const void * key, int len, unsigned int seed);
 void pg_decompress(const PGLZ_Header *source, char *dest);
 bool pg_compress(const char *source, int32 slen, PGLZ_Header *dest, const PGLZ_Strategy *strategy);
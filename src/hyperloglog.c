@@ -10,51 +10,136 @@
 
 #include "postgres.h"
 
-#include "varint.h"
+#include "streamvbyte.h"
+#include "rans.h"
 #include "hyperloglog.h"
 #include "constants.h"
 #include "hllutils.h"
-
-/* Externed Constants
- * Alpha * m * m constants, for various numbers of 'b'. See constants.h for
- * more information. */
-extern const float alpham[ALPHAM_BOUND];
-
-/* linear counting thresholds */
-extern const int threshold[THRESHOLD_BOUND];
-
-/* bit masks used in encode_hash */
-extern const uint32_t MASK[NUM_OF_PRECISIONS][NUM_OF_BINWIDTHS];
-
-/* error correction data (x-values) */
-extern const double rawEstimateData[NUM_OF_PRECISIONS][MAX_NUM_OF_INTERPOLATION_POINTS];
-
-/* error correction data (y-values) */
-extern const double biasData[NUM_OF_PRECISIONS][MAX_NUM_OF_INTERPOLATION_POINTS];
-
-/* precomputed inverse powers of 2 */
-extern const double PE[NUM_OF_PRECOMPUTED_EXPONENTS];
+#include "probes.h"
+
+/* Sparse counters start with an allocation of this many bytes (28 entries),
+ * the allocation is doubled whenever the array fills up (see sparse_full).
+ * Like the POW2(b-2) bytes the array ends at for the fixed policy these are
+ * powers of two so they fill the palloc chunks completely. */
+#define SPARSE_MIN_LENGTH 128
+
+/* New counters start as small sets with an allocation of this many bytes (2
+ * hashes) that is doubled as they fill up. Once a small set would need more
+ * than SMALL_SET_MAX_LENGTH bytes (30 hashes) it's upgraded to sparse
+ * encoding, which takes about 4 bytes per hash once compressed instead of
+ * 8. */
+#define SMALL_SET_MIN_LENGTH 32
+#define SMALL_SET_MAX_LENGTH 256
+#define SMALL_SET_MAX_ENTRIES ((SMALL_SET_MAX_LENGTH - sizeof(HLLData)) / sizeof(uint64_t))
+
+/* Compressed dense registers are decoded this many at a time (into the
+ * scratch arena), so decompressing doesn't need a buffer for all the
+ * registers of a high precision counter */
+#define DENSE_DECODE_BLOCK POW2(MAX_INDEX_BITS)
+
+/* Ertl's alpha for m -> infinity, 1/(2 ln 2) */
+#define ERTL_ALPHA_INF 0.721347520444481703680
+
+int hll_promotion_policy = HLL_PROMOTION_FIXED;
+
+uint64_t hll_stats[HLL_NUM_STATS];
+
+const char * const hll_stat_names[HLL_NUM_STATS] = {
+    "adds_small",
+    "adds_sparse",
+    "adds_dense",
+    "merges_small_small",
+    "merges_small_sparse",
+    "merges_small_dense",
+    "merges_sparse_small",
+    "merges_sparse_sparse",
+    "merges_sparse_dense",
+    "merges_dense_small",
+    "merges_dense_sparse",
+    "merges_dense_dense",
+    "merges_compressed",
+    "promotions_sparse",
+    "promotions_dense",
+    "compress_calls",
+    "compress_bytes_in",
+    "compress_bytes_out",
+    "decompress_calls",
+    "decompress_bytes_in",
+    "decompress_bytes_out",
+    "dedupe_calls",
+    "dedupe_sorts",
+    "upgrades"
+};
 
 /* ------------- function declarations for local functions --------------- */
 static double hll_estimate_dense(HLLCounter hloglog);
 static double hll_estimate_sparse(HLLCounter hloglog);
+static double hll_estimate_histogram(HLLCounter hloglog);
+static double ertl_sigma(double x);
+static double ertl_tau(double x);
+static double ertl_estimate(const int * counts, int m, int q);
+static inline uint8_t joint_register(HLLCounter hloglog, uint32_t idx, int q);
+static uint32_t * joint_entries(HLLCounter hloglog, int q, int * n);
+static inline void joint_count(int counts[3][2][HASH_LENGTH + 2], int r1, int r2, int n);
+static int uint32_cmp(const void * a, const void * b);
+static double joint_likelihood(int counts[3][2][HASH_LENGTH + 2], int m, int q, const double n[3], double g[3], double H[3][3]);
+static double joint_term(int count, int k, int m, int q, double s, int mask, double g[3], double H[3][3]);
+static double joint_equal_term(int count, int k, int m, int q, const double n[3], double g[3], double H[3][3]);
+static bool joint_solve(double H[3][3], const double g[3], double d[3]);
 static double error_estimate(double E,int b);
 
+static HLLCounter hll_add_hash(HLLCounter hloglog, uint64_t hash);
 static HLLCounter hll_add_hash_dense(HLLCounter hloglog, uint64_t hash);
 static HLLCounter hll_add_hash_sparse(HLLCounter hloglog, uint64_t hash);
+static HLLCounter hll_add_hash_small(HLLCounter hloglog, uint64_t hash);
+static inline void hash_to_register(uint64_t hash, int8_t b, uint8_t binbits, uint32_t * idx, uint8_t * rho);
 static uint32_t encode_hash(uint64_t hash, HLLCounter hloglog);
 static HLLCounter sparse_to_dense(HLLCounter hloglog);
 static HLLCounter sparse_to_dense_unpacked(HLLCounter hloglog);
+static inline void decode_sparse_entry(uint32_t entry, int8_t b, uint8_t binbits, uint32_t * idx, uint8_t * rho);
+static inline HLLCounter set_register_max(HLLCounter hloglog, uint32_t idx, uint8_t rho);
+static inline uint8_t get_register(HLLCounter hloglog, uint32_t idx);
+static inline bool is_unpacked(HLLCounter hloglog);
+static HLLCounter merge_dense(HLLCounter result, HLLCounter counter2);
+static HLLCounter nibble_create(HLLCounter header, const uint8_t * registers);
+static void nibble_decode(HLLCounter hloglog, uint8_t * registers);
+static inline uint8_t nibble_get(HLLCounter hloglog, uint32_t idx);
+static HLLCounter nibble_set_max(HLLCounter hloglog, uint32_t idx, uint8_t rho);
+static HLLCounter nibble_merge(HLLCounter result, HLLCounter counter2);
+static HLLCounter nibble_reserve(HLLCounter hloglog, int exceptions);
+static void nibble_rebase(HLLCounter hloglog);
+static double nibble_harmonic_sum(HLLCounter hloglog);
+static bool nibble_check(HLLCounter hloglog);
+static HLLCounter sparse_to_dense_nibble(HLLCounter hloglog);
+static int sparse_capacity(HLLCounter hloglog);
+static size_t sparse_length(HLLCounter hloglog);
+static HLLCounter sparse_full(HLLCounter hloglog, bool * promote);
+static HLLCounter sparse_grow(HLLCounter hloglog, size_t length);
+static uint32_t sparse_compressed_size(HLLCounter hloglog);
+static uint32_t dense_compressed_size(HLLCounter hloglog);
+static inline uint64_t small_set_get(HLLCounter hloglog, int i);
+static int small_set_capacity(HLLCounter hloglog);
+static int small_set_max_entries(HLLCounter hloglog);
+static size_t small_set_length(int entries);
+static void small_set_sort(HLLCounter hloglog);
+static int hash_cmp(const void * a, const void * b);
+static HLLCounter small_set_to_sparse(HLLCounter hloglog);
+static HLLCounter small_set_merge(HLLCounter result, HLLCounter counter2);
+static HLLCounter merge_counters(HLLCounter counter1, HLLCounter counter2);
+static const uint8_t * sparse_stream(HLLCounter hloglog, int8_t * b);
 
 static HLLCounter hll_compress_dense(HLLCounter hloglog);
 static HLLCounter hll_compress_sparse(HLLCounter hloglog);
 static HLLCounter hll_compress_dense_unpacked(HLLCounter hloglog);
+static HLLCounter hll_compress_dense_nibble(HLLCounter hloglog);
 static HLLCounter hll_decompress_unpacked(HLLCounter hloglog);
 static HLLCounter hll_decompress_dense(HLLCounter hloglog);
 static HLLCounter hll_decompress_dense_unpacked(HLLCounter hloglog);
+static HLLCounter hll_decompress_dense_nibble(HLLCounter hloglog);
 static HLLCounter hll_decompress_sparse(HLLCounter hloglog);
-
-static int hll_get_size_sparse(double ndistinct, float error);
+static int compact_read_header(HLLCounter hloglog, HLLCounter header);
+static uint8_t * dense_buffer(size_t size);
+static void dense_buffer_free(uint8_t * buffer);
 
 
 /* ---------------------- function definitions --------------------------- */
@@ -70,6 +155,12 @@ hll_unpack(HLLCounter hloglog){
 	return hloglog;
     }
 
+    /* high precision counters stay bit-packed, NIBBLE counters are read in
+     * their own layout */
+    if (HLL_IS_HIGH_PRECISION(hloglog) || HLL_FORMAT(hloglog) == NIBBLE){
+        return hll_decompress(hloglog);
+    }
+
     /* use decompress to handle compressed unpacking */
     if (hloglog->b < 0){
 	return hll_decompress_unpacked(hloglog);
@@ -120,12 +211,19 @@ hll_decompress_unpacked(HLLCounter hloglog)
 		return hloglog;
 	}
 
+	HLL_STAT_INC(HLL_STAT_DECOMPRESS_CALLS);
+	HLL_STAT_ADD(HLL_STAT_DECOMPRESS_BYTES_IN, VARSIZE_ANY(hloglog));
+	TRACE_HYPERLOGLOG_DECOMPRESS_START(HLL_PRECISION(hloglog), HLL_REPRESENTATION(hloglog), VARSIZE_ANY(hloglog));
+
 	if (hloglog->idx == -1){
 		hloglog = hll_decompress_dense_unpacked(hloglog);
 	} else {
 		hloglog = hll_decompress_sparse(hloglog);
 	}
 
+	HLL_STAT_ADD(HLL_STAT_DECOMPRESS_BYTES_OUT, VARSIZE_ANY(hloglog));
+	TRACE_HYPERLOGLOG_DECOMPRESS_DONE(HLL_PRECISION(hloglog), HLL_REPRESENTATION(hloglog), VARSIZE_ANY(hloglog));
+
 	return hloglog;
 }
 
@@ -150,8 +248,10 @@ hll_decompress_dense_unpacked(HLLCounter hloglog)
 	memset(htemp, 0, m + sizeof(HLLData));
 	memcpy(htemp, hloglog, sizeof(HLLData));
 
-	/* decompress the data */
-	pg_decompress((PGLZ_Header *)hloglog->data,(char *) htemp->data);
+	/* decode the registers straight into the unpacked counter */
+	if (rans_decode_registers((uint8_t *) hloglog->data, VARSIZE_ANY(hloglog) - sizeof(HLLData),
+				  (uint8_t *) htemp->data, m, POW2(hloglog->binbits) - 1) != 0)
+		elog(ERROR, "compressed dense counter data is corrupted");
 
 	hloglog = htemp;
 
@@ -189,8 +289,14 @@ hll_create(double ndistinct, float error, uint8_t format)
         elog(ERROR,"invalid ndstinct - must be between 257 and 1.1579 * 10^77");
     } 
 
-    /* the counter is allocated as part of this memory block  */
-    length = hll_get_size_sparse(ndistinct, error);
+    /* the counter is allocated as part of this memory block, it starts as a
+     * small set that grows as hashes are added (most counters of a large
+     * GROUP BY only ever see a few values) */
+    length = SMALL_SET_MIN_LENGTH;
+    format |= HLL_SMALL_SET;
+    if (hll_promotion_policy == HLL_PROMOTION_SIZE){
+        format |= HLL_PROMOTE_BY_SIZE;
+    }
     p = (HLLCounter)palloc0(length);
 
     /* set the counter struct version */
@@ -210,14 +316,19 @@ hll_create(double ndistinct, float error, uint8_t format)
     /* set the number of bits per bin */
     p->binbits = (uint8_t)ceil(log2(log2(ndistinct)));
 
-    /* set the starting sparse index to 0 since all counters start sparse and
-     *  empty */
+    /* set the starting index to 0 since all counters start as empty small
+     * sets */
     p->idx = 0;
 
     if (p->b < MIN_INDEX_BITS)   /* we want at least 2^4 (=16) bins */
         p->b = MIN_INDEX_BITS;
-    else if (p->b > MAX_INDEX_BITS)
-        elog(ERROR, "number of index bits exceeds MAX_INDEX_BITS (requested %d)", p->b);
+    else if (p->b > HLL_MAX_PRECISION)
+        elog(ERROR, "number of index bits exceeds HLL_MAX_PRECISION (requested %d)", p->b);
+
+    /* high precision counters are always bit-packed */
+    if (p->b > MAX_INDEX_BITS && HLL_FORMAT(p) == NIBBLE){
+        p->format = (p->format & ~HLL_FORMAT_MASK) | PACKED;
+    }
 
     SET_VARSIZE(p, length);
 
@@ -250,13 +361,30 @@ hll_copy(HLLCounter counter)
  *  */
 HLLCounter
 hll_merge(HLLCounter counter1, HLLCounter counter2)
+{
+	HLLCounter result;
+
+	HLL_STAT_INC(HLL_STAT_MERGES_SMALL_SMALL + 3 * HLL_REPRESENTATION(counter1) + HLL_REPRESENTATION(counter2));
+	TRACE_HYPERLOGLOG_MERGE_START(HLL_PRECISION(counter1), HLL_REPRESENTATION(counter1), HLL_REPRESENTATION(counter2));
+
+	result = merge_counters(counter1, counter2);
+
+	TRACE_HYPERLOGLOG_MERGE_DONE(HLL_PRECISION(result), HLL_REPRESENTATION(result));
+
+	return result;
+}
+
+/* Does the work of hll_merge, a result promoted halfway through is merged
+ * again without counting the merge twice */
+static HLLCounter
+merge_counters(HLLCounter counter1, HLLCounter counter2)
 {
 
 	int i;
 	HLLCounter result = counter1;
 	uint8_t rho;
 	uint32_t * sparse_data, *sparse_data_result, idx;
-	int upper_bound = POW2(result->b);
+	bool promote;
 
 	/* check compatibility first */
 	//if (counter1->b != counter2->b && -1*counter1->b != counter2->b)
@@ -264,52 +392,72 @@ hll_merge(HLLCounter counter1, HLLCounter counter2)
 	//else if (counter1->binbits != counter2->binbits)
 	//elog(ERROR, "bin size of estimators differs (%d != %d)", counter1->binbits, counter2->binbits);
 
+	/* Two small sets are merged as sorted lists of hashes. A small set
+	* result that can't hold the union (or meets any other counter) is
+	* upgraded first, its hashes are added to the result in the same way as
+	* those of a small counter2 below. */
+	if (HLL_IS_SMALL_SET(result) && HLL_IS_SMALL_SET(counter2)){
+		small_set_sort(result);
+		small_set_sort(counter2);
+		result = small_set_merge(result, counter2);
+		if (HLL_IS_SMALL_SET(result)){
+			return result;
+		}
+	} else if (HLL_IS_SMALL_SET(result)){
+		result = hll_unpack(small_set_to_sparse(result));
+	}
 
 	/* Keep the maximum register value for each bin */
-	if (result->idx == -1 && counter2->idx == -1){
-		for (i = 0; i < upper_bound; i += 1){
+	if (HLL_IS_SMALL_SET(counter2) && result->idx == -1){
+		for (i = 0; i < counter2->idx; i++){
+			hash_to_register(small_set_get(counter2, i), result->b, result->binbits, &idx, &rho);
+			result = set_register_max(result, idx, rho);
+		}
+	}
+	else if (HLL_IS_SMALL_SET(counter2)){
+		sparse_data_result = (uint32_t *)result->data;
 
-			result->data[i] = ((counter2->data[i] > result->data[i]) ? counter2->data[i] : result->data[i]);
+		/* Encode the hashes just like add_hash_sparse */
+		for (i = 0; i < counter2->idx; i++){
+			sparse_data_result[result->idx++] = encode_hash(small_set_get(counter2, i), result);
 
+			if (result->idx > sparse_capacity(result)) {
+				result = sparse_full(result, &promote);
+				if (promote) {
+					result = sparse_to_dense_unpacked(result);
+					result = merge_counters(result, counter2);
+					return result;
+				}
+				/* the array may have been moved */
+				sparse_data_result = (uint32_t *)result->data;
+			}
 		}
 	}
+	else if (result->idx == -1 && counter2->idx == -1){
+		result = merge_dense(result, counter2);
+	}
 	else if (result->idx == -1) {
 		sparse_data = (uint32_t *)counter2->data;
 
 		/* First the encoded hash must be converted to idx and rho before it
 		* can be added to the densely encoded result counter */
 		for (i = 0; i < counter2->idx; i++){
-			idx = sparse_data[i];
-
-			/* if last bit is 1 then rho is the preceding ~6 bits
-			* otherwise rho can be calculated from the leading bits*/
-			if (sparse_data[i] & 1) {
-				/* grab the binbits before the indicator bit and add that to
-				* the number of zero bits in p-p' */
-				idx = idx >> (32 - result->b);
-				rho = ((sparse_data[i] & (int)(POW2(result->binbits + 1) - 2)) >> 1) + (32 - 1 - result->b - result->binbits);
-			}
-			else {
-				idx = (idx << result->binbits) >> result->binbits;
-				idx = idx >> (32 - (result->binbits + result->b));
-				rho = __builtin_clz(sparse_data[i] << (result->binbits + result->b)) + 1;
-			}
+			decode_sparse_entry(sparse_data[i], result->b, result->binbits, &idx, &rho);
 
 			/* keep the highest value */
-			if (rho > result->data[idx]) {
-				result->data[idx] = rho;
+			if (is_unpacked(result)) {
+				if (rho > result->data[idx]) {
+					result->data[idx] = rho;
+				}
+			} else {
+				result = set_register_max(result, idx, rho);
 			}
 
 		}
 	}
 	else if (counter2->idx == -1) {
 
-		result = sparse_to_dense_unpacked(result);
-		for (i = 0; i < upper_bound; i += 1){
-
-			result->data[i] = ((counter2->data[i] > result->data[i]) ? counter2->data[i] : result->data[i]);
-
-		}
+		result = merge_dense(sparse_to_dense_unpacked(result), counter2);
 	}
 	else {
 		sparse_data = (uint32_t *)counter2->data;
@@ -320,13 +468,15 @@ hll_merge(HLLCounter counter1, HLLCounter counter2)
 		for (i = 0; i < counter2->idx; i++){
 			sparse_data_result[result->idx++] = sparse_data[i];
 
-			if (result->idx > size_sparse_array(result->b)) {
-				result->idx = dedupe((uint32_t *)result->data, result->idx);
-				if (result->idx > size_sparse_array(result->b) * (7.0 / 8)) {
+			if (result->idx > sparse_capacity(result)) {
+				result = sparse_full(result, &promote);
+				if (promote) {
 					result = sparse_to_dense_unpacked(result);
-					result = hll_merge(result, counter2);
+					result = merge_counters(result, counter2);
 					return result;
 				}
+				/* the array may have been moved */
+				sparse_data_result = (uint32_t *)result->data;
 			}
 		}
 
@@ -336,225 +486,1287 @@ hll_merge(HLLCounter counter1, HLLCounter counter2)
 
 }
 
-
-/* Computes size of the structure, depending on the requested error rate and
- * ndistinct. */
-int 
-hll_get_size(double ndistinct, float error)
+/* Merges two compressed sparse counters without decompressing them, the
+ * Stream VByte encoded entries of both are read at the same time and the
+ * merged entries are encoded as they come (see svb_merge_sorted). So merging
+ * takes memory proportional to the compressed counters instead of two
+ * 2^(b-2) byte arrays, which keeps rolling up sparse counters cheap.
+ *
+ * The result is compressed just as hll_compress_sparse would, the header
+ * (format, promotion policy) is taken from counter1. Whenever hll_merge
+ * might promote the result to dense encoding, i.e. the entries of both
+ * wouldn't fit into the array of counter1 once decompressed and the policy
+ * of the counter could decide to promote, the merged stream is dropped and
+ * the counters are decompressed and merged by hll_merge instead, so both
+ * paths always produce the same counter. The same is done for any other
+ * combination of counters. Counters of different precision or bin size
+ * can't be merged and raise an error. */
+HLLCounter
+hll_merge_compressed(HLLCounter counter1, HLLCounter counter2)
 {
+    HLLCounter result;
+    const uint8_t * stream1, * stream2;
+    int8_t b1, b2;
+    int32_t entries;
+    uint32_t size;
+    bool limit;
+
+    /* check compatibility first, hll_merge trusts the registers of both
+     * counters to line up */
+    if (HLL_PRECISION(counter1) != HLL_PRECISION(counter2))
+        elog(ERROR, "index size (bit length) of estimators differs (%d != %d)", HLL_PRECISION(counter1), HLL_PRECISION(counter2));
+    else if (counter1->binbits != counter2->binbits)
+        elog(ERROR, "bin size of estimators differs (%d != %d)", counter1->binbits, counter2->binbits);
 
-    int b;
-    float m;
-    
-    if (error <= 0 || error >= 1)
-        elog(ERROR, "invalid error rate requested");
-    
-    m = ERROR_CONST / (error * error);
-    b = (int)ceil(log2(m));
-    
-    if (b < MIN_INDEX_BITS)
-        b = MIN_INDEX_BITS;
-    else if (b > MAX_INDEX_BITS)
-        elog(ERROR, "number of index bits exceeds MAX_INDEX_BITS (requested %d)",b);
-    
-    /* The size is the sum of the struct overhead and the bytes the used to 
-     * store the buckets. Which is the product of the number of buckets and
-     *  the (bits per bucket)/ 8 where 8 is the amount of bits per byte.
-     *  
-     *  size_in_bytes = struct_overhead + num_buckets*(bits_per_bucket/8)
-     *
-     * */  
-    return sizeof(HLLData) + (int)(ceil(POW2(b)) * ceil(log2(log2(ndistinct))) / 8.0);
+    if (counter1->b > 0 || counter1->idx == -1 ||
+        counter2->b > 0 || counter2->idx == -1){
+        return hll_merge(hll_unpack(counter1), hll_unpack(counter2));
+    }
 
-}
+    stream1 = sparse_stream(counter1, &b1);
+    stream2 = sparse_stream(counter2, &b2);
 
-/* Returns the number of bytes to allocate for the initial sparse encoded 
- * counter. Since palloc allocates blocks that are 2^x bytes big if we were
- * to naively chose our sparse size to be a power of 2 and then add in the 
- * appropriate struct overhead we would have a significant amount of wasted
- * space. So its best to allocate a power of 2 and take the struct overhead 
- * out of the maximum number of sparse encoded hashes. */
-static int 
-hll_get_size_sparse(double ndistinct, float error)
-{
+    result = palloc0(sizeof(HLLData) + SVB_MAX_ENCODED_SIZE(counter1->idx + counter2->idx));
+    memcpy(result, counter1, sizeof(HLLData));
+    result->b = b1;
 
-    int b;
-    float m;
-    if (error <= 0 || error >= 1)
-        elog(ERROR, "invalid error rate requested");
-    
-    m = ERROR_CONST / (error * error);
-    b = (int)ceil(log2(m));
-    
-    if (b < MIN_INDEX_BITS)
-        b = MIN_INDEX_BITS;
-    else if (b > MAX_INDEX_BITS)
-        elog(ERROR, "number of index bits exceeds MAX_INDEX_BITS (requested %d)",b);
-    
-    return POW2(b-2);
-}
+    size = svb_merge_sorted(stream1, counter1->idx, stream2, counter2->idx,
+                            (uint8_t *) result->data, &entries);
 
-/* Hyperloglog estimate header function */
-double 
-hll_estimate(HLLCounter hloglog)
-{
-    double E = 0;
-    
-	if (hloglog->idx == -1 && hloglog->format != PACKED ){
-		E = hll_estimate_dense(hloglog);
-	} else {
-		E = hll_estimate_sparse(hloglog);
-	}
+    /* the same decision sparse_full makes if it's ever called by hll_merge
+     * (counter1 with idx entries is decompressed into sparse_length bytes) */
+    if (counter1->idx + counter2->idx > (sparse_length(result) - sizeof(HLLData)) / sizeof(uint32_t)){
+        limit = HLL_PROMOTES_BY_SIZE(result) || entries > size_sparse_array(b1)*7/8;
+    } else {
+        limit = false;
+    }
 
-    return E;
+    if (limit){
+        pfree(result);
+        return hll_merge(hll_unpack(counter1), hll_unpack(counter2));
+    }
+
+    result->idx = entries;
+    HLL_STAT_INC(HLL_STAT_MERGES_COMPRESSED);
+
+    if (size < entries * sizeof(uint32_t)){
+        SET_VARSIZE(result, sizeof(HLLData) + size);
+        result->b = -1 * b1;
+    } else {
+        /* no gain from Stream VByte, store the entries as they are */
+        svb_decode_sorted((uint8_t *) result->data, entries, (uint32_t *) hll_scratch());
+        memcpy(result->data, hll_scratch(), entries * sizeof(uint32_t));
+        SET_VARSIZE(result, sizeof(HLLData) + entries * sizeof(uint32_t));
+        result->b = -1 * (b1 + MAX_INDEX_BITS);
+    }
+
+    return result;
 }
-/*
- * Computes the HLL estimate, as described in the paper.
- * 
- * In short it does these steps:
- * 
- * 1) sums the data in counters (1/2^m[i])
- * 2) computes the raw estimate E
- * 3) corrects the estimate for low values
- * 
- */
-static double
-hll_estimate_dense(HLLCounter hloglog)
-{
-	double H = 0, E = 0;
-	int j, V = 0;
-	int m = POW2(hloglog->b);
 
-	/* compute the sum for the harmonic mean */
-	if (hloglog->binbits <= MAX_PRECOMPUTED_EXPONENTS_BINWIDTH){
-		for (j = 0; j < m; j++){
-			H += PE[(int)hloglog->data[j]];
-		}
-	}
-	else {
-		for (j = 0; j < m; j++){
-			if (0 <= hloglog->data[j] && hloglog->data[j] < NUM_OF_PRECOMPUTED_EXPONENTS){
-				H += PE[(int)hloglog->data[j]];
-			}
-			else {
-				H += pow(0.5, hloglog->data[j]);
-			}
-		}
-	}
+/* Returns the Stream VByte encoded entries of a compressed sparse counter and
+ * its (positive) b. Entries stored without encoding are encoded first. */
+static const uint8_t *
+sparse_stream(HLLCounter hloglog, int8_t * b)
+{
+    uint8_t * encoded;
 
-	/* multiple by constants to turn the mean into an estimate */
-	E = alpham[hloglog->b] / H;
+    if (hloglog->b >= -MAX_INDEX_BITS){
+        *b = -1 * hloglog->b;
+        return (const uint8_t *) hloglog->data;
+    }
 
-	/* correct for hyperloglog's low cardinality bias by either using linear
-	*  counting or error estimation */
-	if (E <= (5.0 * m)) {
+    *b = -1 * hloglog->b - MAX_INDEX_BITS;
+    encoded = palloc(SVB_MAX_ENCODED_SIZE(hloglog->idx));
+    svb_encode_sorted((uint32_t *) hloglog->data, hloglog->idx, encoded);
 
-		/* account for hloglog low cardinality bias */
-		E = E - error_estimate(E, hloglog->b);
+    return encoded;
+}
 
-		/* search for empty registers for linear counting */
-		for (j = 0; j < m; j++){
-			if (hloglog->data[j] == 0){
-				V += 1;
-			}
-		}
+/* Returns the counter in the fixed size representation, i.e. dense and
+ * uncompressed with the registers either bit-packed (format PACKED) or one
+ * per byte (format UNPACKED). The size of such a counter only depends on the
+ * precision and bin size, so merging more values into it with hll_upsert()
+ * never changes its size. A new counter is always allocated. */
+HLLCounter
+hll_fixed(HLLCounter hloglog, uint8_t format)
+{
+    HLLCounter fixed;
+    size_t length;
+    int m;
 
-		/* Don't use linear counting if there are no empty registers since we
-		* don't to divide by 0 */
-		if (V != 0){
-			H = m * log(m / (float)V);
-		}
-		else {
-			H = E;
-		}
+    if (format != PACKED && format != UNPACKED){
+        elog(ERROR, "fixed size counters must either be PACKED or UNPACKED, got %d", format);
+    }
 
-		/* if the estimated cardinality is below the threshold for a specific
-		* accuracy return the linear counting result otherwise use the error
-		* corrected version */
-		if (H <= threshold[hloglog->b]) {
-			E = H;
-		}
+    if (HLL_IS_SMALL_SET(hloglog)){
+        hloglog = small_set_to_sparse(hloglog);
+    }
+    hloglog = hll_unpack(hloglog);
+    if (hloglog->b < 0){
+        hloglog = hll_decompress_unpacked(hloglog);
+    }
 
-	}
+    m = POW2(hloglog->b);
+    if (format == PACKED){
+        length = sizeof(HLLData) + (int)ceil((m * hloglog->binbits / 8.0));
+    } else {
+        length = sizeof(HLLData) + m;
+    }
 
-	return E;
+    /* an empty dense counter with the same parameters */
+    fixed = palloc0(length);
+    memcpy(fixed, hloglog, offsetof(HLLData, data));
+    SET_VARSIZE(fixed, length);
+    fixed->idx = -1;
+    fixed->format = format;
 
+    return hll_upsert(fixed, hloglog);
 }
 
-
-/* Estimates the error from hyperloglog's low cardinality bias and by taking
- * a simple linear regression of the nearest 6 points */
-static double 
-error_estimate(double E,int b)
+/* Merges 'hloglog' into 'fixed' in place, keeping 'fixed' in the fixed size
+ * representation (see hll_fixed) so the result has exactly the same size as
+ * 'fixed'. If 'fixed' isn't in that representation yet it's converted first
+ * (bit-packed). 'hloglog' may be modified (decompressed/unpacked) as well. */
+HLLCounter
+hll_upsert(HLLCounter fixed, HLLCounter hloglog)
 {
-    double avg=0;
-    double beta,alpha;
-    double sx,sxx,sxy,sy;
-    int i, idx, max=0;
+    uint32_t * sparse_data;
+    uint32_t idx;
+    uint8_t rho;
+    int i, m;
 
-    /* get the number of interpoloation points for that precision */
-    if (b > 5 && b <= 18) {
-        max = MAX_INTERPOLATION_POINTS;
-    } else if (b == 5) {
-        max = PRECISION_5_MAX_INTERPOLATION_POINTS;
-    } else if (b == 4) {
-        max = PRECISION_4_MAX_INTERPOLATION_POINTS;
-    } else {
-	elog(ERROR,"ERROR: parameter b (%d) is out of range (4-18)",b);
+    if (!HLL_IS_FIXED(fixed)){
+        fixed = hll_fixed(fixed, PACKED);
     }
 
-    idx = max;
+    if (HLL_IS_SMALL_SET(hloglog)){
+        hloglog = small_set_to_sparse(hloglog);
+    }
+    hloglog = hll_unpack(hloglog);
+    if (hloglog->b < 0){
+        hloglog = hll_decompress_unpacked(hloglog);
+    }
 
-    /* find the index of the first interpolation point greater than the 
-     * uncorrected estimate */
-    for (i = 0; i < max; i++){
-        if (E < rawEstimateData[b-4][i]){
-            idx = i;
-            break;
+    /* check compatibility first */
+    if (fixed->b != hloglog->b)
+        elog(ERROR, "index size (bit length) of estimators differs (%d != %d)", fixed->b, hloglog->b);
+    else if (fixed->binbits != hloglog->binbits)
+        elog(ERROR, "bin size of estimators differs (%d != %d)", fixed->binbits, hloglog->binbits);
+
+    /* keep the maximum register value for each bin */
+    if (hloglog->idx == -1){
+        m = POW2(hloglog->b);
+        for (i = 0; i < m; i++){
+            set_register_max(fixed, i, get_register(hloglog, i));
+        }
+    } else {
+        sparse_data = (uint32_t *) hloglog->data;
+        for (i = 0; i < hloglog->idx; i++){
+            decode_sparse_entry(sparse_data[i], hloglog->b, hloglog->binbits, &idx, &rho);
+            set_register_max(fixed, idx, rho);
         }
     }
 
-    /* make sure array indexes will be inbounds when getting 6 nearest data
-     * points */
-    if (idx < 3) {
-        idx = 3;
-    } else if ( idx > max - 2){
-        idx = max - 2;
+    return fixed;
+}
+
+/* Decodes an encoded hash (see encode_hash) into the dense register index and
+ * value */
+static inline void
+decode_sparse_entry(uint32_t entry, int8_t b, uint8_t binbits, uint32_t * idx, uint8_t * rho)
+{
+    /* if last bit is 1 then rho is the preceding ~6 bits
+     * otherwise rho can be calculated from the leading bits*/
+    if (entry & 1) {
+        *idx = entry >> (32 - b);
+        *rho = ((entry & (int)(POW2(binbits + 1) - 2)) >> 1) + (32 - 1 - b - binbits);
+    } else {
+        *idx = (entry << binbits) >> binbits;
+        *idx = *idx >> (32 - (binbits + b));
+        *rho = __builtin_clz(entry << (binbits + b)) + 1;
     }
+}
 
-    /* calculate the alpha and beta needed to interpolate the error correction
-     * for E */
-    sx = rawEstimateData[b-4][idx+2] + rawEstimateData[b-4][idx+1] + rawEstimateData[b-4][idx] + rawEstimateData[b-4][idx-1] + rawEstimateData[b-4][idx-2] + rawEstimateData[b-4][idx-3];
-    sxx = rawEstimateData[b-4][idx+2]*rawEstimateData[b-4][idx+2] + rawEstimateData[b-4][idx+1]*rawEstimateData[b-4][idx+1] + rawEstimateData[b-4][idx]*rawEstimateData[b-4][idx] + rawEstimateData[b-4][idx-1]*rawEstimateData[b-4][idx-1] + rawEstimateData[b-4][idx-2]*rawEstimateData[b-4][idx-2] + rawEstimateData[b-4][idx-3]*rawEstimateData[b-4][idx-3]; 
-    sy = biasData[b-4][idx+2] + biasData[b-4][idx+1] + biasData[b-4][idx] + biasData[b-4][idx-1] + biasData[b-4][idx-2] + biasData[b-4][idx-3];
-    sxy = rawEstimateData[b-4][idx+2]*biasData[b-4][idx+2] + rawEstimateData[b-4][idx+1]*biasData[b-4][idx+1] + rawEstimateData[b-4][idx]*biasData[b-4][idx] + rawEstimateData[b-4][idx-1]*biasData[b-4][idx-1] + rawEstimateData[b-4][idx-2]*biasData[b-4][idx-2] + rawEstimateData[b-4][idx-3]*biasData[b-4][idx-3];
-    beta = (6.0*sxy - sx*sy ) / ( 6.0*sxx - sx*sx );
-    alpha = (1.0/6.0)*sy - beta*(1.0/6.0)*sx;
+/* Raises the register to 'rho' in a dense (uncompressed) counter if it's
+ * currently lower, handling the bit-packed, unpacked and NIBBLE layouts. The
+ * returned counter replaces the old one (NIBBLE counters grow as exceptions
+ * are added). */
+static inline HLLCounter
+set_register_max(HLLCounter hloglog, uint32_t idx, uint8_t rho)
+{
+    uint8_t entry;
 
-    avg = alpha + E*beta;
+    if (hloglog->format == PACKED){
+        HLL_DENSE_GET_REGISTER(entry, hloglog->data, idx, hloglog->binbits);
+        if (rho > entry) {
+            HLL_DENSE_SET_REGISTER(hloglog->data, idx, rho, hloglog->binbits);
+        }
+    } else if (hloglog->format == NIBBLE){
+        hloglog = nibble_set_max(hloglog, idx, rho);
+    } else if (rho > (uint8_t) hloglog->data[idx]) {
+        hloglog->data[idx] = rho;
+    }
 
-    return avg;
+    return hloglog;
 }
 
-/* Evaluates the stored encoded hashes using linear counting */
-static double 
-hll_estimate_sparse(HLLCounter hloglog)
+/* Returns the register of a dense (uncompressed) counter in any layout */
+static inline uint8_t
+get_register(HLLCounter hloglog, uint32_t idx)
 {
-    int i,V,m = POW2(32 - 1 - hloglog->binbits);
-    uint32_t * sparse_data;
+    uint8_t entry;
 
-    /* sort the values so we can ignore duplicates */
-    hloglog->idx = dedupe((uint32_t *)hloglog->data,hloglog->idx);
-    sparse_data = (uint32_t *) hloglog->data;
-    
-    /* count number of unique values */
-    V = 0;
-    for (i=0; i < hloglog->idx ; i++){
-        if (i == 0){
-            V++;
-        } else if (sparse_data[i] != sparse_data[i-1]){
-            V++;
-        }
+    if (hloglog->format == PACKED){
+        HLL_DENSE_GET_REGISTER(entry, hloglog->data, idx, hloglog->binbits);
+        return entry;
+    } else if (hloglog->format == NIBBLE){
+        return nibble_get(hloglog, idx);
+    }
+
+    return (uint8_t) hloglog->data[idx];
+}
+
+/* true for dense counters with one register per byte */
+static inline bool
+is_unpacked(HLLCounter hloglog)
+{
+    return hloglog->format == UNPACKED || hloglog->format == UNPACKED_UNPACKED;
+}
+
+/* Keeps the larger value of every register of two dense (uncompressed)
+ * counters, the result keeps its layout. Bit-packed registers (of high
+ * precision counters) and NIBBLE counters are merged without unpacking
+ * them. The returned counter replaces 'result'. */
+static HLLCounter
+merge_dense(HLLCounter result, HLLCounter counter2)
+{
+    uint8_t * registers;
+    int i, m = POW2(result->b);
+
+    if (is_unpacked(result) && is_unpacked(counter2)){
+        for (i = 0; i < m; i++){
+            result->data[i] = ((counter2->data[i] > result->data[i]) ? counter2->data[i] : result->data[i]);
+        }
+        return result;
+    } else if (result->format == NIBBLE && counter2->format == NIBBLE){
+        return nibble_merge(result, counter2);
+    } else if (result->format == NIBBLE || counter2->format == NIBBLE){
+        /* the NIBBLE counter is decoded once instead of looking up every
+         * register, a NIBBLE result is rebuilt from the merged registers */
+        registers = dense_buffer(m);
+        if (result->format == NIBBLE){
+            nibble_decode(result, registers);
+            for (i = 0; i < m; i++){
+                registers[i] = Max(registers[i], get_register(counter2, i));
+            }
+            result = nibble_create(result, registers);
+        } else {
+            nibble_decode(counter2, registers);
+            for (i = 0; i < m; i++){
+                result = set_register_max(result, i, registers[i]);
+            }
+        }
+        dense_buffer_free(registers);
+        return result;
+    }
+
+    for (i = 0; i < m; i++){
+        result = set_register_max(result, i, get_register(counter2, i));
+    }
+
+    return result;
+}
+
+/* Builds a dense NIBBLE counter with the header of 'header' from the 2^b
+ * unpacked registers. The base is the smallest register. */
+static HLLCounter
+nibble_create(HLLCounter header, const uint8_t * registers)
+{
+    HLLCounter hloglog;
+    NibbleHeader * nibbles;
+    uint8_t * data;
+    uint32_t * exceptions;
+    uint8_t base = UINT8_MAX, offset;
+    int i, n = 0, m = POW2(header->b);
+
+    for (i = 0; i < m; i++){
+        base = Min(base, registers[i]);
+    }
+    for (i = 0; i < m; i++){
+        n += (registers[i] - base >= NIBBLE_EXCEPTION);
+    }
+
+    hloglog = palloc0(NIBBLE_LENGTH(header->b, n));
+    memcpy(hloglog, header, offsetof(HLLData, data));
+    SET_VARSIZE(hloglog, NIBBLE_LENGTH(header->b, n));
+    hloglog->format = NIBBLE;
+    hloglog->idx = -1;
+
+    nibbles = (NibbleHeader *) hloglog->data;
+    data = (uint8_t *) (nibbles + 1);
+    exceptions = (uint32_t *) (data + m / 2);
+    nibbles->base = base;
+    nibbles->exceptions = n;
+
+    n = 0;
+    for (i = 0; i < m; i++){
+        offset = registers[i] - base;
+        if (offset >= NIBBLE_EXCEPTION){
+            exceptions[n++] = (uint32_t) i << 8 | registers[i];
+            offset = NIBBLE_EXCEPTION;
+        }
+        nibbles->zeros += (offset == 0);
+        data[i / 2] |= offset << ((i & 1) * 4);
+    }
+
+    return hloglog;
+}
+
+/* Writes the 2^b registers of a dense NIBBLE counter unpacked */
+static void
+nibble_decode(HLLCounter hloglog, uint8_t * registers)
+{
+    NibbleHeader * nibbles = (NibbleHeader *) hloglog->data;
+    const uint8_t * data = (const uint8_t *) (nibbles + 1);
+    const uint32_t * exceptions = (const uint32_t *) (data + POW2(hloglog->b) / 2);
+    int i, e = 0, m = POW2(hloglog->b);
+    uint8_t offset;
+
+    for (i = 0; i < m; i++){
+        offset = (data[i / 2] >> ((i & 1) * 4)) & 0x0F;
+        registers[i] = (offset == NIBBLE_EXCEPTION) ? (uint8_t) exceptions[e++] : nibbles->base + offset;
+    }
+}
+
+/* Returns a register of a dense NIBBLE counter, exceptions are looked up by
+ * a binary search of the (short) list */
+static inline uint8_t
+nibble_get(HLLCounter hloglog, uint32_t idx)
+{
+    NibbleHeader * nibbles = (NibbleHeader *) hloglog->data;
+    const uint8_t * data = (const uint8_t *) (nibbles + 1);
+    const uint32_t * exceptions = (const uint32_t *) (data + POW2(hloglog->b) / 2);
+    uint8_t offset = (data[idx / 2] >> ((idx & 1) * 4)) & 0x0F;
+    int low = 0, high = nibbles->exceptions - 1, mid;
+
+    if (offset != NIBBLE_EXCEPTION){
+        return nibbles->base + offset;
+    }
+
+    while (low < high){
+        mid = (low + high) / 2;
+        if ((exceptions[mid] >> 8) < idx){
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+
+    return (uint8_t) exceptions[low];
+}
+
+/* Raises a register of a dense NIBBLE counter to 'rho' if it's lower. A
+ * register that leaves the base may raise it (see nibble_rebase), one that
+ * gets NIBBLE_EXCEPTION or more above it is added to the exception list. The
+ * returned counter replaces the old one. */
+static HLLCounter
+nibble_set_max(HLLCounter hloglog, uint32_t idx, uint8_t rho)
+{
+    NibbleHeader * nibbles = (NibbleHeader *) hloglog->data;
+    uint8_t * data = (uint8_t *) (nibbles + 1);
+    uint32_t * exceptions;
+    uint8_t offset = (data[idx / 2] >> ((idx & 1) * 4)) & 0x0F;
+    int i, m = POW2(hloglog->b);
+
+    if (rho <= nibbles->base + offset){
+        return hloglog;
+    }
+
+    if (offset == NIBBLE_EXCEPTION || rho - nibbles->base >= NIBBLE_EXCEPTION){
+        if (offset != NIBBLE_EXCEPTION){
+            hloglog = nibble_reserve(hloglog, nibbles->exceptions + 1);
+            nibbles = (NibbleHeader *) hloglog->data;
+            data = (uint8_t *) (nibbles + 1);
+        }
+        exceptions = (uint32_t *) (data + m / 2);
+
+        /* the list is sorted by register, i is where idx is (or goes) */
+        for (i = nibbles->exceptions; i > 0 && (exceptions[i - 1] >> 8) >= idx; i--);
+        if (offset == NIBBLE_EXCEPTION){
+            exceptions[i] = Max(exceptions[i], idx << 8 | rho);
+            return hloglog;
+        }
+        memmove(&exceptions[i + 1], &exceptions[i], (nibbles->exceptions - i) * sizeof(uint32_t));
+        exceptions[i] = idx << 8 | rho;
+        nibbles->exceptions++;
+    }
+
+    nibbles->zeros -= (offset == 0);
+    offset = Min(rho - nibbles->base, NIBBLE_EXCEPTION);
+    data[idx / 2] = (data[idx / 2] & (0xF0 >> ((idx & 1) * 4))) | offset << ((idx & 1) * 4);
+
+    if (nibbles->zeros == 0){
+        nibble_rebase(hloglog);
+    }
+
+    return hloglog;
+}
+
+/* Merges two dense NIBBLE counters a byte (two registers) at a time. With
+ * the same base (most counters of a similar cardinality) that's the larger
+ * of each nibble and the union of the exception lists, otherwise both are
+ * rebased to the larger base on the fly (no register of the result is below
+ * it). The returned counter replaces 'result'. */
+static HLLCounter
+nibble_merge(HLLCounter result, HLLCounter counter2)
+{
+    NibbleHeader * nibbles1 = (NibbleHeader *) result->data, * nibbles2 = (NibbleHeader *) counter2->data;
+    uint8_t * data1 = (uint8_t *) (nibbles1 + 1);
+    const uint8_t * data2 = (const uint8_t *) (nibbles2 + 1);
+    const uint32_t * exceptions1, * exceptions2;
+    uint32_t * merged;
+    uint8_t base, lo, hi, v1, v2, offsets[2];
+    int i, j, e1 = 0, e2 = 0, n = 0, zeros = 0, m = POW2(result->b);
+
+    exceptions1 = (const uint32_t *) (data1 + m / 2);
+    exceptions2 = (const uint32_t *) (data2 + m / 2);
+    merged = (uint32_t *) dense_buffer((nibbles1->exceptions + nibbles2->exceptions) * sizeof(uint32_t));
+
+    if (nibbles1->base == nibbles2->base){
+        base = nibbles1->base;
+        for (i = 0; i < m / 2; i++){
+            lo = Max(data1[i] & 0x0F, data2[i] & 0x0F);
+            hi = Max(data1[i] & 0xF0, data2[i] & 0xF0);
+            data1[i] = lo | hi;
+            zeros += (lo == 0) + (hi == 0);
+        }
+
+        /* a register that is an exception in either counter is one in the
+         * result as well, with the larger value */
+        while (e1 < nibbles1->exceptions || e2 < nibbles2->exceptions){
+            if (e2 == nibbles2->exceptions || (e1 < nibbles1->exceptions && exceptions1[e1] >> 8 < exceptions2[e2] >> 8)){
+                merged[n++] = exceptions1[e1++];
+            } else if (e1 == nibbles1->exceptions || exceptions2[e2] >> 8 < exceptions1[e1] >> 8){
+                merged[n++] = exceptions2[e2++];
+            } else {
+                merged[n++] = Max(exceptions1[e1], exceptions2[e2]);
+                e1++;
+                e2++;
+            }
+        }
+    } else {
+        base = Max(nibbles1->base, nibbles2->base);
+        for (i = 0; i < m / 2; i++){
+            for (j = 0; j < 2; j++){
+                v1 = (data1[i] >> (j * 4)) & 0x0F;
+                v1 = (v1 == NIBBLE_EXCEPTION) ? (uint8_t) exceptions1[e1++] : nibbles1->base + v1;
+                v2 = (data2[i] >> (j * 4)) & 0x0F;
+                v2 = (v2 == NIBBLE_EXCEPTION) ? (uint8_t) exceptions2[e2++] : nibbles2->base + v2;
+
+                offsets[j] = Max(v1, v2) - base;
+                if (offsets[j] >= NIBBLE_EXCEPTION){
+                    merged[n++] = (uint32_t) (2 * i + j) << 8 | Max(v1, v2);
+                    offsets[j] = NIBBLE_EXCEPTION;
+                }
+                zeros += (offsets[j] == 0);
+            }
+            data1[i] = offsets[1] << 4 | offsets[0];
+        }
+    }
+
+    result = nibble_reserve(result, n);
+    nibbles1 = (NibbleHeader *) result->data;
+    memcpy((uint8_t *) (nibbles1 + 1) + m / 2, merged, n * sizeof(uint32_t));
+    nibbles1->base = base;
+    nibbles1->zeros = zeros;
+    nibbles1->exceptions = n;
+    dense_buffer_free((uint8_t *) merged);
+
+    if (zeros == 0){
+        nibble_rebase(result);
+    }
+
+    return result;
+}
+
+/* Makes sure the exception list of a NIBBLE counter has room for the given
+ * number of entries, the room for it is doubled as it grows (and the counter
+ * moved like a growing sparse array, see sparse_grow) */
+static HLLCounter
+nibble_reserve(HLLCounter hloglog, int exceptions)
+{
+    int capacity = (VARSIZE_ANY(hloglog) - NIBBLE_LENGTH(hloglog->b, 0)) / sizeof(uint32_t);
+
+    if (exceptions <= capacity){
+        return hloglog;
+    }
+
+    return sparse_grow(hloglog, NIBBLE_LENGTH(hloglog->b, Max(exceptions, Max(2 * capacity, 8))));
+}
+
+/* Raises the base of a NIBBLE counter that has no register left at it until
+ * one is, every nibble is lowered by one and exceptions that get within
+ * NIBBLE_EXCEPTION of the base become nibbles again */
+static void
+nibble_rebase(HLLCounter hloglog)
+{
+    NibbleHeader * nibbles = (NibbleHeader *) hloglog->data;
+    uint8_t * data = (uint8_t *) (nibbles + 1);
+    uint32_t * exceptions = (uint32_t *) (data + POW2(hloglog->b) / 2);
+    uint8_t lo, hi;
+    uint32_t idx;
+    int i, n, m = POW2(hloglog->b);
+
+    while (nibbles->zeros == 0){
+        nibbles->base++;
+
+        for (i = 0; i < m / 2; i++){
+            lo = data[i] & 0x0F;
+            hi = data[i] >> 4;
+            lo -= (lo != NIBBLE_EXCEPTION);
+            hi -= (hi != NIBBLE_EXCEPTION);
+            nibbles->zeros += (lo == 0) + (hi == 0);
+            data[i] = hi << 4 | lo;
+        }
+
+        for (i = 0, n = 0; i < nibbles->exceptions; i++){
+            idx = exceptions[i] >> 8;
+            if ((uint8_t) exceptions[i] - nibbles->base < NIBBLE_EXCEPTION){
+                data[idx / 2] = (data[idx / 2] & (0xF0 >> ((idx & 1) * 4))) |
+                    ((uint8_t) exceptions[i] - nibbles->base) << ((idx & 1) * 4);
+            } else {
+                exceptions[n++] = exceptions[i];
+            }
+        }
+        nibbles->exceptions = n;
+    }
+}
+
+/* Sums 2^-register over the registers of a dense NIBBLE counter, in the
+ * order hll_estimate_dense sums the unpacked registers so both get exactly
+ * the same estimate */
+static double
+nibble_harmonic_sum(HLLCounter hloglog)
+{
+    NibbleHeader * nibbles = (NibbleHeader *) hloglog->data;
+    const uint8_t * data = (const uint8_t *) (nibbles + 1);
+    const uint32_t * exceptions = (const uint32_t *) (data + POW2(hloglog->b) / 2);
+    double H = 0;
+    uint8_t lo, hi;
+    int i, e = 0, m = POW2(hloglog->b);
+
+    for (i = 0; i < m / 2; i++){
+        lo = data[i] & 0x0F;
+        hi = data[i] >> 4;
+        lo = (lo == NIBBLE_EXCEPTION) ? (uint8_t) exceptions[e++] : nibbles->base + lo;
+        hi = (hi == NIBBLE_EXCEPTION) ? (uint8_t) exceptions[e++] : nibbles->base + hi;
+        H += (lo < NUM_OF_PRECOMPUTED_EXPONENTS) ? PE[lo] : pow(0.5, lo);
+        H += (hi < NUM_OF_PRECOMPUTED_EXPONENTS) ? PE[hi] : pow(0.5, hi);
+    }
+
+    return H;
+}
+
+/* Checks the data of an uncompressed dense NIBBLE counter (whose length
+ * hll_validate checked) is consistent: every register fits the bin size,
+ * the exception list is sorted and matches the exception nibbles and the
+ * number of registers at the base is right */
+static bool
+nibble_check(HLLCounter hloglog)
+{
+    NibbleHeader * nibbles = (NibbleHeader *) hloglog->data;
+    const uint8_t * data = (const uint8_t *) (nibbles + 1);
+    const uint32_t * exceptions = (const uint32_t *) (data + POW2(hloglog->b) / 2);
+    uint8_t offset;
+    int i, e = 0, zeros = 0, m = POW2(hloglog->b);
+
+    for (i = 0; i < m; i++){
+        offset = (data[i / 2] >> ((i & 1) * 4)) & 0x0F;
+        zeros += (offset == 0);
+        if (offset != NIBBLE_EXCEPTION){
+            if (nibbles->base + offset >= POW2(hloglog->binbits)){
+                return false;
+            }
+            continue;
+        } else if (e == nibbles->exceptions || exceptions[e] >> 8 != (uint32_t) i ||
+                   (uint8_t) exceptions[e] < nibbles->base + NIBBLE_EXCEPTION ||
+                   (uint8_t) exceptions[e] >= POW2(hloglog->binbits)){
+            return false;
+        }
+        e++;
+    }
+
+    return e == nibbles->exceptions && zeros == nibbles->zeros && zeros > 0;
+}
+
+/* Promotes a sparse counter of the NIBBLE format, the registers are built
+ * unpacked in the scratch arena first */
+static HLLCounter
+sparse_to_dense_nibble(HLLCounter hloglog)
+{
+    HLLCounter htemp;
+    const uint32_t * sparse_data = (const uint32_t *) hloglog->data;
+    uint8_t * registers;
+    uint32_t idx;
+    uint8_t rho;
+    int i, m = POW2(hloglog->b);
+
+    registers = dense_buffer(m);
+    memset(registers, 0, m);
+
+    for (i = 0; i < hloglog->idx; i++){
+        decode_sparse_entry(sparse_data[i], hloglog->b, hloglog->binbits, &idx, &rho);
+        if (rho > registers[idx]){
+            registers[idx] = rho;
+        }
+    }
+
+    htemp = nibble_create(hloglog, registers);
+    dense_buffer_free(registers);
+
+    return htemp;
+}
+
+/* Sets the sparse to dense promotion policy of a counter in place. Usually
+ * only the format flag changes (small sets keep it for when they're
+ * upgraded to sparse encoding), the sparse array of a counter switched to the
+ * size policy is grown/compared the next time it fills up. A counter whose
+ * array grew past size_sparse_array(b) under the size policy doesn't fit the
+ * fixed policy though, so it's promoted right away (and returned
+ * decompressed). Dense counters are returned as they are. */
+HLLCounter
+hll_set_promotion(HLLCounter hloglog, int policy)
+{
+    int8_t b;
+
+    if (hloglog->idx == -1){
+        return hloglog;
+    }
+
+    /* undo the compression flags (see hll_compress_sparse) */
+    b = HLL_PRECISION(hloglog);
+
+    if (policy == HLL_PROMOTION_SIZE){
+        hloglog->format |= HLL_PROMOTE_BY_SIZE;
+    } else if (!HLL_IS_SMALL_SET(hloglog) && hloglog->idx > size_sparse_array(b)){
+        hloglog = sparse_to_dense(hll_decompress(hloglog));
+    } else {
+        hloglog->format &= ~HLL_PROMOTE_BY_SIZE;
+    }
+
+    return hloglog;
+}
+
+/* Returns the maximum number of entries in the sparse array of the counter,
+ * derived from the allocated length since the array grows. For counters
+ * using the fixed policy it never exceeds size_sparse_array(b). */
+static int
+sparse_capacity(HLLCounter hloglog)
+{
+    return (VARSIZE_ANY(hloglog) - sizeof(HLLData)) / sizeof(uint32_t);
+}
+
+/* Returns the length to allocate for the (uncompressed) sparse counter, that
+ * is the array the counter would have grown to (see sparse_full) so
+ * decompressing and compressing it again doesn't change when the counter is
+ * promoted. For counters using the fixed policy the array ends at the
+ * POW2(b-2) bytes allocation. */
+static size_t
+sparse_length(HLLCounter hloglog)
+{
+    size_t length = SPARSE_MIN_LENGTH;
+
+    while (length < sizeof(HLLData) + hloglog->idx * sizeof(uint32_t)){
+        length *= 2;
+    }
+
+    if (HLL_PROMOTES_BY_SIZE(hloglog)){
+        return length;
+    }
+
+    return Min(length, POW2(hloglog->b-2));
+}
+
+/* Called when the sparse array of the counter is full. The array is deduped
+ * first to guard against situations where many duplicate elements are input
+ * into the counter which would needlessly promote it to dense encoding
+ * sacrificing accuracy at a lower cardinality than desired (or grow the
+ * array). If the dedupe freed at least half of the array it just keeps
+ * going, otherwise the promotion policy of the counter decides:
+ *
+ * fixed - double the array until it reaches the POW2(b-2) bytes allocation,
+ * once it's there promote if the dedupe doesn't provide a reasonable
+ * reduction
+ *
+ * size - promote if the compressed sparse counter would be larger than the
+ * compressed dense one and double the array if it wouldn't. So the sizes are
+ * only compared (which costs about as much as compressing a dense counter)
+ * once per doubling.
+ *
+ * 'promote' is set to the decision, the returned counter replaces the old one
+ * (it's moved when the array grows). */
+static HLLCounter
+sparse_full(HLLCounter hloglog, bool * promote)
+{
+    int capacity = sparse_capacity(hloglog);
+
+    hloglog->idx = dedupe((uint32_t *)hloglog->data,hloglog->idx);
+    *promote = false;
+
+    if (!HLL_PROMOTES_BY_SIZE(hloglog)){
+        if (capacity >= size_sparse_array(hloglog->b)){
+            *promote = (hloglog->idx > size_sparse_array(hloglog->b)*7/8);
+        } else if (hloglog->idx > capacity / 2){
+            hloglog = sparse_grow(hloglog, Min(2 * VARSIZE_ANY(hloglog), POW2(hloglog->b-2)));
+        }
+        return hloglog;
+    }
+
+    if (hloglog->idx <= capacity / 2){
+        return hloglog;
+    }
+
+    /* the compressed sparse data has to fit into the scratch arena, so the
+     * array stops growing there no matter the sizes */
+    if (SVB_MAX_ENCODED_SIZE(2 * capacity + 4) > HLL_SCRATCH_SIZE ||
+        sparse_compressed_size(hloglog) > dense_compressed_size(hloglog)){
+        *promote = true;
+        return hloglog;
+    }
+
+    return sparse_grow(hloglog, 2 * VARSIZE_ANY(hloglog));
+}
+
+/* Moves the sparse counter (or small set or NIBBLE counter) into a new
+ * (zeroed) allocation of 'length' bytes, the old counter stays untouched */
+static HLLCounter
+sparse_grow(HLLCounter hloglog, size_t length)
+{
+    HLLCounter htemp;
+
+    htemp = palloc0(length);
+    memcpy(htemp, hloglog, VARSIZE_ANY(hloglog));
+    SET_VARSIZE(htemp, length);
+
+    return htemp;
+}
+
+/* Returns the size of the data hll_compress_sparse would produce for the
+ * (sorted and deduped) sparse counter */
+static uint32_t
+sparse_compressed_size(HLLCounter hloglog)
+{
+    uint32_t size;
+
+    size = svb_encoded_size_sorted((uint32_t *)hloglog->data, hloglog->idx);
+
+    return Min(size, hloglog->idx * sizeof(uint32_t));
+}
+
+/* Returns the size of the data hll_compress_dense would produce for the
+ * sparse counter (or the small set of a high precision counter) once
+ * promoted. The registers are built and encoded in the scratch arena (see
+ * dense_buffer). */
+static uint32_t
+dense_compressed_size(HLLCounter hloglog)
+{
+    uint8_t * registers;
+    const uint32_t * sparse_data;
+    uint32_t idx, size, capacity;
+    uint8_t rho;
+    int i, m = POW2(hloglog->b);
+
+    capacity = Min(RANS_MAX_ENCODED_SIZE(m), m * hloglog->binbits / 8);
+    registers = dense_buffer(m + capacity);
+    memset(registers, 0, m);
+
+    sparse_data = (const uint32_t *) hloglog->data;
+    for (i = 0; i < hloglog->idx; i++){
+        if (HLL_IS_SMALL_SET(hloglog)){
+            hash_to_register(small_set_get(hloglog, i), hloglog->b, hloglog->binbits, &idx, &rho);
+        } else {
+            decode_sparse_entry(sparse_data[i], hloglog->b, hloglog->binbits, &idx, &rho);
+        }
+        if (rho > registers[idx]){
+            registers[idx] = rho;
+        }
+    }
+
+    size = rans_encode_registers(registers, m, registers + m, capacity);
+    if (size == 0 || size >= (m * hloglog->binbits / 8)){
+        size = (int)ceil((m * hloglog->binbits / 8.0));
+    }
+    dense_buffer_free(registers);
+
+    return size;
+}
+
+/* Returns the i-th hash of a small set. The data array isn't 8 byte aligned
+ * so the hashes are copied out instead of read through a uint64_t pointer. */
+static inline uint64_t
+small_set_get(HLLCounter hloglog, int i)
+{
+    uint64_t hash;
+
+    memcpy(&hash, hloglog->data + i * sizeof(uint64_t), sizeof(uint64_t));
+
+    return hash;
+}
+
+/* Returns the number of hashes the small set has room for */
+static int
+small_set_capacity(HLLCounter hloglog)
+{
+    return (VARSIZE_ANY(hloglog) - sizeof(HLLData)) / sizeof(uint64_t);
+}
+
+/* Returns the largest number of hashes the small set may hold before it's
+ * upgraded. High precision counters keep their hashes until they'd take more
+ * space than the bit-packed registers. */
+static int
+small_set_max_entries(HLLCounter hloglog)
+{
+    if (hloglog->b <= MAX_INDEX_BITS){
+        return SMALL_SET_MAX_ENTRIES;
+    }
+
+    return (int)ceil(POW2(hloglog->b) * hloglog->binbits / 8.0) / sizeof(uint64_t);
+}
+
+/* Returns the length to allocate for a small set of 'entries' hashes, the
+ * allocation doubles from SMALL_SET_MIN_LENGTH just like the sparse one */
+static size_t
+small_set_length(int entries)
+{
+    size_t length = SMALL_SET_MIN_LENGTH;
+
+    while (length < sizeof(HLLData) + entries * sizeof(uint64_t)){
+        length *= 2;
+    }
+
+    return length;
+}
+
+/* Sorts the hashes of a small set and drops the duplicates in place. Only
+ * the small sets of high precision counters are ever out of order (their
+ * hashes are appended, see hll_add_hash_small), so anything that needs the
+ * hashes in order sorts them first. Sorted sets are only scanned. */
+static void
+small_set_sort(HLLCounter hloglog)
+{
+    int i, n;
+
+    for (i = 1; i < hloglog->idx && small_set_get(hloglog, i - 1) < small_set_get(hloglog, i); i++);
+    if (i >= hloglog->idx){
+        return;
+    }
+
+    qsort(hloglog->data, hloglog->idx, sizeof(uint64_t), hash_cmp);
+
+    for (i = 1, n = 1; i < hloglog->idx; i++){
+        if (small_set_get(hloglog, i) != small_set_get(hloglog, n - 1)){
+            memmove(hloglog->data + n * sizeof(uint64_t), hloglog->data + i * sizeof(uint64_t), sizeof(uint64_t));
+            n++;
+        }
+    }
+    hloglog->idx = n;
+}
+
+/* orders the (possibly unaligned) hashes of a small set */
+static int
+hash_cmp(const void * a, const void * b)
+{
+    uint64_t x, y;
+
+    memcpy(&x, a, sizeof(uint64_t));
+    memcpy(&y, b, sizeof(uint64_t));
+
+    return (x > y) - (x < y);
+}
+
+/* Upgrades a small set to sparse encoding by adding its hashes to a new
+ * sparse counter with the same parameters (and promotion policy). Under the
+ * size policy that may promote the counter to dense encoding right away, so
+ * the result is returned packed like from any other add. High precision
+ * counters have no sparse encoding and are promoted to (bit-packed) dense
+ * encoding instead. The small set stays untouched. */
+static HLLCounter
+small_set_to_sparse(HLLCounter hloglog)
+{
+    HLLCounter htemp;
+    size_t length;
+    int i;
+
+    if (hloglog->b > MAX_INDEX_BITS){
+        HLL_STAT_INC(HLL_STAT_PROMOTIONS_DENSE);
+        TRACE_HYPERLOGLOG_PROMOTE_DENSE(hloglog->b, hloglog->idx);
+
+        length = sizeof(HLLData) + (int)ceil((POW2(hloglog->b) * hloglog->binbits / 8.0));
+        htemp = palloc0(length);
+        memcpy(htemp, hloglog, offsetof(HLLData, data));
+        htemp->format = PACKED;
+        htemp->idx = -1;
+        SET_VARSIZE(htemp, length);
+
+        for (i = 0; i < hloglog->idx; i++){
+            htemp = hll_add_hash_dense(htemp, small_set_get(hloglog, i));
+        }
+
+        return htemp;
+    }
+
+    HLL_STAT_INC(HLL_STAT_PROMOTIONS_SPARSE);
+
+    htemp = palloc0(SPARSE_MIN_LENGTH);
+    memcpy(htemp, hloglog, offsetof(HLLData, data));
+    htemp->format &= ~HLL_SMALL_SET;
+    htemp->idx = 0;
+    SET_VARSIZE(htemp, sparse_length(htemp));
+
+    for (i = 0; i < hloglog->idx; i++){
+        htemp = hll_add_hash(htemp, small_set_get(hloglog, i));
+    }
+
+    return htemp;
+}
+
+/* Merges the small set counter2 into the small set result. The union of the
+ * two sorted arrays is built in the scratch arena (or a temporary buffer for
+ * the larger sets of high precision counters) and copied back if it fits a
+ * small set, otherwise the result is upgraded to sparse encoding (unpacked
+ * if it was promoted) and returned without counter2 for hll_merge to add. */
+static HLLCounter
+small_set_merge(HLLCounter result, HLLCounter counter2)
+{
+    uint64_t * merged, hash1, hash2;
+    int i = 0, j = 0, n = 0;
+
+    merged = (uint64_t *) dense_buffer((result->idx + counter2->idx) * sizeof(uint64_t));
+
+    while (i < result->idx && j < counter2->idx){
+        hash1 = small_set_get(result, i);
+        hash2 = small_set_get(counter2, j);
+        if (hash1 <= hash2){
+            merged[n++] = hash1;
+            i++;
+            if (hash1 == hash2){
+                j++;
+            }
+        } else {
+            merged[n++] = hash2;
+            j++;
+        }
+    }
+    while (i < result->idx){
+        merged[n++] = small_set_get(result, i++);
+    }
+    while (j < counter2->idx){
+        merged[n++] = small_set_get(counter2, j++);
+    }
+
+    if (n > small_set_max_entries(result)){
+        dense_buffer_free((uint8_t *) merged);
+        return hll_unpack(small_set_to_sparse(result));
+    }
+
+    if (n > small_set_capacity(result)){
+        result = sparse_grow(result, small_set_length(n));
+    }
+    memcpy(result->data, merged, n * sizeof(uint64_t));
+    result->idx = n;
+    dense_buffer_free((uint8_t *) merged);
+
+    return result;
+}
+
+
+/* Computes size of the structure, depending on the requested error rate and
+ * ndistinct. */
+int 
+hll_get_size(double ndistinct, float error)
+{
+
+    int b;
+    float m;
+    
+    if (error <= 0 || error >= 1)
+        elog(ERROR, "invalid error rate requested");
+    
+    m = ERROR_CONST / (error * error);
+    b = (int)ceil(log2(m));
+    
+    if (b < MIN_INDEX_BITS)
+        b = MIN_INDEX_BITS;
+    else if (b > HLL_MAX_PRECISION)
+        elog(ERROR, "number of index bits exceeds HLL_MAX_PRECISION (requested %d)",b);
+    
+    /* The size is the sum of the struct overhead and the bytes the used to 
+     * store the buckets. Which is the product of the number of buckets and
+     *  the (bits per bucket)/ 8 where 8 is the amount of bits per byte.
+     *  
+     *  size_in_bytes = struct_overhead + num_buckets*(bits_per_bucket/8)
+     *
+     * */  
+    return sizeof(HLLData) + (int)(ceil(POW2(b)) * ceil(log2(log2(ndistinct))) / 8.0);
+
+}
+
+/* Hyperloglog estimate header function */
+double 
+hll_estimate(HLLCounter hloglog)
+{
+    double E = 0;
+
+    /* small sets hold every distinct hash, so they're counted exactly */
+    if (HLL_IS_SMALL_SET(hloglog)){
+        small_set_sort(hloglog);
+        return hloglog->idx;
+    }
+    
+	if (hloglog->idx == -1 && hloglog->b > MAX_INDEX_BITS){
+		E = hll_estimate_histogram(hloglog);
+	} else if (hloglog->idx == -1 && hloglog->format != PACKED ){
+		E = hll_estimate_dense(hloglog);
+	} else {
+		E = hll_estimate_sparse(hloglog);
+	}
+
+    return E;
+}
+/*
+ * Computes the HLL estimate, as described in the paper.
+ * 
+ * In short it does these steps:
+ * 
+ * 1) sums the data in counters (1/2^m[i])
+ * 2) computes the raw estimate E
+ * 3) corrects the estimate for low values
+ * 
+ */
+static double
+hll_estimate_dense(HLLCounter hloglog)
+{
+	double H = 0, E = 0;
+	int j, V = 0;
+	int m = POW2(hloglog->b);
+
+	/* compute the sum for the harmonic mean */
+	if (hloglog->format == NIBBLE){
+		H = nibble_harmonic_sum(hloglog);
+	}
+	else if (hloglog->binbits <= MAX_PRECOMPUTED_EXPONENTS_BINWIDTH){
+		for (j = 0; j < m; j++){
+			H += PE[(int)hloglog->data[j]];
+		}
+	}
+	else {
+		for (j = 0; j < m; j++){
+			if (0 <= hloglog->data[j] && hloglog->data[j] < NUM_OF_PRECOMPUTED_EXPONENTS){
+				H += PE[(int)hloglog->data[j]];
+			}
+			else {
+				H += pow(0.5, hloglog->data[j]);
+			}
+		}
+	}
+
+	/* multiple by constants to turn the mean into an estimate */
+	E = alpham[hloglog->b] / H;
+
+	/* correct for hyperloglog's low cardinality bias by either using linear
+	*  counting or error estimation */
+	if (E <= (5.0 * m)) {
+
+		/* account for hloglog low cardinality bias */
+		E = E - error_estimate(E, hloglog->b);
+
+		/* search for empty registers for linear counting (those at the base
+		* of NIBBLE counters are counted already) */
+		if (hloglog->format == NIBBLE){
+			V = (((NibbleHeader *) hloglog->data)->base == 0) ? ((NibbleHeader *) hloglog->data)->zeros : 0;
+		}
+		else {
+			for (j = 0; j < m; j++){
+				if (hloglog->data[j] == 0){
+					V += 1;
+				}
+			}
+		}
+
+		/* Don't use linear counting if there are no empty registers since we
+		* don't to divide by 0 */
+		if (V != 0){
+			H = m * log(m / (float)V);
+		}
+		else {
+			H = E;
+		}
+
+		/* if the estimated cardinality is below the threshold for a specific
+		* accuracy return the linear counting result otherwise use the error
+		* corrected version */
+		if (H <= threshold[hloglog->b]) {
+			E = H;
+		}
+
+	}
+
+	return E;
+
+}
+
+
+/* Estimates the error from hyperloglog's low cardinality bias and by taking
+ * a simple linear regression of the nearest 6 points */
+static double 
+error_estimate(double E,int b)
+{
+    double avg=0;
+    double beta,alpha;
+    double sx,sxx,sxy,sy;
+    int i, idx, max=0;
+
+    /* get the number of interpoloation points for that precision */
+    if (b > 5 && b <= 18) {
+        max = MAX_INTERPOLATION_POINTS;
+    } else if (b == 5) {
+        max = PRECISION_5_MAX_INTERPOLATION_POINTS;
+    } else if (b == 4) {
+        max = PRECISION_4_MAX_INTERPOLATION_POINTS;
+    } else {
+	elog(ERROR,"ERROR: parameter b (%d) is out of range (4-18)",b);
+    }
+
+    idx = max;
+
+    /* find the index of the first interpolation point greater than the 
+     * uncorrected estimate */
+    for (i = 0; i < max; i++){
+        if (E < rawEstimateData[b-4][i]){
+            idx = i;
+            break;
+        }
+    }
+
+    /* make sure array indexes will be inbounds when getting 6 nearest data
+     * points */
+    if (idx < 3) {
+        idx = 3;
+    } else if ( idx > max - 2){
+        idx = max - 2;
+    }
+
+    /* calculate the alpha and beta needed to interpolate the error correction
+     * for E */
+    sx = rawEstimateData[b-4][idx+2] + rawEstimateData[b-4][idx+1] + rawEstimateData[b-4][idx] + rawEstimateData[b-4][idx-1] + rawEstimateData[b-4][idx-2] + rawEstimateData[b-4][idx-3];
+    sxx = rawEstimateData[b-4][idx+2]*rawEstimateData[b-4][idx+2] + rawEstimateData[b-4][idx+1]*rawEstimateData[b-4][idx+1] + rawEstimateData[b-4][idx]*rawEstimateData[b-4][idx] + rawEstimateData[b-4][idx-1]*rawEstimateData[b-4][idx-1] + rawEstimateData[b-4][idx-2]*rawEstimateData[b-4][idx-2] + rawEstimateData[b-4][idx-3]*rawEstimateData[b-4][idx-3]; 
+    sy = biasData[b-4][idx+2] + biasData[b-4][idx+1] + biasData[b-4][idx] + biasData[b-4][idx-1] + biasData[b-4][idx-2] + biasData[b-4][idx-3];
+    sxy = rawEstimateData[b-4][idx+2]*biasData[b-4][idx+2] + rawEstimateData[b-4][idx+1]*biasData[b-4][idx+1] + rawEstimateData[b-4][idx]*biasData[b-4][idx] + rawEstimateData[b-4][idx-1]*biasData[b-4][idx-1] + rawEstimateData[b-4][idx-2]*biasData[b-4][idx-2] + rawEstimateData[b-4][idx-3]*biasData[b-4][idx-3];
+    beta = (6.0*sxy - sx*sy ) / ( 6.0*sxx - sx*sx );
+    alpha = (1.0/6.0)*sy - beta*(1.0/6.0)*sx;
+
+    avg = alpha + E*beta;
+
+    return avg;
+}
+
+/* Estimates a high precision counter (bit-packed or not) with the improved
+ * raw estimator from "New cardinality estimation algorithms for HyperLogLog
+ * sketches" by Otmar Ertl (2017). It works on the histogram of the register
+ * values, registers that are 0 and those past the 64 - b bits of the hash
+ * (q + 1) are accounted for by sigma and tau, so the estimate is nearly
+ * unbiased over the whole range without linear counting or bias correction
+ * data. */
+static double
+hll_estimate_histogram(HLLCounter hloglog)
+{
+    int i, m = POW2(hloglog->b), q = HASH_LENGTH - hloglog->b;
+    int counts[HASH_LENGTH + 2] = {0};
+
+    for (i = 0; i < m; i++){
+        counts[Min(get_register(hloglog, i), q + 1)]++;
+    }
+
+    return ertl_estimate(counts, m, q);
+}
+
+/* the improved raw estimate of m registers from the histogram of their
+ * values (0 to q + 1) */
+static double
+ertl_estimate(const int * counts, int m, int q)
+{
+    double z;
+    int k;
+
+    z = m * ertl_tau(1.0 - (double) counts[q + 1] / m);
+    for (k = q; k >= 1; k--){
+        z = 0.5 * (z + counts[k]);
+    }
+    z += m * ertl_sigma((double) counts[0] / m);
+
+    return ERTL_ALPHA_INF * m * m / z;
+}
+
+/* sigma(x) = x + sum_{k>=1} x^(2^k) 2^(k-1), infinite for x = 1 (an empty
+ * counter, which makes the estimate 0) */
+static double
+ertl_sigma(double x)
+{
+    double y = 1, z = x, zprev;
+
+    if (x == 1.0){
+        return INFINITY;
+    }
+
+    do {
+        x *= x;
+        zprev = z;
+        z += x * y;
+        y += y;
+    } while (z != zprev);
+
+    return z;
+}
+
+/* tau(x) = (1 - x - sum_{k>=1} (1 - x^(2^-k))^2 2^-k) / 3 */
+static double
+ertl_tau(double x)
+{
+    double y = 1, z = 1 - x, zprev;
+
+    if (x == 0.0 || x == 1.0){
+        return 0;
+    }
+
+    do {
+        x = sqrt(x);
+        zprev = z;
+        y *= 0.5;
+        z -= (1 - x) * (1 - x) * y;
+    } while (z != zprev);
+
+    return z / 3;
+}
+
+/* Evaluates the stored encoded hashes using linear counting */
+static double 
+hll_estimate_sparse(HLLCounter hloglog)
+{
+    int i,V,m = POW2(32 - 1 - hloglog->binbits);
+    uint32_t * sparse_data;
+
+    /* sort the values so we can ignore duplicates */
+    hloglog->idx = dedupe((uint32_t *)hloglog->data,hloglog->idx);
+    sparse_data = (uint32_t *) hloglog->data;
+    
+    /* count number of unique values */
+    V = 0;
+    for (i=0; i < hloglog->idx ; i++){
+        if (i == 0){
+            V++;
+        } else if (sparse_data[i] != sparse_data[i-1]){
+            V++;
+        }
     }
 
     /* Instead of counting empty counters like we do in dense estimation with 
@@ -572,12 +1784,31 @@ hll_add_element(HLLCounter hloglog, const char * element, int elen)
 
     uint64_t hash;
 
+    HLL_STAT_INC(HLL_STAT_ADDS_SMALL + HLL_REPRESENTATION(hloglog));
+
     /* compute the hash */
     hash = MurmurHash64A(element, elen, HASH_SEED);    
 
     /* add the hash to the estimator */
+    return hll_add_hash(hloglog, hash);
+}
+
+/* Computes the register index and value of an element for a counter of the
+ * given precision and bin size, the same ones hll_add_element would set */
+void
+hll_element_register(const char * element, int elen, int8_t b, uint8_t binbits, uint32_t * idx, uint8_t * rho)
+{
+    hash_to_register(MurmurHash64A(element, elen, HASH_SEED), b, binbits, idx, rho);
+}
+
+/* Adds the hash to the counter in whichever encoding it currently uses */
+static HLLCounter
+hll_add_hash(HLLCounter hloglog, uint64_t hash)
+{
     if (hloglog->idx == -1 ){
         hloglog = hll_add_hash_dense(hloglog, hash);
+    } else if (HLL_IS_SMALL_SET(hloglog)){
+        hloglog = hll_add_hash_small(hloglog, hash);
     } else {
         hloglog = hll_add_hash_sparse(hloglog, hash);
     }
@@ -585,39 +1816,51 @@ hll_add_element(HLLCounter hloglog, const char * element, int elen)
     return hloglog;
 }
 
-/* Add the appropriate values to a dense encoded counter for a given hash */
-static HLLCounter
-hll_add_hash_dense(HLLCounter hloglog, uint64_t hash)
+/* Computes the dense register index and value for a given hash */
+static inline void
+hash_to_register(uint64_t hash, int8_t b, uint8_t binbits, uint32_t * idx, uint8_t * rho)
 {
-
-    uint64_t idx;
-    uint8_t rho,entry,addn;
+    uint8_t addn;
 
     /* get idx (keep only the first 'b' bits) */
-    idx  = hash >> (HASH_LENGTH - hloglog->b);
+    *idx  = hash >> (HASH_LENGTH - b);
 
     /* rho needs to be independent from 'idx' */
-    rho = __builtin_clzll(hash << hloglog->b) + 1;
-
-    /* We only have (64 - hloglog->b) bits leftover after the index bits
-     * however the chance that we need more is 2^-(64 - hloglog->b) which
-     * is very small. So we only compute more when needed. To do this we
-     * rehash the original hash and take the rho of the new hash and add it
-     * to the (64 - hloglog->b) bits. We can repeat this for rho up to 255.
-     * We can't go any higher since integer values >255 take more than 1 byte
-     * which is currently supported nor really necessary due to 2^(2^8) ~ 
-     * 1.16E77 a number so large its not feasible to have that many unique 
-     * elements. */
-    if (rho == HASH_LENGTH){
+    *rho = __builtin_clzll(hash << b) + 1;
+
+    /* We only have (64 - b) bits leftover after the index bits however the
+     * chance that we need more is 2^-(64 - b) which is very small. So we
+     * only compute more when needed. To do this we rehash the original hash
+     * and take the rho of the new hash and add it to the (64 - b) bits. We
+     * can repeat this for rho up to 255. We can't go any higher since
+     * integer values >255 take more than 1 byte which is currently supported
+     * nor really necessary due to 2^(2^8) ~ 1.16E77 a number so large its
+     * not feasible to have that many unique elements. */
+    if (*rho == HASH_LENGTH){
 	    addn = HASH_LENGTH;
-	    rho = (HASH_LENGTH - hloglog->b);
-	    while (addn == HASH_LENGTH && rho < POW2(hloglog->binbits)){
+	    *rho = (HASH_LENGTH - b);
+	    while (addn == HASH_LENGTH && *rho < POW2(binbits)){
 		    hash = MurmurHash64A((const char * )&hash, HASH_LENGTH/8, HASH_SEED);
             /* zero length runs should be 1 so counter gets set */
 		    addn = __builtin_clzll(hash) + 1;
-		    rho += addn;
+		    *rho += addn;
 	    }
     }
+}
+
+/* Add the appropriate values to a dense encoded counter for a given hash */
+static HLLCounter
+hll_add_hash_dense(HLLCounter hloglog, uint64_t hash)
+{
+
+    uint32_t idx;
+    uint8_t rho,entry;
+
+    hash_to_register(hash, hloglog->b, hloglog->binbits, &idx, &rho);
+
+    if (hloglog->format == NIBBLE){
+        return nibble_set_max(hloglog, idx, rho);
+    }
 
     /* keep the highest value */
     HLL_DENSE_GET_REGISTER(entry,hloglog->data,idx,hloglog->binbits);
@@ -636,20 +1879,18 @@ hll_add_hash_sparse(HLLCounter hloglog, uint64_t hash)
 {
     uint32_t encoded_hash;
     uint32_t * bigdata;
+    bool promote;
 
     bigdata = (uint32_t *) hloglog->data;
     encoded_hash = encode_hash(hash,hloglog);
 
     bigdata[hloglog->idx++] = encoded_hash;
 
-    /* If the size threshold is exceeded first we dedupe the array to guard 
-     * against situations where many duplicate elements are input into the 
-     * counter which would needlessly promote it to dense encoding sacrificing
-     * accuracy at a lower cardinality than desired. However if the dedupe 
-     * doesn't provide a reasonable reduction its should still be promoted. */
-    if (hloglog->idx > size_sparse_array(hloglog->b)){
-        hloglog->idx = dedupe((uint32_t *)hloglog->data,hloglog->idx);
-        if (hloglog->idx > size_sparse_array(hloglog->b)*7/8){
+    /* If the size threshold is exceeded the promotion policy decides whether
+     * to switch to dense encoding (see sparse_full) */
+    if (hloglog->idx > sparse_capacity(hloglog)){
+        hloglog = sparse_full(hloglog, &promote);
+        if (promote){
             hloglog = sparse_to_dense(hloglog);
         }
     }
@@ -657,6 +1898,73 @@ hll_add_hash_sparse(HLLCounter hloglog, uint64_t hash)
     return hloglog;
 }
 
+/* Inserts the hash into the sorted array of a small set unless it's already
+ * there. A full small set is moved into an allocation twice the size, once
+ * that would exceed SMALL_SET_MAX_LENGTH it's upgraded to sparse encoding
+ * and the hash is added to that instead.
+ *
+ * High precision counters append the hash instead. Like a sparse counter
+ * using the fixed policy a full set is sorted and deduped and only grows if
+ * that didn't free at least half of it, up to small_set_max_entries hashes.
+ * Once the set can't grow anymore it's promoted to dense encoding unless the
+ * dedupe freed at least 1/8 of it. Under the size policy it's promoted as
+ * soon as the hashes take more space than the compressed registers would
+ * (checked whenever the set would grow). */
+static HLLCounter
+hll_add_hash_small(HLLCounter hloglog, uint64_t hash)
+{
+    int lo = 0, hi = hloglog->idx, mid, capacity;
+
+    if (hloglog->b > MAX_INDEX_BITS){
+        capacity = small_set_capacity(hloglog);
+        if (hloglog->idx >= capacity){
+            small_set_sort(hloglog);
+            if (capacity >= small_set_max_entries(hloglog) && hloglog->idx > capacity * 7 / 8){
+                return hll_add_hash(small_set_to_sparse(hloglog), hash);
+            } else if (hloglog->idx > capacity / 2 && HLL_PROMOTES_BY_SIZE(hloglog) &&
+                       hloglog->idx * sizeof(uint64_t) > dense_compressed_size(hloglog)){
+                return hll_add_hash(small_set_to_sparse(hloglog), hash);
+            } else if (hloglog->idx > capacity / 2 && capacity < small_set_max_entries(hloglog)){
+                hloglog = sparse_grow(hloglog, Min(2 * VARSIZE_ANY(hloglog),
+                                                   sizeof(HLLData) + small_set_max_entries(hloglog) * sizeof(uint64_t)));
+            }
+        }
+
+        memcpy(hloglog->data + hloglog->idx * sizeof(uint64_t), &hash, sizeof(uint64_t));
+        hloglog->idx++;
+
+        return hloglog;
+    }
+
+    /* binary search for the first hash that isn't smaller */
+    while (lo < hi){
+        mid = (lo + hi) / 2;
+        if (small_set_get(hloglog, mid) < hash){
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+
+    if (lo < hloglog->idx && small_set_get(hloglog, lo) == hash){
+        return hloglog;
+    }
+
+    if (hloglog->idx >= small_set_capacity(hloglog)){
+        if (hloglog->idx >= SMALL_SET_MAX_ENTRIES){
+            return hll_add_hash(small_set_to_sparse(hloglog), hash);
+        }
+        hloglog = sparse_grow(hloglog, small_set_length(hloglog->idx + 1));
+    }
+
+    memmove(hloglog->data + (lo + 1) * sizeof(uint64_t), hloglog->data + lo * sizeof(uint64_t),
+            (hloglog->idx - lo) * sizeof(uint64_t));
+    memcpy(hloglog->data + lo * sizeof(uint64_t), &hash, sizeof(uint64_t));
+    hloglog->idx++;
+
+    return hloglog;
+}
+
 /* Encode the 64 bit hash to a 32 bit summary for sparse encoding and later
  *  conversion to dense encoding. The encoding scheme is as follows:
  * 
@@ -714,7 +2022,7 @@ static HLLCounter
 sparse_to_dense(HLLCounter hloglog)
 {
     HLLCounter htemp;
-    uint32_t * sparse_data;
+    const uint32_t * sparse_data;
     uint32_t idx;
     uint8_t rho,entry;
     int i, m = POW2(hloglog->b);
@@ -723,20 +2031,23 @@ sparse_to_dense(HLLCounter hloglog)
         return hloglog;
     }
 
-    /* Sparse encoded counters are smaller than dense so new space needs to be
-     *  alloced */
-    sparse_data = malloc(hloglog->idx*sizeof(uint32_t));
-    if (sparse_data == NULL)
-        ereport(ERROR,
-                (errcode(ERRCODE_OUT_OF_MEMORY),
-                 errmsg("out of memory"),
-                 errdetail("Failed on request of size %zu.", hloglog->idx*sizeof(uint32_t))));
+    HLL_STAT_INC(HLL_STAT_PROMOTIONS_DENSE);
+    TRACE_HYPERLOGLOG_PROMOTE_DENSE(hloglog->b, hloglog->idx);
+
+    if (HLL_FORMAT(hloglog) == NIBBLE){
+        return sparse_to_dense_nibble(hloglog);
+    }
 
-    memmove(sparse_data,&hloglog->data,hloglog->idx*sizeof(uint32_t));
+    /* Sparse encoded counters are smaller than dense so new (zeroed) space
+     * needs to be alloced, the sparse entries are read directly from the old
+     * counter which stays untouched */
+    sparse_data = (const uint32_t *) hloglog->data;
     htemp = palloc0(sizeof(HLLData) + (int)ceil((m * hloglog->binbits / 8.0)));
-    memcpy(htemp,hloglog,sizeof(HLLData));
+    /* only copy the header, sizeof(HLLData) would include the first sparse
+     * entry as well */
+    memcpy(htemp,hloglog,offsetof(HLLData,data));
     hloglog = htemp;
-    memset(hloglog->data,0,(int)ceil((m * hloglog->binbits / 8.0)));
+    hloglog->format = HLL_FORMAT(hloglog);
 
     for (i=0; i < hloglog->idx; i++){
         idx = sparse_data[i];
@@ -761,11 +2072,7 @@ sparse_to_dense(HLLCounter hloglog)
         }
 
     }
-    
-    if (sparse_data){
-        free(sparse_data);
-    }
-    
+
     SET_VARSIZE(hloglog,sizeof(HLLData) + (int)ceil((m * hloglog->binbits / 8.0)) );
 
     hloglog->idx = -1;
@@ -777,7 +2084,7 @@ static HLLCounter
 sparse_to_dense_unpacked(HLLCounter hloglog)
 {
 	HLLCounter htemp;
-	uint32_t * sparse_data;
+	const uint32_t * sparse_data;
 	uint32_t idx;
 	uint8_t rho;
 	int i, maxidx, m = POW2(hloglog->b);
@@ -786,28 +2093,28 @@ sparse_to_dense_unpacked(HLLCounter hloglog)
 		return hloglog;
 	}
 
-        if (hloglog->format == PACKED){
+	HLL_STAT_INC(HLL_STAT_PROMOTIONS_DENSE);
+	TRACE_HYPERLOGLOG_PROMOTE_DENSE(hloglog->b, hloglog->idx);
+
+        if (HLL_FORMAT(hloglog) == NIBBLE){
+            return sparse_to_dense_nibble(hloglog);
+        } else if (HLL_FORMAT(hloglog) == PACKED){
 	    hloglog->format = UNPACKED;
-        } else if (hloglog->format == PACKED_UNPACKED) {
+        } else if (HLL_FORMAT(hloglog) == PACKED_UNPACKED) {
             hloglog->format = UNPACKED_UNPACKED;
         } else {
            elog(ERROR,"Sparse counter should either be PACKED or PACKED_UNPACKED it is:%d",hloglog->format);
         }
 
-	/* Sparse encoded counters are smaller than dense so new space needs to be
-	*  alloced */
-	sparse_data = malloc(hloglog->idx*sizeof(uint32_t));
-	if (sparse_data == NULL)
-		ereport(ERROR,
-		(errcode(ERRCODE_OUT_OF_MEMORY),
-		errmsg("out of memory"),
-		errdetail("Failed on request of size %zu.", hloglog->idx*sizeof(uint32_t))));
-
-	memmove(sparse_data, &hloglog->data, hloglog->idx*sizeof(uint32_t));
+	/* Sparse encoded counters are smaller than dense so new (zeroed) space
+	*  needs to be alloced, the sparse entries are read directly from the old
+	*  counter which stays untouched */
+	sparse_data = (const uint32_t *) hloglog->data;
 	htemp = palloc0(sizeof(HLLData) + m);
-	memcpy(htemp, hloglog, sizeof(HLLData));
+	/* only copy the header, sizeof(HLLData) would include the first sparse
+	*  entry as well */
+	memcpy(htemp, hloglog, offsetof(HLLData, data));
 	hloglog = htemp;
-	memset(hloglog->data, 0, m);
 	maxidx = hloglog->idx;
 
 	for (i = 0; i < maxidx; i++){
@@ -827,96 +2134,605 @@ sparse_to_dense_unpacked(HLLCounter hloglog)
 			rho = __builtin_clz(sparse_data[i] << (hloglog->binbits + hloglog->b)) + 1;
 		}
 
-		/* keep the highest value */
-    	if (rho > hloglog->data[idx]) {
-			hloglog->data[idx] = rho;
-		}
+		/* keep the highest value */
+    	if (rho > hloglog->data[idx]) {
+			hloglog->data[idx] = rho;
+		}
+
+	}
+
+	SET_VARSIZE(hloglog, sizeof(HLLData) + m);
+
+	hloglog->idx = -1;
+
+	return hloglog;
+}
+
+/* Just reset the counter (set all the counters to 0). We do this by
+ * zeroing the data array */
+void 
+hll_reset_internal(HLLCounter hloglog)
+{
+
+    /* an empty small set has no hashes (rather than zero hashes) */
+    if (HLL_IS_SMALL_SET(hloglog)){
+        hloglog->idx = 0;
+    }
+    memset(hloglog->data, 0, VARSIZE_ANY(hloglog) - sizeof(HLLData) );
+
+    /* all the registers of a NIBBLE counter are at the base */
+    if (hloglog->idx == -1 && hloglog->b > 0 && hloglog->format == NIBBLE){
+        ((NibbleHeader *) hloglog->data)->zeros = POW2(hloglog->b);
+    }
+
+}
+
+/* check the equality by comparing the register values not the cardinalities */
+int
+hll_is_equal(HLLCounter counter1, HLLCounter counter2)
+{
+
+    HLLCounter counter1copy,counter2copy;
+    uint32_t * sparse_data1, *sparse_data2;
+    int i, m = POW2(counter1->b);
+
+    /* small sets are compared by the registers their hashes set as well */
+    if (HLL_IS_SMALL_SET(counter1)){
+        counter1 = hll_unpack(small_set_to_sparse(counter1));
+    }
+    if (HLL_IS_SMALL_SET(counter2)){
+        counter2 = hll_unpack(small_set_to_sparse(counter2));
+    }
+
+    /* check compatibility first */
+    if (counter1->b != counter2->b)
+        elog(ERROR, "index size (bit length) of estimators differs (%d != %d)", counter1->b, counter2->b);
+    else if (counter1->binbits != counter2->binbits)
+        elog(ERROR, "bin size of estimators differs (%d != %d)", counter1->binbits, counter2->binbits);
+
+    /* high precision counters are always dense by now and stay bit-packed,
+     * NIBBLE counters are compared in their layout as well (with the other
+     * counter promoted if it's sparse) */
+    if (counter1->b > MAX_INDEX_BITS ||
+        (counter1->idx == -1 && counter1->format == NIBBLE) || (counter2->idx == -1 && counter2->format == NIBBLE)){
+        counter1 = sparse_to_dense_unpacked(counter1);
+        counter2 = sparse_to_dense_unpacked(counter2);
+        for (i = 0; i < m; i++){
+            if (get_register(counter1, i) != get_register(counter2, i)){
+                return 0;
+            }
+        }
+        return 1;
+    }
+
+    if (((counter1->format == PACKED || counter1->format == PACKED_UNPACKED) && counter1->idx == -1) || ((counter2->format == PACKED || counter2->format == PACKED_UNPACKED) && counter2->idx == -1))
+	elog(ERROR, "Estimator(s) are not unpacked! (%d,%d)", counter1->format, counter2->format);
+
+    /* compare registers returning false on any difference */
+    if (counter1->idx == -1 && counter2->idx == -1){
+        for (i = 0; i < m; i++){
+            if (counter1->data[i] != counter2->data[i]){
+                return 0;
+            }
+        }
+    } else if (counter1->idx == -1) {
+        counter2copy = sparse_to_dense_unpacked(counter2);
+        for (i = 0; i < m; i++){
+            if (counter1->data[i] != counter2copy->data[i]){
+                return 0;
+            }
+        }
+    } else if (counter2->idx == -1) {
+        counter1copy = sparse_to_dense_unpacked(counter1);
+        for (i = 0; i < m; i++){
+            if (counter1copy->data[i] != counter2->data[i]){
+                return 0;
+            }
+        }
+    } else {
+        counter1copy = hll_copy(counter1);
+        counter2copy = hll_copy(counter2);
+        sparse_data1 = (uint32_t *) counter1copy->data;
+        sparse_data2 = (uint32_t *) counter2copy->data;
+
+        counter1copy->idx = dedupe((uint32_t *)counter1copy->data,counter1copy->idx);
+        counter2copy->idx = dedupe((uint32_t *)counter2copy->data,counter2copy->idx);
+
+        if (counter1copy->idx != counter2copy->idx){
+            return 0;
+        }
+
+        for (i=0; i < counter1copy->idx ; i++){
+            if (sparse_data1[i] != sparse_data2[i]){
+                return 0;
+            }
+        }
+
+    }
+
+    return 1;
+
+}
+
+/* Joint estimate of the items only in counter1 (only1), only in counter2
+ * (only2) and in both (both), following "New cardinality estimation
+ * algorithms for HyperLogLog sketches" by Otmar Ertl (2017). The three sets
+ * are disjoint, so under the Poisson model a register of counter1 is the
+ * maximum of independent registers of the items only in counter1 and of the
+ * items in both, and likewise for counter2. Comparing the registers of both
+ * counters gives five histograms (the values of counter1 and counter2 where
+ * counter1's is smaller, the same two where it's larger and the values where
+ * both are equal), which is all the maximum likelihood estimate needs. Unlike
+ * the inclusion-exclusion of three separate estimates the error of the
+ * intersection doesn't grow with the union, and the registers are read once
+ * without merging or copying counters.
+ *
+ * Dense registers are read in place in any layout. Sparse entries and the
+ * hashes of small sets aren't ordered by register, they're decoded into a
+ * sorted list of the registers they set (see joint_entries) whose pairs
+ * replace the zero registers they stand for.
+ *
+ * Two small sets are counted exactly from their hashes, otherwise both
+ * counters need the same precision. The counters must not be compressed
+ * (see hll_unpack), small sets are sorted in place. */
+void
+hll_joint_estimate(HLLCounter counter1, HLLCounter counter2, double * only1, double * only2, double * both)
+{
+    uint32_t * entries1, * entries2;
+    int n1, n2;
+    int counts[3][2][HASH_LENGTH + 2];
+    int i, j, k, m, q, iter, empty1 = 0, empty2 = 0;
+    double n[3], g[3], H[3][3], d[3], next[3], gnext[3], Hnext[3][3];
+    double L, Lnext, t, total;
+    double estimate1, estimate2, union_estimate;
+    int histogram1[HASH_LENGTH + 2] = {0}, histogram2[HASH_LENGTH + 2] = {0}, histogram_union[HASH_LENGTH + 2] = {0};
+
+    if (counter1->b < 0 || counter2->b < 0){
+        elog(ERROR, "joint estimate of compressed counters");
+    }
+
+    /* small sets hold every distinct hash, the intersection is exact */
+    if (HLL_IS_SMALL_SET(counter1) && HLL_IS_SMALL_SET(counter2)){
+        small_set_sort(counter1);
+        small_set_sort(counter2);
+        for (i = 0, j = 0, k = 0; i < counter1->idx && j < counter2->idx; ){
+            if (small_set_get(counter1, i) < small_set_get(counter2, j)){
+                i++;
+            } else if (small_set_get(counter2, j) < small_set_get(counter1, i)){
+                j++;
+            } else {
+                i++;
+                j++;
+                k++;
+            }
+        }
+        *only1 = counter1->idx - k;
+        *only2 = counter2->idx - k;
+        *both = k;
+        return;
+    }
+
+    if (counter1->b != counter2->b)
+        elog(ERROR, "index size (bit length) of estimators differs (%d != %d)", counter1->b, counter2->b);
+
+    m = POW2(counter1->b);
+    q = HASH_LENGTH - counter1->b;
+    /* counts[c][0] and counts[c][1] are the histograms of the registers of
+     * counter1 and counter2 where counter1's is smaller (c = 0), equal
+     * (c = 1, the two are the same) or larger (c = 2) */
+    memset(counts, 0, sizeof(counts));
+
+    if (counter1->idx == -1 && counter2->idx == -1){
+
+        /* a single branch free pass over both dense counters */
+        for (i = 0; i < m; i++){
+            joint_count(counts, joint_register(counter1, i, q), joint_register(counter2, i, q), 1);
+        }
+
+    } else if (counter1->idx == -1 || counter2->idx == -1){
+
+        /* the sparse registers are all 0 except for the listed ones */
+        if (counter1->idx == -1){
+            entries2 = joint_entries(counter2, q, &n2);
+            for (i = 0; i < m; i++){
+                joint_count(counts, joint_register(counter1, i, q), 0, 1);
+            }
+            for (i = 0; i < n2; i++){
+                k = joint_register(counter1, entries2[i] >> 8, q);
+                joint_count(counts, k, 0, -1);
+                joint_count(counts, k, entries2[i] & 0xFF, 1);
+            }
+            pfree(entries2);
+        } else {
+            entries1 = joint_entries(counter1, q, &n1);
+            for (i = 0; i < m; i++){
+                joint_count(counts, 0, joint_register(counter2, i, q), 1);
+            }
+            for (i = 0; i < n1; i++){
+                k = joint_register(counter2, entries1[i] >> 8, q);
+                joint_count(counts, 0, k, -1);
+                joint_count(counts, entries1[i] & 0xFF, k, 1);
+            }
+            pfree(entries1);
+        }
+
+    } else {
+
+        /* both lists are sorted by register, the registers in neither are
+         * 0 in both counters */
+        entries1 = joint_entries(counter1, q, &n1);
+        entries2 = joint_entries(counter2, q, &n2);
+        k = m;
+        for (i = 0, j = 0; i < n1 || j < n2; k--){
+            if (j == n2 || (i < n1 && (entries1[i] >> 8) < (entries2[j] >> 8))){
+                joint_count(counts, entries1[i++] & 0xFF, 0, 1);
+            } else if (i == n1 || (entries2[j] >> 8) < (entries1[i] >> 8)){
+                joint_count(counts, 0, entries2[j++] & 0xFF, 1);
+            } else {
+                joint_count(counts, entries1[i++] & 0xFF, entries2[j++] & 0xFF, 1);
+            }
+        }
+        joint_count(counts, 0, 0, k);
+        pfree(entries1);
+        pfree(entries2);
+    }
+
+    /* start at the inclusion-exclusion of the separate estimates, the
+     * registers of the union are the larger ones */
+    for (k = 0; k <= q + 1; k++){
+        histogram1[k] = counts[0][0][k] + counts[1][0][k] + counts[2][0][k];
+        histogram2[k] = counts[0][1][k] + counts[1][1][k] + counts[2][1][k];
+        histogram_union[k] = counts[0][1][k] + counts[1][0][k] + counts[2][0][k];
+    }
+    empty1 = (histogram1[0] == m);
+    empty2 = (histogram2[0] == m);
+    estimate1 = empty1 ? 0 : ertl_estimate(histogram1, m, q);
+    estimate2 = empty2 ? 0 : ertl_estimate(histogram2, m, q);
+
+    /* nothing in common with an empty counter */
+    if (empty1 || empty2){
+        *only1 = estimate1;
+        *only2 = estimate2;
+        *both = 0;
+        return;
+    }
+
+    /* identical registers, the estimate of the items only in one of the
+     * counters is 0 */
+    for (k = 0; k <= q + 1 && counts[0][0][k] == 0 && counts[2][0][k] == 0; k++);
+    if (k > q + 1){
+        *only1 = 0;
+        *only2 = 0;
+        *both = estimate1;
+        return;
+    }
+
+    union_estimate = ertl_estimate(histogram_union, m, q);
+    n[2] = Max(estimate1 + estimate2 - union_estimate, 0.05 * Min(estimate1, estimate2));
+    n[0] = Max(estimate1 - n[2], 0.05 * estimate1);
+    n[1] = Max(estimate2 - n[2], 0.05 * estimate2);
+
+    /* Newton's method with a line search on the logarithms of the
+     * estimates, so they stay positive and those that tend to 0 (e.g. only1
+     * when counter1 is a subset of counter2) shrink by a factor of about e
+     * per step without holding back the others. */
+    L = joint_likelihood(counts, m, q, n, g, H);
+    for (iter = 0; iter < 100; iter++){
+
+        /* gradient and Hessian by the logarithms */
+        for (i = 0; i < 3; i++){
+            for (j = 0; j < 3; j++){
+                H[i][j] *= n[i] * n[j];
+            }
+            g[i] *= n[i];
+            H[i][i] += g[i];
+        }
+
+        if (!joint_solve(H, g, d)){
+            break;
+        }
+
+        /* at most a factor of e^2 per step */
+        t = 1;
+        for (i = 0; i < 3; i++){
+            t = Min(t, 2 / fabs(d[i]));
+        }
+
+        for (j = 0; j < 40; j++, t *= 0.5){
+            for (i = 0; i < 3; i++){
+                next[i] = n[i] * exp(t * d[i]);
+            }
+            Lnext = joint_likelihood(counts, m, q, next, gnext, Hnext);
+            if (Lnext >= L){
+                break;
+            }
+        }
+        if (j == 40){
+            break;
+        }
+
+        total = next[0] + next[1] + next[2];
+        for (i = 0; i < 3 && fabs(next[i] - n[i]) <= 1e-9 * total; i++);
+
+        memcpy(n, next, sizeof(n));
+        memcpy(g, gnext, sizeof(g));
+        memcpy(H, Hnext, sizeof(H));
+        L = Lnext;
+
+        if (i == 3){
+            break;
+        }
+    }
+
+    *only1 = n[0];
+    *only2 = n[1];
+    *both = n[2];
+}
+
+/* The register 'idx' of a dense (uncompressed) counter of any layout,
+ * clamped to q + 1 (the largest value of a 64 - q bit index) */
+static inline uint8_t
+joint_register(HLLCounter hloglog, uint32_t idx, int q)
+{
+    uint8_t entry;
+
+    if (is_unpacked(hloglog)){
+        entry = (uint8_t) hloglog->data[idx];
+    } else if (hloglog->format == NIBBLE){
+        entry = nibble_get(hloglog, idx);
+    } else {
+        HLL_DENSE_GET_REGISTER(entry, hloglog->data, idx, hloglog->binbits);
+    }
+
+    return Min(entry, q + 1);
+}
+
+/* The registers set by a sparse counter or small set as a sorted list of
+ * idx << 8 | register (clamped like joint_register), one per register */
+static uint32_t *
+joint_entries(HLLCounter hloglog, int q, int * n)
+{
+    uint32_t * entries;
+    const uint32_t * sparse_data = (const uint32_t *) hloglog->data;
+    uint32_t idx;
+    uint8_t rho;
+    int i, j;
+
+    entries = palloc(Max(hloglog->idx, 1) * sizeof(uint32_t));
 
-	}
+    for (i = 0; i < hloglog->idx; i++){
+        if (HLL_IS_SMALL_SET(hloglog)){
+            hash_to_register(small_set_get(hloglog, i), hloglog->b, hloglog->binbits, &idx, &rho);
+        } else {
+            decode_sparse_entry(sparse_data[i], hloglog->b, hloglog->binbits, &idx, &rho);
+        }
+        entries[i] = idx << 8 | Min(rho, q + 1);
+    }
 
-	if (sparse_data){
-		free(sparse_data);
-	}
+    qsort(entries, hloglog->idx, sizeof(uint32_t), uint32_cmp);
 
-	SET_VARSIZE(hloglog, sizeof(HLLData) + m);
+    /* the largest value of each register comes last */
+    for (i = 0, j = 0; i < hloglog->idx; i++){
+        if (j > 0 && (entries[j - 1] >> 8) == (entries[i] >> 8)){
+            j--;
+        }
+        entries[j++] = entries[i];
+    }
 
-	hloglog->idx = -1;
+    *n = j;
+    return entries;
+}
 
-	return hloglog;
+/* Adds n pairs of registers r1 and r2 to the histograms (n may be negative
+ * to take back pairs) */
+static inline void
+joint_count(int counts[3][2][HASH_LENGTH + 2], int r1, int r2, int n)
+{
+    int c = (r1 > r2) - (r1 < r2) + 1;
+
+    counts[c][0][r1] += n;
+    counts[c][1][r2] += n;
 }
 
-/* Just reset the counter (set all the counters to 0). We do this by
- * zeroing the data array */
-void 
-hll_reset_internal(HLLCounter hloglog)
+static int
+uint32_cmp(const void * a, const void * b)
 {
+    uint32_t x = *(const uint32_t *) a;
+    uint32_t y = *(const uint32_t *) b;
 
-    memset(hloglog->data, 0, VARSIZE_ANY(hloglog) - sizeof(HLLData) );
+    return (x > y) - (x < y);
+}
+
+/* Log-likelihood of the register histograms (see hll_joint_estimate) for
+ * n = (only1, only2, both), with its gradient g and Hessian H. A register
+ * of n items is at most k with probability exp(-n rho_k), rho_k = 2^-k / m
+ * for k <= q and 0 for k = q + 1. */
+static double
+joint_likelihood(int counts[3][2][HASH_LENGTH + 2], int m, int q, const double n[3], double g[3], double H[3][3])
+{
+    double L = 0;
+    int k;
+
+    memset(g, 0, 3 * sizeof(double));
+    memset(H, 0, 9 * sizeof(double));
+
+    for (k = 0; k <= q + 1; k++){
+        /* counter1 smaller, its register is that of only1 and both, the one
+         * of counter2 that of only2 */
+        L += joint_term(counts[0][0][k], k, m, q, n[0] + n[2], 1 | 4, g, H);
+        L += joint_term(counts[0][1][k], k, m, q, n[1], 2, g, H);
+
+        /* counter1 larger */
+        L += joint_term(counts[2][0][k], k, m, q, n[0], 1, g, H);
+        L += joint_term(counts[2][1][k], k, m, q, n[1] + n[2], 2 | 4, g, H);
+
+        L += joint_equal_term(counts[1][0][k], k, m, q, n, g, H);
+    }
 
+    return L;
 }
 
-/* check the equality by comparing the register values not the cardinalities */
-int
-hll_is_equal(HLLCounter counter1, HLLCounter counter2)
+/* count * log P(register = k) of a register of s items, the derivatives are
+ * added for the estimates in mask (bit i for n[i]) whose sum is s */
+static double
+joint_term(int count, int k, int m, int q, double s, int mask, double g[3], double H[3][3])
 {
+    double rho, delta, d1, d2, L;
+    int i, j;
 
-    HLLCounter counter1copy,counter2copy;
-    uint32_t * sparse_data1, *sparse_data2;
-    int i, m = POW2(counter1->b);
+    if (count == 0){
+        return 0;
+    }
 
-    /* check compatibility first */
-    if (counter1->b != counter2->b)
-        elog(ERROR, "index size (bit length) of estimators differs (%d != %d)", counter1->b, counter2->b);
-    else if (counter1->binbits != counter2->binbits)
-        elog(ERROR, "bin size of estimators differs (%d != %d)", counter1->binbits, counter2->binbits);
-    else if (((counter1->format == PACKED || counter1->format == PACKED_UNPACKED) && counter1->idx == -1) || ((counter2->format == PACKED || counter2->format == PACKED_UNPACKED) && counter2->idx == -1))
-	elog(ERROR, "Estimator(s) are not unpacked! (%d,%d)", counter1->format, counter2->format);
+    rho = (k <= q) ? ldexp(1.0 / m, -k) : 0;
 
-    /* compare registers returning false on any difference */
-    if (counter1->idx == -1 && counter2->idx == -1){
-        for (i = 0; i < m; i++){
-            if (counter1->data[i] != counter2->data[i]){
-                return 0;
-            }
-        }
-    } else if (counter1->idx == -1) {
-        counter2copy = sparse_to_dense_unpacked(counter2);
-        for (i = 0; i < m; i++){
-            if (counter1->data[i] != counter2copy->data[i]){
-                return 0;
+    if (k == 0){
+        L = -s * rho;
+        d1 = -rho;
+        d2 = 0;
+    } else {
+        delta = ldexp(1.0 / m, -Min(k, q));
+        L = -s * rho + log(-expm1(-s * delta));
+        d1 = -rho + delta / expm1(s * delta);
+        d2 = -delta * delta / (expm1(s * delta) * -expm1(-s * delta));
+    }
+
+    for (i = 0; i < 3; i++){
+        if (mask & (1 << i)){
+            g[i] += count * d1;
+            for (j = 0; j < 3; j++){
+                if (mask & (1 << j)){
+                    H[i][j] += count * d2;
+                }
             }
         }
-    } else if (counter2->idx == -1) {
-        counter1copy = sparse_to_dense_unpacked(counter1);
-        for (i = 0; i < m; i++){
-            if (counter1copy->data[i] != counter2->data[i]){
-                return 0;
-            }
+    }
+
+    return count * L;
+}
+
+/* count * log P(both registers = k). With d_i = n_i (rho_(k-1) - rho_k)
+ * and u_i = 1 - exp(-d_i) that's
+ *
+ *   -(n_0 + n_1 + n_2) rho_k + log(u_2 + (1 - u_2) u_0 u_1)
+ *
+ * (the register of the items in both is k, or it's smaller and those of the
+ * items only in either counter are k). */
+static double
+joint_equal_term(int count, int k, int m, int q, const double n[3], double g[3], double H[3][3])
+{
+    double rho, delta, u0, u1, u2, h, h0, h1, h2, h01, L;
+    double hd[3], hdd[3][3];
+    int i, j;
+
+    if (count == 0){
+        return 0;
+    }
+
+    rho = (k <= q) ? ldexp(1.0 / m, -k) : 0;
+
+    for (i = 0; i < 3; i++){
+        g[i] -= count * rho;
+    }
+    L = -(n[0] + n[1] + n[2]) * rho;
+
+    if (k == 0){
+        return count * L;
+    }
+
+    delta = ldexp(1.0 / m, -Min(k, q));
+    u0 = -expm1(-n[0] * delta);
+    u1 = -expm1(-n[1] * delta);
+    u2 = -expm1(-n[2] * delta);
+
+    /* h and its derivatives by d_i */
+    h = u2 + (1 - u2) * u0 * u1;
+    h0 = (1 - u2) * (1 - u0) * u1;
+    h1 = (1 - u2) * u0 * (1 - u1);
+    h2 = (1 - u2) * (1 - u0 * u1);
+    h01 = (1 - u2) * (1 - u0) * (1 - u1);
+
+    hd[0] = h0;
+    hd[1] = h1;
+    hd[2] = h2;
+    hdd[0][0] = -h0;
+    hdd[1][1] = -h1;
+    hdd[2][2] = -h2;
+    hdd[0][1] = hdd[1][0] = h01;
+    hdd[0][2] = hdd[2][0] = -h0;
+    hdd[1][2] = hdd[2][1] = -h1;
+
+    for (i = 0; i < 3; i++){
+        g[i] += count * delta * hd[i] / h;
+        for (j = 0; j < 3; j++){
+            H[i][j] += count * delta * delta * (hdd[i][j] * h - hd[i] * hd[j]) / (h * h);
         }
-    } else {
-        counter1copy = hll_copy(counter1);
-        counter2copy = hll_copy(counter2);
-        sparse_data1 = (uint32_t *) counter1copy->data;
-        sparse_data2 = (uint32_t *) counter2copy->data;
+    }
 
-        counter1copy->idx = dedupe((uint32_t *)counter1copy->data,counter1copy->idx);
-        counter2copy->idx = dedupe((uint32_t *)counter2copy->data,counter2copy->idx);
+    return count * (L + log(h));
+}
 
-        if (counter1copy->idx != counter2copy->idx){
-            return 0;
+/* Solves -H d = g for the Newton step with a Cholesky decomposition of -H.
+ * If -H isn't positive definite (away from the maximum) its diagonal is
+ * increased until it is, which turns the step towards the gradient. */
+static bool
+joint_solve(double H[3][3], const double g[3], double d[3])
+{
+    double A[3][3], y[3], mu = 0, scale = 0, sum;
+    int i, j, k, attempt;
+
+    for (i = 0; i < 3; i++){
+        scale = Max(scale, fabs(H[i][i]));
+    }
+    if (!(scale > 0) || !isfinite(scale)){
+        return false;
+    }
+
+    for (attempt = 0; attempt < 60; attempt++){
+        bool ok = true;
+
+        for (i = 0; i < 3 && ok; i++){
+            for (j = 0; j <= i; j++){
+                sum = -H[i][j] + ((i == j) ? mu : 0);
+                for (k = 0; k < j; k++){
+                    sum -= A[i][k] * A[j][k];
+                }
+                if (i == j){
+                    if (!(sum > 0)){
+                        ok = false;
+                        break;
+                    }
+                    A[i][i] = sqrt(sum);
+                } else {
+                    A[i][j] = sum / A[j][j];
+                }
+            }
         }
 
-        for (i=0; i < counter1copy->idx ; i++){
-            if (sparse_data1[i] != sparse_data2[i]){
-                return 0;
+        if (ok){
+            for (i = 0; i < 3; i++){
+                sum = g[i];
+                for (k = 0; k < i; k++){
+                    sum -= A[i][k] * y[k];
+                }
+                y[i] = sum / A[i][i];
+            }
+            for (i = 2; i >= 0; i--){
+                sum = y[i];
+                for (k = i + 1; k < 3; k++){
+                    sum -= A[k][i] * d[k];
+                }
+                d[i] = sum / A[i][i];
             }
+            return true;
         }
 
+        mu = (mu == 0) ? 1e-9 * scale : 4 * mu;
     }
 
-    return 1;
-
+    return false;
 }
+
 /* Compress header function */
 HLLCounter
 hll_compress(HLLCounter hloglog)
@@ -927,176 +2743,185 @@ hll_compress(HLLCounter hloglog)
         return hloglog;
     }
 
+    HLL_STAT_INC(HLL_STAT_COMPRESS_CALLS);
+    HLL_STAT_ADD(HLL_STAT_COMPRESS_BYTES_IN, VARSIZE_ANY(hloglog));
+    TRACE_HYPERLOGLOG_COMPRESS_START(HLL_PRECISION(hloglog), HLL_REPRESENTATION(hloglog), VARSIZE_ANY(hloglog));
+
+    /* small sets are stored as they are, only the unused end of the
+     * allocation is cut off */
+    if (HLL_IS_SMALL_SET(hloglog)){
+        small_set_sort(hloglog);
+        SET_VARSIZE(hloglog, sizeof(HLLData) + hloglog->idx * sizeof(uint64_t));
+        HLL_STAT_ADD(HLL_STAT_COMPRESS_BYTES_OUT, VARSIZE_ANY(hloglog));
+        TRACE_HYPERLOGLOG_COMPRESS_DONE(HLL_PRECISION(hloglog), HLL_REPRESENTATION(hloglog), VARSIZE_ANY(hloglog));
+        return hloglog;
+    }
+
     if (hloglog->idx == -1 && hloglog->format == PACKED){
         hloglog = hll_compress_dense(hloglog);
     } else if (hloglog->idx == -1 && hloglog->format == UNPACKED){
 	hloglog = hll_compress_dense_unpacked(hloglog);
-    } else if (hloglog->format == UNPACKED_UNPACKED){
+    } else if (hloglog->idx == -1 && hloglog->format == NIBBLE){
+        hloglog = hll_compress_dense_nibble(hloglog);
+    } else if (HLL_FORMAT(hloglog) == UNPACKED_UNPACKED){
 	hloglog->format = UNPACKED;
-    } else if (hloglog->format == PACKED_UNPACKED){
+    } else if (HLL_FORMAT(hloglog) == PACKED_UNPACKED){
 	hloglog = hll_unpack(hloglog);
     } else if (hloglog->idx != -1) {
         hloglog = hll_compress_sparse(hloglog);
     }
+
+    HLL_STAT_ADD(HLL_STAT_COMPRESS_BYTES_OUT, VARSIZE_ANY(hloglog));
+    TRACE_HYPERLOGLOG_COMPRESS_DONE(HLL_PRECISION(hloglog), HLL_REPRESENTATION(hloglog), VARSIZE_ANY(hloglog));
     
     return hloglog;
 }
 
-/* Compresses dense encoded counters using lz compression */
+/* Compresses dense encoded counters using rANS entropy coding of the
+ * registers (see rans.h). The model (smallest register value and the
+ * frequencies of the register deltas) is built per counter. If the result
+ * isn't smaller than the bit-packed registers the counter is left as is. */
 static HLLCounter
 hll_compress_dense(HLLCounter hloglog)
 {
-    PGLZ_Header * dest;
-    char entry,*data;    
+    uint8_t * dest, * data;
+    char entry;
     int i, m;
+    uint32_t size, capacity;
 
-    /* make sure the dest struct has enough space for an unsuccessful 
-     * compression and a 4 bytes of overflow since lz might not recognize its
-     * over until then preventing segfaults */
+    /* the unpacked registers and the encoded output share the scratch arena
+     * (a temporary buffer for high precision counters), the output is only
+     * of use if it's smaller than the bit-packed registers */
     m = POW2(hloglog->b);
-    dest = malloc(m + sizeof(PGLZ_Header) + 4);
-    if (dest == NULL)
-        ereport(ERROR,
-                (errcode(ERRCODE_OUT_OF_MEMORY),
-                 errmsg("out of memory"),
-                 errdetail("Failed on request of size %zu.", m + sizeof(PGLZ_Header) + 4)));
-    memset(dest,0,m + sizeof(PGLZ_Header) + 4);
-    data = malloc(m);
-    if (data == NULL){
-	free(dest);
-        ereport(ERROR,
-                (errcode(ERRCODE_OUT_OF_MEMORY),
-                 errmsg("out of memory"),
-                 errdetail("Failed on request of size %d.", m)));
-    }
-
-    /* put all registers in a normal array  i.e. remove dense packing so
-     * lz compression can work optimally */
+    capacity = Min(RANS_MAX_ENCODED_SIZE(m), m * hloglog->binbits / 8);
+    data = dense_buffer(m + capacity);
+    dest = data + m;
+
+    /* put all registers in a normal array i.e. remove dense packing */
     for(i=0; i < m ; i++){
         HLL_DENSE_GET_REGISTER(entry,hloglog->data,i,hloglog->binbits);
         data[i] = entry;
     }
 
-    /* lz_compress the normalized array and copy that data into hloglog->data
+    /* encode the normalized array and copy that data into hloglog->data
      * if any compression was acheived */
-    pg_compress(data,m,dest,PGLZ_strategy_always);
-    if (VARSIZE_ANY(dest) >= (m * hloglog->binbits /8) ){
-	/* free allocated memory and return unaltered array */
-    	if (dest){
-            free(dest);
-    	}
-    	if (data){
-            free(data);
-    	}
+    size = rans_encode_registers(data,m,dest,capacity);
+    if (size == 0 || size >= (m * hloglog->binbits /8) ){
+	/* return unaltered array */
+	dense_buffer_free(data);
     	return hloglog;
     }
-    memcpy(hloglog->data,dest,VARSIZE_ANY(dest));
+    memcpy(hloglog->data,dest,size);
+    dense_buffer_free(data);
 
     /* resize the counter to only encompass the compressed data and the struct
      *  overhead*/
-    SET_VARSIZE(hloglog,sizeof(HLLData) + VARSIZE_ANY(dest) );
+    SET_VARSIZE(hloglog,sizeof(HLLData) + size);
 
     /* invert the b value so it being < 0 can be used as a compression flag */
     hloglog->b = -1 * (hloglog->b);
 
-    /* free allocated memory */
-    if (dest){
-        free(dest);
-    }
-    if (data){
-        free(data);
-    }
-
     /* return the compressed counter */
     return hloglog;
 }
 
-/* Compresses dense encoded counters using lz compression */
+/* Compresses unpacked dense encoded counters using rANS entropy coding, the
+ * registers are already one per byte so they can be encoded directly */
 static HLLCounter
 hll_compress_dense_unpacked(HLLCounter hloglog)
 {
-	PGLZ_Header * dest;
+	uint8_t * dest;
 	int m;
+	uint32_t size, capacity;
 
-	/* make sure the dest struct has enough space for an unsuccessful
-	* compression and a 4 bytes of overflow since lz might not recognize its
-	* over until then preventing segfaults */
 	m = POW2(hloglog->b);
-	dest = malloc(m + sizeof(PGLZ_Header) + 4);
-	if (dest == NULL){
-		return 0;
-	}
-	if (dest == NULL)
-		ereport(ERROR,
-			(errcode(ERRCODE_OUT_OF_MEMORY),
-			 errmsg("out of memory"),
-			 errdetail("Failed on request of size %zu.", m + sizeof(PGLZ_Header) + 4)));
-
-
-	memset(dest, 0, m + sizeof(PGLZ_Header) + 4);
-
-
-	/* lz_compress the normalized array and copy that data into hloglog->data
-	* if any compression was acheived */
-	pg_compress(hloglog->data, m, dest, PGLZ_strategy_always);
-	if (VARSIZE_ANY(dest) >= (m * hloglog->binbits / 8)){
-		/* free allocated memory and return unaltered array */
-		if (dest){
-			free(dest);
-		}
+	capacity = Min(RANS_MAX_ENCODED_SIZE(m), m * hloglog->binbits / 8);
+	dest = dense_buffer(capacity);
+
+	/* encode the registers and copy that data into hloglog->data if any
+	* compression was acheived */
+	size = rans_encode_registers((uint8_t *) hloglog->data, m, dest, capacity);
+	if (size == 0 || size >= (m * hloglog->binbits / 8)){
+		/* return unaltered array */
+		dense_buffer_free(dest);
 		return hloglog;
 	}
-	memcpy(hloglog->data, dest, VARSIZE_ANY(dest));
+	memcpy(hloglog->data, dest, size);
+	dense_buffer_free(dest);
 
 	/* resize the counter to only encompass the compressed data and the struct
 	*  overhead*/
-	SET_VARSIZE(hloglog, sizeof(HLLData) + VARSIZE_ANY(dest));
+	SET_VARSIZE(hloglog, sizeof(HLLData) + size);
 
 	/* invert the b value so it being < 0 can be used as a compression flag */
 	hloglog->b = -1 * (hloglog->b);
 	hloglog->format = PACKED;
 
-	/* free allocated memory */
-	if (dest){
-		free(dest);
-	}
-
 	/* return the compressed counter */
 	return hloglog;
 }
 
-/* Sparse compression uses group-varint encoding on a list of deltas made from
- * a sorted and deduped list of the encoded hashes. Group-varint encoding can
- * be seen in further detail in varint.h but essentially it operates on groups
- * of 4 uint32_t's to compress the chunks. Any remainders is encoded using
- * continuation bit variable length encoding.
+/* Compresses dense NIBBLE counters, the registers are unpacked into the
+ * scratch arena and encoded just like those of the other layouts (so the
+ * compressed data is the same). A counter that doesn't compress is only cut
+ * down to its exception list. */
+static HLLCounter
+hll_compress_dense_nibble(HLLCounter hloglog)
+{
+    uint8_t * data;
+    int m;
+    uint32_t size, capacity;
+    size_t length;
+
+    m = POW2(hloglog->b);
+    capacity = Min(RANS_MAX_ENCODED_SIZE(m), m * hloglog->binbits / 8);
+    data = dense_buffer(m + capacity);
+    nibble_decode(hloglog, data);
+
+    /* a counter that doesn't get smaller than the bit-packed registers or
+     * its own layout stays as it is */
+    length = NIBBLE_LENGTH(hloglog->b, ((NibbleHeader *) hloglog->data)->exceptions);
+    size = rans_encode_registers(data, m, data + m, capacity);
+    if (size == 0 || size >= (m * hloglog->binbits / 8) || size >= length - sizeof(HLLData)){
+        dense_buffer_free(data);
+        SET_VARSIZE(hloglog, length);
+        return hloglog;
+    }
+    memcpy(hloglog->data, data + m, size);
+    dense_buffer_free(data);
+
+    SET_VARSIZE(hloglog, sizeof(HLLData) + size);
+    hloglog->b = -1 * (hloglog->b);
+
+    return hloglog;
+}
+
+/* Sparse compression uses Stream VByte encoding on a list of deltas made from
+ * a sorted and deduped list of the encoded hashes. Stream VByte encoding can
+ * be seen in further detail in streamvbyte.h but essentially it stores every
+ * delta in 1-4 bytes, with the 2-bit lengths of each group of 4 deltas packed
+ * into a control byte and all control bytes stored ahead of the data bytes.
  *
  * However if this fails to produce any reduction in size the original deduped
  * and sorted list is stored and this is indicated by
  * hloglog->b = -1*(hloglog->b + MAX_INDEX_BITS)
  *
  * Using MAX_INDEX_BITS ensures no overlap in negative b values which are
- * varint encoded and those that aren't since b <= MAX_INDEX_BITS */
+ * Stream VByte encoded and those that aren't since b <= MAX_INDEX_BITS */
 static HLLCounter
 hll_compress_sparse(HLLCounter hloglog)
 {
     uint32_t out;
     uint8_t * encodes;
 
-    /* Add 80 (320 bytes) to allow for cases where group-varint doesn't reduce
-     * size. This allows enough space for worst case scenario compression */
-    uint32_t sparse_size = size_sparse_array(hloglog->b) + 80;
-
-    encodes = malloc(sparse_size*sizeof(uint32_t));
-    if (encodes == NULL)
-        ereport(ERROR,
-                (errcode(ERRCODE_OUT_OF_MEMORY),
-                 errmsg("out of memory"),
-                 errdetail("Failed on request of size %zu.", sparse_size*sizeof(uint32_t))));
-
     hloglog->idx = dedupe((uint32_t *)hloglog->data,hloglog->idx);
 
-    out = group_encode_sorted((uint32_t *)hloglog->data,hloglog->idx,encodes);
+    /* worst case scenario is every delta needing all 4 bytes, which always
+     * fits in the scratch arena */
+    Assert(SVB_MAX_ENCODED_SIZE(hloglog->idx) <= HLL_SCRATCH_SIZE);
+    encodes = (uint8_t *) hll_scratch();
+
+    out = svb_encode_sorted((uint32_t *)hloglog->data,hloglog->idx,encodes);
 
     if (out < hloglog->idx*4){
         memcpy(hloglog->data,encodes,out);
@@ -1107,10 +2932,6 @@ hll_compress_sparse(HLLCounter hloglog)
         hloglog->b = ( -1 * (hloglog->b + MAX_INDEX_BITS));
     }
 
-    if (encodes){
-        free(encodes);
-    }
-
     return hloglog;
 }
 
@@ -1122,12 +2943,19 @@ hll_decompress(HLLCounter hloglog)
     if (hloglog->b > 0) {
         return hloglog;
     }
+
+    HLL_STAT_INC(HLL_STAT_DECOMPRESS_CALLS);
+    HLL_STAT_ADD(HLL_STAT_DECOMPRESS_BYTES_IN, VARSIZE_ANY(hloglog));
+    TRACE_HYPERLOGLOG_DECOMPRESS_START(HLL_PRECISION(hloglog), HLL_REPRESENTATION(hloglog), VARSIZE_ANY(hloglog));
     
     if (hloglog->idx == -1){
         hloglog = hll_decompress_dense(hloglog);
     } else {
         hloglog = hll_decompress_sparse(hloglog);
     }
+
+    HLL_STAT_ADD(HLL_STAT_DECOMPRESS_BYTES_OUT, VARSIZE_ANY(hloglog));
+    TRACE_HYPERLOGLOG_DECOMPRESS_DONE(HLL_PRECISION(hloglog), HLL_REPRESENTATION(hloglog), VARSIZE_ANY(hloglog));
     
     return hloglog;
 }
@@ -1136,58 +2964,83 @@ hll_decompress(HLLCounter hloglog)
 static HLLCounter
 hll_decompress_dense(HLLCounter hloglog)
 {
-    char * dest;
-    int m,i;
+    uint8_t * dest;
+    int m,i,j,n;
     HLLCounter htemp;
+    RansDecoder decoder;
+
+    if (hloglog->format == NIBBLE){
+        return hll_decompress_dense_nibble(hloglog);
+    }
 
     /* reset b to positive value for calcs and to indicate data is
      * decompressed */
     hloglog->b = -1 * (hloglog->b);
-
-    /* allocate and zero an array large enough to hold all the decompressed 
-     * bins */
     m = POW2(hloglog->b);
-    dest = malloc(m);
-    if (dest == NULL)
-        ereport(ERROR,
-                (errcode(ERRCODE_OUT_OF_MEMORY),
-                 errmsg("out of memory"),
-                 errdetail("Failed on request of size %d.", m)));
-
-    memset(dest,0,m);
 
-    /* decompress the data */
-    pg_decompress((PGLZ_Header *)hloglog->data,dest);
+    if (rans_decode_init(&decoder, (uint8_t *) hloglog->data, VARSIZE_ANY(hloglog) - sizeof(HLLData),
+                         POW2(hloglog->binbits) - 1) != 0){
+        elog(ERROR, "compressed dense counter data is corrupted");
+    }
 
     /* copy the struct internals but not the data into a counter with enough 
      * space for the uncompressed data  */
     htemp = palloc(sizeof(HLLData) + (int)ceil((m * hloglog->binbits / 8.0)));
     memcpy(htemp,hloglog,sizeof(HLLData));
-    hloglog = htemp;
 
-    /* set the registers to the appropriate value based on the decompressed
-     * data */
-    for (i=0; i<m; i++){
-        HLL_DENSE_SET_REGISTER(hloglog->data,i,dest[i],hloglog->binbits);
+    /* decode the registers a block at a time into the scratch arena and set
+     * them in the new counter, every register is written by the decoder so
+     * neither needs to be zeroed */
+    dest = (uint8_t *) hll_scratch();
+    for (i = 0; i < m; i += DENSE_DECODE_BLOCK){
+        n = Min(DENSE_DECODE_BLOCK, m - i);
+        if (rans_decode_block(&decoder, dest, n) != 0){
+            elog(ERROR, "compressed dense counter data is corrupted");
+        }
+        for (j = 0; j < n; j++){
+            HLL_DENSE_SET_REGISTER(htemp->data,(i + j),dest[j],htemp->binbits);
+        }
     }
+    if (rans_decode_finish(&decoder) != 0){
+        elog(ERROR, "compressed dense counter data is corrupted");
+    }
+    hloglog = htemp;
 
     /* set the varsize to the appropriate length  */
     SET_VARSIZE(hloglog,sizeof(HLLData) + (int)ceil((m * hloglog->binbits / 8.0)) );
-    
 
-    /* free allocated memory */
-    if (dest){
-        free(dest);
+    return hloglog;
+}
+
+/* Decompresses dense NIBBLE counters, the base can only be found with all
+ * the registers decoded so they're decoded in one go (into the scratch
+ * arena, NIBBLE counters aren't high precision ones) */
+static HLLCounter
+hll_decompress_dense_nibble(HLLCounter hloglog)
+{
+    uint8_t * registers;
+    int m;
+
+    hloglog->b = -1 * (hloglog->b);
+    m = POW2(hloglog->b);
+
+    registers = dense_buffer(m);
+    if (rans_decode_registers((uint8_t *) hloglog->data, VARSIZE_ANY(hloglog) - sizeof(HLLData),
+                              registers, m, POW2(hloglog->binbits) - 1) != 0){
+        elog(ERROR, "compressed dense counter data is corrupted");
     }
 
+    hloglog = nibble_create(hloglog, registers);
+    dense_buffer_free(registers);
+
     return hloglog;
 }
 
 /* Decompresses sparse counters. To do this first the compression flag is
- * checked to see if group-varint encoding was used. If -b > MAX_BIN_BITS then
+ * checked to see if Stream VByte encoding was used. If -b > MAX_BIN_BITS then
  * no compression was used the counter was simply resized so all that needs to
  * be done is to copy the data into a fully allocated chunk of memory.
- * However, if -b < MAX_INDEX_BITS then group-varint encoding was used and the
+ * However, if -b < MAX_INDEX_BITS then Stream VByte encoding was used and the
  * bytes in hloglog->data must be decoded before being copied into a fully
  * allocated chunk of memory as well. */
 static HLLCounter
@@ -1203,17 +3056,17 @@ hll_decompress_sparse(HLLCounter hloglog)
     if (hloglog->b > MAX_INDEX_BITS){
         hloglog->b = hloglog->b - MAX_INDEX_BITS;
         
-        length = POW2(hloglog->b-2);
+        length = sparse_length(hloglog);
         htemp = palloc0(length);
         memcpy(htemp,hloglog,VARSIZE_ANY(hloglog));
         hloglog = htemp;
 
         SET_VARSIZE(hloglog,length);
     } else {
-        length = POW2(hloglog->b-2);
+        length = sparse_length(hloglog);
         htemp = palloc0(length);
         memcpy(htemp,hloglog,sizeof(HLLData));
-        group_decode_sorted((uint8_t *)hloglog->data,hloglog->idx,(uint32_t *) htemp->data);
+        svb_decode_sorted((uint8_t *)hloglog->data,hloglog->idx,(uint32_t *) htemp->data);
         hloglog = htemp;
 
         SET_VARSIZE(hloglog,length);
@@ -1221,3 +3074,291 @@ hll_decompress_sparse(HLLCounter hloglog)
     
     return hloglog;
 }
+
+/* Converts a counter to the compact header (see HLL_IS_COMPACT) in place, the
+ * varlena header, b, binbits, version, format and idx (plus 4 bytes of
+ * padding at the end) take 12 bytes in HLLData while most counters only need
+ * 3 bytes in the compact one. That's a big part of the small sets and sparse
+ * counters of a few values most tables are full of.
+ *
+ * Only the forms stored by hyperloglog_comp are converted (compressed
+ * counters, small sets and dense counters that didn't compress), anything
+ * else or a header field that doesn't fit is returned unaltered since both
+ * layouts can be read. */
+HLLCounter
+hll_compact(HLLCounter hloglog)
+{
+    uint8_t header[HLL_COMPACT_MAX_HEADER];
+    uint8_t * p = header;
+    uint8_t state, format;
+    uint32_t entries;
+    int b;
+    size_t length;
+
+    if (HLL_IS_COMPACT(hloglog)){
+        return hloglog;
+    }
+
+    if (hloglog->idx != -1 && hloglog->b < -MAX_INDEX_BITS){
+        state = HLL_COMPACT_RAW;
+        b = -1 * hloglog->b - MAX_INDEX_BITS;
+    } else if (hloglog->b < 0){
+        state = HLL_COMPACT_COMPRESSED;
+        b = -1 * hloglog->b;
+    } else if (hloglog->idx == -1 || HLL_IS_SMALL_SET(hloglog)){
+        state = HLL_COMPACT_PLAIN;
+        b = hloglog->b;
+    } else {
+        return hloglog;
+    }
+
+    /* the small set flag follows from the state and the entry count, the
+     * compact header only has 2 bits for the format (so NIBBLE counters keep
+     * the HLLData one) */
+    format = hloglog->format & ~HLL_SMALL_SET;
+    if (hloglog->version < HLL_COMPACT_VERSION || hloglog->version > HLL_COMPACT_VERSION + 3 ||
+        hloglog->binbits > 7 || b > 31 || (format & ~(HLL_FORMAT_MASK | HLL_PROMOTE_BY_SIZE)) != 0 ||
+        HLL_FORMAT(hloglog) > UNPACKED_UNPACKED){
+        return hloglog;
+    }
+
+    *p++ = HLL_COMPACT_MARKER + ((hloglog->version - HLL_COMPACT_VERSION) << 5 | state << 3 | hloglog->binbits);
+    *p++ = b << 3 | (HLL_PROMOTES_BY_SIZE(hloglog) ? 4 : 0) | HLL_FORMAT(hloglog);
+
+    /* varint of idx + 1, 7 bits per byte with the high bit set on all but the
+     * last byte */
+    entries = (uint32_t) (hloglog->idx + 1);
+    while (entries >= 0x80){
+        *p++ = (entries & 0x7F) | 0x80;
+        entries >>= 7;
+    }
+    *p++ = entries;
+
+    length = VARSIZE_ANY(hloglog) - sizeof(HLLData);
+    memmove((char *) hloglog + VARHDRSZ + (p - header), hloglog->data, length);
+    memcpy((char *) hloglog + VARHDRSZ, header, p - header);
+    SET_VARSIZE(hloglog, VARHDRSZ + (p - header) + length);
+
+    return hloglog;
+}
+
+/* Reads the fields of a compact header into the HLLData header, returns the
+ * number of header bytes following the varlena header */
+static int
+compact_read_header(HLLCounter hloglog, HLLCounter header)
+{
+    const uint8_t * start = (const uint8_t *) hloglog + VARHDRSZ;
+    const uint8_t * p = start;
+    uint8_t state;
+    uint32_t entries = 0;
+    int shift = 0;
+
+    state = (p[0] - HLL_COMPACT_MARKER) >> 3 & 0x03;
+    header->version = HLL_COMPACT_VERSION + ((p[0] - HLL_COMPACT_MARKER) >> 5);
+    header->binbits = p[0] & 0x07;
+    header->b = p[1] >> 3;
+    header->format = p[1] & 0x03;
+    if (p[1] & 0x04){
+        header->format |= HLL_PROMOTE_BY_SIZE;
+    }
+    p += 2;
+
+    do {
+        entries |= (uint32_t) (*p & 0x7F) << shift;
+        shift += 7;
+    } while (*p++ & 0x80 && shift < 35);
+    header->idx = (int32_t) entries - 1;
+
+    if (state == HLL_COMPACT_RAW){
+        header->b = -1 * (header->b + MAX_INDEX_BITS);
+    } else if (state == HLL_COMPACT_COMPRESSED){
+        header->b = -1 * header->b;
+    } else if (state != HLL_COMPACT_PLAIN){
+        elog(ERROR, "compact counter header is corrupted");
+    } else if (header->idx != -1){
+        header->format |= HLL_SMALL_SET;
+    }
+
+    return p - start;
+}
+
+/* Expands a compact counter back to a newly allocated HLLData counter, the
+ * data array is copied as is. Counters using HLLData are returned unaltered. */
+HLLCounter
+hll_expand(HLLCounter hloglog)
+{
+    HLLData header;
+    HLLCounter htemp;
+    size_t length;
+    int hlength;
+
+    if (!HLL_IS_COMPACT(hloglog)){
+        return hloglog;
+    }
+
+    hlength = compact_read_header(hloglog, &header);
+    if (VARSIZE_ANY(hloglog) < VARHDRSZ + hlength){
+        elog(ERROR, "compact counter header is corrupted");
+    }
+    length = VARSIZE_ANY(hloglog) - VARHDRSZ - hlength;
+
+    htemp = palloc0(sizeof(HLLData) + length);
+    memcpy(htemp, &header, offsetof(HLLData, data));
+    memcpy(htemp->data, (char *) hloglog + VARHDRSZ + hlength, length);
+    SET_VARSIZE(htemp, sizeof(HLLData) + length);
+
+    return htemp;
+}
+
+/* Expands only the header of a compact counter, the data array of the result
+ * is empty (and the varlena length meaningless) */
+HLLCounter
+hll_expand_header(HLLCounter hloglog)
+{
+    HLLCounter htemp;
+
+    if (!HLL_IS_COMPACT(hloglog)){
+        return hloglog;
+    }
+
+    htemp = palloc0(sizeof(HLLData));
+    compact_read_header(hloglog, htemp);
+    SET_VARSIZE(htemp, sizeof(HLLData));
+
+    return htemp;
+}
+
+/* Checks the header fields of a counter of version 4 or later (in the HLLData
+ * layout, the data layout hasn't changed since) are within range and consistent with the length of the data
+ * array, so none of the functions reads past its end. Used on counters read
+ * by hyperloglog_recv, stored counters are trusted. The registers of unpacked
+ * dense counters are checked as well since they index the exponent table.
+ * Compressed dense data is checked by the rANS decoder. */
+void
+hll_validate(HLLCounter hloglog)
+{
+    int b, i, m;
+    long length = (long) VARSIZE_ANY(hloglog) - (long) sizeof(HLLData);
+    long required;
+    bool unpacked = false, nibble = false;
+
+    b = HLL_PRECISION(hloglog);
+
+    /* high precision counters are either small sets or dense, the flags are
+     * dropped on promotion (the format of dense counters is compared as is) */
+    if (b < MIN_INDEX_BITS || b > HLL_MAX_PRECISION ||
+        (b > MAX_INDEX_BITS && hloglog->idx != -1 && !HLL_IS_SMALL_SET(hloglog)) ||
+        HLL_FORMAT(hloglog) > NIBBLE || (b > MAX_INDEX_BITS && HLL_FORMAT(hloglog) == NIBBLE) ||
+        hloglog->binbits <= MIN_BINBITS || hloglog->binbits >= MAX_BINBITS ||
+        (hloglog->format & ~(HLL_FORMAT_MASK | HLL_SMALL_SET | HLL_PROMOTE_BY_SIZE)) != 0 ||
+        (hloglog->idx == -1 && hloglog->format != HLL_FORMAT(hloglog)) ||
+        hloglog->idx < -1 || length < 0){
+        elog(ERROR, "counter header is corrupted");
+    }
+
+    /* the number of entries has to fit the sparse array the counter is
+     * decompressed into (see sparse_length), dense counters have none (the
+     * array size is negative below 6 index bits) */
+    if (HLL_IS_SMALL_SET(hloglog) ? hloglog->idx > small_set_max_entries(hloglog) :
+        HLL_PROMOTES_BY_SIZE(hloglog) ? SVB_MAX_ENCODED_SIZE((long) hloglog->idx) > HLL_SCRATCH_SIZE :
+        hloglog->idx != -1 && hloglog->idx > size_sparse_array(b)){
+        elog(ERROR, "counter header is corrupted");
+    }
+
+    m = POW2(b);
+    if (HLL_IS_SMALL_SET(hloglog)){
+        required = (hloglog->b > 0 && hloglog->idx >= 0) ? (long) hloglog->idx * sizeof(uint64_t) : -1;
+    } else if (hloglog->idx != -1 && hloglog->b < -MAX_INDEX_BITS){
+        required = (long) hloglog->idx * sizeof(uint32_t);
+    } else if (hloglog->idx != -1 && hloglog->b < 0){
+        required = ((long) hloglog->idx + 3) / 4;
+        if (required <= length){
+            required = svb_stream_size((const uint8_t *) hloglog->data, hloglog->idx);
+        }
+    } else if (hloglog->idx != -1){
+        required = (long) hloglog->idx * sizeof(uint32_t);
+    } else if (hloglog->b < 0){
+        required = 0;
+    } else if (HLL_FORMAT(hloglog) == NIBBLE){
+        required = NIBBLE_LENGTH(b, 0) - sizeof(HLLData);
+        if (required <= length){
+            required = (((NibbleHeader *) hloglog->data)->exceptions < 0) ? -1 :
+                NIBBLE_LENGTH(b, (long) ((NibbleHeader *) hloglog->data)->exceptions) - sizeof(HLLData);
+        }
+        nibble = true;
+    } else if (HLL_FORMAT(hloglog) == UNPACKED || HLL_FORMAT(hloglog) == UNPACKED_UNPACKED){
+        required = m;
+        unpacked = true;
+    } else {
+        required = (long) ceil(m * hloglog->binbits / 8.0);
+    }
+
+    if (required < 0 || required > length){
+        elog(ERROR, "counter data is corrupted");
+    }
+
+    if (unpacked){
+        for (i = 0; i < m; i++){
+            if ((uint8_t) hloglog->data[i] >= POW2(hloglog->binbits)){
+                elog(ERROR, "counter data is corrupted");
+            }
+        }
+    }
+
+    if (nibble && !nibble_check(hloglog)){
+        elog(ERROR, "counter data is corrupted");
+    }
+
+    /* rANS only checks the stream itself, the registers it decodes to are
+     * checked like those of an uncompressed counter */
+    if (hloglog->idx == -1 && hloglog->b < 0){
+        HLLCounter decompressed = hll_decompress(hll_copy(hloglog));
+        hll_validate(decompressed);
+        pfree(decompressed);
+    }
+
+    /* sparse entries have to decode to a register value that fits binbits
+     * (the hashes of a small set always do) */
+    if (hloglog->idx > 0 && !HLL_IS_SMALL_SET(hloglog)){
+        const uint32_t * entries = (const uint32_t *) hloglog->data;
+        uint32_t idx;
+        uint8_t rho;
+
+        if (hloglog->b < 0 && hloglog->b >= -MAX_INDEX_BITS){
+            svb_decode_sorted((const uint8_t *) hloglog->data, hloglog->idx, (uint32_t *) hll_scratch());
+            entries = (const uint32_t *) hll_scratch();
+        }
+
+        for (i = 0; i < hloglog->idx; i++){
+            if (!(entries[i] & 1) && (entries[i] << (hloglog->binbits + b)) == 0){
+                elog(ERROR, "counter data is corrupted");
+            }
+            decode_sparse_entry(entries[i], b, hloglog->binbits, &idx, &rho);
+            if (rho >= POW2(hloglog->binbits)){
+                elog(ERROR, "counter data is corrupted");
+            }
+        }
+    }
+}
+
+/* Returns a buffer of 'size' bytes for the dense compression code and the
+ * small set merge, the scratch arena unless it's too small (the registers of
+ * high precision counters), in which case it's allocated */
+static uint8_t *
+dense_buffer(size_t size)
+{
+    if (size <= HLL_SCRATCH_SIZE){
+        return (uint8_t *) hll_scratch();
+    }
+
+    return palloc(size);
+}
+
+/* Releases a buffer returned by dense_buffer */
+static void
+dense_buffer_free(uint8_t * buffer)
+{
+    if (buffer != (uint8_t *) hll_scratch()){
+        pfree(buffer);
+    }
+}
@@ -26,7 +26,11 @@
  * MIN_INDEX_BITS no real sense in being as inaccurate as <4 values would be
  * (>35%)
  *
- * MAX_INDEX_BITS error correction data only goes up to 18
+ * MAX_INDEX_BITS error correction data and the 32 bit sparse encoding only
+ * go up to 18
+ *
+ * HLL_MAX_PRECISION the largest precision of a counter, precisions above
+ * MAX_INDEX_BITS make high precision counters (see below)
  *
  * HASH_LENGTH the version of MurmurHash we use produces 64 bit hashes 
  *
@@ -46,10 +50,26 @@
  * 1 - Sparse encoding added for low cardinalities. Improves accuracy and
  * storage for low cardinalities.
  *
- * 2 - Sparse compression added. */
+ * 2 - Sparse compression added.
+ *
+ * 3 - Sparse compression switched from group varint to the Stream VByte
+ * layout (control bytes stored ahead of the data bytes) allowing SIMD
+ * decoding.
+ *
+ * 4 - Dense compression switched from lz compression to rANS entropy coding
+ * of the registers with a per counter model.
+ *
+ * 5 - Small sets added for the lowest cardinalities. New counters keep the
+ * full 64 bit hashes (exact counts) until they're upgraded to sparse
+ * encoding.
+ *
+ * 6 - Compact header added for stored counters. hyperloglog_comp (and so the
+ * aggregates) replaces the 12 byte header with 2 bytes and a varint entry
+ * count, counters are expanded back to HLLData when read. */
 #define ERROR_CONST  1.0816
 #define MIN_INDEX_BITS 4
 #define MAX_INDEX_BITS 18
+#define HLL_MAX_PRECISION 26
 #define MIN_BINBITS 4
 #define MAX_BINBITS 8
 #define HASH_LENGTH 64
@@ -57,11 +77,157 @@
 #define MAX_INTERPOLATION_POINTS 200
 #define PRECISION_5_MAX_INTERPOLATION_POINTS 159
 #define PRECISION_4_MAX_INTERPOLATION_POINTS 79
-#define STRUCT_VERSION 2
+#define STRUCT_VERSION 6
 #define PACKED 0
 #define PACKED_UNPACKED 1
 #define UNPACKED 2
 #define UNPACKED_UNPACKED 3
+#define NIBBLE 4
+
+/* Dense registers of NIBBLE counters are 4 bit offsets from a base value
+ * shared by all of them (like the registers of Druid's HLL), which is half
+ * of the unpacked size and 2/3 of the bit-packed one. The data array holds a
+ * NibbleHeader, the 2^b nibbles (two per byte, the even register in the low
+ * nibble) and the sorted exception list of the registers that are at least
+ * NIBBLE_EXCEPTION above the base, whose nibble is NIBBLE_EXCEPTION and whose
+ * value is kept in the list as register index << 8 | value.
+ *
+ * The base is raised (and every nibble lowered) as soon as no register is
+ * left at the base, so the offsets stay small and exceptions are rare. The
+ * counters are merged, estimated and compressed without unpacking them, and
+ * hll_unpack leaves them in this layout. High precision counters are always
+ * bit-packed, stored NIBBLE counters keep the HLLData header (the compact one
+ * has no room for the format). */
+#define NIBBLE_EXCEPTION 15
+
+typedef struct NibbleHeader {
+
+    /* value of a zero nibble, no register is below it */
+    uint8_t base;
+    uint8_t unused[3];
+
+    /* number of registers at the base */
+    int32_t zeros;
+
+    /* number of entries in the exception list */
+    int32_t exceptions;
+
+} NibbleHeader;
+
+#define NIBBLE_LENGTH(b, exceptions) (sizeof(HLLData) + sizeof(NibbleHeader) + POW2(b) / 2 + (exceptions) * sizeof(uint32_t))
+
+/* The low bits of the format field hold one of the formats above, the high
+ * bit flags sparse counters that are promoted to dense encoding by comparing
+ * the compressed sizes (see hll_promotion_policy). The flag is dropped on
+ * promotion.
+ *
+ * The next bit flags small sets, whose data is the sorted array of the idx
+ * distinct 64 bit hashes added so far. Small sets are never compressed (b
+ * stays positive) and are upgraded to sparse encoding once they outgrow
+ * their largest allocation, which clears the flag. */
+#define HLL_FORMAT_MASK 0x07
+#define HLL_SMALL_SET 0x40
+#define HLL_PROMOTE_BY_SIZE 0x80
+#define HLL_FORMAT(h) ((h)->format & HLL_FORMAT_MASK)
+#define HLL_IS_SMALL_SET(h) (((h)->format & HLL_SMALL_SET) != 0)
+#define HLL_PROMOTES_BY_SIZE(h) (((h)->format & HLL_PROMOTE_BY_SIZE) != 0)
+
+/* Compact header of stored counters (see hll_compact). Its first byte takes
+ * the place of b, which is always within -2*MAX_INDEX_BITS..HLL_MAX_PRECISION
+ * (-HLL_MAX_PRECISION for compressed dense counters), so a first byte in
+ * 0x40..0xBF marks the compact layout
+ *
+ *   byte 0 - HLL_COMPACT_MARKER + ((version - HLL_COMPACT_VERSION) << 5 |
+ *            state << 3 | binbits)
+ *   byte 1 - precision << 3 | promote by size << 2 | format
+ *   varint - idx + 1 (so 0 for dense counters)
+ *
+ * followed by the data array. The state is one of the HLL_COMPACT_* values
+ * below, small sets are the plain counters with an entry count. */
+#define HLL_COMPACT_VERSION 6
+#define HLL_COMPACT_MARKER 0x40
+#define HLL_COMPACT_MAX_HEADER 7
+#define HLL_COMPACT_PLAIN 0
+#define HLL_COMPACT_COMPRESSED 1
+#define HLL_COMPACT_RAW 2
+#define HLL_IS_COMPACT(h) ((uint8_t)(((uint8_t *)(h))[VARHDRSZ] - HLL_COMPACT_MARKER) < 0x80)
+
+/* sparse to dense promotion policies
+ *
+ * HLL_PROMOTION_FIXED - promote once the sparse array holds more than 7/8 of
+ * size_sparse_array(b) distinct entries (a 4KB allocation for b=14)
+ *
+ * HLL_PROMOTION_SIZE - promote once the compressed sparse counter would be
+ * larger than the compressed dense one, the sparse array starts small and
+ * grows (past size_sparse_array(b) if need be) as long as it isn't */
+#define HLL_PROMOTION_FIXED 0
+#define HLL_PROMOTION_SIZE 1
+
+/* Precision of a counter whether it's compressed or not. Compressed sparse
+ * counters stored without Stream VByte encoding use -(b + MAX_INDEX_BITS),
+ * compressed dense counters always use -b. */
+#define HLL_PRECISION(h) ((h)->b > 0 ? (h)->b : \
+    ((h)->idx != -1 && -(h)->b > MAX_INDEX_BITS ? -(h)->b - MAX_INDEX_BITS : -(h)->b))
+
+/* High precision counters (precision above MAX_INDEX_BITS, for error rates
+ * below about 0.2%) have no bias correction data and 2^b registers can't be
+ * addressed by the 25 bit index of the 32 bit sparse encoding. Instead
+ *
+ * - the small set is their sparse encoding, it keeps the 64 bit hashes (so
+ *   counts are exact) until it would be as large as the bit-packed registers
+ *   and is promoted to dense encoding directly. The hashes are appended and
+ *   only sorted (and deduped) when the allocation fills up or the set is
+ *   read, so a set of a million hashes doesn't have to be kept in order.
+ *
+ * - dense counters stay bit-packed, hll_unpack only decompresses them and
+ *   merges, comparisons and estimates read the packed registers, so a
+ *   precision 24 counter takes 12MB instead of 16MB and a merge doesn't
+ *   allocate a second copy of the registers
+ *
+ * - the estimate is the improved raw estimator of Ertl (see
+ *   hll_estimate_histogram), which only needs the histogram of the
+ *   registers */
+#define HLL_IS_HIGH_PRECISION(h) (HLL_PRECISION(h) > MAX_INDEX_BITS)
+
+/* per backend counters of what the engine does (see hll_stats), the merges
+ * are counted for every pair of small set, sparse and dense counters */
+typedef enum HLLStat {
+    HLL_STAT_ADDS_SMALL,
+    HLL_STAT_ADDS_SPARSE,
+    HLL_STAT_ADDS_DENSE,
+    HLL_STAT_MERGES_SMALL_SMALL,
+    HLL_STAT_MERGES_SMALL_SPARSE,
+    HLL_STAT_MERGES_SMALL_DENSE,
+    HLL_STAT_MERGES_SPARSE_SMALL,
+    HLL_STAT_MERGES_SPARSE_SPARSE,
+    HLL_STAT_MERGES_SPARSE_DENSE,
+    HLL_STAT_MERGES_DENSE_SMALL,
+    HLL_STAT_MERGES_DENSE_SPARSE,
+    HLL_STAT_MERGES_DENSE_DENSE,
+    HLL_STAT_MERGES_COMPRESSED,
+    HLL_STAT_PROMOTIONS_SPARSE,
+    HLL_STAT_PROMOTIONS_DENSE,
+    HLL_STAT_COMPRESS_CALLS,
+    HLL_STAT_COMPRESS_BYTES_IN,
+    HLL_STAT_COMPRESS_BYTES_OUT,
+    HLL_STAT_DECOMPRESS_CALLS,
+    HLL_STAT_DECOMPRESS_BYTES_IN,
+    HLL_STAT_DECOMPRESS_BYTES_OUT,
+    HLL_STAT_DEDUPE_CALLS,
+    HLL_STAT_DEDUPE_SORTS,
+    HLL_STAT_UPGRADES,
+    HLL_NUM_STATS
+} HLLStat;
+
+/* 0 for small sets, 1 for sparse and 2 for dense counters, the order of the
+ * HLL_STAT_ADDS_* and HLL_STAT_MERGES_* counters */
+#define HLL_REPRESENTATION(h) (HLL_IS_SMALL_SET(h) ? 0 : ((h)->idx == -1 ? 2 : 1))
+
+#define HLL_STAT_ADD(stat, n) (hll_stats[stat] += (n))
+#define HLL_STAT_INC(stat) HLL_STAT_ADD(stat, 1)
+
+/* true for counters in the fixed size representation (see hll_fixed) */
+#define HLL_IS_FIXED(h) ((h)->b > 0 && (h)->idx == -1 && ((h)->format == PACKED || (h)->format == UNPACKED))
 
 #define HLL_DENSE_GET_REGISTER(target,p,regnum,hll_bits) do { \
     uint8_t *_p = (uint8_t*) p; \
@@ -123,6 +289,16 @@ typedef struct HLLData {
 
 typedef HLLData * HLLCounter;
 
+/* promotion policy of newly created counters (HLL_PROMOTION_FIXED or
+ * HLL_PROMOTION_SIZE), set by the hyperloglog.promotion GUC */
+extern int hll_promotion_policy;
+
+/* The engine counters (indexed by HLLStat) and their names, plain increments
+ * of a per backend array so they're cheap enough for the hot paths. They're
+ * read by hyperloglog_stats() and cleared by hyperloglog_stats_reset(). */
+extern uint64_t hll_stats[HLL_NUM_STATS];
+extern const char * const hll_stat_names[HLL_NUM_STATS];
+
 /* ---------------------- function declarations ------------------------ */
 
 /* creates an optimal bitmap able to count a multiset with the expected
@@ -136,6 +312,11 @@ int hll_get_size(double ndistinct, float error);
 /* Compares the bucket values of two counters to test for equality */
 int hll_is_equal(HLLCounter counter1, HLLCounter counter2);
 
+/* Estimates the items only in counter1, only in counter2 and in both with a
+ * joint maximum likelihood estimate of the registers of both counters (the
+ * counters must not be compressed, see hll_unpack) */
+void hll_joint_estimate(HLLCounter counter1, HLLCounter counter2, double * only1, double * only2, double * both);
+
 /* Returns a copy of the counter */
 HLLCounter hll_copy(HLLCounter counter);
 
@@ -143,9 +324,27 @@ HLLCounter hll_copy(HLLCounter counter);
  * counter1 or completely new copy. */
 HLLCounter hll_merge(HLLCounter counter1, HLLCounter counter2);
 
+/* Merges two counters like hll_merge, but two compressed sparse counters are
+ * merged without decompressing them and the result stays compressed. */
+HLLCounter hll_merge_compressed(HLLCounter counter1, HLLCounter counter2);
+
+/* Converts a counter into the fixed size representation (dense, uncompressed
+ * and either PACKED or UNPACKED) whose size only depends on the precision. */
+HLLCounter hll_fixed(HLLCounter hloglog, uint8_t format);
+
+/* Merges the second counter into the fixed size counter in place. */
+HLLCounter hll_upsert(HLLCounter fixed, HLLCounter hloglog);
+
+/* Sets the sparse to dense promotion policy of the counter in place (no-op for
+ * dense counters). */
+HLLCounter hll_set_promotion(HLLCounter hloglog, int policy);
+
 /* add element existence */
 HLLCounter hll_add_element(HLLCounter hloglog, const char * element, int elen);
 
+/* register index and value an element maps to (what hll_add_element sets) */
+void hll_element_register(const char * element, int elen, int8_t b, uint8_t binbits, uint32_t * idx, uint8_t * rho);
+
 /* get an estimate from the hyperloglog counter */
 double hll_estimate(HLLCounter hloglog);
 
@@ -157,4 +356,15 @@ HLLCounter hll_compress(HLLCounter hloglog);
 HLLCounter hll_decompress(HLLCounter hloglog);
 HLLCounter hll_unpack(HLLCounter hloglog);
 
+/* conversion of compressed counters (and small sets) to the compact header
+ * used for storage and back, hll_expand_header only reads the header so it
+ * can be used on a header slice */
+HLLCounter hll_compact(HLLCounter hloglog);
+HLLCounter hll_expand(HLLCounter hloglog);
+HLLCounter hll_expand_header(HLLCounter hloglog);
+
+/* checks that a counter read from outside (version 4 or later) is
+ * consistent, errors out otherwise */
+void hll_validate(HLLCounter hloglog);
+
 #endif // #ifndef _HYPERLOGLOG_H_
@@ -6,24 +6,77 @@
 
 #include "postgres.h"
 #include "fmgr.h"
+#include "funcapi.h"
 #include "utils/builtins.h"
+#include "utils/array.h"
+#include "catalog/pg_type.h"
 #include "utils/bytea.h"
 #include "utils/lsyscache.h"
+#include "utils/guc.h"
+#include "utils/timestamp.h"
 #include "lib/stringinfo.h"
 #include "libpq/pqformat.h"
+#if PG_VERSION_NUM >= 90300
+#include "access/htup_details.h"
+#endif
+#if PG_VERSION_NUM >= 130000
+#include "access/detoast.h"
+#else
+#include "access/tuptoaster.h"
+#endif
 
 #include "hyperloglog.h"
+#include "hllutils.h"
 #include "upgrade.h"
 #include "encoding.h"
+#include "sliding.h"
+#include "ultraloglog.h"
+#include "theta.h"
 
 #ifdef PG_MODULE_MAGIC
 PG_MODULE_MAGIC;
 #endif
 
+void _PG_init(void);
+
+/* hyperloglog.output_wrap GUC, breaks the text output into lines */
+static bool hll_output_wrap = true;
+
+#if PG_VERSION_NUM >= 80400
+/* values of the hyperloglog.promotion GUC */
+static const struct config_enum_entry promotion_options[] = {
+    {"fixed", HLL_PROMOTION_FIXED, false},
+    {"size", HLL_PROMOTION_SIZE, false},
+    {NULL, 0, false}
+};
+#endif
+
 /* PG_GETARG macros for HLLCounter's that does version checking */
 #define PG_GETARG_HLL_P(n) pg_check_hll_version((HLLCounter) PG_GETARG_BYTEA_P(n))
 #define PG_GETARG_HLL_P_COPY(n) pg_check_hll_version((HLLCounter) PG_GETARG_BYTEA_P_COPY(n))
 
+/* PG_GETARG macro for functions that only need the header fields of the
+ * counter, only the first bytes are detoasted (so just the first chunk is read
+ * for counters stored out of line). The data array must not be accessed and
+ * VARSIZE is the size of the slice, use toast_raw_datum_size() for the size of
+ * the counter. The slice also covers the longest compact header. */
+#define HLL_HEADER_SLICE (offsetof(HLLData, data) - VARHDRSZ)
+#define PG_GETARG_HLL_HEADER_P(n) hll_expand_header((HLLCounter) PG_DETOAST_DATUM_SLICE(PG_GETARG_DATUM(n), 0, HLL_HEADER_SLICE))
+
+/* PG_GETARG macros for sliding window counters */
+#define PG_GETARG_SLIDING_P(n) ((SlidingHLL) PG_GETARG_BYTEA_P(n))
+#define PG_GETARG_SLIDING_P_COPY(n) ((SlidingHLL) PG_GETARG_BYTEA_P_COPY(n))
+
+/* PG_GETARG macros for UltraLogLog counters */
+#define PG_GETARG_ULTRA_P(n) ((UltraHLL) PG_GETARG_BYTEA_P(n))
+#define PG_GETARG_ULTRA_P_COPY(n) ((UltraHLL) PG_GETARG_BYTEA_P_COPY(n))
+
+/* PG_GETARG macros for theta sketches, the header one only detoasts the
+ * fields in front of the hashes (see HLL_HEADER_SLICE) */
+#define PG_GETARG_THETA_P(n) ((ThetaSketch) PG_GETARG_BYTEA_P(n))
+#define PG_GETARG_THETA_P_COPY(n) ((ThetaSketch) PG_GETARG_BYTEA_P_COPY(n))
+#define PG_GETARG_THETA_HEADER_P(n) ((ThetaSketch) PG_DETOAST_DATUM_SLICE(PG_GETARG_DATUM(n), 0, offsetof(ThetaSketchData, data) - VARHDRSZ))
+
 /* shoot for 2^64 distinct items and 0.8125% error rate by default */
 #define DEFAULT_NDISTINCT   1ULL << 63 
 #define DEFAULT_ERROR       0.008125
@@ -49,6 +102,7 @@ PG_FUNCTION_INFO_V1(hyperloglog_size_error);
 PG_FUNCTION_INFO_V1(hyperloglog_size);
 PG_FUNCTION_INFO_V1(hyperloglog_reset);
 PG_FUNCTION_INFO_V1(hyperloglog_length);
+PG_FUNCTION_INFO_V1(hyperloglog_precision);
 
 PG_FUNCTION_INFO_V1(hyperloglog_in);
 PG_FUNCTION_INFO_V1(hyperloglog_out);
@@ -60,6 +114,9 @@ PG_FUNCTION_INFO_V1(hyperloglog_decomp);
 PG_FUNCTION_INFO_V1(hyperloglog_update);
 PG_FUNCTION_INFO_V1(hyperloglog_info);
 PG_FUNCTION_INFO_V1(hyperloglog_info_noargs);
+PG_FUNCTION_INFO_V1(hyperloglog_info_record);
+PG_FUNCTION_INFO_V1(hyperloglog_stats);
+PG_FUNCTION_INFO_V1(hyperloglog_stats_reset);
 
 
 PG_FUNCTION_INFO_V1(hyperloglog_equal);
@@ -68,8 +125,51 @@ PG_FUNCTION_INFO_V1(hyperloglog_union);
 PG_FUNCTION_INFO_V1(hyperloglog_intersection);
 PG_FUNCTION_INFO_V1(hyperloglog_compliment);
 PG_FUNCTION_INFO_V1(hyperloglog_symmetric_diff);
+PG_FUNCTION_INFO_V1(hyperloglog_jaccard);
+PG_FUNCTION_INFO_V1(hyperloglog_containment);
 
 PG_FUNCTION_INFO_V1(hyperloglog_unpack);
+PG_FUNCTION_INFO_V1(hyperloglog_fixed);
+PG_FUNCTION_INFO_V1(hyperloglog_fixed_format);
+PG_FUNCTION_INFO_V1(hyperloglog_upsert);
+PG_FUNCTION_INFO_V1(hyperloglog_promotion);
+
+PG_FUNCTION_INFO_V1(hyperloglog_sliding_init);
+PG_FUNCTION_INFO_V1(hyperloglog_sliding_add);
+PG_FUNCTION_INFO_V1(hyperloglog_sliding_add_agg);
+PG_FUNCTION_INFO_V1(hyperloglog_sliding_merge);
+PG_FUNCTION_INFO_V1(hyperloglog_sliding_comp);
+PG_FUNCTION_INFO_V1(hyperloglog_sliding_estimate);
+PG_FUNCTION_INFO_V1(hyperloglog_sliding_counter);
+PG_FUNCTION_INFO_V1(hyperloglog_sliding_in);
+PG_FUNCTION_INFO_V1(hyperloglog_sliding_out);
+PG_FUNCTION_INFO_V1(hyperloglog_sliding_recv);
+PG_FUNCTION_INFO_V1(hyperloglog_sliding_send);
+
+PG_FUNCTION_INFO_V1(hyperloglog_ultra_init);
+PG_FUNCTION_INFO_V1(hyperloglog_ultra_add);
+PG_FUNCTION_INFO_V1(hyperloglog_ultra_add_agg);
+PG_FUNCTION_INFO_V1(hyperloglog_ultra_merge);
+PG_FUNCTION_INFO_V1(hyperloglog_ultra_comp);
+PG_FUNCTION_INFO_V1(hyperloglog_ultra_get_estimate);
+PG_FUNCTION_INFO_V1(hyperloglog_ultra_counter);
+PG_FUNCTION_INFO_V1(hyperloglog_ultra_from_counter);
+PG_FUNCTION_INFO_V1(hyperloglog_ultra_in);
+PG_FUNCTION_INFO_V1(hyperloglog_ultra_out);
+PG_FUNCTION_INFO_V1(hyperloglog_ultra_recv);
+PG_FUNCTION_INFO_V1(hyperloglog_ultra_send);
+PG_FUNCTION_INFO_V1(hyperloglog_theta_init);
+PG_FUNCTION_INFO_V1(hyperloglog_theta_add);
+PG_FUNCTION_INFO_V1(hyperloglog_theta_add_agg);
+PG_FUNCTION_INFO_V1(hyperloglog_theta_merge);
+PG_FUNCTION_INFO_V1(hyperloglog_theta_intersect);
+PG_FUNCTION_INFO_V1(hyperloglog_theta_a_not_b);
+PG_FUNCTION_INFO_V1(hyperloglog_theta_comp);
+PG_FUNCTION_INFO_V1(hyperloglog_theta_estimate);
+PG_FUNCTION_INFO_V1(hyperloglog_theta_in);
+PG_FUNCTION_INFO_V1(hyperloglog_theta_out);
+PG_FUNCTION_INFO_V1(hyperloglog_theta_recv);
+PG_FUNCTION_INFO_V1(hyperloglog_theta_send);
 
 /* ------------- function declarations for local functions --------------- */
 Datum hyperloglog_add_item(PG_FUNCTION_ARGS);
@@ -92,6 +192,7 @@ Datum hyperloglog_init_error(PG_FUNCTION_ARGS);
 Datum hyperloglog_init(PG_FUNCTION_ARGS);
 Datum hyperloglog_reset(PG_FUNCTION_ARGS);
 Datum hyperloglog_length(PG_FUNCTION_ARGS);
+Datum hyperloglog_precision(PG_FUNCTION_ARGS);
 
 Datum hyperloglog_in(PG_FUNCTION_ARGS);
 Datum hyperloglog_out(PG_FUNCTION_ARGS);
@@ -103,6 +204,9 @@ Datum hyperloglog_decomp(PG_FUNCTION_ARGS);
 Datum hyperloglog_update(PG_FUNCTION_ARGS);
 Datum hyperloglog_info(PG_FUNCTION_ARGS);
 Datum hyperloglog_info_noargs(PG_FUNCTION_ARGS);
+Datum hyperloglog_info_record(PG_FUNCTION_ARGS);
+Datum hyperloglog_stats(PG_FUNCTION_ARGS);
+Datum hyperloglog_stats_reset(PG_FUNCTION_ARGS);
 
 Datum hyperloglog_equal(PG_FUNCTION_ARGS);
 Datum hyperloglog_not_equal(PG_FUNCTION_ARGS);
@@ -110,22 +214,176 @@ Datum hyperloglog_union(PG_FUNCTION_ARGS);
 Datum hyperloglog_intersection(PG_FUNCTION_ARGS);
 Datum hyperloglog_compliment(PG_FUNCTION_ARGS);
 Datum hyperloglog_symmetric_diff(PG_FUNCTION_ARGS);
+Datum hyperloglog_jaccard(PG_FUNCTION_ARGS);
+Datum hyperloglog_containment(PG_FUNCTION_ARGS);
 
 Datum hyperloglog_unpack(PG_FUNCTION_ARGS);
+Datum hyperloglog_fixed(PG_FUNCTION_ARGS);
+Datum hyperloglog_fixed_format(PG_FUNCTION_ARGS);
+Datum hyperloglog_upsert(PG_FUNCTION_ARGS);
+Datum hyperloglog_promotion(PG_FUNCTION_ARGS);
+
+Datum hyperloglog_sliding_init(PG_FUNCTION_ARGS);
+Datum hyperloglog_sliding_add(PG_FUNCTION_ARGS);
+Datum hyperloglog_sliding_add_agg(PG_FUNCTION_ARGS);
+Datum hyperloglog_sliding_merge(PG_FUNCTION_ARGS);
+Datum hyperloglog_sliding_comp(PG_FUNCTION_ARGS);
+Datum hyperloglog_sliding_estimate(PG_FUNCTION_ARGS);
+Datum hyperloglog_sliding_counter(PG_FUNCTION_ARGS);
+Datum hyperloglog_sliding_in(PG_FUNCTION_ARGS);
+Datum hyperloglog_sliding_out(PG_FUNCTION_ARGS);
+Datum hyperloglog_sliding_recv(PG_FUNCTION_ARGS);
+Datum hyperloglog_sliding_send(PG_FUNCTION_ARGS);
+
+Datum hyperloglog_ultra_init(PG_FUNCTION_ARGS);
+Datum hyperloglog_ultra_add(PG_FUNCTION_ARGS);
+Datum hyperloglog_ultra_add_agg(PG_FUNCTION_ARGS);
+Datum hyperloglog_ultra_merge(PG_FUNCTION_ARGS);
+Datum hyperloglog_ultra_comp(PG_FUNCTION_ARGS);
+Datum hyperloglog_ultra_get_estimate(PG_FUNCTION_ARGS);
+Datum hyperloglog_ultra_counter(PG_FUNCTION_ARGS);
+Datum hyperloglog_ultra_from_counter(PG_FUNCTION_ARGS);
+Datum hyperloglog_ultra_in(PG_FUNCTION_ARGS);
+Datum hyperloglog_ultra_out(PG_FUNCTION_ARGS);
+Datum hyperloglog_ultra_recv(PG_FUNCTION_ARGS);
+Datum hyperloglog_ultra_send(PG_FUNCTION_ARGS);
+Datum hyperloglog_theta_init(PG_FUNCTION_ARGS);
+Datum hyperloglog_theta_add(PG_FUNCTION_ARGS);
+Datum hyperloglog_theta_add_agg(PG_FUNCTION_ARGS);
+Datum hyperloglog_theta_merge(PG_FUNCTION_ARGS);
+Datum hyperloglog_theta_intersect(PG_FUNCTION_ARGS);
+Datum hyperloglog_theta_a_not_b(PG_FUNCTION_ARGS);
+Datum hyperloglog_theta_comp(PG_FUNCTION_ARGS);
+Datum hyperloglog_theta_estimate(PG_FUNCTION_ARGS);
+Datum hyperloglog_theta_in(PG_FUNCTION_ARGS);
+Datum hyperloglog_theta_out(PG_FUNCTION_ARGS);
+Datum hyperloglog_theta_recv(PG_FUNCTION_ARGS);
+Datum hyperloglog_theta_send(PG_FUNCTION_ARGS);
+
+/* checks the value read by pg_varlena_in/pg_varlena_recv, errors out if
+ * it's corrupted (pg_validate_sliding, pg_validate_ultra, ...) */
+typedef void (*pg_varlena_validator)(void * data);
 
 static HLLCounter pg_check_hll_version(HLLCounter hloglog);
+static void pg_check_hll_header_version(HLLCounter hloglog);
+static const char * hll_format_name(HLLCounter hloglog);
+static const char * hll_representation_name(HLLCounter hloglog);
+static int64_t pg_timestamp_usecs(TimestampTz timestamp);
+static int64_t pg_interval_usecs(Interval * interval);
+static void pg_element_bytes(FunctionCallInfo fcinfo, int argno, Datum * datum, const char ** element, int * elen);
+static HLLCounter pg_joint_counter(FunctionCallInfo fcinfo, int argno);
+static char * pg_varlena_out(bytea * data);
+static void * pg_varlena_in(char * data, int header_length, pg_varlena_validator validate);
+static void * pg_varlena_recv(StringInfo buf, int header_length, pg_varlena_validator validate);
+static void pg_validate_sliding(void * data);
+static void pg_validate_ultra(void * data);
+static void pg_validate_theta(void * data);
 
 
 /* ---------------------- function definitions --------------------------- */
+
+/* Module load callback, defines the GUCs */
+void
+_PG_init(void)
+{
+#if PG_VERSION_NUM >= 90100
+    DefineCustomEnumVariable("hyperloglog.promotion",
+                             "Sparse to dense promotion policy of new counters.",
+                             "fixed promotes at a fixed number of entries, size promotes once the compressed sparse counter would be larger than the compressed dense one.",
+                             &hll_promotion_policy,
+                             HLL_PROMOTION_FIXED,
+                             promotion_options,
+                             PGC_USERSET,
+                             0,
+                             NULL,
+                             NULL,
+                             NULL);
+
+    DefineCustomBoolVariable("hyperloglog.output_wrap",
+                             "Breaks the base64 text output of counters into lines of 76 characters.",
+                             "Turn it off for a single line per counter, which is shorter and faster to read back (e.g. in CSV exports).",
+                             &hll_output_wrap,
+                             true,
+                             PGC_USERSET,
+                             0,
+                             NULL,
+                             NULL,
+                             NULL);
+#elif PG_VERSION_NUM >= 80400
+    DefineCustomEnumVariable("hyperloglog.promotion",
+                             "Sparse to dense promotion policy of new counters.",
+                             "fixed promotes at a fixed number of entries, size promotes once the compressed sparse counter would be larger than the compressed dense one.",
+                             &hll_promotion_policy,
+                             HLL_PROMOTION_FIXED,
+                             promotion_options,
+                             PGC_USERSET,
+                             0,
+                             NULL,
+                             NULL);
+
+    DefineCustomBoolVariable("hyperloglog.output_wrap",
+                             "Breaks the base64 text output of counters into lines of 76 characters.",
+                             "Turn it off for a single line per counter, which is shorter and faster to read back (e.g. in CSV exports).",
+                             &hll_output_wrap,
+                             true,
+                             PGC_USERSET,
+                             0,
+                             NULL,
+                             NULL);
+#endif
+}
+
 static HLLCounter 
 pg_check_hll_version(HLLCounter hloglog)
 {
+    /* stored counters usually use the compact header, the functions work on
+     * a HLLData copy */
+    hloglog = hll_expand(hloglog);
+
+    pg_check_hll_header_version(hloglog);
     if (hloglog->version != STRUCT_VERSION){
-        elog(ERROR,"ERROR: The stored counter is version %u while the library is version %u. Please change library version or use upgrade function to upgrade the counter",hloglog->version,STRUCT_VERSION);
+        /* older counters are upgraded on the fly, on a copy since the upgrade
+         * may modify the counter in place */
+        hloglog = hll_upgrade(hll_copy(hloglog));
     }
     return hloglog;
 }
 
+/* Only checks the version is supported (can be used on a header slice) */
+static void
+pg_check_hll_header_version(HLLCounter hloglog)
+{
+    if (hloglog->version > STRUCT_VERSION){
+        elog(ERROR,"ERROR: The stored counter is version %u while the library is version %u. Please change library version or use upgrade function to upgrade the counter",hloglog->version,STRUCT_VERSION);
+    }
+}
+
+/* name of the register format of the counter */
+static const char *
+hll_format_name(HLLCounter hloglog)
+{
+    switch (HLL_FORMAT(hloglog)){
+        case PACKED:
+            return "packed";
+        case PACKED_UNPACKED:
+            return "packed_unpacked";
+        case UNPACKED:
+            return "unpacked";
+        case NIBBLE:
+            return "nibble";
+        default:
+            return "unpacked_unpacked";
+    }
+}
+
+static const char *
+hll_representation_name(HLLCounter hloglog)
+{
+    static const char * const names[] = {"small", "sparse", "dense"};
+
+    return names[HLL_REPRESENTATION(hloglog)];
+}
+
 Datum
 hyperloglog_unpack(PG_FUNCTION_ARGS)
 {
@@ -142,6 +400,97 @@ hyperloglog_unpack(PG_FUNCTION_ARGS)
     PG_RETURN_BYTEA_P(hyperloglog);
 }
 
+/* Fixed size (dense, uncompressed) counters are meant for columns that are
+ * updated frequently, see hll_fixed() */
+Datum
+hyperloglog_fixed(PG_FUNCTION_ARGS)
+{
+    HLLCounter hyperloglog;
+
+    hyperloglog = PG_GETARG_HLL_P_COPY(0);
+
+    PG_RETURN_BYTEA_P(hll_fixed(hyperloglog, PACKED));
+}
+
+Datum
+hyperloglog_fixed_format(PG_FUNCTION_ARGS)
+{
+    HLLCounter hyperloglog;
+    char format;
+
+    hyperloglog = PG_GETARG_HLL_P_COPY(0);
+    format = VARDATA_ANY(PG_GETARG_TEXT_P(1))[0];
+
+    if (format == 'u' || format == 'U'){
+        hyperloglog = hll_fixed(hyperloglog, UNPACKED);
+    } else if (format == 'p' || format == 'P'){
+        hyperloglog = hll_fixed(hyperloglog, PACKED);
+    } else {
+        elog(ERROR,"ERROR: Improper format specification! Must be U or P");
+    }
+
+    PG_RETURN_BYTEA_P(hyperloglog);
+}
+
+/* Merges the second counter into the first one keeping the first one in the
+ * fixed size representation, so repeated updates of a column never change the
+ * size of the stored counter. If the first counter is null the second one is
+ * converted, if the second one is null the first one is returned as a fixed
+ * size counter. */
+Datum
+hyperloglog_upsert(PG_FUNCTION_ARGS)
+{
+    HLLCounter counter1;
+    HLLCounter counter2;
+
+    if (PG_ARGISNULL(0) && PG_ARGISNULL(1)){
+        PG_RETURN_NULL();
+    } else if (PG_ARGISNULL(0)) {
+        counter1 = hll_fixed(PG_GETARG_HLL_P_COPY(1), PACKED);
+    } else if (PG_ARGISNULL(1)) {
+        counter1 = PG_GETARG_HLL_P_COPY(0);
+        if (!HLL_IS_FIXED(counter1)){
+            counter1 = hll_fixed(counter1, PACKED);
+        }
+    } else {
+        counter1 = PG_GETARG_HLL_P_COPY(0);
+        counter2 = PG_GETARG_HLL_P_COPY(1);
+
+        counter1 = hll_upsert(counter1, counter2);
+    }
+
+    PG_RETURN_BYTEA_P(counter1);
+}
+
+/* Sets the sparse to dense promotion policy ('fixed' or 'size') of a counter,
+ * overriding the hyperloglog.promotion GUC the counter was created with. */
+Datum
+hyperloglog_promotion(PG_FUNCTION_ARGS)
+{
+    HLLCounter hyperloglog;
+    char * policy;
+    bool compressed;
+
+    hyperloglog = PG_GETARG_HLL_P_COPY(0);
+    policy = text_to_cstring(PG_GETARG_TEXT_P(1));
+    compressed = (hyperloglog->b < 0);
+
+    if (pg_strcasecmp(policy, "fixed") == 0){
+        hyperloglog = hll_set_promotion(hyperloglog, HLL_PROMOTION_FIXED);
+    } else if (pg_strcasecmp(policy, "size") == 0){
+        hyperloglog = hll_set_promotion(hyperloglog, HLL_PROMOTION_SIZE);
+    } else {
+        elog(ERROR,"ERROR: Improper promotion policy! Must be fixed or size");
+    }
+
+    /* switching to fixed may promote (and decompress) the counter */
+    if (compressed){
+        hyperloglog = hll_compact(hll_compress(hyperloglog));
+    }
+
+    PG_RETURN_BYTEA_P(hyperloglog);
+}
+
 Datum
 hyperloglog_add_item(PG_FUNCTION_ARGS)
 {
@@ -301,8 +650,10 @@ hyperloglog_add_item_agg_pack(PG_FUNCTION_ARGS)
             hyperloglog = hll_create(ndistinct, errorRate, PACKED_UNPACKED);
         } else if (!PG_ARGISNULL(4) && ('p' == VARDATA_ANY(PG_GETARG_TEXT_P(4))[0] || 'P'  == VARDATA_ANY(PG_GETARG_TEXT_P(4))[0] ) ) {
             hyperloglog = hll_create(ndistinct, errorRate, PACKED);
+        } else if (!PG_ARGISNULL(4) && ('n' == VARDATA_ANY(PG_GETARG_TEXT_P(4))[0] || 'N'  == VARDATA_ANY(PG_GETARG_TEXT_P(4))[0] ) ) {
+            hyperloglog = hll_create(ndistinct, errorRate, NIBBLE);
         } else {
-            elog(ERROR,"ERROR: Improper format specification! Must be U or P");
+            elog(ERROR,"ERROR: Improper format specification! Must be U, P or N");
             PG_RETURN_NULL();
         }
 
@@ -446,8 +797,10 @@ hyperloglog_add_item_agg_error_pack(PG_FUNCTION_ARGS)
             hyperloglog = hll_create(DEFAULT_NDISTINCT, errorRate, PACKED_UNPACKED);
         } else if (!PG_ARGISNULL(3) && ('p' == VARDATA_ANY(PG_GETARG_TEXT_P(3))[0] || 'P'  == VARDATA_ANY(PG_GETARG_TEXT_P(3))[0] ) ) {
             hyperloglog = hll_create(DEFAULT_NDISTINCT, errorRate, PACKED);
+        } else if (!PG_ARGISNULL(3) && ('n' == VARDATA_ANY(PG_GETARG_TEXT_P(3))[0] || 'N'  == VARDATA_ANY(PG_GETARG_TEXT_P(3))[0] ) ) {
+            hyperloglog = hll_create(DEFAULT_NDISTINCT, errorRate, NIBBLE);
         } else {
-            elog(ERROR,"ERROR: Improper format specification! Must be U or P");
+            elog(ERROR,"ERROR: Improper format specification! Must be U, P or N");
             PG_RETURN_NULL();
         }
 
@@ -576,8 +929,10 @@ hyperloglog_add_item_agg_default_pack(PG_FUNCTION_ARGS)
             hyperloglog = hll_create(DEFAULT_NDISTINCT, DEFAULT_ERROR, PACKED_UNPACKED);
         } else if (!PG_ARGISNULL(2) && ('p' == VARDATA_ANY(PG_GETARG_TEXT_P(2))[0] || 'P'  == VARDATA_ANY(PG_GETARG_TEXT_P(2))[0] ) ) {
             hyperloglog = hll_create(DEFAULT_NDISTINCT, DEFAULT_ERROR, PACKED);
+        } else if (!PG_ARGISNULL(2) && ('n' == VARDATA_ANY(PG_GETARG_TEXT_P(2))[0] || 'N'  == VARDATA_ANY(PG_GETARG_TEXT_P(2))[0] ) ) {
+            hyperloglog = hll_create(DEFAULT_NDISTINCT, DEFAULT_ERROR, NIBBLE);
         } else {
-        elog(ERROR,"ERROR: Improper format specification! Must be U or P");
+        elog(ERROR,"ERROR: Improper format specification! Must be U, P or N");
         PG_RETURN_NULL();
     }
     } else {
@@ -649,12 +1004,9 @@ hyperloglog_merge(PG_FUNCTION_ARGS)
         counter1 = PG_GETARG_HLL_P_COPY(0);
         counter2 = PG_GETARG_HLL_P_COPY(1);
 
-        /* unpack if needed */
-    counter1 = hll_unpack(counter1);
-    counter2 = hll_unpack(counter2);
-
-        /* perform the merge */
-        counter1 = hll_merge(counter1, counter2);
+        /* perform the merge (unpacks the counters if needed, compressed
+         * sparse counters are merged without decompressing them) */
+        counter1 = hll_merge_compressed(counter1, counter2);
 
     }
 
@@ -693,12 +1045,9 @@ hyperloglog_merge_unsafe(PG_FUNCTION_ARGS)
         counter1 = PG_GETARG_HLL_P(0);
         counter2 = PG_GETARG_HLL_P(1);
 
-        /* unpack if needed */
-        counter1 = hll_unpack(counter1);
-        counter2 = hll_unpack(counter2);
-
-        /* perform the merge */
-        counter1 = hll_merge(counter1, counter2);
+        /* perform the merge (unpacks the counters if needed, compressed
+         * sparse counters are merged without decompressing them) */
+        counter1 = hll_merge_compressed(counter1, counter2);
 
     }
 
@@ -813,10 +1162,31 @@ hyperloglog_size(PG_FUNCTION_ARGS)
       PG_RETURN_INT32(hll_get_size(ndistinct, errorRate));
 }
 
+/* The length is taken from the toast pointer (or the varlena header) so the
+ * counter doesn't need to be detoasted. Older versions are upgraded on read by
+ * every other function, so they report the length of the counter
+ * hyperloglog_update would store. */
 Datum
 hyperloglog_length(PG_FUNCTION_ARGS)
 {
-    PG_RETURN_INT32(VARSIZE_ANY(PG_GETARG_HLL_P(0)));
+    HLLCounter hyperloglog = PG_GETARG_HLL_HEADER_P(0);
+
+    pg_check_hll_header_version(hyperloglog);
+    if (hyperloglog->version != STRUCT_VERSION){
+        PG_RETURN_INT32(VARSIZE_ANY(hll_compact(PG_GETARG_HLL_P(0))));
+    }
+
+    PG_RETURN_INT32(toast_raw_datum_size(PG_GETARG_DATUM(0)));
+}
+
+Datum
+hyperloglog_precision(PG_FUNCTION_ARGS)
+{
+    HLLCounter hyperloglog = PG_GETARG_HLL_HEADER_P(0);
+
+    pg_check_hll_header_version(hyperloglog);
+
+    PG_RETURN_INT32(HLL_PRECISION(hyperloglog));
 }
 
 Datum
@@ -829,14 +1199,14 @@ hyperloglog_reset(PG_FUNCTION_ARGS)
 Datum
 hyperloglog_out(PG_FUNCTION_ARGS)
 {
-    int16   datalen, resultlen, res;
+    int32   datalen, resultlen, res;
     char     *result;
     bytea    *data = PG_GETARG_BYTEA_P(0);
 
     datalen = VARSIZE_ANY_EXHDR(data);
     resultlen = b64_enc_len(VARDATA_ANY(data), datalen);
     result = palloc(resultlen + 1);
-    res = hll_b64_encode(VARDATA_ANY(data),datalen, result);
+    res = hll_b64_encode(VARDATA_ANY(data),datalen, result, hll_output_wrap);
     
     /* Make this FATAL 'cause we've trodden on memory ... */
     if (res > resultlen)
@@ -852,7 +1222,7 @@ hyperloglog_in(PG_FUNCTION_ARGS)
 {
     bytea      *result;
     char       *data = PG_GETARG_CSTRING(0);
-    int16      datalen, resultlen, res;
+    int32      datalen, resultlen, res;
 
     datalen = strlen(data);
     resultlen = b64_dec_len(data,datalen);
@@ -869,30 +1239,66 @@ hyperloglog_in(PG_FUNCTION_ARGS)
     
 }
 
+/* oldest struct version accepted by hyperloglog_recv */
+#define HLL_BINARY_MIN_VERSION 4
+
 /*
- *        bytearecv            - converts external binary format to bytea
+ * The binary format of a counter is the counter itself (see the Binary Format
+ * section of documentation/README.md). Counters are sent with the compact
+ * header, whose first two bytes carry the struct version, state, bin size,
+ * precision and format. Counters using the HLLData header (uncompressed
+ * sparse counters and those sent by older versions, which just passed the
+ * bytes through) are accepted as well.
+ *
+ * hyperloglog_recv checks the version and the consistency of the counter
+ * (so a corrupted message can't make any function read past its end),
+ * upgrades older counters and stores them compact. The layout of the data
+ * hasn't changed since version 4, older counters are rejected.
  */
 Datum
 hyperloglog_recv(PG_FUNCTION_ARGS)
 {
-    Datum dd = DirectFunctionCall1(bytearecv, PG_GETARG_DATUM(0));
-    return dd;
+    StringInfo buf = (StringInfo) PG_GETARG_POINTER(0);
+    HLLCounter hloglog;
+    int length = buf->len - buf->cursor;
+
+    /* zero padded, so a truncated compact header is caught by hll_expand
+     * without reading past the end */
+    hloglog = palloc0(VARHDRSZ + length + HLL_COMPACT_MAX_HEADER);
+    pq_copymsgbytes(buf, VARDATA(hloglog), length);
+    SET_VARSIZE(hloglog, VARHDRSZ + length);
+
+    if (length == 0 || (!HLL_IS_COMPACT(hloglog) && VARSIZE(hloglog) < offsetof(HLLData, data))){
+        elog(ERROR, "binary counter is too short");
+    }
+
+    /* the layout of older versions isn't checked, they have to be upgraded
+     * with hyperloglog_update before they're sent */
+    hloglog = hll_expand(hloglog);
+    pg_check_hll_header_version(hloglog);
+    if (hloglog->version < HLL_BINARY_MIN_VERSION){
+        elog(ERROR, "binary input of counters older than version %d is not supported", HLL_BINARY_MIN_VERSION);
+    }
+    hll_validate(hloglog);
+
+    PG_RETURN_BYTEA_P(hll_compact(pg_check_hll_version(hloglog)));
 }
 
 /*
- *        byteasend            - converts bytea to binary format
- *
- * This is a special case: just copy the input...
+ * Compact counters of the current version (anything stored by
+ * hyperloglog_comp or the aggregates) are sent straight from the detoasted
+ * datum without being copied, others are converted first.
  */
 Datum
 hyperloglog_send(PG_FUNCTION_ARGS)
 {
-    Datum dd = PG_GETARG_DATUM(0);
-    bytea* bp = DatumGetByteaP(dd);
-    StringInfoData buf;
-    pq_begintypsend(&buf);
-    pq_sendbytes(&buf, VARDATA_ANY(bp), VARSIZE_ANY_EXHDR(bp));
-    PG_RETURN_BYTEA_P(pq_endtypsend(&buf));
+    HLLCounter hloglog = (HLLCounter) PG_GETARG_BYTEA_P(0);
+
+    if (!HLL_IS_COMPACT(hloglog) || hll_expand_header(hloglog)->version != STRUCT_VERSION){
+        hloglog = hll_compact(hll_compress(hll_copy(pg_check_hll_version(hloglog))));
+    }
+
+    PG_RETURN_BYTEA_P(hloglog);
 }
 
 Datum
@@ -906,7 +1312,8 @@ hyperloglog_comp(PG_FUNCTION_ARGS)
 
     hyperloglog =  PG_GETARG_HLL_P_COPY(0);
 
-    hyperloglog = hll_compress(hyperloglog);
+    /* the result is usually stored so it gets the compact header as well */
+    hyperloglog = hll_compact(hll_compress(hyperloglog));
 
     PG_RETURN_BYTEA_P(hyperloglog);
 }
@@ -921,7 +1328,7 @@ hyperloglog_decomp(PG_FUNCTION_ARGS)
     }
 
     hyperloglog =  PG_GETARG_HLL_P_COPY(0);
-    if (hyperloglog-> b < 0 && hyperloglog->format == PACKED ) {
+    if (hyperloglog-> b < 0 && (HLL_FORMAT(hyperloglog) == PACKED || HLL_FORMAT(hyperloglog) == NIBBLE)) {
         hyperloglog = hll_decompress(hyperloglog);
     }
 
@@ -940,7 +1347,7 @@ hyperloglog_update(PG_FUNCTION_ARGS)
 
     hyperloglog = (HLLCounter)PG_GETARG_BYTEA_P_COPY(0);
 
-    hyperloglog = hll_upgrade(hyperloglog);
+    hyperloglog = hll_compact(hll_upgrade(hyperloglog));
 
     PG_RETURN_BYTEA_P(hyperloglog);
 }
@@ -950,14 +1357,14 @@ Datum
 hyperloglog_info(PG_FUNCTION_ARGS)
 {
     HLLCounter hyperloglog;
-    char out[500], comp[4], enc[7], format[9];
+    char out[500], comp[4];
     int corrected_b;
 
     if (PG_ARGISNULL(0) ){
         PG_RETURN_NULL();
     }
 
-    hyperloglog =  (HLLCounter)PG_GETARG_BYTEA_P(0);
+    hyperloglog = PG_GETARG_HLL_HEADER_P(0);
     
     if (hyperloglog->b < 0){
         snprintf(comp,4,"yes");
@@ -965,27 +1372,9 @@ hyperloglog_info(PG_FUNCTION_ARGS)
         snprintf(comp,4,"no");
     }
 
-    if (-1*hyperloglog->b > MAX_INDEX_BITS){
-        corrected_b = -1*hyperloglog->b - MAX_INDEX_BITS;
-    } else if (hyperloglog->b < 0){
-        corrected_b = -1*hyperloglog->b;
-    } else {
-        corrected_b = hyperloglog->b;
-    }
+    corrected_b = HLL_PRECISION(hyperloglog);
 
-    if (hyperloglog->idx == -1){
-        snprintf(enc,7,"dense");
-    } else {
-        snprintf(enc,7,"sparse");
-    }
-    
-    if (hyperloglog->format == PACKED){
-        snprintf(format, 9, "packed");
-    } else if (hyperloglog->format == UNPACKED) {
-        snprintf(format, 9, "unpacked");
-    }
-
-    snprintf(out, 500, "Counter Summary\nstruct version: %d\nsize on disk (bytes): %ld\nbits per bin: %d\nindex bits: %d\nnumber of bins: %d\ncompressed?: %s\nencoding: %s\nformat: %s\n--------------------------", hyperloglog->version, VARSIZE_ANY(hyperloglog), hyperloglog->binbits, corrected_b, (int)pow(2, corrected_b), comp, enc, format);
+    snprintf(out, 500, "Counter Summary\nstruct version: %d\nsize on disk (bytes): %ld\nbits per bin: %d\nindex bits: %d\nnumber of bins: %d\ncompressed?: %s\nencoding: %s\nformat: %s\n--------------------------", hyperloglog->version, (long) toast_raw_datum_size(PG_GETARG_DATUM(0)), hyperloglog->binbits, corrected_b, (int)pow(2, corrected_b), comp, hll_representation_name(hyperloglog), hll_format_name(hyperloglog));
 
     PG_RETURN_TEXT_P(cstring_to_text(out));
 }
@@ -1000,6 +1389,130 @@ hyperloglog_info_noargs(PG_FUNCTION_ARGS)
     PG_RETURN_TEXT_P(cstring_to_text(out));
 }
 
+/* Returns what hyperloglog_info describes as a record, plus the metrics that
+ * need the whole counter: the size once decompressed and unpacked (what the
+ * functions work on), the number of sparse entries, the registers of the
+ * counter as a dense one (the number of nonzero ones and a histogram, element
+ * k counts the registers of value k-1 up to the largest one) and the
+ * estimate. */
+Datum
+hyperloglog_info_record(PG_FUNCTION_ARGS)
+{
+    HLLCounter header, hyperloglog, registers;
+    TupleDesc tupdesc;
+    Datum values[13];
+    bool nulls[13];
+    Datum *histogram;
+    int *counts;
+    int i, m, max = 0, nonzero = 0;
+    double estimate;
+
+    if (get_call_result_type(fcinfo, NULL, &tupdesc) != TYPEFUNC_COMPOSITE){
+        elog(ERROR, "return type must be a row type");
+    }
+    tupdesc = BlessTupleDesc(tupdesc);
+
+    /* the version and flags as stored, before any upgrade */
+    header = PG_GETARG_HLL_HEADER_P(0);
+    pg_check_hll_header_version(header);
+
+    /* the counter the functions work on, with the sparse entries deduped by
+     * the estimate */
+    hyperloglog = hll_unpack(PG_GETARG_HLL_P_COPY(0));
+    estimate = hll_estimate(hyperloglog);
+
+    registers = hll_fixed(hll_copy(hyperloglog), UNPACKED);
+    m = POW2(registers->b);
+    counts = palloc0(POW2(registers->binbits) * sizeof(int));
+    for (i = 0; i < m; i++){
+        uint8_t rho = (uint8_t) registers->data[i];
+
+        counts[rho]++;
+        max = Max(max, rho);
+        nonzero += (rho != 0);
+    }
+
+    histogram = palloc((max + 1) * sizeof(Datum));
+    for (i = 0; i <= max; i++){
+        histogram[i] = Int32GetDatum(counts[i]);
+    }
+
+    memset(nulls, false, sizeof(nulls));
+    values[0] = CStringGetTextDatum(hll_representation_name(header));
+    values[1] = BoolGetDatum(header->b < 0);
+    values[2] = CStringGetTextDatum(hll_format_name(header));
+    values[3] = CStringGetTextDatum(HLL_PROMOTES_BY_SIZE(header) ? "size" : "fixed");
+    values[4] = Int32GetDatum(HLL_PRECISION(header));
+    values[5] = Int32GetDatum(header->binbits);
+    values[6] = Int32GetDatum(header->version);
+    values[7] = Int64GetDatum((int64) toast_raw_datum_size(PG_GETARG_DATUM(0)));
+    values[8] = Int64GetDatum((int64) VARSIZE(hyperloglog));
+    if (hyperloglog->idx == -1){
+        nulls[9] = true;
+    } else {
+        values[9] = Int32GetDatum(hyperloglog->idx);
+    }
+    values[10] = Int32GetDatum(nonzero);
+    values[11] = PointerGetDatum(construct_array(histogram, max + 1, INT4OID, sizeof(int32), true, 'i'));
+    values[12] = Float8GetDatum(estimate);
+
+    PG_RETURN_DATUM(HeapTupleGetDatum(heap_form_tuple(tupdesc, values, nulls)));
+}
+
+/* Returns the engine counters of this backend (see HLLStat) as name/value
+ * rows. They're copied on the first call so the rows are consistent even if
+ * the query itself adds to them. */
+Datum
+hyperloglog_stats(PG_FUNCTION_ARGS)
+{
+    FuncCallContext *funcctx;
+    uint64_t *snapshot;
+    Datum values[2];
+    bool nulls[2] = {false, false};
+    HeapTuple tuple;
+
+    if (SRF_IS_FIRSTCALL()){
+        MemoryContext oldcontext;
+        TupleDesc tupdesc;
+
+        funcctx = SRF_FIRSTCALL_INIT();
+        oldcontext = MemoryContextSwitchTo(funcctx->multi_call_memory_ctx);
+
+        if (get_call_result_type(fcinfo, NULL, &tupdesc) != TYPEFUNC_COMPOSITE){
+            elog(ERROR, "return type must be a row type");
+        }
+        funcctx->tuple_desc = BlessTupleDesc(tupdesc);
+
+        snapshot = palloc(sizeof(hll_stats));
+        memcpy(snapshot, hll_stats, sizeof(hll_stats));
+        funcctx->user_fctx = snapshot;
+        funcctx->max_calls = HLL_NUM_STATS;
+
+        MemoryContextSwitchTo(oldcontext);
+    }
+
+    funcctx = SRF_PERCALL_SETUP();
+    snapshot = (uint64_t *) funcctx->user_fctx;
+
+    if (funcctx->call_cntr < funcctx->max_calls){
+        values[0] = CStringGetTextDatum(hll_stat_names[funcctx->call_cntr]);
+        values[1] = Int64GetDatum((int64) snapshot[funcctx->call_cntr]);
+        tuple = heap_form_tuple(funcctx->tuple_desc, values, nulls);
+
+        SRF_RETURN_NEXT(funcctx, HeapTupleGetDatum(tuple));
+    }
+
+    SRF_RETURN_DONE(funcctx);
+}
+
+Datum
+hyperloglog_stats_reset(PG_FUNCTION_ARGS)
+{
+    memset(hll_stats, 0, sizeof(hll_stats));
+
+    PG_RETURN_VOID();
+}
+
     
 /* set operations */
 Datum
@@ -1192,3 +1705,674 @@ hyperloglog_symmetric_diff(PG_FUNCTION_ARGS)
 
 }
 
+/* The argument as hll_joint_estimate reads it: the registers are read in
+ * place, so only compressed counters are decoded (straight into one byte per
+ * register, see hll_unpack). Decompressing (or sorting a small set) modifies
+ * the counter, so one that is still the datum itself (neither detoasted nor
+ * expanded from the compact header) is copied first. */
+static HLLCounter
+pg_joint_counter(FunctionCallInfo fcinfo, int argno)
+{
+    HLLCounter hyperloglog = PG_GETARG_HLL_P(argno);
+
+    if ((hyperloglog->b < 0 || HLL_IS_SMALL_SET(hyperloglog)) &&
+        (Pointer) hyperloglog == DatumGetPointer(PG_GETARG_DATUM(argno))){
+        hyperloglog = hll_copy(hyperloglog);
+    }
+
+    if (hyperloglog->b < 0){
+        hyperloglog = hll_unpack(hyperloglog);
+    }
+
+    return hyperloglog;
+}
+
+/* Jaccard similarity |A n B| / |A u B| of the counters from the joint
+ * estimate of the items only in either counter and in both (see
+ * hll_joint_estimate), 1 for two empty counters */
+Datum
+hyperloglog_jaccard(PG_FUNCTION_ARGS)
+{
+    HLLCounter counter1 = pg_joint_counter(fcinfo, 0);
+    HLLCounter counter2 = pg_joint_counter(fcinfo, 1);
+    double only1, only2, both;
+
+    hll_joint_estimate(counter1, counter2, &only1, &only2, &both);
+
+    if (only1 + only2 + both == 0){
+        PG_RETURN_FLOAT8(1.0);
+    }
+
+    PG_RETURN_FLOAT8(both / (only1 + only2 + both));
+}
+
+/* Containment |A n B| / |A| of the first counter in the second one (like
+ * hyperloglog_jaccard), 1 for an empty first counter */
+Datum
+hyperloglog_containment(PG_FUNCTION_ARGS)
+{
+    HLLCounter counter1 = pg_joint_counter(fcinfo, 0);
+    HLLCounter counter2 = pg_joint_counter(fcinfo, 1);
+    double only1, only2, both;
+
+    hll_joint_estimate(counter1, counter2, &only1, &only2, &both);
+
+    if (only1 + both == 0){
+        PG_RETURN_FLOAT8(1.0);
+    }
+
+    PG_RETURN_FLOAT8(both / (only1 + both));
+}
+
+
+/* ------------------------ sliding window counters ---------------------- */
+
+/* The times of sliding counters are microseconds, like timestamptz (and
+ * intervals are converted the same way interval comparisons do, 30 days a
+ * month). Builds with float timestamps (before PostgreSQL 10) are converted
+ * to microseconds as well. */
+static int64_t
+pg_timestamp_usecs(TimestampTz timestamp)
+{
+#if PG_VERSION_NUM < 100000 && !defined(HAVE_INT64_TIMESTAMP)
+    return (int64_t) rint(timestamp * USECS_PER_SEC);
+#else
+    return timestamp;
+#endif
+}
+
+static int64_t
+pg_interval_usecs(Interval * interval)
+{
+#if PG_VERSION_NUM < 100000 && !defined(HAVE_INT64_TIMESTAMP)
+    return (int64_t) rint((interval->time + (interval->day + (double) interval->month * DAYS_PER_MONTH) * SECS_PER_DAY) * USECS_PER_SEC);
+#else
+    return interval->time + (interval->day + (int64_t) interval->month * DAYS_PER_MONTH) * USECS_PER_DAY;
+#endif
+}
+
+/* The bytes of the anyelement argument that get hashed (see
+ * hyperloglog_add_item), values passed by value are hashed from 'datum'. */
+static void
+pg_element_bytes(FunctionCallInfo fcinfo, int argno, Datum * datum, const char ** element, int * elen)
+{
+    Oid         element_type = get_fn_expr_argtype(fcinfo->flinfo, argno);
+    int16       typlen;
+    bool        typbyval;
+    char        typalign;
+
+    *datum = PG_GETARG_DATUM(argno);
+    get_typlenbyvalalign(element_type, &typlen, &typbyval, &typalign);
+
+    if (typlen == -1) {
+        /* varlena */
+        *element = VARDATA_ANY(*datum);
+        *elen = VARSIZE_ANY_EXHDR(*datum);
+    } else if (typbyval) {
+        /* fixed-length, passed by value */
+        *element = (const char *) datum;
+        *elen = typlen;
+    } else {
+        /* fixed-length, passed by reference */
+        *element = (const char *) DatumGetPointer(*datum);
+        *elen = typlen;
+    }
+}
+
+/* The text format of sliding counters, UltraLogLog counters and theta
+ * sketches is the base64 encoding of the value itself, the binary format the
+ * value. Both are validated on input, the buffer is zero padded to at least
+ * 'header_length' bytes (the offset of the data array) so a truncated header
+ * is caught without reading past the end. */
+static char *
+pg_varlena_out(bytea * data)
+{
+    int32   datalen, resultlen, res;
+    char     *result;
+
+    datalen = VARSIZE_ANY_EXHDR(data);
+    resultlen = b64_enc_len(VARDATA_ANY(data), datalen);
+    result = palloc(resultlen + 1);
+    res = hll_b64_encode(VARDATA_ANY(data), datalen, result, hll_output_wrap);
+
+    /* Make this FATAL 'cause we've trodden on memory ... */
+    if (res > resultlen)
+        elog(FATAL, "overflow - encode estimate too small");
+
+    result[res] = '\0';
+
+    return result;
+}
+
+static void *
+pg_varlena_in(char * data, int header_length, pg_varlena_validator validate)
+{
+    bytea      *result;
+    int32      datalen, resultlen, res;
+
+    datalen = strlen(data);
+    resultlen = b64_dec_len(data, datalen);
+    result = palloc0(VARHDRSZ + Max(resultlen, header_length));
+    res = hll_b64_decode(data, datalen, VARDATA(result));
+
+    /* Make this FATAL 'cause we've trodden on memory ... */
+    if (res > resultlen)
+        elog(FATAL, "overflow - decode estimate too small");
+
+    SET_VARSIZE(result, VARHDRSZ + res);
+    validate(result);
+
+    return result;
+}
+
+static void *
+pg_varlena_recv(StringInfo buf, int header_length, pg_varlena_validator validate)
+{
+    bytea *result;
+    int length = buf->len - buf->cursor;
+
+    result = palloc0(VARHDRSZ + Max(length, header_length));
+    pq_copymsgbytes(buf, VARDATA(result), length);
+    SET_VARSIZE(result, VARHDRSZ + length);
+    validate(result);
+
+    return result;
+}
+
+/* typed wrappers of the validators passed to pg_varlena_in/pg_varlena_recv */
+static void
+pg_validate_sliding(void * data)
+{
+    hll_sliding_validate((SlidingHLL) data);
+}
+
+static void
+pg_validate_ultra(void * data)
+{
+    hll_ultra_validate((UltraHLL) data);
+}
+
+static void
+pg_validate_theta(void * data)
+{
+    hll_theta_validate((ThetaSketch) data);
+}
+
+/* an empty sliding counter for the window (interval) and optional error rate */
+Datum
+hyperloglog_sliding_init(PG_FUNCTION_ARGS)
+{
+    float errorRate = DEFAULT_ERROR;
+
+    if (PG_NARGS() > 1){
+        errorRate = PG_GETARG_FLOAT4(1);
+    }
+
+    PG_RETURN_POINTER(hll_sliding_create(errorRate, pg_interval_usecs(PG_GETARG_INTERVAL_P(0))));
+}
+
+/* Adds the item seen at the given time to a copy of the counter, NULL items
+ * and times are skipped. */
+Datum
+hyperloglog_sliding_add(PG_FUNCTION_ARGS)
+{
+    SlidingHLL counter;
+    Datum datum;
+    const char * element;
+    int elen;
+
+    if (PG_ARGISNULL(0)){
+        elog(ERROR, "sliding counter must not be NULL");
+    }
+
+    counter = PG_GETARG_SLIDING_P_COPY(0);
+
+    if (!PG_ARGISNULL(1) && !PG_ARGISNULL(2)){
+        pg_element_bytes(fcinfo, 1, &datum, &element, &elen);
+        counter = hll_sliding_add(counter, element, elen, pg_timestamp_usecs(PG_GETARG_TIMESTAMPTZ(2)));
+    }
+
+    PG_RETURN_POINTER(counter);
+}
+
+/* Transition function of hyperloglog_sliding_accum(item, time, window [,
+ * error rate]), the counter is created with the first item that isn't NULL */
+Datum
+hyperloglog_sliding_add_agg(PG_FUNCTION_ARGS)
+{
+    SlidingHLL counter;
+    Datum datum;
+    const char * element;
+    int elen;
+    float errorRate = DEFAULT_ERROR;
+
+    if (PG_ARGISNULL(1) || PG_ARGISNULL(2)){
+        if (PG_ARGISNULL(0)){
+            PG_RETURN_NULL();
+        }
+        PG_RETURN_POINTER(PG_GETARG_SLIDING_P(0));
+    }
+
+    if (PG_ARGISNULL(0)){
+        if (PG_ARGISNULL(3)){
+            elog(ERROR, "window of a sliding counter must not be NULL");
+        }
+        if (PG_NARGS() > 4 && !PG_ARGISNULL(4)){
+            errorRate = PG_GETARG_FLOAT4(4);
+        }
+        counter = hll_sliding_create(errorRate, pg_interval_usecs(PG_GETARG_INTERVAL_P(3)));
+    } else {
+        counter = PG_GETARG_SLIDING_P(0);
+    }
+
+    pg_element_bytes(fcinfo, 1, &datum, &element, &elen);
+    counter = hll_sliding_add(counter, element, elen, pg_timestamp_usecs(PG_GETARG_TIMESTAMPTZ(2)));
+
+    PG_RETURN_POINTER(counter);
+}
+
+Datum
+hyperloglog_sliding_merge(PG_FUNCTION_ARGS)
+{
+    SlidingHLL counter1;
+
+    if (PG_ARGISNULL(0) && PG_ARGISNULL(1)){
+        PG_RETURN_NULL();
+    } else if (PG_ARGISNULL(0)){
+        PG_RETURN_POINTER(PG_GETARG_SLIDING_P(1));
+    } else if (PG_ARGISNULL(1)){
+        PG_RETURN_POINTER(PG_GETARG_SLIDING_P(0));
+    }
+
+    counter1 = hll_sliding_merge(PG_GETARG_SLIDING_P_COPY(0), PG_GETARG_SLIDING_P(1));
+
+    PG_RETURN_POINTER(counter1);
+}
+
+/* final function of the aggregates, prunes the counter for storage */
+Datum
+hyperloglog_sliding_comp(PG_FUNCTION_ARGS)
+{
+    if (PG_ARGISNULL(0)){
+        PG_RETURN_NULL();
+    }
+
+    PG_RETURN_POINTER(hll_sliding_compact(PG_GETARG_SLIDING_P_COPY(0)));
+}
+
+/* estimate of the distinct items seen at or after the given time (within
+ * the window) */
+Datum
+hyperloglog_sliding_estimate(PG_FUNCTION_ARGS)
+{
+    SlidingHLL counter = PG_GETARG_SLIDING_P(0);
+
+    PG_RETURN_FLOAT8(hll_sliding_estimate(counter, pg_timestamp_usecs(PG_GETARG_TIMESTAMPTZ(1))));
+}
+
+/* the items seen at or after the given time as a regular counter, so it can
+ * be stored or merged with other hyperloglog_estimators */
+Datum
+hyperloglog_sliding_counter(PG_FUNCTION_ARGS)
+{
+    SlidingHLL counter = PG_GETARG_SLIDING_P(0);
+    HLLCounter hyperloglog;
+
+    hyperloglog = hll_sliding_registers(counter, pg_timestamp_usecs(PG_GETARG_TIMESTAMPTZ(1)));
+
+    PG_RETURN_BYTEA_P(hll_compact(hll_compress(hyperloglog)));
+}
+
+/* text and binary I/O of sliding counters (see pg_varlena_out) */
+Datum
+hyperloglog_sliding_out(PG_FUNCTION_ARGS)
+{
+    PG_RETURN_CSTRING(pg_varlena_out(PG_GETARG_BYTEA_P(0)));
+}
+
+Datum
+hyperloglog_sliding_in(PG_FUNCTION_ARGS)
+{
+    PG_RETURN_POINTER(pg_varlena_in(PG_GETARG_CSTRING(0), offsetof(SlidingHLLData, data),
+                                    pg_validate_sliding));
+}
+
+Datum
+hyperloglog_sliding_recv(PG_FUNCTION_ARGS)
+{
+    PG_RETURN_POINTER(pg_varlena_recv((StringInfo) PG_GETARG_POINTER(0), offsetof(SlidingHLLData, data),
+                                      pg_validate_sliding));
+}
+
+Datum
+hyperloglog_sliding_send(PG_FUNCTION_ARGS)
+{
+    PG_RETURN_BYTEA_P(PG_GETARG_BYTEA_P(0));
+}
+
+/* ------------------------- UltraLogLog counters ------------------------ */
+
+/* an empty UltraLogLog counter for the optional error rate */
+Datum
+hyperloglog_ultra_init(PG_FUNCTION_ARGS)
+{
+    float errorRate = ULTRA_DEFAULT_ERROR;
+
+    if (PG_NARGS() > 0){
+        errorRate = PG_GETARG_FLOAT4(0);
+    }
+
+    PG_RETURN_POINTER(hll_ultra_create(errorRate));
+}
+
+/* Adds the item to a copy of the counter, NULL items are skipped. */
+Datum
+hyperloglog_ultra_add(PG_FUNCTION_ARGS)
+{
+    UltraHLL counter;
+    Datum datum;
+    const char * element;
+    int elen;
+
+    if (PG_ARGISNULL(0)){
+        elog(ERROR, "ultraloglog counter must not be NULL");
+    }
+
+    counter = PG_GETARG_ULTRA_P_COPY(0);
+
+    if (!PG_ARGISNULL(1)){
+        pg_element_bytes(fcinfo, 1, &datum, &element, &elen);
+        counter = hll_ultra_add(counter, element, elen);
+    }
+
+    PG_RETURN_POINTER(counter);
+}
+
+/* Transition function of hyperloglog_ultra_accum(item [, error rate]) and
+ * hyperloglog_ultra_distinct, the counter is created with the first item
+ * that isn't NULL */
+Datum
+hyperloglog_ultra_add_agg(PG_FUNCTION_ARGS)
+{
+    UltraHLL counter;
+    Datum datum;
+    const char * element;
+    int elen;
+    float errorRate = ULTRA_DEFAULT_ERROR;
+
+    if (PG_ARGISNULL(1)){
+        if (PG_ARGISNULL(0)){
+            PG_RETURN_NULL();
+        }
+        PG_RETURN_POINTER(PG_GETARG_ULTRA_P(0));
+    }
+
+    if (PG_ARGISNULL(0)){
+        if (PG_NARGS() > 2 && !PG_ARGISNULL(2)){
+            errorRate = PG_GETARG_FLOAT4(2);
+        }
+        counter = hll_ultra_create(errorRate);
+    } else {
+        counter = PG_GETARG_ULTRA_P(0);
+    }
+
+    pg_element_bytes(fcinfo, 1, &datum, &element, &elen);
+    counter = hll_ultra_add(counter, element, elen);
+
+    PG_RETURN_POINTER(counter);
+}
+
+Datum
+hyperloglog_ultra_merge(PG_FUNCTION_ARGS)
+{
+    UltraHLL counter1;
+
+    if (PG_ARGISNULL(0) && PG_ARGISNULL(1)){
+        PG_RETURN_NULL();
+    } else if (PG_ARGISNULL(0)){
+        PG_RETURN_POINTER(PG_GETARG_ULTRA_P(1));
+    } else if (PG_ARGISNULL(1)){
+        PG_RETURN_POINTER(PG_GETARG_ULTRA_P(0));
+    }
+
+    counter1 = hll_ultra_merge(PG_GETARG_ULTRA_P_COPY(0), PG_GETARG_ULTRA_P(1));
+
+    PG_RETURN_POINTER(counter1);
+}
+
+/* final function of the aggregates, compresses the counter for storage */
+Datum
+hyperloglog_ultra_comp(PG_FUNCTION_ARGS)
+{
+    if (PG_ARGISNULL(0)){
+        PG_RETURN_NULL();
+    }
+
+    PG_RETURN_POINTER(hll_ultra_compress(PG_GETARG_ULTRA_P_COPY(0)));
+}
+
+/* estimate of the distinct items (on a copy, sparse counters are
+ * deduplicated in place) */
+Datum
+hyperloglog_ultra_get_estimate(PG_FUNCTION_ARGS)
+{
+    UltraHLL counter = PG_GETARG_ULTRA_P_COPY(0);
+
+    PG_RETURN_FLOAT8(hll_ultra_estimate(counter));
+}
+
+/* the registers as a regular counter of the same precision */
+Datum
+hyperloglog_ultra_counter(PG_FUNCTION_ARGS)
+{
+    UltraHLL counter = PG_GETARG_ULTRA_P(0);
+    HLLCounter hyperloglog;
+
+    hyperloglog = hll_ultra_to_counter(counter);
+
+    PG_RETURN_BYTEA_P(hll_compact(hll_compress(hyperloglog)));
+}
+
+/* an UltraLogLog counter from a regular counter of at most MAX_INDEX_BITS */
+Datum
+hyperloglog_ultra_from_counter(PG_FUNCTION_ARGS)
+{
+    HLLCounter hyperloglog = PG_GETARG_HLL_P_COPY(0);
+
+    PG_RETURN_POINTER(hll_ultra_compress(hll_ultra_from_counter(hyperloglog)));
+}
+
+/* text and binary I/O of UltraLogLog counters (see pg_varlena_out) */
+Datum
+hyperloglog_ultra_out(PG_FUNCTION_ARGS)
+{
+    PG_RETURN_CSTRING(pg_varlena_out(PG_GETARG_BYTEA_P(0)));
+}
+
+Datum
+hyperloglog_ultra_in(PG_FUNCTION_ARGS)
+{
+    PG_RETURN_POINTER(pg_varlena_in(PG_GETARG_CSTRING(0), offsetof(UltraHLLData, data),
+                                    pg_validate_ultra));
+}
+
+Datum
+hyperloglog_ultra_recv(PG_FUNCTION_ARGS)
+{
+    PG_RETURN_POINTER(pg_varlena_recv((StringInfo) PG_GETARG_POINTER(0), offsetof(UltraHLLData, data),
+                                      pg_validate_ultra));
+}
+
+Datum
+hyperloglog_ultra_send(PG_FUNCTION_ARGS)
+{
+    PG_RETURN_BYTEA_P(PG_GETARG_BYTEA_P(0));
+}
+
+/* --------------------------- Theta sketches ---------------------------- */
+
+/* an empty theta sketch for the optional error rate */
+Datum
+hyperloglog_theta_init(PG_FUNCTION_ARGS)
+{
+    float errorRate = THETA_DEFAULT_ERROR;
+
+    if (PG_NARGS() > 0){
+        errorRate = PG_GETARG_FLOAT4(0);
+    }
+
+    PG_RETURN_POINTER(hll_theta_create(errorRate));
+}
+
+/* Adds the item to a copy of the sketch, NULL items are skipped. */
+Datum
+hyperloglog_theta_add(PG_FUNCTION_ARGS)
+{
+    ThetaSketch sketch;
+    Datum datum;
+    const char * element;
+    int elen;
+
+    if (PG_ARGISNULL(0)){
+        elog(ERROR, "theta sketch must not be NULL");
+    }
+
+    sketch = PG_GETARG_THETA_P_COPY(0);
+
+    if (!PG_ARGISNULL(1)){
+        pg_element_bytes(fcinfo, 1, &datum, &element, &elen);
+        sketch = hll_theta_add(sketch, element, elen);
+    }
+
+    PG_RETURN_POINTER(sketch);
+}
+
+/* Transition function of hyperloglog_theta_accum(item [, error rate]) and
+ * hyperloglog_theta_distinct, the sketch is created with the first item
+ * that isn't NULL */
+Datum
+hyperloglog_theta_add_agg(PG_FUNCTION_ARGS)
+{
+    ThetaSketch sketch;
+    Datum datum;
+    const char * element;
+    int elen;
+    float errorRate = THETA_DEFAULT_ERROR;
+
+    if (PG_ARGISNULL(1)){
+        if (PG_ARGISNULL(0)){
+            PG_RETURN_NULL();
+        }
+        PG_RETURN_POINTER(PG_GETARG_THETA_P(0));
+    }
+
+    if (PG_ARGISNULL(0)){
+        if (PG_NARGS() > 2 && !PG_ARGISNULL(2)){
+            errorRate = PG_GETARG_FLOAT4(2);
+        }
+        sketch = hll_theta_create(errorRate);
+    } else {
+        sketch = PG_GETARG_THETA_P(0);
+    }
+
+    pg_element_bytes(fcinfo, 1, &datum, &element, &elen);
+    sketch = hll_theta_add(sketch, element, elen);
+
+    PG_RETURN_POINTER(sketch);
+}
+
+/* The set operations return a new sketch, NULL sketches are skipped like
+ * for the merges (so the intersection aggregate ignores NULL rows). */
+Datum
+hyperloglog_theta_merge(PG_FUNCTION_ARGS)
+{
+    if (PG_ARGISNULL(0) && PG_ARGISNULL(1)){
+        PG_RETURN_NULL();
+    } else if (PG_ARGISNULL(0)){
+        PG_RETURN_POINTER(PG_GETARG_THETA_P(1));
+    } else if (PG_ARGISNULL(1)){
+        PG_RETURN_POINTER(PG_GETARG_THETA_P(0));
+    }
+
+    PG_RETURN_POINTER(hll_theta_union(PG_GETARG_THETA_P(0), PG_GETARG_THETA_P(1)));
+}
+
+Datum
+hyperloglog_theta_intersect(PG_FUNCTION_ARGS)
+{
+    if (PG_ARGISNULL(0) && PG_ARGISNULL(1)){
+        PG_RETURN_NULL();
+    } else if (PG_ARGISNULL(0)){
+        PG_RETURN_POINTER(PG_GETARG_THETA_P(1));
+    } else if (PG_ARGISNULL(1)){
+        PG_RETURN_POINTER(PG_GETARG_THETA_P(0));
+    }
+
+    PG_RETURN_POINTER(hll_theta_intersect(PG_GETARG_THETA_P(0), PG_GETARG_THETA_P(1)));
+}
+
+/* the items of the first sketch that aren't in the second one */
+Datum
+hyperloglog_theta_a_not_b(PG_FUNCTION_ARGS)
+{
+    if (PG_ARGISNULL(0)){
+        PG_RETURN_NULL();
+    } else if (PG_ARGISNULL(1)){
+        PG_RETURN_POINTER(PG_GETARG_THETA_P(0));
+    }
+
+    PG_RETURN_POINTER(hll_theta_a_not_b(PG_GETARG_THETA_P(0), PG_GETARG_THETA_P(1)));
+}
+
+/* final function of the aggregates, compacts the sketch for storage */
+Datum
+hyperloglog_theta_comp(PG_FUNCTION_ARGS)
+{
+    if (PG_ARGISNULL(0)){
+        PG_RETURN_NULL();
+    }
+
+    PG_RETURN_POINTER(hll_theta_compact(PG_GETARG_THETA_P_COPY(0)));
+}
+
+/* Estimate of the distinct items. The estimate of compact sketches (all
+ * stored by the aggregates and set operations) only needs the header, so
+ * the hashes aren't detoasted at all. */
+Datum
+hyperloglog_theta_estimate(PG_FUNCTION_ARGS)
+{
+    ThetaSketch sketch = PG_GETARG_THETA_HEADER_P(0);
+
+    if (!THETA_IS_COMPACT(sketch)){
+        sketch = PG_GETARG_THETA_P(0);
+    }
+
+    PG_RETURN_FLOAT8(hll_theta_estimate(sketch));
+}
+
+/* text and binary I/O of theta sketches (see pg_varlena_out) */
+Datum
+hyperloglog_theta_out(PG_FUNCTION_ARGS)
+{
+    PG_RETURN_CSTRING(pg_varlena_out(PG_GETARG_BYTEA_P(0)));
+}
+
+Datum
+hyperloglog_theta_in(PG_FUNCTION_ARGS)
+{
+    PG_RETURN_POINTER(pg_varlena_in(PG_GETARG_CSTRING(0), offsetof(ThetaSketchData, data),
+                                    pg_validate_theta));
+}
+
+Datum
+hyperloglog_theta_recv(PG_FUNCTION_ARGS)
+{
+    PG_RETURN_POINTER(pg_varlena_recv((StringInfo) PG_GETARG_POINTER(0), offsetof(ThetaSketchData, data),
+                                      pg_validate_theta));
+}
+
+Datum
+hyperloglog_theta_send(PG_FUNCTION_ARGS)
+{
+    PG_RETURN_BYTEA_P(PG_GETARG_BYTEA_P(0));
+}
@@ -0,0 +1,67 @@
+#ifndef _HLL_PROBES_H_
+#define _HLL_PROBES_H_
+/* Static probe points (SDT markers, like PostgreSQL's TRACE_POSTGRESQL_*
+ * probes) in the hot paths of the engine, so latency spikes can be pinned on
+ * specific counter shapes with perf, bpftrace or systemtap on a production
+ * build, e.g.
+ *
+ *     bpftrace -e 'usdt:$libdir/hyperloglog_counter.so:hyperloglog:merge__start { @[arg0, arg1, arg2] = count(); }'
+ *
+ * They're only compiled in when built with make HLL_SDT=1 (which needs
+ * sys/sdt.h, e.g. from systemtap-sdt-dev), an unattached probe is a single
+ * nop. Otherwise the macros expand to nothing and their arguments aren't
+ * evaluated.
+ *
+ * The arguments describe the counter: its precision (HLL_PRECISION, also for
+ * compressed counters), its representation (0 small set, 1 sparse, 2 dense)
+ * and its size in bytes or number of entries.
+ *
+ *   merge__start(precision, representation1, representation2)
+ *   merge__done(precision, representation)
+ *   compress__start(precision, representation, bytes)
+ *   compress__done(precision, representation, bytes)
+ *   decompress__start(precision, representation, bytes)
+ *   decompress__done(precision, representation, bytes)
+ *   promote__dense(precision, sparse entries)
+ *   dedupe__sort(entries)
+ *   upgrade(version, precision, representation)
+ */
+
+#ifdef HLL_ENABLE_SDT
+
+#include <sys/sdt.h>
+
+#define TRACE_HYPERLOGLOG_MERGE_START(b, repr1, repr2) \
+    DTRACE_PROBE3(hyperloglog, merge__start, b, repr1, repr2)
+#define TRACE_HYPERLOGLOG_MERGE_DONE(b, repr) \
+    DTRACE_PROBE2(hyperloglog, merge__done, b, repr)
+#define TRACE_HYPERLOGLOG_COMPRESS_START(b, repr, bytes) \
+    DTRACE_PROBE3(hyperloglog, compress__start, b, repr, bytes)
+#define TRACE_HYPERLOGLOG_COMPRESS_DONE(b, repr, bytes) \
+    DTRACE_PROBE3(hyperloglog, compress__done, b, repr, bytes)
+#define TRACE_HYPERLOGLOG_DECOMPRESS_START(b, repr, bytes) \
+    DTRACE_PROBE3(hyperloglog, decompress__start, b, repr, bytes)
+#define TRACE_HYPERLOGLOG_DECOMPRESS_DONE(b, repr, bytes) \
+    DTRACE_PROBE3(hyperloglog, decompress__done, b, repr, bytes)
+#define TRACE_HYPERLOGLOG_PROMOTE_DENSE(b, entries) \
+    DTRACE_PROBE2(hyperloglog, promote__dense, b, entries)
+#define TRACE_HYPERLOGLOG_DEDUPE_SORT(entries) \
+    DTRACE_PROBE1(hyperloglog, dedupe__sort, entries)
+#define TRACE_HYPERLOGLOG_UPGRADE(version, b, repr) \
+    DTRACE_PROBE3(hyperloglog, upgrade, version, b, repr)
+
+#else
+
+#define TRACE_HYPERLOGLOG_MERGE_START(b, repr1, repr2) do {} while (0)
+#define TRACE_HYPERLOGLOG_MERGE_DONE(b, repr) do {} while (0)
+#define TRACE_HYPERLOGLOG_COMPRESS_START(b, repr, bytes) do {} while (0)
+#define TRACE_HYPERLOGLOG_COMPRESS_DONE(b, repr, bytes) do {} while (0)
+#define TRACE_HYPERLOGLOG_DECOMPRESS_START(b, repr, bytes) do {} while (0)
+#define TRACE_HYPERLOGLOG_DECOMPRESS_DONE(b, repr, bytes) do {} while (0)
+#define TRACE_HYPERLOGLOG_PROMOTE_DENSE(b, entries) do {} while (0)
+#define TRACE_HYPERLOGLOG_DEDUPE_SORT(entries) do {} while (0)
+#define TRACE_HYPERLOGLOG_UPGRADE(version, b, repr) do {} while (0)
+
+#endif
+
+#endif
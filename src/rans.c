@@ -0,0 +1,236 @@
+/* rANS coding of dense register arrays, see rans.h for a description of the
+ * layout. */
+#include <string.h>
+
+#include "rans.h"
+
+/* lower bound of the normalized state interval [RANS_L, RANS_L << 8) */
+#define RANS_L (1U << 23)
+
+/* ------------- function declarations for local functions --------------- */
+static void rans_normalize(const uint32_t * counts, int nsym, int m, uint32_t * freq);
+static inline void rans_put32(uint8_t * p, uint32_t value);
+static inline uint32_t rans_get32(const uint8_t * p);
+
+/* ---------------------- function definitions --------------------------- */
+
+/* Builds the model (base value and normalized frequencies of the deltas) and
+ * encodes the registers back to front, rANS being a last in first out coder.
+ * The renormalization bytes are written backwards from the end of 'output'
+ * and moved behind the header once the final states are known. */
+uint32_t
+rans_encode_registers(const uint8_t * registers, int m, uint8_t * output, uint32_t capacity)
+{
+    int i, s, nsym;
+    uint8_t base = 255, max = 0;
+    uint32_t counts[RANS_MAX_SYMBOLS] = {0};
+    uint32_t freq[RANS_MAX_SYMBOLS] = {0}, cum[RANS_MAX_SYMBOLS];
+    uint32_t x[2] = {RANS_L, RANS_L};
+    uint32_t f, x_max, header_size, stream_size;
+    uint8_t * ptr = output + capacity;
+    uint8_t * header;
+
+    for (i = 0; i < m; i++){
+        counts[registers[i]]++;
+        if (registers[i] < base){
+            base = registers[i];
+        }
+        if (registers[i] > max){
+            max = registers[i];
+        }
+    }
+
+    nsym = max - base + 1;
+    header_size = 2 + 2 * nsym + 8;
+    if (capacity < header_size){
+        return 0;
+    }
+
+    rans_normalize(counts + base, nsym, m, freq);
+
+    cum[0] = 0;
+    for (s = 1; s < nsym; s++){
+        cum[s] = cum[s - 1] + freq[s - 1];
+    }
+
+    for (i = m - 1; i >= 0; i--){
+        s = registers[i] - base;
+        f = freq[s];
+
+        /* renormalize so the state stays in range after encoding */
+        x_max = ((RANS_L >> RANS_PROB_BITS) << 8) * f;
+        while (x[i & 1] >= x_max){
+            if (ptr <= output + header_size){
+                return 0;
+            }
+            *--ptr = (uint8_t) (x[i & 1] & 0xFF);
+            x[i & 1] >>= 8;
+        }
+
+        x[i & 1] = ((x[i & 1] / f) << RANS_PROB_BITS) + (x[i & 1] % f) + cum[s];
+    }
+
+    header = output;
+    header[0] = base;
+    header[1] = (uint8_t) (nsym - 1);
+    for (s = 0; s < nsym; s++){
+        header[2 + 2 * s] = (uint8_t) (freq[s] & 0xFF);
+        header[3 + 2 * s] = (uint8_t) (freq[s] >> 8);
+    }
+    rans_put32(header + 2 + 2 * nsym, x[0]);
+    rans_put32(header + 6 + 2 * nsym, x[1]);
+
+    stream_size = (output + capacity) - ptr;
+    memmove(output + header_size, ptr, stream_size);
+
+    return header_size + stream_size;
+}
+
+/* Decodes the registers front to back. The model is validated before use and
+ * every stream byte is bounds checked, both states have to end up at their
+ * initial value for the data to be considered intact. */
+int
+rans_decode_registers(const uint8_t * input, uint32_t size, uint8_t * registers, int m, uint8_t max_value)
+{
+    RansDecoder decoder;
+
+    if (rans_decode_init(&decoder, input, size, max_value) != 0 ||
+        rans_decode_block(&decoder, registers, m) != 0){
+        return -1;
+    }
+
+    return rans_decode_finish(&decoder);
+}
+
+/* Reads and validates the model and the final encoder states */
+int
+rans_decode_init(RansDecoder * decoder, const uint8_t * input, uint32_t size, uint8_t max_value)
+{
+    int s, nsym;
+    uint32_t total = 0;
+
+    if (size < 2){
+        return -1;
+    }
+
+    decoder->base = input[0];
+    nsym = input[1] + 1;
+    if (size < (uint32_t) (2 + 2 * nsym + 8) || decoder->base + nsym - 1 > max_value){
+        return -1;
+    }
+
+    for (s = 0; s < nsym; s++){
+        decoder->freq[s] = input[2 + 2 * s] | ((uint32_t) input[3 + 2 * s] << 8);
+        decoder->cum[s] = total;
+        total += decoder->freq[s];
+        if (total > RANS_PROB_SCALE){
+            return -1;
+        }
+        memset(decoder->slot + decoder->cum[s], s, decoder->freq[s]);
+    }
+    if (total != RANS_PROB_SCALE){
+        return -1;
+    }
+
+    decoder->ptr = input + 2 + 2 * nsym;
+    decoder->end = input + size;
+    decoder->x[0] = rans_get32(decoder->ptr);
+    decoder->x[1] = rans_get32(decoder->ptr + 4);
+    decoder->ptr += 8;
+
+    return 0;
+}
+
+/* Decodes the next 'n' registers, the states are kept in locals while the
+ * block is decoded */
+int
+rans_decode_block(RansDecoder * decoder, uint8_t * registers, int n)
+{
+    int i, s;
+    uint8_t base = decoder->base;
+    const uint32_t * freq = decoder->freq;
+    const uint32_t * cum = decoder->cum;
+    const uint8_t * slot = decoder->slot;
+    uint32_t x0 = decoder->x[0], x1 = decoder->x[1];
+    const uint8_t * ptr = decoder->ptr;
+    const uint8_t * end = decoder->end;
+
+    for (i = 0; i < n; i += 2){
+        s = slot[x0 & RANS_PROB_MASK];
+        registers[i] = base + s;
+        x0 = freq[s] * (x0 >> RANS_PROB_BITS) + (x0 & RANS_PROB_MASK) - cum[s];
+
+        s = slot[x1 & RANS_PROB_MASK];
+        registers[i + 1] = base + s;
+        x1 = freq[s] * (x1 >> RANS_PROB_BITS) + (x1 & RANS_PROB_MASK) - cum[s];
+
+        while (x0 < RANS_L){
+            if (ptr >= end){
+                return -1;
+            }
+            x0 = (x0 << 8) | *ptr++;
+        }
+        while (x1 < RANS_L){
+            if (ptr >= end){
+                return -1;
+            }
+            x1 = (x1 << 8) | *ptr++;
+        }
+    }
+
+    decoder->x[0] = x0;
+    decoder->x[1] = x1;
+    decoder->ptr = ptr;
+
+    return 0;
+}
+
+/* The encoder starts from RANS_L and its output is exactly what the decoder
+ * reads, so both states have to be back at RANS_L with no bytes left over */
+int
+rans_decode_finish(const RansDecoder * decoder)
+{
+    if (decoder->ptr != decoder->end){
+        return -1;
+    }
+
+    return (decoder->x[0] == RANS_L && decoder->x[1] == RANS_L) ? 0 : -1;
+}
+
+/* Scales the symbol counts so they sum to RANS_PROB_SCALE while keeping every
+ * symbol that occurs at a frequency of at least 1. The rounding error is
+ * given to (or taken from) the most frequent symbol. */
+static void
+rans_normalize(const uint32_t * counts, int nsym, int m, uint32_t * freq)
+{
+    int s, largest = 0;
+    int32_t total = 0;
+
+    for (s = 0; s < nsym; s++){
+        freq[s] = (uint32_t) (((uint64_t) counts[s] * RANS_PROB_SCALE) / m);
+        if (counts[s] > 0 && freq[s] == 0){
+            freq[s] = 1;
+        }
+        if (freq[s] > freq[largest]){
+            largest = s;
+        }
+        total += freq[s];
+    }
+
+    freq[largest] += RANS_PROB_SCALE - total;
+}
+
+static inline void
+rans_put32(uint8_t * p, uint32_t value)
+{
+    p[0] = (uint8_t) value;
+    p[1] = (uint8_t) (value >> 8);
+    p[2] = (uint8_t) (value >> 16);
+    p[3] = (uint8_t) (value >> 24);
+}
+
+static inline uint32_t
+rans_get32(const uint8_t * p)
+{
+    return p[0] | ((uint32_t) p[1] << 8) | ((uint32_t) p[2] << 16) | ((uint32_t) p[3] << 24);
+}
@@ -0,0 +1,73 @@
+/* Entropy coding of dense register arrays using rANS (range asymmetric
+ * numeral systems) as described in "Asymmetric numeral systems: entropy
+ * coding combining speed of Huffman coding with compression rate of
+ * arithmetic coding" by Jarek Duda, following the byte-wise renormalizing
+ * variant popularized by Fabian Giesen.
+ *
+ * Register values follow a nearly geometric distribution around log2(n/m) so
+ * a static model built per counter gets close to their entropy (~2.5-3 bits
+ * per register for large cardinalities), while lz compression can only use
+ * repeated runs.
+ *
+ * Layout for m registers:
+ *
+ *     uint8      base             smallest register value
+ *     uint8      nsym - 1         number of symbols (register - base)
+ *     uint16     freq[nsym]       normalized frequencies, sum to 4096
+ *     uint32     state[2]         final encoder states
+ *     uint8      stream[]         renormalization bytes
+ *
+ * All multi-byte values are little-endian. Two interleaved rANS states are
+ * used (even registers use the first, odd registers the second) so the
+ * decoder can work on two symbols in parallel. Symbols are decoded with a
+ * 4096 entry slot lookup table. */
+#ifndef _RANS_H_
+#define _RANS_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+/* upper bound on the number of bytes used to encode 'm' registers, every
+ * register takes at most 12 bits and there are at most 256 symbols */
+#define RANS_MAX_ENCODED_SIZE(m) (2 + 2 * 256 + 8 + 2 * (m))
+
+/* probabilities are quantized to 12 bits */
+#define RANS_PROB_BITS 12
+#define RANS_PROB_SCALE (1 << RANS_PROB_BITS)
+#define RANS_PROB_MASK (RANS_PROB_SCALE - 1)
+
+#define RANS_MAX_SYMBOLS 256
+
+/* State of a decoder going through the registers a block at a time, so the
+ * registers of a large counter can be decoded without a buffer for all of
+ * them (see rans_decode_init) */
+typedef struct RansDecoder {
+    const uint8_t * ptr;
+    const uint8_t * end;
+    uint32_t x[2];
+    uint32_t freq[RANS_MAX_SYMBOLS];
+    uint32_t cum[RANS_MAX_SYMBOLS];
+    uint8_t slot[RANS_PROB_SCALE];
+    uint8_t base;
+} RansDecoder;
+
+/* ---------------------- function declarations ------------------------ */
+
+/* Encodes 'm' (even) register values into 'output'. Returns the number of
+ * bytes used or 0 if the result doesn't fit into 'capacity' bytes. */
+uint32_t rans_encode_registers(const uint8_t * registers, int m, uint8_t * output, uint32_t capacity);
+
+/* Decodes 'm' (even) register values from 'size' bytes of 'input'. Returns 0
+ * on success and -1 when the data is corrupted (never reads past 'size' or
+ * produces values above 'max_value'). */
+int rans_decode_registers(const uint8_t * input, uint32_t size, uint8_t * registers, int m, uint8_t max_value);
+
+/* The steps of rans_decode_registers: reads the model of 'size' bytes of
+ * 'input', decodes the next 'n' (even) registers and checks the whole stream
+ * was consumed once all of them are decoded. Each returns 0 on success and -1
+ * when the data is corrupted. */
+int rans_decode_init(RansDecoder * decoder, const uint8_t * input, uint32_t size, uint8_t max_value);
+int rans_decode_block(RansDecoder * decoder, uint8_t * registers, int n);
+int rans_decode_finish(const RansDecoder * decoder);
+
+#endif /* _RANS_H_ */
@@ -0,0 +1,296 @@
+/* This file contains the functions of the sliding window counters exposed via
+ * sliding.h (see there for how the counters work). */
+#include <stdint.h>
+#include <stdlib.h>
+#include <math.h>
+#include <string.h>
+
+#include "postgres.h"
+
+#include "hyperloglog.h"
+#include "hllutils.h"
+#include "sliding.h"
+
+/* Counters start with room for this many pairs, the array is doubled
+ * whenever pruning doesn't free more than half of it. */
+#define SLIDING_MIN_ENTRIES 16
+
+#define SLIDING_CAPACITY(s) ((int)((VARSIZE(s) - offsetof(SlidingHLLData, data)) / sizeof(SlidingEntry)))
+#define SLIDING_LENGTH(entries) (offsetof(SlidingHLLData, data) + (entries) * sizeof(SlidingEntry))
+
+/* ------------- function declarations for local functions --------------- */
+static int64_t sliding_cutoff(SlidingHLL counter);
+static int entry_cmp(const void * a, const void * b);
+static void sliding_prune(SlidingHLL counter);
+static SlidingHLL sliding_resize(SlidingHLL counter, int capacity);
+
+/* ---------------------- function definitions --------------------------- */
+
+SlidingHLL
+hll_sliding_create(float error, int64_t window)
+{
+    SlidingHLL counter;
+    float m;
+    int b;
+
+    if (error <= 0 || error >= 1){
+        elog(ERROR, "invalid error rate requested - only values in (0,1) allowed");
+    }
+    if (window < 0){
+        elog(ERROR, "window of a sliding counter can't be negative");
+    }
+
+    /* the same precision hll_create picks for the error rate */
+    m = ERROR_CONST / (error * error);
+    b = (int)ceil(log2(m));
+    if (b < MIN_INDEX_BITS){
+        b = MIN_INDEX_BITS;
+    } else if (b > MAX_INDEX_BITS){
+        elog(ERROR, "number of index bits exceeds MAX_INDEX_BITS (requested %d)", b);
+    }
+
+    counter = palloc0(SLIDING_LENGTH(SLIDING_MIN_ENTRIES));
+    SET_VARSIZE(counter, SLIDING_LENGTH(SLIDING_MIN_ENTRIES));
+    counter->b = b;
+    counter->binbits = SLIDING_BINBITS;
+    counter->version = SLIDING_VERSION;
+    counter->window = window;
+
+    return counter;
+}
+
+SlidingHLL
+hll_sliding_copy(SlidingHLL counter)
+{
+    SlidingHLL copy = palloc(VARSIZE(counter));
+
+    memcpy(copy, counter, VARSIZE(counter));
+
+    return copy;
+}
+
+/* Pairs before this time have expired (empty counters and those without a
+ * window keep everything) */
+static int64_t
+sliding_cutoff(SlidingHLL counter)
+{
+    if (counter->window == 0 || counter->entries == 0 || counter->latest < INT64_MIN + counter->window){
+        return INT64_MIN;
+    }
+
+    return counter->latest - counter->window;
+}
+
+SlidingHLL
+hll_sliding_add(SlidingHLL counter, const char * element, int elen, int64_t time)
+{
+    SlidingEntry * entry;
+    uint32_t idx;
+    uint8_t rho;
+
+    /* an item that is already out of the window can't change any estimate */
+    if (time < sliding_cutoff(counter)){
+        return counter;
+    }
+
+    hll_element_register(element, elen, counter->b, counter->binbits, &idx, &rho);
+
+    if (counter->entries == SLIDING_CAPACITY(counter)){
+        sliding_prune(counter);
+        if (counter->entries >= SLIDING_CAPACITY(counter) / 2){
+            counter = sliding_resize(counter, Max(2 * SLIDING_CAPACITY(counter), SLIDING_MIN_ENTRIES));
+        }
+    }
+
+    if (counter->entries == 0 || time > counter->latest){
+        counter->latest = time;
+    }
+
+    /* zeroed so the padding of stored counters is deterministic */
+    entry = &counter->data[counter->entries++];
+    memset(entry, 0, sizeof(SlidingEntry));
+    entry->time = time;
+    entry->idx = idx;
+    entry->rho = rho;
+
+    return counter;
+}
+
+/* Appends the pairs of counter2 to counter1 and prunes the result. Both have
+ * to use the same precision. */
+SlidingHLL
+hll_sliding_merge(SlidingHLL counter1, SlidingHLL counter2)
+{
+    int entries, capacity;
+
+    if (counter1->b != counter2->b){
+        elog(ERROR, "index size (bit length) of sliding counters differs (%d != %d)", counter1->b, counter2->b);
+    } else if (counter1->binbits != counter2->binbits){
+        elog(ERROR, "bin size of sliding counters differs (%d != %d)", counter1->binbits, counter2->binbits);
+    }
+
+    if (counter2->entries == 0){
+        return counter1;
+    }
+
+    entries = counter1->entries + counter2->entries;
+    if (entries > SLIDING_CAPACITY(counter1)){
+        for (capacity = SLIDING_MIN_ENTRIES; capacity < entries; capacity *= 2);
+        counter1 = sliding_resize(counter1, capacity);
+    }
+
+    /* pairs only expire within the smaller window */
+    if (counter1->window == 0 || (counter2->window != 0 && counter2->window < counter1->window)){
+        counter1->window = counter2->window;
+    }
+    if (counter1->entries == 0 || counter2->latest > counter1->latest){
+        counter1->latest = counter2->latest;
+    }
+
+    memcpy(&counter1->data[counter1->entries], counter2->data, counter2->entries * sizeof(SlidingEntry));
+    counter1->entries = entries;
+
+    sliding_prune(counter1);
+
+    return counter1;
+}
+
+SlidingHLL
+hll_sliding_compact(SlidingHLL counter)
+{
+    sliding_prune(counter);
+
+    return sliding_resize(counter, counter->entries);
+}
+
+double
+hll_sliding_estimate(SlidingHLL counter, int64_t since)
+{
+    return hll_estimate(hll_sliding_registers(counter, since));
+}
+
+/* The pairs don't have to be pruned, the largest rho at or after 'since' is
+ * the same either way. Times before the window are treated as its start so
+ * pairs that expired since the last pruning aren't counted. */
+HLLCounter
+hll_sliding_registers(SlidingHLL counter, int64_t since)
+{
+    HLLCounter hloglog;
+    size_t length = sizeof(HLLData) + POW2(counter->b);
+    int i;
+
+    since = Max(since, sliding_cutoff(counter));
+
+    hloglog = palloc0(length);
+    SET_VARSIZE(hloglog, length);
+    hloglog->b = counter->b;
+    hloglog->binbits = counter->binbits;
+    hloglog->version = STRUCT_VERSION;
+    hloglog->format = UNPACKED;
+    hloglog->idx = -1;
+
+    for (i = 0; i < counter->entries; i++){
+        const SlidingEntry * entry = &counter->data[i];
+
+        if (entry->time >= since && entry->rho > (uint8_t) hloglog->data[entry->idx]){
+            hloglog->data[entry->idx] = entry->rho;
+        }
+    }
+
+    return hloglog;
+}
+
+void
+hll_sliding_validate(SlidingHLL counter)
+{
+    int i;
+
+    if (VARSIZE(counter) < offsetof(SlidingHLLData, data)){
+        elog(ERROR, "sliding counter is too short");
+    } else if (counter->version != SLIDING_VERSION){
+        elog(ERROR, "unsupported sliding counter version %u (expected %u)", counter->version, SLIDING_VERSION);
+    } else if (counter->b < MIN_INDEX_BITS || counter->b > MAX_INDEX_BITS || counter->binbits != SLIDING_BINBITS || counter->flags != 0){
+        elog(ERROR, "sliding counter header is corrupted");
+    } else if (counter->window < 0 || counter->entries < 0 || counter->entries > SLIDING_CAPACITY(counter) ||
+               counter->pruned < 0 || counter->pruned > counter->entries){
+        elog(ERROR, "sliding counter header is corrupted");
+    }
+
+    for (i = 0; i < counter->entries; i++){
+        if (counter->data[i].idx >= POW2(counter->b) || counter->data[i].rho == 0 || counter->data[i].time > counter->latest){
+            elog(ERROR, "sliding counter data is corrupted");
+        }
+    }
+}
+
+/* orders the pairs by register, time and rho */
+static int
+entry_cmp(const void * a, const void * b)
+{
+    const SlidingEntry * x = (const SlidingEntry *) a;
+    const SlidingEntry * y = (const SlidingEntry *) b;
+
+    if (x->idx != y->idx){
+        return (x->idx > y->idx) - (x->idx < y->idx);
+    } else if (x->time != y->time){
+        return (x->time > y->time) - (x->time < y->time);
+    }
+
+    return (x->rho > y->rho) - (x->rho < y->rho);
+}
+
+/* Reduces the pairs of every register to its LFPM and drops the expired ones.
+ * Walking a register's pairs from the latest one back a pair is kept only if
+ * its rho is larger than all the later ones (of the pairs with the same time
+ * the one with the largest rho comes last). Dropped pairs get rho 0 and the
+ * rest is moved forward. */
+static void
+sliding_prune(SlidingHLL counter)
+{
+    SlidingEntry * data = counter->data;
+    int64_t cutoff = sliding_cutoff(counter);
+    int i, j = 0, start, end;
+    uint8_t max;
+
+    if (counter->pruned == counter->entries){
+        return;
+    }
+
+    qsort(data, counter->entries, sizeof(SlidingEntry), entry_cmp);
+
+    for (start = 0; start < counter->entries; start = end){
+        for (end = start + 1; end < counter->entries && data[end].idx == data[start].idx; end++);
+
+        max = 0;
+        for (i = end - 1; i >= start; i--){
+            if (data[i].time >= cutoff && data[i].rho > max){
+                max = data[i].rho;
+            } else {
+                data[i].rho = 0;
+            }
+        }
+
+        for (i = start; i < end; i++){
+            if (data[i].rho != 0){
+                data[j++] = data[i];
+            }
+        }
+    }
+
+    counter->entries = j;
+    counter->pruned = j;
+}
+
+/* Moves the counter into a new (zeroed) allocation with room for 'capacity'
+ * pairs like sparse_grow, the old counter stays untouched (it may be the
+ * transition state of an aggregate, which PostgreSQL frees itself) */
+static SlidingHLL
+sliding_resize(SlidingHLL counter, int capacity)
+{
+    SlidingHLL result = palloc0(SLIDING_LENGTH(capacity));
+
+    memcpy(result, counter, Min(VARSIZE(counter), SLIDING_LENGTH(capacity)));
+    SET_VARSIZE(result, SLIDING_LENGTH(capacity));
+
+    return result;
+}
@@ -0,0 +1,101 @@
+#ifndef _SLIDING_H_
+#define _SLIDING_H_
+/* Sliding window HyperLogLog as described in "Sliding HyperLogLog: Estimating
+ * cardinality in a data stream over a sliding window", published by Yousra
+ * Chabchoub and Georges Hebrail in 2010.
+ *
+ * Instead of the largest rho of each register the counter keeps the list of
+ * future possible maxima (LFPM) of the register: every (time, rho) pair that
+ * isn't dominated by a later (or simultaneous) pair with the same or a larger
+ * rho. Along a list the times increase and the rhos decrease, so the largest
+ * rho of the items added since any time t is the first pair at or after t. An
+ * estimate since t takes that for every register and runs the usual dense
+ * estimate (hll_estimate) on the result, without keeping or merging per
+ * minute counters.
+ *
+ * Pairs older than the window (relative to the latest time added) can no
+ * longer matter and are dropped, estimates since an earlier time only count
+ * the window. A window of 0 keeps everything.
+ *
+ * The registers and rhos are the ones a hyperloglog_estimator of the same
+ * precision would have (see hll_element_register), so a window can be turned
+ * into a regular counter and merged with them.
+ *
+ * Like the sparse array of HLLCounter the pairs are simply appended as items
+ * are added, the array is pruned down to the LFPMs (sorted by register and
+ * time, expired pairs dropped) when it fills up and doubled if that doesn't
+ * free more than half of it. Estimates don't need the pairs sorted.
+ *
+ * SLIDING_VERSION
+ * 1 - Initial version. */
+#define SLIDING_VERSION 1
+#define SLIDING_BINBITS 6
+
+typedef struct SlidingEntry {
+
+    /* time the item was added (microseconds for timestamptz) */
+    int64_t time;
+
+    /* register index and value */
+    uint32_t idx;
+    uint8_t rho;
+
+} SlidingEntry;
+
+typedef struct SlidingHLLData {
+
+    /* varlena header */
+    char vl_len_[4];
+
+    /* bits for the register index and per register (same as HLLData) */
+    int8_t b;
+    uint8_t binbits;
+
+    uint8_t version;
+
+    /* unused, always 0 */
+    uint8_t flags;
+
+    /* number of pairs in the data array, the allocation may hold more */
+    int32_t entries;
+
+    /* number of leading pairs that are pruned (sorted LFPMs) */
+    int32_t pruned;
+
+    /* width of the window and the latest time added */
+    int64_t window;
+    int64_t latest;
+
+    SlidingEntry data[1];
+
+} SlidingHLLData;
+
+typedef SlidingHLLData * SlidingHLL;
+
+/* creates an empty counter for the error rate (like hll_create) and window */
+SlidingHLL hll_sliding_create(float error, int64_t window);
+
+SlidingHLL hll_sliding_copy(SlidingHLL counter);
+
+/* adds an element seen at the given time, returns the counter or a larger
+ * copy of it (the argument is never freed) */
+SlidingHLL hll_sliding_add(SlidingHLL counter, const char * element, int elen, int64_t time);
+
+/* merges counter2 into counter1 (the window is the smaller of the two) */
+SlidingHLL hll_sliding_merge(SlidingHLL counter1, SlidingHLL counter2);
+
+/* prunes the pairs and trims the allocation, for storing the counter */
+SlidingHLL hll_sliding_compact(SlidingHLL counter);
+
+/* estimate of the distinct items added at or after 'since' */
+double hll_sliding_estimate(SlidingHLL counter, int64_t since);
+
+/* the registers of the items added at or after 'since' as an unpacked dense
+ * HLLCounter */
+HLLCounter hll_sliding_registers(SlidingHLL counter, int64_t since);
+
+/* checks that a counter read from outside is consistent, errors out
+ * otherwise */
+void hll_sliding_validate(SlidingHLL counter);
+
+#endif // #ifndef _SLIDING_H_
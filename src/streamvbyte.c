@@ -0,0 +1,958 @@
+/* Stream VByte encoding/decoding of sorted uint32 arrays, see streamvbyte.h
+ * for a description of the layout. */
+#include <string.h>
+
+#include "streamvbyte.h"
+
+#if !defined(HLL_NO_SIMD) && defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define SVB_SSSE3 1
+#include <tmmintrin.h>
+#endif
+
+/* Reads the values of an encoded array one at a time, see svb_reader_next */
+typedef struct {
+    const uint8_t * ctrl;
+    const uint8_t * data;
+    int32_t i;
+    int32_t length;
+    uint32_t value;
+} SVBReader;
+
+/* ------------- function declarations for local functions --------------- */
+static inline uint8_t svb_code(uint32_t value);
+static uint8_t * svb_encode_scalar(const uint32_t * input, int32_t start, int32_t length, uint8_t * ctrl, uint8_t * data);
+static void svb_decode_scalar(const uint8_t * ctrl, const uint8_t * data, int32_t start, int32_t length, uint32_t * output);
+static inline int svb_reader_next(SVBReader * reader);
+static inline void svb_write(uint8_t * ctrl, uint8_t ** data, int32_t i, uint32_t delta);
+
+#ifdef SVB_SSSE3
+static int svb_have_ssse3(void);
+static uint8_t * svb_encode_ssse3(const uint32_t * input, int32_t groups, uint8_t * ctrl, uint8_t * data);
+static inline __m128i svb_expand_group_ssse3(__m128i v, uint8_t c, __m128i prev, uint32_t * output);
+static const uint8_t * svb_decode_ssse3(const uint8_t * ctrl, const uint8_t * data, int32_t length, uint32_t * output);
+#endif
+
+/* ---------------------- lookup tables --------------------------------- */
+#ifdef SVB_SSSE3
+/* total number of data bytes described by a control byte */
+static const uint8_t SVB_LENGTH_ARR[256] =
+{
+     4,  5,  6,  7,  5,  6,  7,  8,  6,  7,  8,  9,  7,  8,  9, 10,
+     5,  6,  7,  8,  6,  7,  8,  9,  7,  8,  9, 10,  8,  9, 10, 11,
+     6,  7,  8,  9,  7,  8,  9, 10,  8,  9, 10, 11,  9, 10, 11, 12,
+     7,  8,  9, 10,  8,  9, 10, 11,  9, 10, 11, 12, 10, 11, 12, 13,
+     5,  6,  7,  8,  6,  7,  8,  9,  7,  8,  9, 10,  8,  9, 10, 11,
+     6,  7,  8,  9,  7,  8,  9, 10,  8,  9, 10, 11,  9, 10, 11, 12,
+     7,  8,  9, 10,  8,  9, 10, 11,  9, 10, 11, 12, 10, 11, 12, 13,
+     8,  9, 10, 11,  9, 10, 11, 12, 10, 11, 12, 13, 11, 12, 13, 14,
+     6,  7,  8,  9,  7,  8,  9, 10,  8,  9, 10, 11,  9, 10, 11, 12,
+     7,  8,  9, 10,  8,  9, 10, 11,  9, 10, 11, 12, 10, 11, 12, 13,
+     8,  9, 10, 11,  9, 10, 11, 12, 10, 11, 12, 13, 11, 12, 13, 14,
+     9, 10, 11, 12, 10, 11, 12, 13, 11, 12, 13, 14, 12, 13, 14, 15,
+     7,  8,  9, 10,  8,  9, 10, 11,  9, 10, 11, 12, 10, 11, 12, 13,
+     8,  9, 10, 11,  9, 10, 11, 12, 10, 11, 12, 13, 11, 12, 13, 14,
+     9, 10, 11, 12, 10, 11, 12, 13, 11, 12, 13, 14, 12, 13, 14, 15,
+    10, 11, 12, 13, 11, 12, 13, 14, 12, 13, 14, 15, 13, 14, 15, 16
+};
+
+/* pshufb masks expanding the packed data bytes of a group into 4 uint32s */
+static const uint8_t SVB_DECODE_SHUFFLE_ARR[256][16] =
+{
+    {0x00, 0x80, 0x80, 0x80, 0x01, 0x80, 0x80, 0x80, 0x02, 0x80, 0x80, 0x80, 0x03, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x80, 0x80, 0x02, 0x80, 0x80, 0x80, 0x03, 0x80, 0x80, 0x80, 0x04, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x02, 0x80, 0x03, 0x80, 0x80, 0x80, 0x04, 0x80, 0x80, 0x80, 0x05, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x02, 0x03, 0x04, 0x80, 0x80, 0x80, 0x05, 0x80, 0x80, 0x80, 0x06, 0x80, 0x80, 0x80},
+    {0x00, 0x80, 0x80, 0x80, 0x01, 0x02, 0x80, 0x80, 0x03, 0x80, 0x80, 0x80, 0x04, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x80, 0x80, 0x02, 0x03, 0x80, 0x80, 0x04, 0x80, 0x80, 0x80, 0x05, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x02, 0x80, 0x03, 0x04, 0x80, 0x80, 0x05, 0x80, 0x80, 0x80, 0x06, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x80, 0x80, 0x06, 0x80, 0x80, 0x80, 0x07, 0x80, 0x80, 0x80},
+    {0x00, 0x80, 0x80, 0x80, 0x01, 0x02, 0x03, 0x80, 0x04, 0x80, 0x80, 0x80, 0x05, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x80, 0x80, 0x02, 0x03, 0x04, 0x80, 0x05, 0x80, 0x80, 0x80, 0x06, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x02, 0x80, 0x03, 0x04, 0x05, 0x80, 0x06, 0x80, 0x80, 0x80, 0x07, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x80, 0x07, 0x80, 0x80, 0x80, 0x08, 0x80, 0x80, 0x80},
+    {0x00, 0x80, 0x80, 0x80, 0x01, 0x02, 0x03, 0x04, 0x05, 0x80, 0x80, 0x80, 0x06, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x80, 0x80, 0x02, 0x03, 0x04, 0x05, 0x06, 0x80, 0x80, 0x80, 0x07, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x02, 0x80, 0x03, 0x04, 0x05, 0x06, 0x07, 0x80, 0x80, 0x80, 0x08, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x80, 0x80, 0x80, 0x09, 0x80, 0x80, 0x80},
+    {0x00, 0x80, 0x80, 0x80, 0x01, 0x80, 0x80, 0x80, 0x02, 0x03, 0x80, 0x80, 0x04, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x80, 0x80, 0x02, 0x80, 0x80, 0x80, 0x03, 0x04, 0x80, 0x80, 0x05, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x02, 0x80, 0x03, 0x80, 0x80, 0x80, 0x04, 0x05, 0x80, 0x80, 0x06, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x02, 0x03, 0x04, 0x80, 0x80, 0x80, 0x05, 0x06, 0x80, 0x80, 0x07, 0x80, 0x80, 0x80},
+    {0x00, 0x80, 0x80, 0x80, 0x01, 0x02, 0x80, 0x80, 0x03, 0x04, 0x80, 0x80, 0x05, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x80, 0x80, 0x02, 0x03, 0x80, 0x80, 0x04, 0x05, 0x80, 0x80, 0x06, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x02, 0x80, 0x03, 0x04, 0x80, 0x80, 0x05, 0x06, 0x80, 0x80, 0x07, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x80, 0x80, 0x06, 0x07, 0x80, 0x80, 0x08, 0x80, 0x80, 0x80},
+    {0x00, 0x80, 0x80, 0x80, 0x01, 0x02, 0x03, 0x80, 0x04, 0x05, 0x80, 0x80, 0x06, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x80, 0x80, 0x02, 0x03, 0x04, 0x80, 0x05, 0x06, 0x80, 0x80, 0x07, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x02, 0x80, 0x03, 0x04, 0x05, 0x80, 0x06, 0x07, 0x80, 0x80, 0x08, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x80, 0x07, 0x08, 0x80, 0x80, 0x09, 0x80, 0x80, 0x80},
+    {0x00, 0x80, 0x80, 0x80, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x80, 0x80, 0x07, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x80, 0x80, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x80, 0x80, 0x08, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x02, 0x80, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x80, 0x80, 0x09, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x80, 0x80, 0x0a, 0x80, 0x80, 0x80},
+    {0x00, 0x80, 0x80, 0x80, 0x01, 0x80, 0x80, 0x80, 0x02, 0x03, 0x04, 0x80, 0x05, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x80, 0x80, 0x02, 0x80, 0x80, 0x80, 0x03, 0x04, 0x05, 0x80, 0x06, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x02, 0x80, 0x03, 0x80, 0x80, 0x80, 0x04, 0x05, 0x06, 0x80, 0x07, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x02, 0x03, 0x04, 0x80, 0x80, 0x80, 0x05, 0x06, 0x07, 0x80, 0x08, 0x80, 0x80, 0x80},
+    {0x00, 0x80, 0x80, 0x80, 0x01, 0x02, 0x80, 0x80, 0x03, 0x04, 0x05, 0x80, 0x06, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x80, 0x80, 0x02, 0x03, 0x80, 0x80, 0x04, 0x05, 0x06, 0x80, 0x07, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x02, 0x80, 0x03, 0x04, 0x80, 0x80, 0x05, 0x06, 0x07, 0x80, 0x08, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x80, 0x80, 0x06, 0x07, 0x08, 0x80, 0x09, 0x80, 0x80, 0x80},
+    {0x00, 0x80, 0x80, 0x80, 0x01, 0x02, 0x03, 0x80, 0x04, 0x05, 0x06, 0x80, 0x07, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x80, 0x80, 0x02, 0x03, 0x04, 0x80, 0x05, 0x06, 0x07, 0x80, 0x08, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x02, 0x80, 0x03, 0x04, 0x05, 0x80, 0x06, 0x07, 0x08, 0x80, 0x09, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x80, 0x07, 0x08, 0x09, 0x80, 0x0a, 0x80, 0x80, 0x80},
+    {0x00, 0x80, 0x80, 0x80, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x80, 0x08, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x80, 0x80, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x80, 0x09, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x02, 0x80, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x80, 0x0a, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x80, 0x0b, 0x80, 0x80, 0x80},
+    {0x00, 0x80, 0x80, 0x80, 0x01, 0x80, 0x80, 0x80, 0x02, 0x03, 0x04, 0x05, 0x06, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x80, 0x80, 0x02, 0x80, 0x80, 0x80, 0x03, 0x04, 0x05, 0x06, 0x07, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x02, 0x80, 0x03, 0x80, 0x80, 0x80, 0x04, 0x05, 0x06, 0x07, 0x08, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x02, 0x03, 0x04, 0x80, 0x80, 0x80, 0x05, 0x06, 0x07, 0x08, 0x09, 0x80, 0x80, 0x80},
+    {0x00, 0x80, 0x80, 0x80, 0x01, 0x02, 0x80, 0x80, 0x03, 0x04, 0x05, 0x06, 0x07, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x80, 0x80, 0x02, 0x03, 0x80, 0x80, 0x04, 0x05, 0x06, 0x07, 0x08, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x02, 0x80, 0x03, 0x04, 0x80, 0x80, 0x05, 0x06, 0x07, 0x08, 0x09, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x80, 0x80, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x80, 0x80, 0x80},
+    {0x00, 0x80, 0x80, 0x80, 0x01, 0x02, 0x03, 0x80, 0x04, 0x05, 0x06, 0x07, 0x08, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x80, 0x80, 0x02, 0x03, 0x04, 0x80, 0x05, 0x06, 0x07, 0x08, 0x09, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x02, 0x80, 0x03, 0x04, 0x05, 0x80, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x80, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x80, 0x80, 0x80},
+    {0x00, 0x80, 0x80, 0x80, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x80, 0x80, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x02, 0x80, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x80, 0x80, 0x80},
+    {0x00, 0x80, 0x80, 0x80, 0x01, 0x80, 0x80, 0x80, 0x02, 0x80, 0x80, 0x80, 0x03, 0x04, 0x80, 0x80},
+    {0x00, 0x01, 0x80, 0x80, 0x02, 0x80, 0x80, 0x80, 0x03, 0x80, 0x80, 0x80, 0x04, 0x05, 0x80, 0x80},
+    {0x00, 0x01, 0x02, 0x80, 0x03, 0x80, 0x80, 0x80, 0x04, 0x80, 0x80, 0x80, 0x05, 0x06, 0x80, 0x80},
+    {0x00, 0x01, 0x02, 0x03, 0x04, 0x80, 0x80, 0x80, 0x05, 0x80, 0x80, 0x80, 0x06, 0x07, 0x80, 0x80},
+    {0x00, 0x80, 0x80, 0x80, 0x01, 0x02, 0x80, 0x80, 0x03, 0x80, 0x80, 0x80, 0x04, 0x05, 0x80, 0x80},
+    {0x00, 0x01, 0x80, 0x80, 0x02, 0x03, 0x80, 0x80, 0x04, 0x80, 0x80, 0x80, 0x05, 0x06, 0x80, 0x80},
+    {0x00, 0x01, 0x02, 0x80, 0x03, 0x04, 0x80, 0x80, 0x05, 0x80, 0x80, 0x80, 0x06, 0x07, 0x80, 0x80},
+    {0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x80, 0x80, 0x06, 0x80, 0x80, 0x80, 0x07, 0x08, 0x80, 0x80},
+    {0x00, 0x80, 0x80, 0x80, 0x01, 0x02, 0x03, 0x80, 0x04, 0x80, 0x80, 0x80, 0x05, 0x06, 0x80, 0x80},
+    {0x00, 0x01, 0x80, 0x80, 0x02, 0x03, 0x04, 0x80, 0x05, 0x80, 0x80, 0x80, 0x06, 0x07, 0x80, 0x80},
+    {0x00, 0x01, 0x02, 0x80, 0x03, 0x04, 0x05, 0x80, 0x06, 0x80, 0x80, 0x80, 0x07, 0x08, 0x80, 0x80},
+    {0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x80, 0x07, 0x80, 0x80, 0x80, 0x08, 0x09, 0x80, 0x80},
+    {0x00, 0x80, 0x80, 0x80, 0x01, 0x02, 0x03, 0x04, 0x05, 0x80, 0x80, 0x80, 0x06, 0x07, 0x80, 0x80},
+    {0x00, 0x01, 0x80, 0x80, 0x02, 0x03, 0x04, 0x05, 0x06, 0x80, 0x80, 0x80, 0x07, 0x08, 0x80, 0x80},
+    {0x00, 0x01, 0x02, 0x80, 0x03, 0x04, 0x05, 0x06, 0x07, 0x80, 0x80, 0x80, 0x08, 0x09, 0x80, 0x80},
+    {0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x80, 0x80, 0x80, 0x09, 0x0a, 0x80, 0x80},
+    {0x00, 0x80, 0x80, 0x80, 0x01, 0x80, 0x80, 0x80, 0x02, 0x03, 0x80, 0x80, 0x04, 0x05, 0x80, 0x80},
+    {0x00, 0x01, 0x80, 0x80, 0x02, 0x80, 0x80, 0x80, 0x03, 0x04, 0x80, 0x80, 0x05, 0x06, 0x80, 0x80},
+    {0x00, 0x01, 0x02, 0x80, 0x03, 0x80, 0x80, 0x80, 0x04, 0x05, 0x80, 0x80, 0x06, 0x07, 0x80, 0x80},
+    {0x00, 0x01, 0x02, 0x03, 0x04, 0x80, 0x80, 0x80, 0x05, 0x06, 0x80, 0x80, 0x07, 0x08, 0x80, 0x80},
+    {0x00, 0x80, 0x80, 0x80, 0x01, 0x02, 0x80, 0x80, 0x03, 0x04, 0x80, 0x80, 0x05, 0x06, 0x80, 0x80},
+    {0x00, 0x01, 0x80, 0x80, 0x02, 0x03, 0x80, 0x80, 0x04, 0x05, 0x80, 0x80, 0x06, 0x07, 0x80, 0x80},
+    {0x00, 0x01, 0x02, 0x80, 0x03, 0x04, 0x80, 0x80, 0x05, 0x06, 0x80, 0x80, 0x07, 0x08, 0x80, 0x80},
+    {0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x80, 0x80, 0x06, 0x07, 0x80, 0x80, 0x08, 0x09, 0x80, 0x80},
+    {0x00, 0x80, 0x80, 0x80, 0x01, 0x02, 0x03, 0x80, 0x04, 0x05, 0x80, 0x80, 0x06, 0x07, 0x80, 0x80},
+    {0x00, 0x01, 0x80, 0x80, 0x02, 0x03, 0x04, 0x80, 0x05, 0x06, 0x80, 0x80, 0x07, 0x08, 0x80, 0x80},
+    {0x00, 0x01, 0x02, 0x80, 0x03, 0x04, 0x05, 0x80, 0x06, 0x07, 0x80, 0x80, 0x08, 0x09, 0x80, 0x80},
+    {0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x80, 0x07, 0x08, 0x80, 0x80, 0x09, 0x0a, 0x80, 0x80},
+    {0x00, 0x80, 0x80, 0x80, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x80, 0x80, 0x07, 0x08, 0x80, 0x80},
+    {0x00, 0x01, 0x80, 0x80, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x80, 0x80, 0x08, 0x09, 0x80, 0x80},
+    {0x00, 0x01, 0x02, 0x80, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x80, 0x80, 0x09, 0x0a, 0x80, 0x80},
+    {0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x80, 0x80, 0x0a, 0x0b, 0x80, 0x80},
+    {0x00, 0x80, 0x80, 0x80, 0x01, 0x80, 0x80, 0x80, 0x02, 0x03, 0x04, 0x80, 0x05, 0x06, 0x80, 0x80},
+    {0x00, 0x01, 0x80, 0x80, 0x02, 0x80, 0x80, 0x80, 0x03, 0x04, 0x05, 0x80, 0x06, 0x07, 0x80, 0x80},
+    {0x00, 0x01, 0x02, 0x80, 0x03, 0x80, 0x80, 0x80, 0x04, 0x05, 0x06, 0x80, 0x07, 0x08, 0x80, 0x80},
+    {0x00, 0x01, 0x02, 0x03, 0x04, 0x80, 0x80, 0x80, 0x05, 0x06, 0x07, 0x80, 0x08, 0x09, 0x80, 0x80},
+    {0x00, 0x80, 0x80, 0x80, 0x01, 0x02, 0x80, 0x80, 0x03, 0x04, 0x05, 0x80, 0x06, 0x07, 0x80, 0x80},
+    {0x00, 0x01, 0x80, 0x80, 0x02, 0x03, 0x80, 0x80, 0x04, 0x05, 0x06, 0x80, 0x07, 0x08, 0x80, 0x80},
+    {0x00, 0x01, 0x02, 0x80, 0x03, 0x04, 0x80, 0x80, 0x05, 0x06, 0x07, 0x80, 0x08, 0x09, 0x80, 0x80},
+    {0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x80, 0x80, 0x06, 0x07, 0x08, 0x80, 0x09, 0x0a, 0x80, 0x80},
+    {0x00, 0x80, 0x80, 0x80, 0x01, 0x02, 0x03, 0x80, 0x04, 0x05, 0x06, 0x80, 0x07, 0x08, 0x80, 0x80},
+    {0x00, 0x01, 0x80, 0x80, 0x02, 0x03, 0x04, 0x80, 0x05, 0x06, 0x07, 0x80, 0x08, 0x09, 0x80, 0x80},
+    {0x00, 0x01, 0x02, 0x80, 0x03, 0x04, 0x05, 0x80, 0x06, 0x07, 0x08, 0x80, 0x09, 0x0a, 0x80, 0x80},
+    {0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x80, 0x07, 0x08, 0x09, 0x80, 0x0a, 0x0b, 0x80, 0x80},
+    {0x00, 0x80, 0x80, 0x80, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x80, 0x08, 0x09, 0x80, 0x80},
+    {0x00, 0x01, 0x80, 0x80, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x80, 0x09, 0x0a, 0x80, 0x80},
+    {0x00, 0x01, 0x02, 0x80, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x80, 0x0a, 0x0b, 0x80, 0x80},
+    {0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x80, 0x0b, 0x0c, 0x80, 0x80},
+    {0x00, 0x80, 0x80, 0x80, 0x01, 0x80, 0x80, 0x80, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x80, 0x80},
+    {0x00, 0x01, 0x80, 0x80, 0x02, 0x80, 0x80, 0x80, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x80, 0x80},
+    {0x00, 0x01, 0x02, 0x80, 0x03, 0x80, 0x80, 0x80, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x80, 0x80},
+    {0x00, 0x01, 0x02, 0x03, 0x04, 0x80, 0x80, 0x80, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x80, 0x80},
+    {0x00, 0x80, 0x80, 0x80, 0x01, 0x02, 0x80, 0x80, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x80, 0x80},
+    {0x00, 0x01, 0x80, 0x80, 0x02, 0x03, 0x80, 0x80, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x80, 0x80},
+    {0x00, 0x01, 0x02, 0x80, 0x03, 0x04, 0x80, 0x80, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x80, 0x80},
+    {0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x80, 0x80, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x80, 0x80},
+    {0x00, 0x80, 0x80, 0x80, 0x01, 0x02, 0x03, 0x80, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x80, 0x80},
+    {0x00, 0x01, 0x80, 0x80, 0x02, 0x03, 0x04, 0x80, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x80, 0x80},
+    {0x00, 0x01, 0x02, 0x80, 0x03, 0x04, 0x05, 0x80, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x80, 0x80},
+    {0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x80, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x80, 0x80},
+    {0x00, 0x80, 0x80, 0x80, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x80, 0x80},
+    {0x00, 0x01, 0x80, 0x80, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x80, 0x80},
+    {0x00, 0x01, 0x02, 0x80, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x80, 0x80},
+    {0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x80, 0x80},
+    {0x00, 0x80, 0x80, 0x80, 0x01, 0x80, 0x80, 0x80, 0x02, 0x80, 0x80, 0x80, 0x03, 0x04, 0x05, 0x80},
+    {0x00, 0x01, 0x80, 0x80, 0x02, 0x80, 0x80, 0x80, 0x03, 0x80, 0x80, 0x80, 0x04, 0x05, 0x06, 0x80},
+    {0x00, 0x01, 0x02, 0x80, 0x03, 0x80, 0x80, 0x80, 0x04, 0x80, 0x80, 0x80, 0x05, 0x06, 0x07, 0x80},
+    {0x00, 0x01, 0x02, 0x03, 0x04, 0x80, 0x80, 0x80, 0x05, 0x80, 0x80, 0x80, 0x06, 0x07, 0x08, 0x80},
+    {0x00, 0x80, 0x80, 0x80, 0x01, 0x02, 0x80, 0x80, 0x03, 0x80, 0x80, 0x80, 0x04, 0x05, 0x06, 0x80},
+    {0x00, 0x01, 0x80, 0x80, 0x02, 0x03, 0x80, 0x80, 0x04, 0x80, 0x80, 0x80, 0x05, 0x06, 0x07, 0x80},
+    {0x00, 0x01, 0x02, 0x80, 0x03, 0x04, 0x80, 0x80, 0x05, 0x80, 0x80, 0x80, 0x06, 0x07, 0x08, 0x80},
+    {0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x80, 0x80, 0x06, 0x80, 0x80, 0x80, 0x07, 0x08, 0x09, 0x80},
+    {0x00, 0x80, 0x80, 0x80, 0x01, 0x02, 0x03, 0x80, 0x04, 0x80, 0x80, 0x80, 0x05, 0x06, 0x07, 0x80},
+    {0x00, 0x01, 0x80, 0x80, 0x02, 0x03, 0x04, 0x80, 0x05, 0x80, 0x80, 0x80, 0x06, 0x07, 0x08, 0x80},
+    {0x00, 0x01, 0x02, 0x80, 0x03, 0x04, 0x05, 0x80, 0x06, 0x80, 0x80, 0x80, 0x07, 0x08, 0x09, 0x80},
+    {0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x80, 0x07, 0x80, 0x80, 0x80, 0x08, 0x09, 0x0a, 0x80},
+    {0x00, 0x80, 0x80, 0x80, 0x01, 0x02, 0x03, 0x04, 0x05, 0x80, 0x80, 0x80, 0x06, 0x07, 0x08, 0x80},
+    {0x00, 0x01, 0x80, 0x80, 0x02, 0x03, 0x04, 0x05, 0x06, 0x80, 0x80, 0x80, 0x07, 0x08, 0x09, 0x80},
+    {0x00, 0x01, 0x02, 0x80, 0x03, 0x04, 0x05, 0x06, 0x07, 0x80, 0x80, 0x80, 0x08, 0x09, 0x0a, 0x80},
+    {0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x80, 0x80, 0x80, 0x09, 0x0a, 0x0b, 0x80},
+    {0x00, 0x80, 0x80, 0x80, 0x01, 0x80, 0x80, 0x80, 0x02, 0x03, 0x80, 0x80, 0x04, 0x05, 0x06, 0x80},
+    {0x00, 0x01, 0x80, 0x80, 0x02, 0x80, 0x80, 0x80, 0x03, 0x04, 0x80, 0x80, 0x05, 0x06, 0x07, 0x80},
+    {0x00, 0x01, 0x02, 0x80, 0x03, 0x80, 0x80, 0x80, 0x04, 0x05, 0x80, 0x80, 0x06, 0x07, 0x08, 0x80},
+    {0x00, 0x01, 0x02, 0x03, 0x04, 0x80, 0x80, 0x80, 0x05, 0x06, 0x80, 0x80, 0x07, 0x08, 0x09, 0x80},
+    {0x00, 0x80, 0x80, 0x80, 0x01, 0x02, 0x80, 0x80, 0x03, 0x04, 0x80, 0x80, 0x05, 0x06, 0x07, 0x80},
+    {0x00, 0x01, 0x80, 0x80, 0x02, 0x03, 0x80, 0x80, 0x04, 0x05, 0x80, 0x80, 0x06, 0x07, 0x08, 0x80},
+    {0x00, 0x01, 0x02, 0x80, 0x03, 0x04, 0x80, 0x80, 0x05, 0x06, 0x80, 0x80, 0x07, 0x08, 0x09, 0x80},
+    {0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x80, 0x80, 0x06, 0x07, 0x80, 0x80, 0x08, 0x09, 0x0a, 0x80},
+    {0x00, 0x80, 0x80, 0x80, 0x01, 0x02, 0x03, 0x80, 0x04, 0x05, 0x80, 0x80, 0x06, 0x07, 0x08, 0x80},
+    {0x00, 0x01, 0x80, 0x80, 0x02, 0x03, 0x04, 0x80, 0x05, 0x06, 0x80, 0x80, 0x07, 0x08, 0x09, 0x80},
+    {0x00, 0x01, 0x02, 0x80, 0x03, 0x04, 0x05, 0x80, 0x06, 0x07, 0x80, 0x80, 0x08, 0x09, 0x0a, 0x80},
+    {0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x80, 0x07, 0x08, 0x80, 0x80, 0x09, 0x0a, 0x0b, 0x80},
+    {0x00, 0x80, 0x80, 0x80, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x80, 0x80, 0x07, 0x08, 0x09, 0x80},
+    {0x00, 0x01, 0x80, 0x80, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x80, 0x80, 0x08, 0x09, 0x0a, 0x80},
+    {0x00, 0x01, 0x02, 0x80, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x80, 0x80, 0x09, 0x0a, 0x0b, 0x80},
+    {0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x80, 0x80, 0x0a, 0x0b, 0x0c, 0x80},
+    {0x00, 0x80, 0x80, 0x80, 0x01, 0x80, 0x80, 0x80, 0x02, 0x03, 0x04, 0x80, 0x05, 0x06, 0x07, 0x80},
+    {0x00, 0x01, 0x80, 0x80, 0x02, 0x80, 0x80, 0x80, 0x03, 0x04, 0x05, 0x80, 0x06, 0x07, 0x08, 0x80},
+    {0x00, 0x01, 0x02, 0x80, 0x03, 0x80, 0x80, 0x80, 0x04, 0x05, 0x06, 0x80, 0x07, 0x08, 0x09, 0x80},
+    {0x00, 0x01, 0x02, 0x03, 0x04, 0x80, 0x80, 0x80, 0x05, 0x06, 0x07, 0x80, 0x08, 0x09, 0x0a, 0x80},
+    {0x00, 0x80, 0x80, 0x80, 0x01, 0x02, 0x80, 0x80, 0x03, 0x04, 0x05, 0x80, 0x06, 0x07, 0x08, 0x80},
+    {0x00, 0x01, 0x80, 0x80, 0x02, 0x03, 0x80, 0x80, 0x04, 0x05, 0x06, 0x80, 0x07, 0x08, 0x09, 0x80},
+    {0x00, 0x01, 0x02, 0x80, 0x03, 0x04, 0x80, 0x80, 0x05, 0x06, 0x07, 0x80, 0x08, 0x09, 0x0a, 0x80},
+    {0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x80, 0x80, 0x06, 0x07, 0x08, 0x80, 0x09, 0x0a, 0x0b, 0x80},
+    {0x00, 0x80, 0x80, 0x80, 0x01, 0x02, 0x03, 0x80, 0x04, 0x05, 0x06, 0x80, 0x07, 0x08, 0x09, 0x80},
+    {0x00, 0x01, 0x80, 0x80, 0x02, 0x03, 0x04, 0x80, 0x05, 0x06, 0x07, 0x80, 0x08, 0x09, 0x0a, 0x80},
+    {0x00, 0x01, 0x02, 0x80, 0x03, 0x04, 0x05, 0x80, 0x06, 0x07, 0x08, 0x80, 0x09, 0x0a, 0x0b, 0x80},
+    {0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x80, 0x07, 0x08, 0x09, 0x80, 0x0a, 0x0b, 0x0c, 0x80},
+    {0x00, 0x80, 0x80, 0x80, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x80, 0x08, 0x09, 0x0a, 0x80},
+    {0x00, 0x01, 0x80, 0x80, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x80, 0x09, 0x0a, 0x0b, 0x80},
+    {0x00, 0x01, 0x02, 0x80, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x80, 0x0a, 0x0b, 0x0c, 0x80},
+    {0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x80, 0x0b, 0x0c, 0x0d, 0x80},
+    {0x00, 0x80, 0x80, 0x80, 0x01, 0x80, 0x80, 0x80, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x80},
+    {0x00, 0x01, 0x80, 0x80, 0x02, 0x80, 0x80, 0x80, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x80},
+    {0x00, 0x01, 0x02, 0x80, 0x03, 0x80, 0x80, 0x80, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x80},
+    {0x00, 0x01, 0x02, 0x03, 0x04, 0x80, 0x80, 0x80, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x80},
+    {0x00, 0x80, 0x80, 0x80, 0x01, 0x02, 0x80, 0x80, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x80},
+    {0x00, 0x01, 0x80, 0x80, 0x02, 0x03, 0x80, 0x80, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x80},
+    {0x00, 0x01, 0x02, 0x80, 0x03, 0x04, 0x80, 0x80, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x80},
+    {0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x80, 0x80, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x80},
+    {0x00, 0x80, 0x80, 0x80, 0x01, 0x02, 0x03, 0x80, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x80},
+    {0x00, 0x01, 0x80, 0x80, 0x02, 0x03, 0x04, 0x80, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x80},
+    {0x00, 0x01, 0x02, 0x80, 0x03, 0x04, 0x05, 0x80, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x80},
+    {0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x80, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x80},
+    {0x00, 0x80, 0x80, 0x80, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x80},
+    {0x00, 0x01, 0x80, 0x80, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x80},
+    {0x00, 0x01, 0x02, 0x80, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x80},
+    {0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x80},
+    {0x00, 0x80, 0x80, 0x80, 0x01, 0x80, 0x80, 0x80, 0x02, 0x80, 0x80, 0x80, 0x03, 0x04, 0x05, 0x06},
+    {0x00, 0x01, 0x80, 0x80, 0x02, 0x80, 0x80, 0x80, 0x03, 0x80, 0x80, 0x80, 0x04, 0x05, 0x06, 0x07},
+    {0x00, 0x01, 0x02, 0x80, 0x03, 0x80, 0x80, 0x80, 0x04, 0x80, 0x80, 0x80, 0x05, 0x06, 0x07, 0x08},
+    {0x00, 0x01, 0x02, 0x03, 0x04, 0x80, 0x80, 0x80, 0x05, 0x80, 0x80, 0x80, 0x06, 0x07, 0x08, 0x09},
+    {0x00, 0x80, 0x80, 0x80, 0x01, 0x02, 0x80, 0x80, 0x03, 0x80, 0x80, 0x80, 0x04, 0x05, 0x06, 0x07},
+    {0x00, 0x01, 0x80, 0x80, 0x02, 0x03, 0x80, 0x80, 0x04, 0x80, 0x80, 0x80, 0x05, 0x06, 0x07, 0x08},
+    {0x00, 0x01, 0x02, 0x80, 0x03, 0x04, 0x80, 0x80, 0x05, 0x80, 0x80, 0x80, 0x06, 0x07, 0x08, 0x09},
+    {0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x80, 0x80, 0x06, 0x80, 0x80, 0x80, 0x07, 0x08, 0x09, 0x0a},
+    {0x00, 0x80, 0x80, 0x80, 0x01, 0x02, 0x03, 0x80, 0x04, 0x80, 0x80, 0x80, 0x05, 0x06, 0x07, 0x08},
+    {0x00, 0x01, 0x80, 0x80, 0x02, 0x03, 0x04, 0x80, 0x05, 0x80, 0x80, 0x80, 0x06, 0x07, 0x08, 0x09},
+    {0x00, 0x01, 0x02, 0x80, 0x03, 0x04, 0x05, 0x80, 0x06, 0x80, 0x80, 0x80, 0x07, 0x08, 0x09, 0x0a},
+    {0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x80, 0x07, 0x80, 0x80, 0x80, 0x08, 0x09, 0x0a, 0x0b},
+    {0x00, 0x80, 0x80, 0x80, 0x01, 0x02, 0x03, 0x04, 0x05, 0x80, 0x80, 0x80, 0x06, 0x07, 0x08, 0x09},
+    {0x00, 0x01, 0x80, 0x80, 0x02, 0x03, 0x04, 0x05, 0x06, 0x80, 0x80, 0x80, 0x07, 0x08, 0x09, 0x0a},
+    {0x00, 0x01, 0x02, 0x80, 0x03, 0x04, 0x05, 0x06, 0x07, 0x80, 0x80, 0x80, 0x08, 0x09, 0x0a, 0x0b},
+    {0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x80, 0x80, 0x80, 0x09, 0x0a, 0x0b, 0x0c},
+    {0x00, 0x80, 0x80, 0x80, 0x01, 0x80, 0x80, 0x80, 0x02, 0x03, 0x80, 0x80, 0x04, 0x05, 0x06, 0x07},
+    {0x00, 0x01, 0x80, 0x80, 0x02, 0x80, 0x80, 0x80, 0x03, 0x04, 0x80, 0x80, 0x05, 0x06, 0x07, 0x08},
+    {0x00, 0x01, 0x02, 0x80, 0x03, 0x80, 0x80, 0x80, 0x04, 0x05, 0x80, 0x80, 0x06, 0x07, 0x08, 0x09},
+    {0x00, 0x01, 0x02, 0x03, 0x04, 0x80, 0x80, 0x80, 0x05, 0x06, 0x80, 0x80, 0x07, 0x08, 0x09, 0x0a},
+    {0x00, 0x80, 0x80, 0x80, 0x01, 0x02, 0x80, 0x80, 0x03, 0x04, 0x80, 0x80, 0x05, 0x06, 0x07, 0x08},
+    {0x00, 0x01, 0x80, 0x80, 0x02, 0x03, 0x80, 0x80, 0x04, 0x05, 0x80, 0x80, 0x06, 0x07, 0x08, 0x09},
+    {0x00, 0x01, 0x02, 0x80, 0x03, 0x04, 0x80, 0x80, 0x05, 0x06, 0x80, 0x80, 0x07, 0x08, 0x09, 0x0a},
+    {0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x80, 0x80, 0x06, 0x07, 0x80, 0x80, 0x08, 0x09, 0x0a, 0x0b},
+    {0x00, 0x80, 0x80, 0x80, 0x01, 0x02, 0x03, 0x80, 0x04, 0x05, 0x80, 0x80, 0x06, 0x07, 0x08, 0x09},
+    {0x00, 0x01, 0x80, 0x80, 0x02, 0x03, 0x04, 0x80, 0x05, 0x06, 0x80, 0x80, 0x07, 0x08, 0x09, 0x0a},
+    {0x00, 0x01, 0x02, 0x80, 0x03, 0x04, 0x05, 0x80, 0x06, 0x07, 0x80, 0x80, 0x08, 0x09, 0x0a, 0x0b},
+    {0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x80, 0x07, 0x08, 0x80, 0x80, 0x09, 0x0a, 0x0b, 0x0c},
+    {0x00, 0x80, 0x80, 0x80, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x80, 0x80, 0x07, 0x08, 0x09, 0x0a},
+    {0x00, 0x01, 0x80, 0x80, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x80, 0x80, 0x08, 0x09, 0x0a, 0x0b},
+    {0x00, 0x01, 0x02, 0x80, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x80, 0x80, 0x09, 0x0a, 0x0b, 0x0c},
+    {0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x80, 0x80, 0x0a, 0x0b, 0x0c, 0x0d},
+    {0x00, 0x80, 0x80, 0x80, 0x01, 0x80, 0x80, 0x80, 0x02, 0x03, 0x04, 0x80, 0x05, 0x06, 0x07, 0x08},
+    {0x00, 0x01, 0x80, 0x80, 0x02, 0x80, 0x80, 0x80, 0x03, 0x04, 0x05, 0x80, 0x06, 0x07, 0x08, 0x09},
+    {0x00, 0x01, 0x02, 0x80, 0x03, 0x80, 0x80, 0x80, 0x04, 0x05, 0x06, 0x80, 0x07, 0x08, 0x09, 0x0a},
+    {0x00, 0x01, 0x02, 0x03, 0x04, 0x80, 0x80, 0x80, 0x05, 0x06, 0x07, 0x80, 0x08, 0x09, 0x0a, 0x0b},
+    {0x00, 0x80, 0x80, 0x80, 0x01, 0x02, 0x80, 0x80, 0x03, 0x04, 0x05, 0x80, 0x06, 0x07, 0x08, 0x09},
+    {0x00, 0x01, 0x80, 0x80, 0x02, 0x03, 0x80, 0x80, 0x04, 0x05, 0x06, 0x80, 0x07, 0x08, 0x09, 0x0a},
+    {0x00, 0x01, 0x02, 0x80, 0x03, 0x04, 0x80, 0x80, 0x05, 0x06, 0x07, 0x80, 0x08, 0x09, 0x0a, 0x0b},
+    {0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x80, 0x80, 0x06, 0x07, 0x08, 0x80, 0x09, 0x0a, 0x0b, 0x0c},
+    {0x00, 0x80, 0x80, 0x80, 0x01, 0x02, 0x03, 0x80, 0x04, 0x05, 0x06, 0x80, 0x07, 0x08, 0x09, 0x0a},
+    {0x00, 0x01, 0x80, 0x80, 0x02, 0x03, 0x04, 0x80, 0x05, 0x06, 0x07, 0x80, 0x08, 0x09, 0x0a, 0x0b},
+    {0x00, 0x01, 0x02, 0x80, 0x03, 0x04, 0x05, 0x80, 0x06, 0x07, 0x08, 0x80, 0x09, 0x0a, 0x0b, 0x0c},
+    {0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x80, 0x07, 0x08, 0x09, 0x80, 0x0a, 0x0b, 0x0c, 0x0d},
+    {0x00, 0x80, 0x80, 0x80, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x80, 0x08, 0x09, 0x0a, 0x0b},
+    {0x00, 0x01, 0x80, 0x80, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x80, 0x09, 0x0a, 0x0b, 0x0c},
+    {0x00, 0x01, 0x02, 0x80, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x80, 0x0a, 0x0b, 0x0c, 0x0d},
+    {0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x80, 0x0b, 0x0c, 0x0d, 0x0e},
+    {0x00, 0x80, 0x80, 0x80, 0x01, 0x80, 0x80, 0x80, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09},
+    {0x00, 0x01, 0x80, 0x80, 0x02, 0x80, 0x80, 0x80, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a},
+    {0x00, 0x01, 0x02, 0x80, 0x03, 0x80, 0x80, 0x80, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b},
+    {0x00, 0x01, 0x02, 0x03, 0x04, 0x80, 0x80, 0x80, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c},
+    {0x00, 0x80, 0x80, 0x80, 0x01, 0x02, 0x80, 0x80, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a},
+    {0x00, 0x01, 0x80, 0x80, 0x02, 0x03, 0x80, 0x80, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b},
+    {0x00, 0x01, 0x02, 0x80, 0x03, 0x04, 0x80, 0x80, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c},
+    {0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x80, 0x80, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d},
+    {0x00, 0x80, 0x80, 0x80, 0x01, 0x02, 0x03, 0x80, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b},
+    {0x00, 0x01, 0x80, 0x80, 0x02, 0x03, 0x04, 0x80, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c},
+    {0x00, 0x01, 0x02, 0x80, 0x03, 0x04, 0x05, 0x80, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d},
+    {0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x80, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e},
+    {0x00, 0x80, 0x80, 0x80, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c},
+    {0x00, 0x01, 0x80, 0x80, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d},
+    {0x00, 0x01, 0x02, 0x80, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e},
+    {0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f}
+};
+
+/* pshufb masks packing the significant bytes of 4 uint32s together */
+static const uint8_t SVB_ENCODE_SHUFFLE_ARR[256][16] =
+{
+    {0x00, 0x04, 0x08, 0x0c, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x04, 0x08, 0x0c, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x02, 0x04, 0x08, 0x0c, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x02, 0x03, 0x04, 0x08, 0x0c, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x04, 0x05, 0x08, 0x0c, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x04, 0x05, 0x08, 0x0c, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x02, 0x04, 0x05, 0x08, 0x0c, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x08, 0x0c, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x04, 0x05, 0x06, 0x08, 0x0c, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x04, 0x05, 0x06, 0x08, 0x0c, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x02, 0x04, 0x05, 0x06, 0x08, 0x0c, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x08, 0x0c, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x04, 0x05, 0x06, 0x07, 0x08, 0x0c, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x04, 0x05, 0x06, 0x07, 0x08, 0x0c, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x02, 0x04, 0x05, 0x06, 0x07, 0x08, 0x0c, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x0c, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x04, 0x08, 0x09, 0x0c, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x04, 0x08, 0x09, 0x0c, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x02, 0x04, 0x08, 0x09, 0x0c, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x02, 0x03, 0x04, 0x08, 0x09, 0x0c, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x04, 0x05, 0x08, 0x09, 0x0c, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x04, 0x05, 0x08, 0x09, 0x0c, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x02, 0x04, 0x05, 0x08, 0x09, 0x0c, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x08, 0x09, 0x0c, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x04, 0x05, 0x06, 0x08, 0x09, 0x0c, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x04, 0x05, 0x06, 0x08, 0x09, 0x0c, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x02, 0x04, 0x05, 0x06, 0x08, 0x09, 0x0c, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x08, 0x09, 0x0c, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0c, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0c, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x02, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0c, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0c, 0x80, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x04, 0x08, 0x09, 0x0a, 0x0c, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x04, 0x08, 0x09, 0x0a, 0x0c, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x02, 0x04, 0x08, 0x09, 0x0a, 0x0c, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x02, 0x03, 0x04, 0x08, 0x09, 0x0a, 0x0c, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x04, 0x05, 0x08, 0x09, 0x0a, 0x0c, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x04, 0x05, 0x08, 0x09, 0x0a, 0x0c, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x02, 0x04, 0x05, 0x08, 0x09, 0x0a, 0x0c, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x08, 0x09, 0x0a, 0x0c, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x04, 0x05, 0x06, 0x08, 0x09, 0x0a, 0x0c, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x04, 0x05, 0x06, 0x08, 0x09, 0x0a, 0x0c, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x02, 0x04, 0x05, 0x06, 0x08, 0x09, 0x0a, 0x0c, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x08, 0x09, 0x0a, 0x0c, 0x80, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0c, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0c, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x02, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0c, 0x80, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0c, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x04, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x04, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x02, 0x04, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x02, 0x03, 0x04, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x04, 0x05, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x04, 0x05, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x02, 0x04, 0x05, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x80, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x04, 0x05, 0x06, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x04, 0x05, 0x06, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x02, 0x04, 0x05, 0x06, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x80, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x80, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x02, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x80, 0x80, 0x80},
+    {0x00, 0x04, 0x08, 0x0c, 0x0d, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x04, 0x08, 0x0c, 0x0d, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x02, 0x04, 0x08, 0x0c, 0x0d, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x02, 0x03, 0x04, 0x08, 0x0c, 0x0d, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x04, 0x05, 0x08, 0x0c, 0x0d, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x04, 0x05, 0x08, 0x0c, 0x0d, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x02, 0x04, 0x05, 0x08, 0x0c, 0x0d, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x08, 0x0c, 0x0d, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x04, 0x05, 0x06, 0x08, 0x0c, 0x0d, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x04, 0x05, 0x06, 0x08, 0x0c, 0x0d, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x02, 0x04, 0x05, 0x06, 0x08, 0x0c, 0x0d, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x08, 0x0c, 0x0d, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x04, 0x05, 0x06, 0x07, 0x08, 0x0c, 0x0d, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x04, 0x05, 0x06, 0x07, 0x08, 0x0c, 0x0d, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x02, 0x04, 0x05, 0x06, 0x07, 0x08, 0x0c, 0x0d, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x0c, 0x0d, 0x80, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x04, 0x08, 0x09, 0x0c, 0x0d, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x04, 0x08, 0x09, 0x0c, 0x0d, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x02, 0x04, 0x08, 0x09, 0x0c, 0x0d, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x02, 0x03, 0x04, 0x08, 0x09, 0x0c, 0x0d, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x04, 0x05, 0x08, 0x09, 0x0c, 0x0d, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x04, 0x05, 0x08, 0x09, 0x0c, 0x0d, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x02, 0x04, 0x05, 0x08, 0x09, 0x0c, 0x0d, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x08, 0x09, 0x0c, 0x0d, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x04, 0x05, 0x06, 0x08, 0x09, 0x0c, 0x0d, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x04, 0x05, 0x06, 0x08, 0x09, 0x0c, 0x0d, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x02, 0x04, 0x05, 0x06, 0x08, 0x09, 0x0c, 0x0d, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x08, 0x09, 0x0c, 0x0d, 0x80, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0c, 0x0d, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0c, 0x0d, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x02, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0c, 0x0d, 0x80, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0c, 0x0d, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x04, 0x08, 0x09, 0x0a, 0x0c, 0x0d, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x04, 0x08, 0x09, 0x0a, 0x0c, 0x0d, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x02, 0x04, 0x08, 0x09, 0x0a, 0x0c, 0x0d, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x02, 0x03, 0x04, 0x08, 0x09, 0x0a, 0x0c, 0x0d, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x04, 0x05, 0x08, 0x09, 0x0a, 0x0c, 0x0d, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x04, 0x05, 0x08, 0x09, 0x0a, 0x0c, 0x0d, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x02, 0x04, 0x05, 0x08, 0x09, 0x0a, 0x0c, 0x0d, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x08, 0x09, 0x0a, 0x0c, 0x0d, 0x80, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x04, 0x05, 0x06, 0x08, 0x09, 0x0a, 0x0c, 0x0d, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x04, 0x05, 0x06, 0x08, 0x09, 0x0a, 0x0c, 0x0d, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x02, 0x04, 0x05, 0x06, 0x08, 0x09, 0x0a, 0x0c, 0x0d, 0x80, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x08, 0x09, 0x0a, 0x0c, 0x0d, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0c, 0x0d, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0c, 0x0d, 0x80, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x02, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0c, 0x0d, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0c, 0x0d, 0x80, 0x80, 0x80},
+    {0x00, 0x04, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x04, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x02, 0x04, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x02, 0x03, 0x04, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x80, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x04, 0x05, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x04, 0x05, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x02, 0x04, 0x05, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x80, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x04, 0x05, 0x06, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x04, 0x05, 0x06, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x80, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x02, 0x04, 0x05, 0x06, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x80, 0x80, 0x80},
+    {0x00, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x80, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x02, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x80, 0x80},
+    {0x00, 0x04, 0x08, 0x0c, 0x0d, 0x0e, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x04, 0x08, 0x0c, 0x0d, 0x0e, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x02, 0x04, 0x08, 0x0c, 0x0d, 0x0e, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x02, 0x03, 0x04, 0x08, 0x0c, 0x0d, 0x0e, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x04, 0x05, 0x08, 0x0c, 0x0d, 0x0e, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x04, 0x05, 0x08, 0x0c, 0x0d, 0x0e, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x02, 0x04, 0x05, 0x08, 0x0c, 0x0d, 0x0e, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x08, 0x0c, 0x0d, 0x0e, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x04, 0x05, 0x06, 0x08, 0x0c, 0x0d, 0x0e, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x04, 0x05, 0x06, 0x08, 0x0c, 0x0d, 0x0e, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x02, 0x04, 0x05, 0x06, 0x08, 0x0c, 0x0d, 0x0e, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x08, 0x0c, 0x0d, 0x0e, 0x80, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x04, 0x05, 0x06, 0x07, 0x08, 0x0c, 0x0d, 0x0e, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x04, 0x05, 0x06, 0x07, 0x08, 0x0c, 0x0d, 0x0e, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x02, 0x04, 0x05, 0x06, 0x07, 0x08, 0x0c, 0x0d, 0x0e, 0x80, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x0c, 0x0d, 0x0e, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x04, 0x08, 0x09, 0x0c, 0x0d, 0x0e, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x04, 0x08, 0x09, 0x0c, 0x0d, 0x0e, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x02, 0x04, 0x08, 0x09, 0x0c, 0x0d, 0x0e, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x02, 0x03, 0x04, 0x08, 0x09, 0x0c, 0x0d, 0x0e, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x04, 0x05, 0x08, 0x09, 0x0c, 0x0d, 0x0e, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x04, 0x05, 0x08, 0x09, 0x0c, 0x0d, 0x0e, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x02, 0x04, 0x05, 0x08, 0x09, 0x0c, 0x0d, 0x0e, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x08, 0x09, 0x0c, 0x0d, 0x0e, 0x80, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x04, 0x05, 0x06, 0x08, 0x09, 0x0c, 0x0d, 0x0e, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x04, 0x05, 0x06, 0x08, 0x09, 0x0c, 0x0d, 0x0e, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x02, 0x04, 0x05, 0x06, 0x08, 0x09, 0x0c, 0x0d, 0x0e, 0x80, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x08, 0x09, 0x0c, 0x0d, 0x0e, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0c, 0x0d, 0x0e, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0c, 0x0d, 0x0e, 0x80, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x02, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0c, 0x0d, 0x0e, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0c, 0x0d, 0x0e, 0x80, 0x80, 0x80},
+    {0x00, 0x04, 0x08, 0x09, 0x0a, 0x0c, 0x0d, 0x0e, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x04, 0x08, 0x09, 0x0a, 0x0c, 0x0d, 0x0e, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x02, 0x04, 0x08, 0x09, 0x0a, 0x0c, 0x0d, 0x0e, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x02, 0x03, 0x04, 0x08, 0x09, 0x0a, 0x0c, 0x0d, 0x0e, 0x80, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x04, 0x05, 0x08, 0x09, 0x0a, 0x0c, 0x0d, 0x0e, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x04, 0x05, 0x08, 0x09, 0x0a, 0x0c, 0x0d, 0x0e, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x02, 0x04, 0x05, 0x08, 0x09, 0x0a, 0x0c, 0x0d, 0x0e, 0x80, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x08, 0x09, 0x0a, 0x0c, 0x0d, 0x0e, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x04, 0x05, 0x06, 0x08, 0x09, 0x0a, 0x0c, 0x0d, 0x0e, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x04, 0x05, 0x06, 0x08, 0x09, 0x0a, 0x0c, 0x0d, 0x0e, 0x80, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x02, 0x04, 0x05, 0x06, 0x08, 0x09, 0x0a, 0x0c, 0x0d, 0x0e, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x08, 0x09, 0x0a, 0x0c, 0x0d, 0x0e, 0x80, 0x80, 0x80},
+    {0x00, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0c, 0x0d, 0x0e, 0x80, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0c, 0x0d, 0x0e, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x02, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0c, 0x0d, 0x0e, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0c, 0x0d, 0x0e, 0x80, 0x80},
+    {0x00, 0x04, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x04, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x02, 0x04, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x80, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x02, 0x03, 0x04, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x04, 0x05, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x04, 0x05, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x80, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x02, 0x04, 0x05, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x80, 0x80, 0x80},
+    {0x00, 0x04, 0x05, 0x06, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x80, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x04, 0x05, 0x06, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x02, 0x04, 0x05, 0x06, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x80, 0x80},
+    {0x00, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x02, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x80, 0x80},
+    {0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x80},
+    {0x00, 0x04, 0x08, 0x0c, 0x0d, 0x0e, 0x0f, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x04, 0x08, 0x0c, 0x0d, 0x0e, 0x0f, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x02, 0x04, 0x08, 0x0c, 0x0d, 0x0e, 0x0f, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x02, 0x03, 0x04, 0x08, 0x0c, 0x0d, 0x0e, 0x0f, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x04, 0x05, 0x08, 0x0c, 0x0d, 0x0e, 0x0f, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x04, 0x05, 0x08, 0x0c, 0x0d, 0x0e, 0x0f, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x02, 0x04, 0x05, 0x08, 0x0c, 0x0d, 0x0e, 0x0f, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x08, 0x0c, 0x0d, 0x0e, 0x0f, 0x80, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x04, 0x05, 0x06, 0x08, 0x0c, 0x0d, 0x0e, 0x0f, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x04, 0x05, 0x06, 0x08, 0x0c, 0x0d, 0x0e, 0x0f, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x02, 0x04, 0x05, 0x06, 0x08, 0x0c, 0x0d, 0x0e, 0x0f, 0x80, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x08, 0x0c, 0x0d, 0x0e, 0x0f, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x04, 0x05, 0x06, 0x07, 0x08, 0x0c, 0x0d, 0x0e, 0x0f, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x04, 0x05, 0x06, 0x07, 0x08, 0x0c, 0x0d, 0x0e, 0x0f, 0x80, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x02, 0x04, 0x05, 0x06, 0x07, 0x08, 0x0c, 0x0d, 0x0e, 0x0f, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x0c, 0x0d, 0x0e, 0x0f, 0x80, 0x80, 0x80},
+    {0x00, 0x04, 0x08, 0x09, 0x0c, 0x0d, 0x0e, 0x0f, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x04, 0x08, 0x09, 0x0c, 0x0d, 0x0e, 0x0f, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x02, 0x04, 0x08, 0x09, 0x0c, 0x0d, 0x0e, 0x0f, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x02, 0x03, 0x04, 0x08, 0x09, 0x0c, 0x0d, 0x0e, 0x0f, 0x80, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x04, 0x05, 0x08, 0x09, 0x0c, 0x0d, 0x0e, 0x0f, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x04, 0x05, 0x08, 0x09, 0x0c, 0x0d, 0x0e, 0x0f, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x02, 0x04, 0x05, 0x08, 0x09, 0x0c, 0x0d, 0x0e, 0x0f, 0x80, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x08, 0x09, 0x0c, 0x0d, 0x0e, 0x0f, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x04, 0x05, 0x06, 0x08, 0x09, 0x0c, 0x0d, 0x0e, 0x0f, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x04, 0x05, 0x06, 0x08, 0x09, 0x0c, 0x0d, 0x0e, 0x0f, 0x80, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x02, 0x04, 0x05, 0x06, 0x08, 0x09, 0x0c, 0x0d, 0x0e, 0x0f, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x08, 0x09, 0x0c, 0x0d, 0x0e, 0x0f, 0x80, 0x80, 0x80},
+    {0x00, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0c, 0x0d, 0x0e, 0x0f, 0x80, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0c, 0x0d, 0x0e, 0x0f, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x02, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0c, 0x0d, 0x0e, 0x0f, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0c, 0x0d, 0x0e, 0x0f, 0x80, 0x80},
+    {0x00, 0x04, 0x08, 0x09, 0x0a, 0x0c, 0x0d, 0x0e, 0x0f, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x04, 0x08, 0x09, 0x0a, 0x0c, 0x0d, 0x0e, 0x0f, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x02, 0x04, 0x08, 0x09, 0x0a, 0x0c, 0x0d, 0x0e, 0x0f, 0x80, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x02, 0x03, 0x04, 0x08, 0x09, 0x0a, 0x0c, 0x0d, 0x0e, 0x0f, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x04, 0x05, 0x08, 0x09, 0x0a, 0x0c, 0x0d, 0x0e, 0x0f, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x04, 0x05, 0x08, 0x09, 0x0a, 0x0c, 0x0d, 0x0e, 0x0f, 0x80, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x02, 0x04, 0x05, 0x08, 0x09, 0x0a, 0x0c, 0x0d, 0x0e, 0x0f, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x08, 0x09, 0x0a, 0x0c, 0x0d, 0x0e, 0x0f, 0x80, 0x80, 0x80},
+    {0x00, 0x04, 0x05, 0x06, 0x08, 0x09, 0x0a, 0x0c, 0x0d, 0x0e, 0x0f, 0x80, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x04, 0x05, 0x06, 0x08, 0x09, 0x0a, 0x0c, 0x0d, 0x0e, 0x0f, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x02, 0x04, 0x05, 0x06, 0x08, 0x09, 0x0a, 0x0c, 0x0d, 0x0e, 0x0f, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x08, 0x09, 0x0a, 0x0c, 0x0d, 0x0e, 0x0f, 0x80, 0x80},
+    {0x00, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0c, 0x0d, 0x0e, 0x0f, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0c, 0x0d, 0x0e, 0x0f, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x02, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0c, 0x0d, 0x0e, 0x0f, 0x80, 0x80},
+    {0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0c, 0x0d, 0x0e, 0x0f, 0x80},
+    {0x00, 0x04, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x04, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f, 0x80, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x02, 0x04, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x02, 0x03, 0x04, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f, 0x80, 0x80, 0x80},
+    {0x00, 0x04, 0x05, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f, 0x80, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x04, 0x05, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x02, 0x04, 0x05, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f, 0x80, 0x80},
+    {0x00, 0x04, 0x05, 0x06, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f, 0x80, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x04, 0x05, 0x06, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x02, 0x04, 0x05, 0x06, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f, 0x80, 0x80},
+    {0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f, 0x80},
+    {0x00, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f, 0x80, 0x80, 0x80},
+    {0x00, 0x01, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f, 0x80, 0x80},
+    {0x00, 0x01, 0x02, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f, 0x80},
+    {0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f}
+};
+#endif
+
+/* ---------------------- function definitions --------------------------- */
+
+/* Encodes the deltas of a sorted array. Full groups of 4 are handled by the
+ * SSSE3 encoder when available, the rest (or everything) by the scalar one. */
+uint32_t
+svb_encode_sorted(const uint32_t * input, int32_t length, uint8_t * output)
+{
+    int32_t i = 0;
+    uint8_t * ctrl = output;
+    uint8_t * data = output + ((length + 3) >> 2);
+
+#ifdef SVB_SSSE3
+    if (svb_have_ssse3()){
+        data = svb_encode_ssse3(input, length >> 2, ctrl, data);
+        i = length & ~3;
+    }
+#endif
+
+    data = svb_encode_scalar(input, i, length, ctrl, data);
+
+    return data - output;
+}
+
+/* Decodes 'length' values. Full groups of 4 are handled by the SSSE3 decoder
+ * when available, the rest (or everything) by the scalar one. */
+void
+svb_decode_sorted(const uint8_t * input, int32_t length, uint32_t * output)
+{
+    int32_t i = 0;
+    const uint8_t * ctrl = input;
+    const uint8_t * data = input + ((length + 3) >> 2);
+
+#ifdef SVB_SSSE3
+    if (length >= 4 && svb_have_ssse3()){
+        data = svb_decode_ssse3(ctrl, data, length, output);
+        i = length & ~3;
+    }
+#endif
+
+    svb_decode_scalar(ctrl, data, i, length, output);
+}
+
+/* Computes the encoded size without encoding anything */
+uint32_t
+svb_encoded_size_sorted(const uint32_t * input, int32_t length)
+{
+    int32_t i;
+    uint32_t size = (length + 3) >> 2;
+    uint32_t prev = 0;
+
+    for (i = 0; i < length; i++){
+        size += svb_code(input[i] - prev) + 1;
+        prev = input[i];
+    }
+
+    return size;
+}
+
+/* Sums the lengths of the values in the control bytes, the unused bits of
+ * the last one are zero but don't belong to any value */
+uint32_t
+svb_stream_size(const uint8_t * input, int32_t length)
+{
+    int32_t i;
+    uint32_t size = (length + 3) >> 2;
+
+    for (i = 0; i < length; i++){
+        size += ((input[i >> 2] >> ((i & 3) * 2)) & 3) + 1;
+    }
+
+    return size;
+}
+
+/* Merges the two encoded arrays value by value. The control bytes of the
+ * output are written assuming no value is shared (the upper bound on their
+ * number), so the data bytes are moved right behind the actual control bytes
+ * at the end. */
+uint32_t
+svb_merge_sorted(const uint8_t * input1, int32_t length1,
+                 const uint8_t * input2, int32_t length2,
+                 uint8_t * output, int32_t * length)
+{
+    SVBReader r1, r2;
+    int32_t i = 0;
+    int more1, more2;
+    uint32_t value, prev = 0;
+    uint8_t * ctrl = output;
+    uint8_t * start = output + ((length1 + length2 + 3) >> 2);
+    uint8_t * data = start;
+
+    r1.ctrl = input1;
+    r1.data = input1 + ((length1 + 3) >> 2);
+    r1.i = 0;
+    r1.length = length1;
+    r1.value = 0;
+
+    r2.ctrl = input2;
+    r2.data = input2 + ((length2 + 3) >> 2);
+    r2.i = 0;
+    r2.length = length2;
+    r2.value = 0;
+
+    more1 = svb_reader_next(&r1);
+    more2 = svb_reader_next(&r2);
+
+    while (more1 || more2){
+        if (!more2 || (more1 && r1.value < r2.value)){
+            value = r1.value;
+            more1 = svb_reader_next(&r1);
+        } else if (!more1 || r2.value < r1.value){
+            value = r2.value;
+            more2 = svb_reader_next(&r2);
+        } else {
+            value = r1.value;
+            more1 = svb_reader_next(&r1);
+            more2 = svb_reader_next(&r2);
+        }
+
+        svb_write(ctrl, &data, i++, value - prev);
+        prev = value;
+    }
+
+    memmove(output + ((i + 3) >> 2), start, data - start);
+    *length = i;
+
+    return ((i + 3) >> 2) + (data - start);
+}
+
+/* Advances the reader to the next value, returns 0 once all the values were
+ * read */
+static inline int
+svb_reader_next(SVBReader * reader)
+{
+    uint8_t code;
+    uint32_t delta;
+
+    if (reader->i >= reader->length){
+        return 0;
+    }
+
+    code = (reader->ctrl[reader->i >> 2] >> ((reader->i & 3) * 2)) & 3;
+
+    /* data bytes are little-endian */
+    delta = reader->data[0];
+    switch (code){
+        case 3: delta |= (uint32_t) reader->data[3] << 24;
+        /* fall through */
+        case 2: delta |= (uint32_t) reader->data[2] << 16;
+        /* fall through */
+        case 1: delta |= (uint32_t) reader->data[1] << 8;
+    }
+    reader->data += code + 1;
+    reader->value += delta;
+    reader->i++;
+
+    return 1;
+}
+
+/* Writes the i-th delta, the control bytes are zeroed group by group as in
+ * svb_encode_scalar */
+static inline void
+svb_write(uint8_t * ctrl, uint8_t ** data, int32_t i, uint32_t delta)
+{
+    uint8_t j, code = svb_code(delta);
+
+    if ((i & 3) == 0){
+        ctrl[i >> 2] = 0;
+    }
+    ctrl[i >> 2] |= code << ((i & 3) * 2);
+
+    /* data bytes are little-endian */
+    for (j = 0; j <= code; j++){
+        *(*data)++ = (uint8_t) (delta >> (8 * j));
+    }
+}
+
+/* Number of bytes needed to store the value minus one (the 2-bit code
+ * stored in the control byte) */
+static inline uint8_t
+svb_code(uint32_t value)
+{
+    if (value < (1U << 8)){
+        return 0;
+    } else if (value < (1U << 16)){
+        return 1;
+    } else if (value < (1U << 24)){
+        return 2;
+    }
+    return 3;
+}
+
+/* Scalar encoder for values [start,length), 'start' must be a multiple of 4 */
+static uint8_t *
+svb_encode_scalar(const uint32_t * input, int32_t start, int32_t length, uint8_t * ctrl, uint8_t * data)
+{
+    int32_t i;
+    uint8_t j, code;
+    uint32_t delta;
+    uint32_t prev = (start > 0) ? input[start - 1] : 0;
+
+    for (i = start; i < length; i++){
+        delta = input[i] - prev;
+        prev = input[i];
+        code = svb_code(delta);
+
+        if ((i & 3) == 0){
+            ctrl[i >> 2] = 0;
+        }
+        ctrl[i >> 2] |= code << ((i & 3) * 2);
+
+        /* data bytes are little-endian */
+        for (j = 0; j <= code; j++){
+            *data++ = (uint8_t) (delta >> (8 * j));
+        }
+    }
+
+    return data;
+}
+
+/* Scalar decoder for values [start,length), 'start' must be a multiple of 4
+ * and 'data' must point to the data of the group containing 'start' */
+static void
+svb_decode_scalar(const uint8_t * ctrl, const uint8_t * data, int32_t start, int32_t length, uint32_t * output)
+{
+    int32_t i;
+    uint8_t code;
+    uint32_t delta;
+    uint32_t prev = (start > 0) ? output[start - 1] : 0;
+
+    for (i = start; i < length; i++){
+        code = (ctrl[i >> 2] >> ((i & 3) * 2)) & 3;
+
+        /* data bytes are little-endian */
+        delta = data[0];
+        switch (code){
+            case 3: delta |= (uint32_t) data[3] << 24;
+            /* fall through */
+            case 2: delta |= (uint32_t) data[2] << 16;
+            /* fall through */
+            case 1: delta |= (uint32_t) data[1] << 8;
+        }
+        data += code + 1;
+
+        prev += delta;
+        output[i] = prev;
+    }
+}
+
+#ifdef SVB_SSSE3
+/* Checks (once) whether the CPU supports SSSE3 */
+static int
+svb_have_ssse3(void)
+{
+    static int supported = -1;
+
+    if (supported < 0){
+        __builtin_cpu_init();
+        supported = __builtin_cpu_supports("ssse3") ? 1 : 0;
+    }
+
+    return supported;
+}
+
+/* SSSE3 encoder for 'groups' full groups of 4. The deltas are computed in a
+ * register, the 4 codes are derived from which bytes of each delta are zero
+ * and the significant bytes are packed with a single shuffle. Each group
+ * stores 16 bytes, but since the data of the first g groups is at most 16*g
+ * bytes long this never writes past SVB_MAX_ENCODED_SIZE(4*groups). */
+__attribute__((target("ssse3")))
+static uint8_t *
+svb_encode_ssse3(const uint32_t * input, int32_t groups, uint8_t * ctrl, uint8_t * data)
+{
+    int32_t g;
+    uint32_t u;
+    uint8_t c;
+    __m128i cur, delta, codes;
+    __m128i prev = _mm_setzero_si128();
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i three = _mm_set1_epi32(3);
+    const __m128i gather = _mm_setr_epi8(0, 4, 8, 12, -1, -1, -1, -1,
+                                         -1, -1, -1, -1, -1, -1, -1, -1);
+
+    for (g = 0; g < groups; g++){
+        cur = _mm_loadu_si128((const __m128i *) (input + 4 * g));
+        delta = _mm_sub_epi32(cur, _mm_alignr_epi8(cur, prev, 12));
+        prev = cur;
+
+        /* code = 3 - (number of zero high bytes), compares yield -1 */
+        codes = _mm_add_epi32(_mm_cmpeq_epi32(_mm_srli_epi32(delta, 8), zero),
+                              _mm_cmpeq_epi32(_mm_srli_epi32(delta, 16), zero));
+        codes = _mm_add_epi32(codes, _mm_cmpeq_epi32(_mm_srli_epi32(delta, 24), zero));
+        codes = _mm_add_epi32(codes, three);
+
+        /* move the 2-bit codes next to each other into the control byte */
+        u = (uint32_t) _mm_cvtsi128_si32(_mm_shuffle_epi8(codes, gather));
+        c = (uint8_t) ((u | (u >> 6) | (u >> 12) | (u >> 18)) & 0xFF);
+
+        _mm_storeu_si128((__m128i *) data,
+            _mm_shuffle_epi8(delta, _mm_loadu_si128((const __m128i *) SVB_ENCODE_SHUFFLE_ARR[c])));
+
+        ctrl[g] = c;
+        data += SVB_LENGTH_ARR[c];
+    }
+
+    return data;
+}
+
+/* Expands the data bytes of a single group (loaded in 'v') into 4 values
+ * stored at 'output', returns the last value broadcast to all lanes. */
+__attribute__((target("ssse3")))
+static inline __m128i
+svb_expand_group_ssse3(__m128i v, uint8_t c, __m128i prev, uint32_t * output)
+{
+    v = _mm_shuffle_epi8(v, _mm_loadu_si128((const __m128i *) SVB_DECODE_SHUFFLE_ARR[c]));
+
+    /* prefix sum of the deltas plus the last value of the previous group */
+    v = _mm_add_epi32(v, _mm_slli_si128(v, 4));
+    v = _mm_add_epi32(v, _mm_slli_si128(v, 8));
+    v = _mm_add_epi32(v, prev);
+
+    _mm_storeu_si128((__m128i *) output, v);
+
+    return _mm_shuffle_epi32(v, 0xFF);
+}
+
+/* SSSE3 decoder for the full groups of 4. The data bytes of a group are
+ * expanded into 4 uint32 deltas with a single shuffle and turned back into
+ * the sorted values with an in-register prefix sum. Each group loads 16 bytes
+ * regardless of its actual length. Every group is at least 4 bytes long, so
+ * this is always safe up to 3 groups before the end. For the last groups the
+ * end of the data is computed from the remaining control bytes and once less
+ * than 16 bytes are left they are copied into a local buffer first, so
+ * nothing past the end is ever read. */
+__attribute__((target("ssse3")))
+static const uint8_t *
+svb_decode_ssse3(const uint8_t * ctrl, const uint8_t * data, int32_t length, uint32_t * output)
+{
+    int32_t g, k, groups = length >> 2;
+    uint8_t c;
+    uint8_t tail[16];
+    const uint8_t * end;
+    __m128i v;
+    __m128i prev = _mm_setzero_si128();
+
+    for (g = 0; g < groups - 3; g++){
+        c = ctrl[g];
+        v = _mm_loadu_si128((const __m128i *) data);
+        prev = svb_expand_group_ssse3(v, c, prev, output + 4 * g);
+        data += SVB_LENGTH_ARR[c];
+    }
+
+    /* only the used codes of a partial last group count (like in
+     * svb_stream_size), the unused ones are zero but a corrupted counter
+     * might not have them zeroed */
+    end = data;
+    for (k = g; k < groups; k++){
+        end += SVB_LENGTH_ARR[ctrl[k]];
+    }
+    for (k = 0; k < (length & 3); k++){
+        end += ((ctrl[groups] >> (2 * k)) & 3) + 1;
+    }
+
+    for (; g < groups; g++){
+        c = ctrl[g];
+        if (data + 16 <= end){
+            v = _mm_loadu_si128((const __m128i *) data);
+        } else {
+            memset(tail, 0, sizeof(tail));
+            memcpy(tail, data, end - data);
+            v = _mm_loadu_si128((const __m128i *) tail);
+        }
+        prev = svb_expand_group_ssse3(v, c, prev, output + 4 * g);
+        data += SVB_LENGTH_ARR[c];
+    }
+
+    return data;
+}
+#endif
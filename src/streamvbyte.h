@@ -0,0 +1,59 @@
+/* Stream VByte encoding of sorted uint32 arrays as described in "Stream VByte:
+ * Faster Byte-Oriented Integer Compression" by Daniel Lemire, Nathan Kurz and
+ * Christoph Rupp.
+ *
+ * Like group varint each value is stored in 1-4 bytes and every group of 4
+ * values is described by a single control byte (2 bits per value, first value
+ * in the low bits). Unlike group varint all control bytes are stored first,
+ * followed by the packed data bytes, so the position of the data of a group
+ * never depends on decoding the previous group. This allows the data of a
+ * whole group to be expanded with a single shuffle.
+ *
+ * Layout for n values:
+ *
+ *     [ ceil(n/4) control bytes ][ data bytes ]
+ *
+ * The last group may be partial, its unused control bits are zero. The
+ * values encoded are the deltas of the sorted input array.
+ *
+ * On x86 an SSSE3 version of the encoder and decoder is used whenever the CPU
+ * supports it (detected at runtime), otherwise a scalar version is used. Both
+ * produce identical output. Compiling with -DHLL_NO_SIMD disables the SSSE3
+ * code paths altogether. */
+#ifndef _STREAMVBYTE_H_
+#define _STREAMVBYTE_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+/* upper bound on the number of bytes used to encode 'length' values */
+#define SVB_MAX_ENCODED_SIZE(length) ((((length) + 3) >> 2) + (length) * 4)
+
+/* ---------------------- function declarations ------------------------ */
+
+/* Encodes the deltas of a sorted array of 'length' uint32's into 'output'
+ * (which needs at least SVB_MAX_ENCODED_SIZE(length) bytes) and returns the
+ * number of bytes used. */
+uint32_t svb_encode_sorted(const uint32_t * input, int32_t length, uint8_t * output);
+
+/* Decodes 'length' values encoded by svb_encode_sorted into 'output'. */
+void svb_decode_sorted(const uint8_t * input, int32_t length, uint32_t * output);
+
+/* Returns the number of bytes svb_encode_sorted would produce for the given
+ * sorted array without actually encoding it. */
+uint32_t svb_encoded_size_sorted(const uint32_t * input, int32_t length);
+
+/* Returns the number of bytes taken by 'length' values encoded by
+ * svb_encode_sorted, computed from the control bytes only. */
+uint32_t svb_stream_size(const uint8_t * input, int32_t length);
+
+/* Merges two encoded sorted arrays of 'length1' and 'length2' values into
+ * 'output' (which needs at least SVB_MAX_ENCODED_SIZE(length1 + length2)
+ * bytes) without decoding them into arrays first. Values present in both are
+ * stored once, the number of values written is returned in 'length' and the
+ * number of bytes used is returned. */
+uint32_t svb_merge_sorted(const uint8_t * input1, int32_t length1,
+                          const uint8_t * input2, int32_t length2,
+                          uint8_t * output, int32_t * length);
+
+#endif /* _STREAMVBYTE_H_ */
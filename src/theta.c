@@ -0,0 +1,327 @@
+/* This file contains the functions of the theta sketches exposed via theta.h
+ * (see there for how the sketches work). */
+#include <stdint.h>
+#include <stdlib.h>
+#include <math.h>
+#include <string.h>
+
+#include "postgres.h"
+
+#include "hyperloglog.h"
+#include "hllutils.h"
+#include "theta.h"
+
+/* Sketches start with room for this many hashes, the array is doubled
+ * whenever compacting it doesn't free more than half of it (up to 2k). */
+#define THETA_MIN_ENTRIES 16
+
+#define THETA_K(s) POW2((s)->lgk)
+#define THETA_CAPACITY(s) ((int)((VARSIZE(s) - offsetof(ThetaSketchData, data)) / sizeof(uint64_t)))
+#define THETA_LENGTH(entries) (offsetof(ThetaSketchData, data) + (entries) * sizeof(uint64_t))
+
+/* ------------- function declarations for local functions --------------- */
+static int hash_cmp(const void * a, const void * b);
+static void theta_sort(ThetaSketch sketch);
+static ThetaSketch theta_resize(ThetaSketch sketch, int capacity);
+static ThetaSketch theta_sorted(ThetaSketch sketch);
+static ThetaSketch theta_result(ThetaSketch sketch1, ThetaSketch sketch2, int capacity);
+
+/* ---------------------- function definitions --------------------------- */
+
+ThetaSketch
+hll_theta_create(float error)
+{
+    ThetaSketch sketch;
+    int lgk;
+
+    if (error <= 0 || error >= 1){
+        elog(ERROR, "invalid error rate requested - only values in (0,1) allowed");
+    }
+
+    lgk = (int)ceil(log2(1.0 / ((double) error * error)));
+    if (lgk < THETA_MIN_LGK){
+        lgk = THETA_MIN_LGK;
+    } else if (lgk > THETA_MAX_LGK){
+        elog(ERROR, "number of hashes kept exceeds 2^%d (requested 2^%d)", THETA_MAX_LGK, lgk);
+    }
+
+    sketch = palloc0(THETA_LENGTH(THETA_MIN_ENTRIES));
+    SET_VARSIZE(sketch, THETA_LENGTH(THETA_MIN_ENTRIES));
+    sketch->lgk = lgk;
+    sketch->version = THETA_VERSION;
+    sketch->theta = THETA_MAX;
+
+    return sketch;
+}
+
+ThetaSketch
+hll_theta_copy(ThetaSketch sketch)
+{
+    ThetaSketch copy = palloc(VARSIZE(sketch));
+
+    memcpy(copy, sketch, VARSIZE(sketch));
+
+    return copy;
+}
+
+ThetaSketch
+hll_theta_add(ThetaSketch sketch, const char * element, int elen)
+{
+    uint64_t hash = MurmurHash64A(element, elen, HASH_SEED);
+
+    if (hash >= sketch->theta){
+        return sketch;
+    }
+
+    if (sketch->entries == THETA_CAPACITY(sketch)){
+        theta_sort(sketch);
+        if (sketch->entries >= THETA_CAPACITY(sketch) / 2 && THETA_CAPACITY(sketch) < 2 * THETA_K(sketch)){
+            sketch = theta_resize(sketch, Min(Max(2 * THETA_CAPACITY(sketch), THETA_MIN_ENTRIES), 2 * THETA_K(sketch)));
+        }
+
+        /* theta may have dropped below the hash */
+        if (hash >= sketch->theta){
+            return sketch;
+        }
+    }
+
+    sketch->data[sketch->entries++] = hash;
+
+    return sketch;
+}
+
+ThetaSketch
+hll_theta_compact(ThetaSketch sketch)
+{
+    theta_sort(sketch);
+
+    return theta_resize(sketch, sketch->entries);
+}
+
+/* The hashes of both sketches below the smaller theta, if that's more than
+ * the smaller k theta drops to the (k+1)-th one. */
+ThetaSketch
+hll_theta_union(ThetaSketch sketch1, ThetaSketch sketch2)
+{
+    ThetaSketch result;
+    const uint64_t * a, * b;
+    int i = 0, j = 0, n = 0, k;
+
+    sketch1 = theta_sorted(sketch1);
+    sketch2 = theta_sorted(sketch2);
+    result = theta_result(sketch1, sketch2, sketch1->entries + sketch2->entries);
+    a = sketch1->data;
+    b = sketch2->data;
+
+    while (i < sketch1->entries || j < sketch2->entries){
+        uint64_t hash;
+
+        if (j == sketch2->entries || (i < sketch1->entries && a[i] < b[j])){
+            hash = a[i++];
+        } else if (i == sketch1->entries || b[j] < a[i]){
+            hash = b[j++];
+        } else {
+            hash = a[i++];
+            j++;
+        }
+
+        /* both arrays are sorted, nothing after this is kept either */
+        if (hash >= result->theta){
+            break;
+        }
+        result->data[n++] = hash;
+    }
+
+    k = THETA_K(result);
+    if (n > k){
+        result->theta = result->data[k];
+        n = k;
+    }
+
+    result->entries = n;
+    result->sorted = n;
+
+    return theta_resize(result, n);
+}
+
+/* the hashes below the smaller theta that are in both sketches */
+ThetaSketch
+hll_theta_intersect(ThetaSketch sketch1, ThetaSketch sketch2)
+{
+    ThetaSketch result;
+    const uint64_t * a, * b;
+    int i = 0, j = 0, n = 0;
+
+    sketch1 = theta_sorted(sketch1);
+    sketch2 = theta_sorted(sketch2);
+    result = theta_result(sketch1, sketch2, Min(sketch1->entries, sketch2->entries));
+    a = sketch1->data;
+    b = sketch2->data;
+
+    while (i < sketch1->entries && j < sketch2->entries && a[i] < result->theta && b[j] < result->theta){
+        if (a[i] < b[j]){
+            i++;
+        } else if (b[j] < a[i]){
+            j++;
+        } else {
+            result->data[n++] = a[i];
+            i++;
+            j++;
+        }
+    }
+
+    result->entries = n;
+    result->sorted = n;
+
+    return theta_resize(result, n);
+}
+
+/* the hashes below the smaller theta that are in the first sketch but not
+ * in the second one */
+ThetaSketch
+hll_theta_a_not_b(ThetaSketch sketch1, ThetaSketch sketch2)
+{
+    ThetaSketch result;
+    const uint64_t * a, * b;
+    int i = 0, j = 0, n = 0;
+
+    sketch1 = theta_sorted(sketch1);
+    sketch2 = theta_sorted(sketch2);
+    result = theta_result(sketch1, sketch2, sketch1->entries);
+    a = sketch1->data;
+    b = sketch2->data;
+
+    for (i = 0; i < sketch1->entries && a[i] < result->theta; i++){
+        while (j < sketch2->entries && b[j] < a[i]){
+            j++;
+        }
+        if (j == sketch2->entries || b[j] != a[i]){
+            result->data[n++] = a[i];
+        }
+    }
+
+    result->entries = n;
+    result->sorted = n;
+
+    return theta_resize(result, n);
+}
+
+double
+hll_theta_estimate(ThetaSketch sketch)
+{
+    if (!THETA_IS_COMPACT(sketch)){
+        sketch = theta_sorted(sketch);
+    }
+
+    if (sketch->theta == THETA_MAX){
+        return sketch->entries;
+    }
+
+    return sketch->entries / ldexp((double) sketch->theta, -64);
+}
+
+void
+hll_theta_validate(ThetaSketch sketch)
+{
+    int i;
+
+    if (VARSIZE(sketch) < offsetof(ThetaSketchData, data)){
+        elog(ERROR, "theta sketch is too short");
+    } else if (sketch->version != THETA_VERSION){
+        elog(ERROR, "unsupported theta sketch version %u (expected %u)", sketch->version, THETA_VERSION);
+    } else if (sketch->lgk < THETA_MIN_LGK || sketch->lgk > THETA_MAX_LGK || sketch->flags != 0 ||
+               sketch->unused != 0 || sketch->padding[0] != 0 || sketch->padding[1] != 0 ||
+               sketch->theta == 0){
+        elog(ERROR, "theta sketch header is corrupted");
+    } else if (sketch->entries < 0 || sketch->entries > THETA_CAPACITY(sketch) || sketch->entries > 2 * THETA_K(sketch) ||
+               sketch->sorted < 0 || sketch->sorted > sketch->entries || sketch->sorted > THETA_K(sketch)){
+        elog(ERROR, "theta sketch header is corrupted");
+    }
+
+    for (i = 0; i < sketch->entries; i++){
+        if (sketch->data[i] >= sketch->theta || (i > 0 && i < sketch->sorted && sketch->data[i] <= sketch->data[i - 1])){
+            elog(ERROR, "theta sketch data is corrupted");
+        }
+    }
+}
+
+static int
+hash_cmp(const void * a, const void * b)
+{
+    uint64_t x = *(const uint64_t *) a;
+    uint64_t y = *(const uint64_t *) b;
+
+    return (x > y) - (x < y);
+}
+
+/* Sorts and deduplicates the hashes in place and keeps the k smallest ones
+ * (theta becomes the next one) */
+static void
+theta_sort(ThetaSketch sketch)
+{
+    uint64_t * data = sketch->data;
+    int i, j = 0;
+
+    if (THETA_IS_COMPACT(sketch)){
+        return;
+    }
+
+    qsort(data, sketch->entries, sizeof(uint64_t), hash_cmp);
+
+    for (i = 1; i < sketch->entries; i++){
+        if (data[i] != data[j]){
+            data[++j] = data[i];
+        }
+    }
+    sketch->entries = j + 1;
+
+    if (sketch->entries > THETA_K(sketch)){
+        sketch->theta = data[THETA_K(sketch)];
+        sketch->entries = THETA_K(sketch);
+    }
+
+    sketch->sorted = sketch->entries;
+}
+
+/* Moves the sketch into a new (zeroed) allocation with room for 'capacity'
+ * hashes like sparse_grow, the old sketch stays allocated (it may be the
+ * transition state of an aggregate, which PostgreSQL frees itself) */
+static ThetaSketch
+theta_resize(ThetaSketch sketch, int capacity)
+{
+    ThetaSketch result = palloc0(THETA_LENGTH(capacity));
+
+    memcpy(result, sketch, Min(VARSIZE(sketch), THETA_LENGTH(capacity)));
+    SET_VARSIZE(result, THETA_LENGTH(capacity));
+
+    return result;
+}
+
+/* the sketch itself when it's compact, a compacted copy otherwise */
+static ThetaSketch
+theta_sorted(ThetaSketch sketch)
+{
+    if (THETA_IS_COMPACT(sketch)){
+        return sketch;
+    }
+
+    sketch = hll_theta_copy(sketch);
+    theta_sort(sketch);
+
+    return sketch;
+}
+
+/* an empty sketch for the result of a set operation with room for
+ * 'capacity' hashes */
+static ThetaSketch
+theta_result(ThetaSketch sketch1, ThetaSketch sketch2, int capacity)
+{
+    ThetaSketch result = palloc0(THETA_LENGTH(Max(capacity, 1)));
+
+    SET_VARSIZE(result, THETA_LENGTH(Max(capacity, 1)));
+    result->lgk = Min(sketch1->lgk, sketch2->lgk);
+    result->version = THETA_VERSION;
+    result->theta = Min(sketch1->theta, sketch2->theta);
+
+    return result;
+}
@@ -0,0 +1,106 @@
+#ifndef _THETA_H_
+#define _THETA_H_
+/* Theta sketches (k minimum values) as described in "Theta Sketch Framework"
+ * by Anirban Dasgupta, Kevin Lang, Lee Rhodes and Justin Thaler (2016).
+ *
+ * Items are hashed to 64 bits like for hyperloglog_estimator's and the
+ * sketch keeps the distinct hashes below a threshold theta, at most k of
+ * them. Once more than k distinct hashes are seen theta drops to the
+ * (k+1)-th smallest one, so the kept hashes are a uniform sample of the
+ * items with rate theta / 2^64 and the estimate is simply
+ *
+ *   entries / (theta / 2^64)
+ *
+ * with a relative error of about 1/sqrt(k). Sketches that never filled up
+ * (theta = THETA_MAX) count exactly.
+ *
+ * Unlike HyperLogLog registers the samples support all set operations
+ * directly: the union, intersection or difference of two sketches is the
+ * union, intersection or difference of their (sorted) hashes below the
+ * smaller theta, computed with a single pass over both arrays. The estimate
+ * of the result has the error of a sketch of that size instead of the
+ * error of the inclusion-exclusion terms.
+ *
+ * Like the sliding window counters the hashes are simply appended as items
+ * are added. When the array fills up it's sorted, deduplicated and trimmed
+ * to the k smallest hashes and doubled (up to 2k) if that doesn't free more
+ * than half of it. The leading 'sorted' entries are known to be sorted and
+ * distinct, a compact sketch (all entries sorted, as stored) has its
+ * estimate in the header.
+ *
+ * THETA_VERSION
+ * 1 - Initial version. */
+#define THETA_VERSION 1
+
+/* range of log2(k), the nominal number of hashes kept */
+#define THETA_MIN_LGK 4
+#define THETA_MAX_LGK 20
+
+/* theta of sketches that kept every hash */
+#define THETA_MAX UINT64_MAX
+
+/* default error rate, k = 4096 */
+#define THETA_DEFAULT_ERROR 0.015625
+
+#define THETA_IS_COMPACT(s) ((s)->sorted == (s)->entries)
+
+typedef struct ThetaSketchData {
+
+    /* varlena header */
+    char vl_len_[4];
+
+    /* log2 of the nominal number of hashes kept (k) */
+    int8_t lgk;
+
+    uint8_t version;
+
+    /* unused, always 0 */
+    uint8_t flags;
+    uint8_t unused;
+
+    /* number of hashes in the data array, the allocation may hold more */
+    int32_t entries;
+
+    /* number of leading hashes that are sorted and distinct */
+    int32_t sorted;
+
+    /* unused, always 0 (covers the gap up to the 8 byte aligned theta) */
+    int32_t padding[2];
+
+    /* only hashes below theta are kept */
+    uint64_t theta;
+
+    uint64_t data[1];
+
+} ThetaSketchData;
+
+typedef ThetaSketchData * ThetaSketch;
+
+/* creates an empty sketch with k = 2^ceil(log2(1 / error^2)) */
+ThetaSketch hll_theta_create(float error);
+
+ThetaSketch hll_theta_copy(ThetaSketch sketch);
+
+/* adds an element, returns the sketch or a larger copy of it (the argument
+ * is never freed) */
+ThetaSketch hll_theta_add(ThetaSketch sketch, const char * element, int elen);
+
+/* sorts, deduplicates and trims the sketch in place and returns a copy of
+ * it without the unused room, for storing the sketch */
+ThetaSketch hll_theta_compact(ThetaSketch sketch);
+
+/* Set operations on two sketches, the result is a new compact sketch with
+ * the smaller k and theta of the two. The arguments aren't modified. */
+ThetaSketch hll_theta_union(ThetaSketch sketch1, ThetaSketch sketch2);
+ThetaSketch hll_theta_intersect(ThetaSketch sketch1, ThetaSketch sketch2);
+ThetaSketch hll_theta_a_not_b(ThetaSketch sketch1, ThetaSketch sketch2);
+
+/* estimate of the distinct items, only reads the header of compact
+ * sketches */
+double hll_theta_estimate(ThetaSketch sketch);
+
+/* checks that a sketch read from outside is consistent, errors out
+ * otherwise */
+void hll_theta_validate(ThetaSketch sketch);
+
+#endif // #ifndef _THETA_H_
@@ -0,0 +1,702 @@
+/* This file contains the functions of the UltraLogLog counters exposed via
+ * ultraloglog.h (see there for the register layout). */
+#include <stdint.h>
+#include <stdlib.h>
+#include <math.h>
+#include <string.h>
+
+#include "postgres.h"
+
+#include "hyperloglog.h"
+#include "hllutils.h"
+#include "ultraloglog.h"
+#include "rans.h"
+#include "streamvbyte.h"
+
+/* Sparse counters start with room for this many entries, the array is
+ * doubled whenever deduplicating it doesn't free more than half of it. */
+#define ULTRA_MIN_ENTRIES 16
+
+/* the update values are the rhos of 6 bit HLLCounter registers */
+#define ULTRA_BINBITS 6
+
+#define ULTRA_HEADER_LENGTH offsetof(UltraHLLData, data)
+#define ULTRA_CAPACITY(u) ((int)((VARSIZE(u) - ULTRA_HEADER_LENGTH) / sizeof(uint32_t)))
+#define ULTRA_SPARSE_LENGTH(entries) (ULTRA_HEADER_LENGTH + (entries) * sizeof(uint32_t))
+#define ULTRA_DENSE_LENGTH(b) (ULTRA_HEADER_LENGTH + POW2(b))
+
+/* sparse counters with more (distinct) entries are turned into dense ones */
+#define ULTRA_SPARSE_MAX(b) (POW2(b) / 8)
+
+#define ULTRA_ENTRY(idx, reg) (((uint32_t)(idx) << 8) | (reg))
+#define ULTRA_ENTRY_IDX(e) ((e) >> 8)
+#define ULTRA_ENTRY_REG(e) ((uint8_t)((e) & 0xFF))
+
+/* ------------- function declarations for local functions --------------- */
+static inline uint64_t ultra_unpack(uint8_t reg);
+static inline uint8_t ultra_pack(uint64_t mask);
+static inline uint8_t ultra_merge_register(uint8_t reg1, uint8_t reg2);
+static bool ultra_register_valid(uint8_t reg);
+static int entry_cmp(const void * a, const void * b);
+static void ultra_dedupe(UltraHLL counter);
+static UltraHLL ultra_resize(UltraHLL counter, int capacity);
+static UltraHLL ultra_to_dense(UltraHLL counter);
+static void ultra_check_compressed(UltraHLL counter);
+static double ultra_estimate_histogram(const uint32_t * counts, int b);
+
+/* ---------------------- function definitions --------------------------- */
+
+UltraHLL
+hll_ultra_create(float error)
+{
+    UltraHLL counter;
+    float m;
+    int b;
+
+    if (error <= 0 || error >= 1){
+        elog(ERROR, "invalid error rate requested - only values in (0,1) allowed");
+    }
+
+    /* the smallest precision with the requested error rate */
+    m = ULTRA_ERROR_CONST / (error * error);
+    b = (int)ceil(log2(m));
+    if (b < MIN_INDEX_BITS){
+        b = MIN_INDEX_BITS;
+    } else if (b > MAX_INDEX_BITS){
+        elog(ERROR, "number of index bits exceeds MAX_INDEX_BITS (requested %d)", b);
+    }
+
+    counter = palloc0(ULTRA_SPARSE_LENGTH(ULTRA_MIN_ENTRIES));
+    SET_VARSIZE(counter, ULTRA_SPARSE_LENGTH(ULTRA_MIN_ENTRIES));
+    counter->b = b;
+    counter->version = ULTRA_VERSION;
+
+    return counter;
+}
+
+UltraHLL
+hll_ultra_copy(UltraHLL counter)
+{
+    UltraHLL copy = palloc(VARSIZE(counter));
+
+    memcpy(copy, counter, VARSIZE(counter));
+
+    return copy;
+}
+
+/* the values seen by a register as a mask (bit k for value k) */
+static inline uint64_t
+ultra_unpack(uint8_t reg)
+{
+    int u = reg >> 2;
+    uint64_t mask;
+
+    if (u == 0){
+        return 0;
+    }
+
+    mask = 1ULL << u;
+    if (reg & 2){
+        mask |= 1ULL << (u - 1);
+    }
+    if (reg & 1){
+        mask |= 1ULL << (u - 2);
+    }
+
+    return mask;
+}
+
+/* the register of a mask of seen values (value 0 is never seen) */
+static inline uint8_t
+ultra_pack(uint64_t mask)
+{
+    int u;
+
+    if (mask == 0){
+        return 0;
+    }
+
+    u = 63 - __builtin_clzll(mask);
+    if (u == 1){
+        return 1 << 2;
+    }
+
+    return (uint8_t)((u << 2) | ((mask >> (u - 2)) & 3));
+}
+
+static inline uint8_t
+ultra_merge_register(uint8_t reg1, uint8_t reg2)
+{
+    if (reg1 == reg2 || reg2 == 0){
+        return reg1;
+    } else if (reg1 == 0){
+        return reg2;
+    }
+
+    return ultra_pack(ultra_unpack(reg1) | ultra_unpack(reg2));
+}
+
+/* registers can't have bits for values below 1 */
+static bool
+ultra_register_valid(uint8_t reg)
+{
+    int u = reg >> 2;
+
+    return (u > 2) || (u == 2 && (reg & 1) == 0) || (u < 2 && (reg & 3) == 0);
+}
+
+UltraHLL
+hll_ultra_add(UltraHLL counter, const char * element, int elen)
+{
+    uint32_t idx;
+    uint8_t rho, reg;
+
+    counter = hll_ultra_decompress(counter);
+
+    hll_element_register(element, elen, counter->b, ULTRA_BINBITS, &idx, &rho);
+    reg = ultra_pack(1ULL << Min(rho, ULTRA_MAX_VALUE));
+
+    if (counter->entries != ULTRA_DENSE && counter->entries == ULTRA_CAPACITY(counter)){
+        ultra_dedupe(counter);
+        if (counter->entries > ULTRA_SPARSE_MAX(counter->b)){
+            counter = ultra_to_dense(counter);
+        } else if (counter->entries >= ULTRA_CAPACITY(counter) / 2){
+            counter = ultra_resize(counter, Max(2 * ULTRA_CAPACITY(counter), ULTRA_MIN_ENTRIES));
+        }
+    }
+
+    if (counter->entries == ULTRA_DENSE){
+        counter->data[idx] = ultra_merge_register(counter->data[idx], reg);
+    } else {
+        ((uint32_t *) counter->data)[counter->entries++] = ULTRA_ENTRY(idx, reg);
+    }
+
+    return counter;
+}
+
+UltraHLL
+hll_ultra_merge(UltraHLL counter1, UltraHLL counter2)
+{
+    const uint32_t * entries2;
+    int i, entries, capacity;
+
+    if (ULTRA_PRECISION(counter1) != ULTRA_PRECISION(counter2)){
+        elog(ERROR, "index size (bit length) of ultraloglog counters differs (%d != %d)",
+             ULTRA_PRECISION(counter1), ULTRA_PRECISION(counter2));
+    }
+
+    counter1 = hll_ultra_decompress(counter1);
+    counter2 = hll_ultra_decompress(counter2);
+
+    if (counter2->entries == 0){
+        return counter1;
+    } else if (counter2->entries == ULTRA_DENSE && counter1->entries != ULTRA_DENSE){
+        counter1 = ultra_to_dense(counter1);
+    }
+
+    entries2 = (const uint32_t *) counter2->data;
+
+    if (counter1->entries == ULTRA_DENSE && counter2->entries == ULTRA_DENSE){
+        for (i = 0; i < POW2(counter1->b); i++){
+            counter1->data[i] = ultra_merge_register(counter1->data[i], counter2->data[i]);
+        }
+        return counter1;
+    } else if (counter1->entries == ULTRA_DENSE){
+        for (i = 0; i < counter2->entries; i++){
+            uint32_t idx = ULTRA_ENTRY_IDX(entries2[i]);
+
+            counter1->data[idx] = ultra_merge_register(counter1->data[idx], ULTRA_ENTRY_REG(entries2[i]));
+        }
+        return counter1;
+    }
+
+    /* both sparse, append the entries and deduplicate them */
+    entries = counter1->entries + counter2->entries;
+    if (entries > ULTRA_CAPACITY(counter1)){
+        for (capacity = ULTRA_MIN_ENTRIES; capacity < entries; capacity *= 2);
+        counter1 = ultra_resize(counter1, capacity);
+    }
+
+    memcpy((uint32_t *) counter1->data + counter1->entries, entries2, counter2->entries * sizeof(uint32_t));
+    counter1->entries = entries;
+
+    ultra_dedupe(counter1);
+    if (counter1->entries > ULTRA_SPARSE_MAX(counter1->b)){
+        counter1 = ultra_to_dense(counter1);
+    }
+
+    return counter1;
+}
+
+/* Dense counters are rANS coded, sparse ones are deduplicated and their
+ * (sorted) entries Stream VByte coded - unless that doesn't make them smaller,
+ * then the counter is just trimmed. */
+UltraHLL
+hll_ultra_compress(UltraHLL counter)
+{
+    UltraHLL result;
+    uint32_t size;
+    int m;
+
+    if (counter->b < 0){
+        return counter;
+    }
+
+    /* entries appended since the array was last deduplicated may be too many
+     * for a sparse counter */
+    if (counter->entries != ULTRA_DENSE){
+        ultra_dedupe(counter);
+        if (counter->entries > ULTRA_SPARSE_MAX(counter->b)){
+            counter = ultra_to_dense(counter);
+        }
+    }
+
+    if (counter->entries == ULTRA_DENSE){
+        m = POW2(counter->b);
+        result = palloc0(ULTRA_HEADER_LENGTH + RANS_MAX_ENCODED_SIZE(m));
+        size = rans_encode_registers(counter->data, m, result->data, m - 1);
+    } else {
+        result = palloc0(ULTRA_HEADER_LENGTH + SVB_MAX_ENCODED_SIZE(counter->entries));
+        size = svb_encode_sorted((uint32_t *) counter->data, counter->entries, result->data);
+        if (size >= counter->entries * sizeof(uint32_t)){
+            size = 0;
+        }
+    }
+
+    if (size == 0){
+        pfree(result);
+        if (counter->entries == ULTRA_DENSE){
+            return counter;
+        }
+        return ultra_resize(counter, counter->entries);
+    }
+
+    memcpy(result, counter, ULTRA_HEADER_LENGTH);
+    SET_VARSIZE(result, ULTRA_HEADER_LENGTH + size);
+    result->b = -counter->b;
+
+    return result;
+}
+
+UltraHLL
+hll_ultra_decompress(UltraHLL counter)
+{
+    UltraHLL result;
+    int b = ULTRA_PRECISION(counter);
+
+    if (counter->b > 0){
+        return counter;
+    }
+
+    ultra_check_compressed(counter);
+
+    if (counter->entries == ULTRA_DENSE){
+        result = palloc0(ULTRA_DENSE_LENGTH(b));
+        if (rans_decode_registers(counter->data, VARSIZE(counter) - ULTRA_HEADER_LENGTH,
+                                  result->data, POW2(b), UINT8_MAX) != 0){
+            elog(ERROR, "ultraloglog counter data is corrupted");
+        }
+        SET_VARSIZE(result, ULTRA_DENSE_LENGTH(b));
+    } else {
+        result = palloc0(ULTRA_SPARSE_LENGTH(Max(counter->entries, ULTRA_MIN_ENTRIES)));
+        svb_decode_sorted(counter->data, counter->entries, (uint32_t *) result->data);
+        SET_VARSIZE(result, ULTRA_SPARSE_LENGTH(Max(counter->entries, ULTRA_MIN_ENTRIES)));
+    }
+
+    result->b = b;
+    result->version = counter->version;
+    result->entries = counter->entries;
+
+    return result;
+}
+
+/* the compressed data has to be complete before it's decoded */
+static void
+ultra_check_compressed(UltraHLL counter)
+{
+    uint32_t size = VARSIZE(counter) - ULTRA_HEADER_LENGTH;
+
+    if (counter->entries == ULTRA_DENSE){
+        return;
+    } else if (counter->entries < 0 || counter->entries > ULTRA_SPARSE_MAX(ULTRA_PRECISION(counter)) ||
+               (counter->entries + 3) / 4 > size ||
+               svb_stream_size(counter->data, counter->entries) != size){
+        elog(ERROR, "ultraloglog counter data is corrupted");
+    }
+}
+
+double
+hll_ultra_estimate(UltraHLL counter)
+{
+    uint32_t counts[UINT8_MAX + 1];
+    const uint32_t * entries;
+    int i;
+
+    counter = hll_ultra_decompress(counter);
+    memset(counts, 0, sizeof(counts));
+
+    if (counter->entries == ULTRA_DENSE){
+        for (i = 0; i < POW2(counter->b); i++){
+            counts[counter->data[i]]++;
+        }
+    } else {
+        ultra_dedupe(counter);
+        entries = (const uint32_t *) counter->data;
+        for (i = 0; i < counter->entries; i++){
+            counts[ULTRA_ENTRY_REG(entries[i])]++;
+        }
+        counts[0] += POW2(counter->b) - counter->entries;
+    }
+
+    return ultra_estimate_histogram(counts, counter->b);
+}
+
+/* probability that an item updates a register with value k (the last value
+ * takes the rest) */
+static inline double
+ultra_probability(int k)
+{
+    return ldexp(1.0, -Min(k, ULTRA_MAX_VALUE - 1));
+}
+
+/* The maximum likelihood estimate given the number of registers with each
+ * value. With items distributed as a Poisson process of rate l per register
+ * value k of a register is seen with probability 1 - exp(-l * p_k) (with p_k
+ * from ultra_probability), so the log-likelihood of the registers is
+ *
+ *   -l * A + sum C_k * log(1 - exp(-l * p_k))
+ *
+ * where C_k is the number of times value k is known to be seen and A the sum
+ * of p_k over the values known not to be seen (all the ones above u, the
+ * unset bits below it and all the values of empty registers). The rate where
+ * its derivative vanishes, i.e. where
+ *
+ *   sum C_k * p_k / (exp(l * p_k) - 1) = A
+ *
+ * is found with safeguarded Newton iterations on log(l), the left hand side
+ * decreases in l. The estimate is 2^b * l. */
+static double
+ultra_estimate_histogram(const uint32_t * counts, int b)
+{
+    double c[ULTRA_MAX_VALUE + 1];
+    double a = 0, seen = 0;
+    double x, lo, hi, f, df, step;
+    int reg, k, i;
+
+    memset(c, 0, sizeof(c));
+
+    for (reg = 0; reg <= UINT8_MAX; reg++){
+        int u = reg >> 2;
+
+        if (counts[reg] == 0){
+            continue;
+        } else if (u == 0){
+            /* the p_k of all values add up to 1 */
+            a += counts[reg];
+            continue;
+        }
+
+        if (u < ULTRA_MAX_VALUE){
+            a += counts[reg] * ldexp(1.0, -u);
+        }
+        c[u] += counts[reg];
+
+        for (k = u - 1; k >= Max(u - 2, 1); k--){
+            if (reg & (1 << (k - u + 2))){
+                c[k] += counts[reg];
+            } else {
+                a += counts[reg] * ultra_probability(k);
+            }
+        }
+    }
+
+    for (k = 1; k <= ULTRA_MAX_VALUE; k++){
+        seen += c[k];
+    }
+
+    if (seen == 0){
+        return 0;
+    } else if (a == 0){
+        /* every value of every register seen, the counter is saturated */
+        return ldexp((double) POW2(b), ULTRA_MAX_VALUE);
+    }
+
+    /* the root is between a rate too small to see anything and one that
+     * should have filled every register */
+    lo = log(ldexp(1.0, -MAX_INDEX_BITS - 8));
+    hi = log(ldexp(1.0, ULTRA_MAX_VALUE + 16));
+    x = Min(Max(log(seen / a), lo), hi);
+
+    for (i = 0; i < 100; i++){
+        double l = exp(x);
+
+        f = -a;
+        df = 0;
+        for (k = 1; k <= ULTRA_MAX_VALUE; k++){
+            double t, e;
+
+            if (c[k] == 0){
+                continue;
+            }
+
+            t = l * ultra_probability(k);
+            if (t > 700){
+                continue;
+            }
+
+            e = expm1(t);
+            f += c[k] * ultra_probability(k) / e;
+            df -= c[k] * ultra_probability(k) * t * (e + 1) / (e * e);
+        }
+
+        if (f > 0){
+            lo = x;
+        } else {
+            hi = x;
+        }
+
+        step = (df < 0) ? -f / df : 0;
+        if (df >= 0 || x + step <= lo || x + step >= hi){
+            step = (lo + hi) / 2 - x;
+        }
+        x += step;
+
+        if (fabs(step) < 1e-12){
+            break;
+        }
+    }
+
+    return POW2(b) * exp(x);
+}
+
+HLLCounter
+hll_ultra_to_counter(UltraHLL counter)
+{
+    HLLCounter hloglog;
+    size_t length;
+    const uint32_t * entries;
+    int i;
+
+    counter = hll_ultra_decompress(counter);
+
+    length = sizeof(HLLData) + POW2(counter->b);
+    hloglog = palloc0(length);
+    SET_VARSIZE(hloglog, length);
+    hloglog->b = counter->b;
+    hloglog->binbits = ULTRA_BINBITS;
+    hloglog->version = STRUCT_VERSION;
+    hloglog->format = UNPACKED;
+    hloglog->idx = -1;
+
+    if (counter->entries == ULTRA_DENSE){
+        for (i = 0; i < POW2(counter->b); i++){
+            hloglog->data[i] = counter->data[i] >> 2;
+        }
+    } else {
+        entries = (const uint32_t *) counter->data;
+        for (i = 0; i < counter->entries; i++){
+            uint8_t u = ULTRA_ENTRY_REG(entries[i]) >> 2;
+
+            if (u > (uint8_t) hloglog->data[ULTRA_ENTRY_IDX(entries[i])]){
+                hloglog->data[ULTRA_ENTRY_IDX(entries[i])] = u;
+            }
+        }
+    }
+
+    return hloglog;
+}
+
+/* The registers of the counter only say which value was the largest one. At
+ * the estimated rate per register l value k is seen with probability
+ * 1 - exp(-l * p_k) regardless of the largest one, so the bits of the values
+ * below are set with that probability (decided by a hash of the register
+ * index, so the conversion is deterministic). Rounding the probabilities
+ * instead would bias the maximum likelihood estimate of the result. */
+UltraHLL
+hll_ultra_from_counter(HLLCounter hloglog)
+{
+    UltraHLL counter;
+    double seen[ULTRA_MAX_VALUE + 1];
+    double rate;
+    int b, m, i, k, set = 0;
+
+    if (HLL_IS_HIGH_PRECISION(hloglog)){
+        elog(ERROR, "counters with more than %d index bits can't be converted (index bits %d)",
+             MAX_INDEX_BITS, HLL_PRECISION(hloglog));
+    }
+
+    hloglog = hll_fixed(hloglog, UNPACKED);
+    b = hloglog->b;
+    m = POW2(b);
+    rate = hll_estimate(hloglog) / m;
+
+    for (k = 0; k <= ULTRA_MAX_VALUE; k++){
+        seen[k] = -expm1(-rate * ultra_probability(k));
+    }
+
+    for (i = 0; i < m; i++){
+        if (hloglog->data[i] != 0){
+            set++;
+        }
+    }
+
+    if (set > ULTRA_SPARSE_MAX(b)){
+        counter = palloc0(ULTRA_DENSE_LENGTH(b));
+        SET_VARSIZE(counter, ULTRA_DENSE_LENGTH(b));
+        counter->entries = ULTRA_DENSE;
+    } else {
+        counter = palloc0(ULTRA_SPARSE_LENGTH(Max(set, ULTRA_MIN_ENTRIES)));
+        SET_VARSIZE(counter, ULTRA_SPARSE_LENGTH(Max(set, ULTRA_MIN_ENTRIES)));
+    }
+    counter->b = b;
+    counter->version = ULTRA_VERSION;
+
+    for (i = 0; i < m; i++){
+        int u = Min((uint8_t) hloglog->data[i], ULTRA_MAX_VALUE);
+        uint64_t hash;
+        uint8_t reg;
+
+        if (u == 0){
+            continue;
+        }
+
+        /* two independent uniform 32 bit numbers for the two bits */
+        hash = MurmurHash64A(&i, sizeof(i), HASH_SEED);
+
+        reg = u << 2;
+        if (u >= 2 && ldexp((double)(hash >> 32), -32) < seen[u - 1]){
+            reg |= 2;
+        }
+        if (u >= 3 && ldexp((double)(hash & 0xFFFFFFFF), -32) < seen[u - 2]){
+            reg |= 1;
+        }
+
+        if (counter->entries == ULTRA_DENSE){
+            counter->data[i] = reg;
+        } else {
+            ((uint32_t *) counter->data)[counter->entries++] = ULTRA_ENTRY(i, reg);
+        }
+    }
+
+    return counter;
+}
+
+void
+hll_ultra_validate(UltraHLL counter)
+{
+    const uint32_t * entries;
+    UltraHLL decompressed;
+    int b, i;
+
+    if (VARSIZE(counter) < ULTRA_HEADER_LENGTH){
+        elog(ERROR, "ultraloglog counter is too short");
+    } else if (counter->version != ULTRA_VERSION){
+        elog(ERROR, "unsupported ultraloglog counter version %u (expected %u)", counter->version, ULTRA_VERSION);
+    } else if (ULTRA_PRECISION(counter) < MIN_INDEX_BITS || ULTRA_PRECISION(counter) > MAX_INDEX_BITS ||
+               counter->flags != 0 || counter->unused != 0){
+        elog(ERROR, "ultraloglog counter header is corrupted");
+    }
+
+    b = ULTRA_PRECISION(counter);
+
+    if (counter->b < 0){
+        ultra_check_compressed(counter);
+        decompressed = hll_ultra_decompress(counter);
+        hll_ultra_validate(decompressed);
+        pfree(decompressed);
+        return;
+    }
+
+    if (counter->entries == ULTRA_DENSE){
+        if (VARSIZE(counter) != ULTRA_DENSE_LENGTH(b)){
+            elog(ERROR, "ultraloglog counter header is corrupted");
+        }
+        for (i = 0; i < POW2(b); i++){
+            if (!ultra_register_valid(counter->data[i])){
+                elog(ERROR, "ultraloglog counter data is corrupted");
+            }
+        }
+        return;
+    }
+
+    if (counter->entries < 0 || counter->entries > ULTRA_CAPACITY(counter)){
+        elog(ERROR, "ultraloglog counter header is corrupted");
+    }
+
+    entries = (const uint32_t *) counter->data;
+    for (i = 0; i < counter->entries; i++){
+        if (ULTRA_ENTRY_IDX(entries[i]) >= POW2(b) || ULTRA_ENTRY_REG(entries[i]) == 0 ||
+            !ultra_register_valid(ULTRA_ENTRY_REG(entries[i]))){
+            elog(ERROR, "ultraloglog counter data is corrupted");
+        }
+    }
+}
+
+static int
+entry_cmp(const void * a, const void * b)
+{
+    uint32_t x = *(const uint32_t *) a;
+    uint32_t y = *(const uint32_t *) b;
+
+    return (x > y) - (x < y);
+}
+
+/* sorts the sparse entries and merges the ones of the same register */
+static void
+ultra_dedupe(UltraHLL counter)
+{
+    uint32_t * entries = (uint32_t *) counter->data;
+    int i, j = 0;
+
+    if (counter->entries < 2){
+        return;
+    }
+
+    qsort(entries, counter->entries, sizeof(uint32_t), entry_cmp);
+
+    for (i = 1; i < counter->entries; i++){
+        if (ULTRA_ENTRY_IDX(entries[i]) == ULTRA_ENTRY_IDX(entries[j])){
+            entries[j] = ULTRA_ENTRY(ULTRA_ENTRY_IDX(entries[j]),
+                                     ultra_merge_register(ULTRA_ENTRY_REG(entries[j]), ULTRA_ENTRY_REG(entries[i])));
+        } else {
+            entries[++j] = entries[i];
+        }
+    }
+
+    counter->entries = j + 1;
+}
+
+/* Moves the sparse counter into a new (zeroed) allocation with room for
+ * 'capacity' entries like sparse_grow, the old counter stays untouched (it may
+ * be the transition state of an aggregate, which PostgreSQL frees itself) */
+static UltraHLL
+ultra_resize(UltraHLL counter, int capacity)
+{
+    UltraHLL result = palloc0(ULTRA_SPARSE_LENGTH(capacity));
+
+    memcpy(result, counter, Min(VARSIZE(counter), ULTRA_SPARSE_LENGTH(capacity)));
+    SET_VARSIZE(result, ULTRA_SPARSE_LENGTH(capacity));
+
+    return result;
+}
+
+static UltraHLL
+ultra_to_dense(UltraHLL counter)
+{
+    UltraHLL dense = palloc0(ULTRA_DENSE_LENGTH(counter->b));
+    const uint32_t * entries = (const uint32_t *) counter->data;
+    int i;
+
+    SET_VARSIZE(dense, ULTRA_DENSE_LENGTH(counter->b));
+    dense->b = counter->b;
+    dense->version = counter->version;
+    dense->entries = ULTRA_DENSE;
+
+    for (i = 0; i < counter->entries; i++){
+        uint32_t idx = ULTRA_ENTRY_IDX(entries[i]);
+
+        dense->data[idx] = ultra_merge_register(dense->data[idx], ULTRA_ENTRY_REG(entries[i]));
+    }
+
+    return dense;
+}
@@ -0,0 +1,115 @@
+#ifndef _ULTRALOGLOG_H_
+#define _ULTRALOGLOG_H_
+/* UltraLogLog as described in "UltraLogLog: A Practical and More
+ * Space-Efficient Alternative to HyperLogLog for Approximate Distinct
+ * Counting", published by Otmar Ertl in 2024.
+ *
+ * Every register is a byte. The upper 6 bits hold the largest update value u
+ * seen by the register (the rho a hyperloglog_estimator of the same precision
+ * keeps, see hll_element_register), the two lower bits record whether the
+ * values u-1 and u-2 were seen as well:
+ *
+ *   register = (u << 2) | (seen(u - 1) << 1) | seen(u - 2)
+ *
+ * 0 is an empty register, bits for values below 1 are always 0. Updates and
+ * merges turn the register into the mask of seen values, OR them and turn
+ * the mask back, so merging two counters gives the same registers as adding
+ * the items of both to one.
+ *
+ * The extra bits carry enough information that the maximum likelihood
+ * estimate (see ultra_estimate_histogram) of 2^p registers is about as
+ * accurate as the HyperLogLog estimate of 2^(p+1) registers, i.e. the same
+ * accuracy takes 8 * 2^p instead of 6 * 2^(p+1) bits - a third less storage
+ * and merge bandwidth. The precision is the smallest one that gives the
+ * requested error rate (see ULTRA_ERROR_CONST), which is one bit below the
+ * one hll_create picks for most but not all error rates.
+ *
+ * Like HLLCounter new counters are sparse, an array of idx << 8 | register
+ * entries that are simply appended and deduplicated (sorted, registers of
+ * the same index merged) when the array fills up. Once more than 1/8 of the
+ * registers are set the counter turns into the dense array of 2^p registers.
+ * Stored counters are compressed when that makes them smaller, sparse ones
+ * with Stream VByte and dense ones with rANS, which is marked by a negative
+ * b (like for HLLCounter).
+ *
+ * ULTRA_VERSION
+ * 1 - Initial version. */
+#define ULTRA_VERSION 1
+
+/* largest update value a register can hold */
+#define ULTRA_MAX_VALUE 63
+
+/* The relative error of the estimate is about 0.78/sqrt(m) (1.04/sqrt(m)
+ * for HyperLogLog, see ERROR_CONST), so m = 0.78^2 / error^2 */
+#define ULTRA_ERROR_CONST 0.6084
+
+/* default error rate, the accuracy of 2^13 registers (hyperloglog_estimator's
+ * default error rate takes 2^14) */
+#define ULTRA_DEFAULT_ERROR 0.00862
+
+/* entries value of dense counters */
+#define ULTRA_DENSE -1
+
+#define ULTRA_PRECISION(u) ((u)->b > 0 ? (u)->b : -(u)->b)
+
+typedef struct UltraHLLData {
+
+    /* varlena header */
+    char vl_len_[4];
+
+    /* bits for the register index, negative for compressed counters */
+    int8_t b;
+
+    uint8_t version;
+
+    /* unused, always 0 */
+    uint8_t flags;
+    uint8_t unused;
+
+    /* number of sparse entries in the data array (the allocation may hold
+     * more) or ULTRA_DENSE */
+    int32_t entries;
+
+    /* uint32 sparse entries, 2^b registers or the compressed data */
+    uint8_t data[1];
+
+} UltraHLLData;
+
+typedef UltraHLLData * UltraHLL;
+
+/* creates an empty counter for the error rate (see ULTRA_ERROR_CONST) */
+UltraHLL hll_ultra_create(float error);
+
+UltraHLL hll_ultra_copy(UltraHLL counter);
+
+/* adds an element, returns the counter or a larger copy of it (the argument
+ * is never freed) */
+UltraHLL hll_ultra_add(UltraHLL counter, const char * element, int elen);
+
+/* merges counter2 into counter1 and returns the result (a modified counter1
+ * or a new counter), both have to use the same precision */
+UltraHLL hll_ultra_merge(UltraHLL counter1, UltraHLL counter2);
+
+/* compresses the counter for storage (or just trims it) and back */
+UltraHLL hll_ultra_compress(UltraHLL counter);
+UltraHLL hll_ultra_decompress(UltraHLL counter);
+
+/* estimate of the distinct items added (deduplicates sparse counters in
+ * place) */
+double hll_ultra_estimate(UltraHLL counter);
+
+/* the largest update values as an unpacked dense HLLCounter, the registers a
+ * hyperloglog_estimator of the same precision would have (and only its
+ * accuracy) */
+HLLCounter hll_ultra_to_counter(UltraHLL counter);
+
+/* counter with the registers of a hyperloglog_estimator of at most
+ * MAX_INDEX_BITS (which is modified), the bits of the values below are set
+ * from its estimate */
+UltraHLL hll_ultra_from_counter(HLLCounter hloglog);
+
+/* checks that a counter read from outside is consistent, errors out
+ * otherwise */
+void hll_ultra_validate(UltraHLL counter);
+
+#endif // #ifndef _ULTRALOGLOG_H_
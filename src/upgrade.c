@@ -11,6 +11,8 @@
 #include "upgrade.h"
 
 #include "hllutils.h"
+#include "probes.h"
+#include "varint.h"
 
 /* ------------- function declarations for local functions --------------- */
 /* V1 specific function versions */
@@ -18,6 +20,9 @@ static HLLCounter hll_decompress_V1(HLLCounter hloglog);
 static HLLCounter hll_decompress_dense_V1(HLLCounter hloglog);
 static HLLCounter hll_decompress_sparse_V1(HLLCounter hloglog);
 
+/* V2 specific function versions */
+static HLLCounter hll_decompress_sparse_V2(HLLCounter hloglog);
+
 /* ---------------------- function definitions --------------------------- */
 /* Used to upgrade old versions to the newest version. This is needed when the
  * HyperLogLogCounterData struct changes or how its handled changes. */
@@ -26,6 +31,15 @@ hll_upgrade(HLLCounter hloglog)
 {
     int m;
     HLLCounter htemp = 0;
+
+    /* compact counters are read from the expanded header */
+    hloglog = hll_expand(hloglog);
+
+    if (hloglog->version != STRUCT_VERSION){
+        HLL_STAT_INC(HLL_STAT_UPGRADES);
+        TRACE_HYPERLOGLOG_UPGRADE(hloglog->version, HLL_PRECISION(hloglog), HLL_REPRESENTATION(hloglog));
+    }
+
     if (hloglog->version == 0){
         if (hloglog->b < 0){
             m = pow(2,-1*hloglog->b);
@@ -50,6 +64,27 @@ hll_upgrade(HLLCounter hloglog)
         hloglog->version = STRUCT_VERSION;
         hloglog = hll_compress(hloglog);
         htemp = hloglog;
+    } else if (hloglog->version == 2 || hloglog->version == 3){
+        /* dense counters were lz compressed before version 4 and sparse
+         * counters were group varint encoded before version 3, those need to
+         * be decoded and compressed again. Everything else is unchanged */
+        if (hloglog->idx == -1 && hloglog->b < 0){
+            hloglog = hll_decompress_dense_V1(hloglog);
+            hloglog->version = STRUCT_VERSION;
+            hloglog = hll_compress(hloglog);
+        } else if (hloglog->version == 2 && hloglog->idx != -1 && hloglog->b < 0 && hloglog->b >= -MAX_INDEX_BITS){
+            hloglog = hll_decompress_sparse_V2(hloglog);
+            hloglog->version = STRUCT_VERSION;
+            hloglog = hll_compress(hloglog);
+        } else {
+            hloglog->version = STRUCT_VERSION;
+        }
+        htemp = hloglog;
+    } else if (hloglog->version == 4 || hloglog->version == 5){
+        /* version 5 only added small sets and version 6 the compact header,
+         * existing counters are unchanged */
+        hloglog->version = STRUCT_VERSION;
+        htemp = hloglog;
     } else if (hloglog->version == STRUCT_VERSION) {
         htemp = hloglog;
     } else {
@@ -82,7 +117,7 @@ hll_decompress_V1(HLLCounter hloglog)
     return hloglog;
 }
 
-/* Decompresses sparse counters */
+/* Decompresses lz compressed dense counters (also used by versions 2 and 3) */
 static HLLCounter 
 hll_decompress_dense_V1(HLLCounter hloglog)
 {
@@ -93,10 +128,10 @@ hll_decompress_dense_V1(HLLCounter hloglog)
      * decompressed */
     hloglog->b = -1 * (hloglog->b);
 
-    /* allocate and zero an array large enough to hold all the decompressed
-     * bins */
+    /* zero an array large enough to hold all the decompressed bins in the
+     * scratch arena */
     m = (int) pow(2,hloglog->b);
-    dest = malloc(m);
+    dest = hll_scratch();
     memset(dest,0,m);
 
     /* decompress the data */
@@ -117,12 +152,6 @@ hll_decompress_dense_V1(HLLCounter hloglog)
     /* set the varsize to the appropriate length  */
     SET_VARSIZE(hloglog,sizeof(HLLData) + (int)ceil((m * hloglog->binbits / 8.0)) );
 
-
-    /* free allocated memory */
-    if (dest){
-        free(dest);
-    }
-
     return hloglog;
 }
 
@@ -148,3 +177,26 @@ hll_decompress_sparse_V1(HLLCounter hloglog)
     return hloglog;
 }
 
+/* V2 functions */
+
+/* Decompresses group varint encoded sparse counters */
+static HLLCounter
+hll_decompress_sparse_V2(HLLCounter hloglog)
+{
+    HLLCounter htemp;
+    size_t length;
+
+    /* reset b to positive value for calcs and to indicate data is
+     * decompressed */
+    hloglog->b = -1 * (hloglog->b);
+
+    length = POW2(hloglog->b-2);
+    htemp = palloc0(length);
+    memcpy(htemp,hloglog,sizeof(HLLData));
+    group_decode_sorted((uint8_t *)hloglog->data,hloglog->idx,(uint32_t *) htemp->data);
+    hloglog = htemp;
+
+    SET_VARSIZE(hloglog,length);
+
+    return hloglog;
+}
@@ -0,0 +1,430 @@
+/* Regenerates the accuracy curves in stats/ (see documentation/README.md,
+ * Error Correction). Every estimator variant counts the same synthetic
+ * streams of distinct 8 byte items with 2^14 registers of 6 bits, and for
+ * every point of the curve (10, 20, ..., 100000 distinct items, or 1000,
+ * 2000, ..., 10M for 'big') it records the relative error of the estimate.
+ * The variants are
+ *
+ * - orig     - Flajolet's original algorithm, raw estimate on the dense
+ *              registers and linear counting below 2.5 * m
+ * - noerr    - no bias correction, linear counting below the threshold
+ * - nothresh - bias correction (6-point OLS) below 5 * m, no linear counting
+ * - hithresh - linear counting below 2.5 * m, bias correction above it
+ * - estavg   - bias correction by the average of the 2 nearest points
+ * - interp   - bias correction by interpolating the 2 nearest points
+ * - OLS      - bias correction by a regression of the 6 nearest points (the
+ *              one hll_estimate uses)
+ * - lin25    - linear counting on the 2^25 registers of the sparse encoding
+ *              without ever switching to dense registers
+ * - engine   - hll_estimate itself (the sigma-N files)
+ * - big      - hll_estimate at large cardinalities
+ *
+ * The variants other than orig and lin25 use the estimate of the engine while
+ * its counter is a small set or sparse, and their own estimate once it's
+ * promoted to dense registers.
+ *
+ * For every variant it writes <variant>_sigma1.txt, _sigma2.txt and
+ * _sigma3.txt (sigma-1.txt etc. for the engine) with one line per point, the
+ * relative error in percent that 68.27%, 95.45% and 99.73% of the samples
+ * stay within, and <variant>_time.txt with the average time of an estimate in
+ * ns. The engine is measured the way the SQL functions call it, on an unpacked
+ * copy of the counter.
+ *
+ * Build and run with
+ *
+ *     make stats
+ *
+ * or make stats/accuracy && ./stats/accuracy [-s samples] [-o dir] [variant ...]
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <math.h>
+#include <unistd.h>
+
+#include "postgres.h"
+#include "utils/memutils.h"
+#include "hyperloglog.h"
+#include "constants.h"
+#include "hllutils.h"
+
+#define PRECISION 14
+#define BINBITS 6
+#define POINTS 10000
+#define SPARSE_INDEX_BITS (32 - 1 - BINBITS)
+
+/* which estimate is used once the registers are dense */
+typedef enum Correction
+{
+    CORRECTION_NONE,
+    CORRECTION_AVG2,
+    CORRECTION_INTERP2,
+    CORRECTION_OLS6
+} Correction;
+
+typedef struct Variant
+{
+    const char *name;
+    const char *prefix;         /* of the output files */
+    int step;                   /* distinct items between two points */
+
+    /* dense estimate: raw estimates up to lc_bound * m use linear counting
+     * (if it's below the threshold when lc_threshold is set), the bias
+     * correction is applied up to 5 * m */
+    Correction correction;
+    double lc_bound;
+    bool lc_threshold;
+
+    bool dense_only;            /* registers from the first item */
+    bool linear_only;           /* linear counting on the sparse index */
+    bool engine;                /* hll_estimate */
+} Variant;
+
+static const Variant variants[] = {
+    {"orig", "orig_sigma", 10, CORRECTION_NONE, 2.5, false, true, false, false},
+    {"noerr", "noerr_sigma", 10, CORRECTION_NONE, 5, true, false, false, false},
+    {"nothresh", "nothresh_sigma", 10, CORRECTION_OLS6, 0, false, false, false, false},
+    {"hithresh", "hithresh_sigma", 10, CORRECTION_OLS6, 2.5, false, false, false, false},
+    {"estavg", "estavg_sigma", 10, CORRECTION_AVG2, 5, true, false, false, false},
+    {"interp", "interp_sigma", 10, CORRECTION_INTERP2, 5, true, false, false, false},
+    {"OLS", "OLS_sigma", 10, CORRECTION_OLS6, 5, true, false, false, false},
+    {"lin25", "lin25_sigma", 10, CORRECTION_NONE, 0, false, false, true, false},
+    {"engine", "sigma-", 10, CORRECTION_NONE, 0, false, false, false, true},
+    {"big", "big_sigma", 1000, CORRECTION_NONE, 0, false, false, false, true}
+};
+
+/* the quantiles of 1, 2 and 3 sigma */
+static const double quantiles[3] = {0.6827, 0.9545, 0.9973};
+
+static int samples = 500;
+static const char *output_dir = "stats";
+
+/* ---------------------- function definitions --------------------------- */
+
+static double
+now(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static int
+cmp_float(const void * a, const void * b)
+{
+    float x = *(const float *) a, y = *(const float *) b;
+    return (x > y) - (x < y);
+}
+
+/* Same as hash_to_register in hyperloglog.c, so the registers are the ones
+ * of the engine's dense counter */
+static void
+add_to_registers(uint8_t *registers, uint64_t hash)
+{
+    uint32_t idx = hash >> (HASH_LENGTH - PRECISION);
+    uint8_t rho = __builtin_clzll(hash << PRECISION) + 1;
+    uint8_t addn;
+
+    if (rho == HASH_LENGTH){
+        addn = HASH_LENGTH;
+        rho = HASH_LENGTH - PRECISION;
+        while (addn == HASH_LENGTH && rho < POW2(BINBITS)){
+            hash = MurmurHash64A((const char *) &hash, HASH_LENGTH / 8, HASH_SEED);
+            addn = __builtin_clzll(hash) + 1;
+            rho += addn;
+        }
+    }
+
+    if (rho > registers[idx]){
+        registers[idx] = rho;
+    }
+}
+
+/* index of the first interpolation point above the raw estimate, like
+ * error_estimate does */
+static int
+nearest_point(double E)
+{
+    const double *raw = rawEstimateData[PRECISION - 4];
+    int i;
+
+    for (i = 0; i < MAX_INTERPOLATION_POINTS; i++){
+        if (E < raw[i]){
+            return i;
+        }
+    }
+
+    return MAX_INTERPOLATION_POINTS;
+}
+
+static double
+bias(double E, Correction correction)
+{
+    const double *raw = rawEstimateData[PRECISION - 4];
+    const double *bias = biasData[PRECISION - 4];
+    double sx = 0, sxx = 0, sy = 0, sxy = 0, beta, alpha;
+    int i, idx = nearest_point(E);
+
+    switch (correction){
+        case CORRECTION_AVG2:
+            idx = Max(1, Min(idx, MAX_INTERPOLATION_POINTS - 1));
+            return (bias[idx - 1] + bias[idx]) / 2;
+
+        case CORRECTION_INTERP2:
+            idx = Max(1, Min(idx, MAX_INTERPOLATION_POINTS - 1));
+            return bias[idx - 1] + (E - raw[idx - 1]) * (bias[idx] - bias[idx - 1]) / (raw[idx] - raw[idx - 1]);
+
+        case CORRECTION_OLS6:
+            idx = Max(3, Min(idx, MAX_INTERPOLATION_POINTS - 2));
+            for (i = idx - 3; i <= idx + 2; i++){
+                sx += raw[i];
+                sxx += raw[i] * raw[i];
+                sy += bias[i];
+                sxy += raw[i] * bias[i];
+            }
+            beta = (6.0 * sxy - sx * sy) / (6.0 * sxx - sx * sx);
+            alpha = (sy - beta * sx) / 6.0;
+            return alpha + E * beta;
+
+        default:
+            return 0;
+    }
+}
+
+static double
+estimate_dense(const Variant *variant, const uint8_t *registers)
+{
+    int i, V = 0, m = POW2(PRECISION);
+    double H = 0, E, LC;
+
+    for (i = 0; i < m; i++){
+        H += PE[registers[i]];
+        V += (registers[i] == 0);
+    }
+
+    E = alpham[PRECISION] / H;
+    /* as hll_estimate_dense computes it */
+    LC = (V != 0) ? m * log(m / (float) V) : E;
+
+    if (E <= variant->lc_bound * m && (!variant->lc_threshold || LC <= threshold[PRECISION])){
+        return LC;
+    }
+
+    if (E <= 5.0 * m){
+        E -= bias(E, variant->correction);
+    }
+
+    return E;
+}
+
+/* linear counting on the 2^25 indexes of the sparse encoding */
+static double
+estimate_linear(int V)
+{
+    double m = POW2(SPARSE_INDEX_BITS);
+
+    return m * log(m / (m - V));
+}
+
+/* the engine's estimate the way the SQL functions compute it */
+static double
+estimate_engine(HLLCounter hloglog)
+{
+    HLLCounter copy = hll_copy(hloglog), unpacked = hll_unpack(copy);
+    double E = hll_estimate(unpacked);
+
+    if (unpacked != copy){
+        pfree(unpacked);
+    }
+    pfree(copy);
+
+    return E;
+}
+
+/* counts one stream of distinct items and records the error at every point */
+static void
+run_sample(const Variant *variant, int sample, float *errors, double *seconds)
+{
+    int m = POW2(PRECISION);
+    uint8_t *registers = calloc(m, 1);
+    uint8_t *bitmap = variant->linear_only ? calloc(POW2(SPARSE_INDEX_BITS) / 8, 1) : NULL;
+    HLLCounter hloglog = hll_create(pow(2, 63), sqrt(1.0816 / (0.9 * m)), PACKED);
+    int point, V = 0;
+    uint64_t i = 0;
+    double start, E;
+
+    if (registers == NULL || (variant->linear_only && bitmap == NULL)){
+        fprintf(stderr, "out of memory\n");
+        exit(1);
+    }
+
+    for (point = 0; point < POINTS; point++){
+        uint64_t n = (uint64_t) (point + 1) * variant->step;
+
+        for (; i < n; i++){
+            uint64_t value = ((uint64_t) sample << 40) | i;
+            uint64_t hash = MurmurHash64A((const char *) &value, sizeof(value), HASH_SEED);
+
+            if (variant->linear_only){
+                uint32_t idx = hash >> (HASH_LENGTH - SPARSE_INDEX_BITS);
+
+                if ((bitmap[idx / 8] & (1 << (idx % 8))) == 0){
+                    bitmap[idx / 8] |= 1 << (idx % 8);
+                    V++;
+                }
+            } else if (!variant->engine){
+                add_to_registers(registers, hash);
+            }
+
+            /* the variants only need the engine's counter until it's
+             * promoted, from there on its registers are the same as theirs */
+            if (variant->engine || (!variant->dense_only && !variant->linear_only && hloglog->idx != -1)){
+                hloglog = hll_add_element(hloglog, (const char *) &value, sizeof(value));
+            }
+        }
+
+        start = now();
+        if (variant->linear_only){
+            E = estimate_linear(V);
+        } else if (variant->engine){
+            E = estimate_engine(hloglog);
+        } else if (variant->dense_only || hloglog->idx == -1){
+            E = estimate_dense(variant, registers);
+        } else {
+            E = hll_estimate(hloglog);
+        }
+        seconds[point] += now() - start;
+
+        errors[(size_t) point * samples + sample] = 100.0 * fabs(E - n) / n;
+    }
+
+    free(registers);
+    free(bitmap);
+
+    /* the counter and everything the engine allocated */
+    MemoryContextReset(CurrentMemoryContext);
+}
+
+static FILE *
+open_output(const char *prefix, const char *suffix)
+{
+    char path[1024];
+    FILE *file;
+
+    snprintf(path, sizeof(path), "%s/%s%s.txt", output_dir, prefix, suffix);
+    file = fopen(path, "w");
+    if (file == NULL){
+        perror(path);
+        exit(1);
+    }
+
+    return file;
+}
+
+static void
+run_variant(const Variant *variant)
+{
+    float *errors = malloc(sizeof(float) * POINTS * samples);
+    double *seconds = calloc(POINTS, sizeof(double));
+    FILE *sigma[3], *timing;
+    char suffix[16];
+    int point, sample, k;
+
+    if (errors == NULL || seconds == NULL){
+        fprintf(stderr, "out of memory\n");
+        exit(1);
+    }
+
+    for (sample = 0; sample < samples; sample++){
+        run_sample(variant, sample, errors, seconds);
+    }
+
+    for (k = 0; k < 3; k++){
+        snprintf(suffix, sizeof(suffix), "%d", k + 1);
+        sigma[k] = open_output(variant->prefix, suffix);
+    }
+    timing = open_output(variant->name, "_time");
+
+    for (point = 0; point < POINTS; point++){
+        float *point_errors = errors + (size_t) point * samples;
+
+        qsort(point_errors, samples, sizeof(float), cmp_float);
+        for (k = 0; k < 3; k++){
+            int rank = (int) ceil(quantiles[k] * samples) - 1;
+
+            fprintf(sigma[k], "%.12g\n", point_errors[Max(rank, 0)]);
+        }
+        fprintf(timing, "%.1f\n", seconds[point] * 1e9 / samples);
+    }
+
+    for (k = 0; k < 3; k++){
+        fclose(sigma[k]);
+    }
+    fclose(timing);
+
+    free(errors);
+    free(seconds);
+}
+
+static void
+usage(const char *program)
+{
+    int i;
+
+    fprintf(stderr, "usage: %s [-s samples] [-o dir] [variant ...]\nvariants:", program);
+    for (i = 0; i < lengthof(variants); i++){
+        fprintf(stderr, " %s", variants[i].name);
+    }
+    fprintf(stderr, "\n");
+    exit(1);
+}
+
+int
+main(int argc, char **argv)
+{
+    int opt, i, j;
+
+    while ((opt = getopt(argc, argv, "s:o:")) != -1){
+        switch (opt){
+            case 's':
+                samples = atoi(optarg);
+                break;
+            case 'o':
+                output_dir = optarg;
+                break;
+            default:
+                usage(argv[0]);
+        }
+    }
+
+    if (samples < 1){
+        usage(argv[0]);
+    }
+
+    /* names that don't match any variant */
+    for (j = optind; j < argc; j++){
+        for (i = 0; i < lengthof(variants) && strcmp(argv[j], variants[i].name) != 0; i++);
+        if (i == lengthof(variants)){
+            usage(argv[0]);
+        }
+    }
+
+    for (i = 0; i < lengthof(variants); i++){
+        bool selected = (optind == argc);
+
+        for (j = optind; j < argc; j++){
+            selected |= (strcmp(argv[j], variants[i].name) == 0);
+        }
+
+        if (selected){
+            double start = now();
+
+            run_variant(&variants[i]);
+            fprintf(stderr, "%s: %.0fs\n", variants[i].name, now() - start);
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,107 @@
+/* Merges of counters built through the public API of libhll.a (see
+ * lib/hll.h). Counters of different error rates or ndistinct have to be
+ * rejected with -1, leaving the target counter as it was, for every
+ * combination of small set, sparse and dense counters, both as built and
+ * after a round trip through their stored bytes.
+ *
+ * Build and run with
+ *
+ *     make libtest
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+
+#include "hll.h"
+
+#define COUNTS 3
+
+static int failures = 0;
+
+static void
+check(int ok, const char * what, int n1, int n2)
+{
+    if (!ok){
+        printf("FAIL: %s (%d and %d items)\n", what, n1, n2);
+        failures++;
+    }
+}
+
+static hll_counter *
+build(double ndistinct, float error, int items, int stored)
+{
+    hll_counter * counter = hll_counter_create(ndistinct, error, 'P');
+    hll_counter * copy;
+    unsigned char * data;
+    size_t length;
+    int32_t i;
+
+    for (i = 1; i <= items; i++){
+        hll_counter_add(counter, &i, sizeof(i));
+    }
+
+    if (!stored){
+        return counter;
+    }
+
+    hll_counter_serialize(counter, &data, &length);
+    copy = hll_counter_deserialize(data, length);
+    free(data);
+    hll_counter_free(counter);
+
+    return copy;
+}
+
+/* merges counters with the given parameters both ways, expecting an error
+ * and unchanged estimates */
+static void
+mismatched(double ndistinct1, float error1, double ndistinct2, float error2, const char * what)
+{
+    int counts[COUNTS] = {10, 1000, 100000};
+    int i, j, stored;
+
+    for (stored = 0; stored < 2; stored++){
+        for (i = 0; i < COUNTS; i++){
+            for (j = 0; j < COUNTS; j++){
+                hll_counter * a = build(ndistinct1, error1, counts[i], stored);
+                hll_counter * b = build(ndistinct2, error2, counts[j], stored);
+                double estimate_a = hll_counter_estimate(a);
+                double estimate_b = hll_counter_estimate(b);
+
+                check(hll_counter_merge(a, b) == -1, what, counts[i], counts[j]);
+                check(hll_counter_merge(b, a) == -1, what, counts[j], counts[i]);
+                check(hll_counter_estimate(a) == estimate_a && hll_counter_estimate(b) == estimate_b,
+                      "counter changed by a failed merge", counts[i], counts[j]);
+
+                hll_counter_free(a);
+                hll_counter_free(b);
+            }
+        }
+    }
+}
+
+int
+main(void)
+{
+    hll_counter * a = build(HLL_DEFAULT_NDISTINCT, HLL_DEFAULT_ERROR, 1000, 0);
+    hll_counter * b = build(HLL_DEFAULT_NDISTINCT, HLL_DEFAULT_ERROR, 100000, 1);
+
+    /* counters of the same parameters still merge */
+    check(hll_counter_merge(a, b) == 0 && hll_counter_estimate(a) == hll_counter_estimate(b),
+          "merge of matching counters", 1000, 100000);
+    hll_counter_free(a);
+    hll_counter_free(b);
+
+    mismatched(HLL_DEFAULT_NDISTINCT, HLL_DEFAULT_ERROR, HLL_DEFAULT_NDISTINCT, 0.02f,
+               "merge of counters of different precision");
+    mismatched(HLL_DEFAULT_NDISTINCT, HLL_DEFAULT_ERROR, 1000000.0, HLL_DEFAULT_ERROR,
+               "merge of counters of different bin size");
+
+    if (failures > 0){
+        printf("%d checks failed\n", failures);
+        return 1;
+    }
+
+    printf("all checks passed\n");
+    return 0;
+}
@@ -36,4 +36,8 @@ BEGIN;
     SELECT hyperloglog_get_estimate(hyperloglog_merge(hyperloglog_comp(hyperloglog_accum(i)),hyperloglog_decomp(hyperloglog_accum(i))))::numeric(30,10) merge_comp_decomp from generate_series(1,100) s(i);
 
     SELECT hyperloglog_get_estimate(hyperloglog_merge(hyperloglog_decomp(hyperloglog_accum(i)),hyperloglog_decomp(hyperloglog_accum(i))))::numeric(30,10) merge_decomp_decomp from generate_series(1,100) s(i);
+
+    SELECT hyperloglog_get_estimate(hyperloglog_merge(hyperloglog_comp(hyperloglog_accum(i)),hyperloglog_comp(hyperloglog_accum(i + 50))))::numeric(30,10) merge_comp_comp_sparse from generate_series(1,100) s(i);
+
+    SELECT length(hyperloglog_merge(hyperloglog_comp(hyperloglog_accum(i)),hyperloglog_comp(hyperloglog_accum(i + 50)))) merge_comp_comp_length from generate_series(1,100) s(i);
 ROLLBACK;
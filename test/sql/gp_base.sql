@@ -28,6 +28,16 @@ BEGIN;
 
     SELECT length(v_counter3) v_counter3_length from test_temp;
 
+    SELECT hyperloglog_precision(v_counter) v_counter_precision from test_temp;
+
+    SELECT hyperloglog_precision(v_counter2) v_counter2_precision from test_temp;
+
+    SELECT hyperloglog_precision(v_counter3) v_counter3_precision from test_temp;
+
+    SELECT hyperloglog_precision(hyperloglog_accum(i, 0.02::real)) b_12_precision from generate_series(1,100) s(i);
+
+    SELECT hyperloglog_precision(hyperloglog_accum(i, 0.02::real)) b_12_dense_precision from generate_series(1,10000) s(i);
+
     SELECT hyperloglog_get_estimate(v_counter) v_counter_estimate from test_temp;
 
     SELECT hyperloglog_get_estimate(v_counter2) v_counter2_estimate from test_temp;
@@ -52,4 +62,92 @@ BEGIN;
 
     SELECT hyperloglog_get_estimate(hyperloglog_merge(v_counter,v_counter)) merge_same from test_temp;
 
+    CREATE TEMP TABLE raw_temp (counter hyperloglog_estimator_raw);
+
+    INSERT INTO raw_temp SELECT hyperloglog_accum(i) FROM generate_series(1,100000) s(i);
+
+    SELECT typstorage raw_storage FROM pg_type WHERE typname = 'hyperloglog_estimator_raw';
+
+    SELECT length(counter) raw_length from raw_temp;
+
+    SELECT counter = (SELECT hyperloglog_accum(i) FROM generate_series(1,100000) s(i)) raw_equal from raw_temp;
+
+    SELECT length(hyperloglog_fixed(hyperloglog_accum(i))) fixed_sparse_length from generate_series(1,100) s(i);
+
+    SELECT length(hyperloglog_fixed(hyperloglog_accum(i), 'u')) fixed_unpacked_length from generate_series(1,100000) s(i);
+
+    SELECT length(hyperloglog_upsert(hyperloglog_fixed(hyperloglog_accum(i)), (SELECT hyperloglog_accum(i) FROM generate_series(50001,150000) s(i)))) upsert_length from generate_series(1,100000) s(i);
+
+    SELECT hyperloglog_upsert(hyperloglog_fixed(hyperloglog_accum(i)), (SELECT hyperloglog_accum(i) FROM generate_series(50001,150000) s(i))) = (SELECT hyperloglog_accum(i) FROM generate_series(1,150000) s(i)) upsert_equal from generate_series(1,100000) s(i);
+
+    SELECT length(hyperloglog_upsert(NULL, hyperloglog_accum(i))) upsert_null_length from generate_series(1,100) s(i);
+
+    SET hyperloglog.promotion = size;
+
+    SELECT length(hyperloglog_accum(i)) size_promotion_length from generate_series(1,1000) s(i);
+
+    SELECT hyperloglog_get_estimate(hyperloglog_accum(i)) size_promotion_estimate from generate_series(1,1000) s(i);
+
+    RESET hyperloglog.promotion;
+
+    SELECT length(hyperloglog_promotion(hyperloglog_accum(i), 'size')) promotion_length from generate_series(1,1000) s(i);
+
+    SELECT length(hyperloglog_accum(i)) small_set_length from generate_series(1,20) s(i);
+
+    SELECT hyperloglog_get_estimate(hyperloglog_accum(i % 20)) small_set_estimate from generate_series(1,1000) s(i);
+
+    SELECT hyperloglog_get_estimate(hyperloglog_merge(hyperloglog_accum(i), hyperloglog_accum(i + 10))) small_set_merge from generate_series(1,20) s(i);
+
+    SELECT hyperloglog_get_estimate(hyperloglog_merge(hyperloglog_accum(i), hyperloglog_accum(i + 20))) small_set_merge_sparse from generate_series(1,20) s(i);
+
+    SET hyperloglog.output_wrap = off;
+
+    SELECT length(hyperloglog_accum(i)::text) unwrapped_text_length from generate_series(1,1000) s(i);
+
+    SELECT hyperloglog_decomp(hyperloglog_accum(i, 0.005::real))::text::hyperloglog_estimator = hyperloglog_decomp(hyperloglog_accum(i, 0.005::real)) unwrapped_text_round_trip from generate_series(1,10000) s(i);
+
+    RESET hyperloglog.output_wrap;
+
+    SELECT length(hyperloglog_accum(i)::text) wrapped_text_length from generate_series(1,1000) s(i);
+
+    SELECT hyperloglog_decomp(hyperloglog_accum(i, 0.005::real))::text::hyperloglog_estimator = hyperloglog_decomp(hyperloglog_accum(i, 0.005::real)) wrapped_text_round_trip from generate_series(1,10000) s(i);
+
+    SELECT hyperloglog_send(hyperloglog_accum(i)) = hyperloglog_accum(i)::bytea send_stored_form from generate_series(1,1000) s(i);
+
+    SELECT length(hyperloglog_send(hyperloglog_decomp(hyperloglog_accum(i)))) send_decomp_length from generate_series(1,1000) s(i);
+
+    SELECT hyperloglog_stats_reset();
+
+    SELECT sum(value) stats_after_reset, count(*) stats_count from hyperloglog_stats();
+
+    SELECT (r).representation, (r).compressed, (r).format, (r).promotion, (r).index_bits, (r).binbits, (r).version, (r).memory_bytes, (r).sparse_entries, (r).nonzero_registers, (r).register_histogram, (r).estimate from (SELECT hyperloglog_info_record(hyperloglog_accum(i)) r from generate_series(1,20) s(i)) t;
+
+    SELECT (r).representation, (r).compressed, (r).format, (r).promotion, (r).index_bits, (r).binbits, (r).version, (r).memory_bytes, (r).sparse_entries, (r).nonzero_registers, (r).register_histogram, (r).estimate from (SELECT hyperloglog_info_record(hyperloglog_accum(i)) r from generate_series(1,1000) s(i)) t;
+
+    SELECT (r).representation, (r).compressed, (r).format, (r).promotion, (r).index_bits, (r).binbits, (r).version, (r).memory_bytes, (r).sparse_entries, (r).nonzero_registers, (r).register_histogram, (r).estimate from (SELECT hyperloglog_info_record(hyperloglog_accum(i)) r from generate_series(1,100000) s(i)) t;
+
+    SELECT hyperloglog_precision(hyperloglog_accum(i, 0.0005::real)) high_precision from generate_series(1,100) s(i);
+
+    SELECT hyperloglog_size(0.0005) = 6291472 b_23_counter_size;
+
+    SELECT (r).representation, (r).index_bits, (r).sparse_entries from (SELECT hyperloglog_info_record(hyperloglog_accum(i, 0.0005::real)) r from generate_series(1,10000) s(i)) t;
+
+    SELECT hyperloglog_get_estimate(hyperloglog_accum(i, 0.0005::real)) high_precision_small_set from generate_series(1,10000) s(i);
+
+    SELECT (r).representation, (r).compressed, (r).format, (r).index_bits, (r).memory_bytes, (r).sparse_entries from (SELECT hyperloglog_info_record(hyperloglog_accum(i, 0.0016::real)) r from generate_series(1,100000) s(i)) t;
+
+    SELECT hyperloglog_get_estimate(hyperloglog_accum(i, 0.0016::real)) high_precision_dense from generate_series(1,100000) s(i);
+
+    SELECT hyperloglog_get_estimate(hyperloglog_merge(hyperloglog_accum(i, 0.0016::real), hyperloglog_accum(i + 50000, 0.0016::real))) high_precision_merge from generate_series(1,50000) s(i);
+
+    SELECT hyperloglog_decomp(hyperloglog_accum(i, 0.0016::real))::text::hyperloglog_estimator = hyperloglog_decomp(hyperloglog_accum(i, 0.0016::real)) high_precision_text_round_trip from generate_series(1,100000) s(i);
+
+    SELECT (r).representation, (r).compressed, (r).format, (r).index_bits, (r).memory_bytes, (r).sparse_entries from (SELECT hyperloglog_info_record(hyperloglog_accum(i, 'n')) r from generate_series(1,100000) s(i)) t;
+
+    SELECT hyperloglog_get_estimate(hyperloglog_accum(i, 'n')) nibble_estimate from generate_series(1,100000) s(i);
+
+    SELECT hyperloglog_get_estimate(hyperloglog_merge(hyperloglog_accum(i, 'n'), hyperloglog_accum(i + 50000))) nibble_merge from generate_series(1,50000) s(i);
+
+    SELECT hyperloglog_accum(i, 'n')::text::hyperloglog_estimator = hyperloglog_accum(i) nibble_equals_packed from generate_series(1,100000) s(i);
+
 ROLLBACK;
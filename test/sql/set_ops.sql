@@ -37,5 +37,19 @@ BEGIN;
     SELECT hyperloglog_compliment(hyperloglog_accum(i%100),hyperloglog_accum(i)) = 0 compliment from generate_series(1,10000) s(i);
   
     SELECT hyperloglog_symmetric_diff(hyperloglog_accum(i),hyperloglog_accum(i*-1))::numeric(30,10)  symmetric_diff from generate_series(-1000,10000) s(i);
+  
+    SELECT hyperloglog_jaccard(hyperloglog_accum(i),hyperloglog_accum(i%5))::numeric(30,10) jaccard_small from generate_series(1,10) s(i);
+  
+    SELECT hyperloglog_jaccard(hyperloglog_accum(i),hyperloglog_accum(i*-1))::numeric(30,10) jaccard_sparse from generate_series(-10,100) s(i);
+  
+    SELECT hyperloglog_jaccard(hyperloglog_accum(i),hyperloglog_accum(i*-1))::numeric(30,10) jaccard_dense from generate_series(-1000,10000) s(i);
+  
+    SELECT hyperloglog_jaccard(hyperloglog_accum(i),hyperloglog_accum(i)) = 1 jaccard_equal from generate_series(1,10000) s(i);
+  
+    SELECT hyperloglog_containment(hyperloglog_accum(i%5),hyperloglog_accum(i))::numeric(30,10) containment_small from generate_series(1,10) s(i);
+  
+    SELECT hyperloglog_containment(hyperloglog_accum(i%100),hyperloglog_accum(i))::numeric(30,10) containment_mixed from generate_series(1,10000) s(i);
+  
+    SELECT hyperloglog_containment(hyperloglog_accum(i),hyperloglog_accum(i*-1))::numeric(30,10) containment_dense from generate_series(-1000,10000) s(i);
 
 ROLLBACK;
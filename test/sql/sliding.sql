@@ -0,0 +1,25 @@
+SET search_path = public, pg_catalog;
+
+BEGIN;
+
+    SELECT hyperloglog_sliding_estimate(hyperloglog_sliding_accum(i, '2024-01-01 00:00:00+00'::timestamptz + i * interval '1 second', interval '15 minutes'), '2024-01-01 00:15:01+00')::numeric(30,10) last_100 from generate_series(1,1000) s(i);
+  
+    SELECT hyperloglog_sliding_estimate(hyperloglog_sliding_accum(i, '2024-01-01 00:00:00+00'::timestamptz + i * interval '1 second', interval '15 minutes'), '2024-01-01 00:00:00+00')::numeric(30,10) whole_window from generate_series(1,1000) s(i);
+  
+    SELECT hyperloglog_sliding_estimate(hyperloglog_sliding_accum(i, '2024-01-01 00:00:00+00'::timestamptz + i * interval '1 second', interval '15 minutes'), '2024-01-01 00:16:40+00')::numeric(30,10) last_one from generate_series(1,1000) s(i);
+  
+    SELECT hyperloglog_sliding_estimate(hyperloglog_sliding_merge(a, b), '2024-01-01 00:10:00+00') = hyperloglog_sliding_estimate(c, '2024-01-01 00:10:00+00') merge_equality from (SELECT hyperloglog_sliding_accum(i, '2024-01-01 00:00:00+00'::timestamptz + i * interval '1 second', interval '15 minutes') a from generate_series(1,1000) s(i) where i % 2 = 0) t1, (SELECT hyperloglog_sliding_accum(i, '2024-01-01 00:00:00+00'::timestamptz + i * interval '1 second', interval '15 minutes') b from generate_series(1,1000) s(i) where i % 2 = 1) t2, (SELECT hyperloglog_sliding_accum(i, '2024-01-01 00:00:00+00'::timestamptz + i * interval '1 second', interval '15 minutes') c from generate_series(1,1000) s(i)) t3;
+  
+    SELECT hyperloglog_sliding_estimate(hyperloglog_sliding_merge(c), '2024-01-01 00:10:00+00') = (SELECT hyperloglog_sliding_estimate(hyperloglog_sliding_accum(i, '2024-01-01 00:00:00+00'::timestamptz + i * interval '1 second', interval '15 minutes'), '2024-01-01 00:10:00+00') from generate_series(1,1000) s(i)) merge_agg_equality from (SELECT hyperloglog_sliding_accum(i, '2024-01-01 00:00:00+00'::timestamptz + i * interval '1 second', interval '15 minutes') c from generate_series(1,1000) s(i) group by i % 10) t;
+  
+    SELECT hyperloglog_sliding_estimate(c::text::hyperloglog_sliding, '2024-01-01 00:10:00+00') = hyperloglog_sliding_estimate(c, '2024-01-01 00:10:00+00') text_equality from (SELECT hyperloglog_sliding_accum(i, '2024-01-01 00:00:00+00'::timestamptz + i * interval '1 second', interval '15 minutes') c from generate_series(1,1000) s(i)) t;
+  
+    SELECT hyperloglog_get_estimate(hyperloglog_sliding_counter(c, '2024-01-01 00:10:00+00')) = hyperloglog_sliding_estimate(c, '2024-01-01 00:10:00+00') counter_equality from (SELECT hyperloglog_sliding_accum(i, '2024-01-01 00:00:00+00'::timestamptz + i * interval '1 second', interval '15 minutes') c from generate_series(1,1000) s(i)) t;
+  
+    SELECT hyperloglog_sliding_estimate(hyperloglog_sliding_add(hyperloglog_sliding_init(interval '1 hour'), 42, '2024-01-01 12:00:00+00'), '2024-01-01 11:30:00+00')::numeric(30,10) single_item;
+  
+    SELECT hyperloglog_sliding_estimate(hyperloglog_sliding_add(hyperloglog_sliding_add(hyperloglog_sliding_init(interval '1 hour'), 42, '2024-01-01 12:00:00+00'), 43, '2024-01-01 10:00:00+00'), '2024-01-01 09:00:00+00')::numeric(30,10) expired_item;
+  
+    SELECT hyperloglog_sliding_estimate(hyperloglog_sliding_add(hyperloglog_sliding_comp(hyperloglog_sliding_init(interval '1 hour')), 42, '2024-01-01 12:00:00+00'), '2024-01-01 11:30:00+00')::numeric(30,10) empty_comp_add;
+
+ROLLBACK;
@@ -0,0 +1,27 @@
+SET search_path = public, pg_catalog;
+
+BEGIN;
+
+    SELECT hyperloglog_theta_estimate(hyperloglog_theta_accum(i))::numeric(30,10) theta_estimate from generate_series(1,100000) s(i);
+  
+    SELECT hyperloglog_theta_distinct(i) = hyperloglog_theta_estimate(hyperloglog_theta_accum(i)) distinct_equality from generate_series(1,100000) s(i);
+  
+    SELECT hyperloglog_theta_estimate(hyperloglog_theta_accum(i)) exact_small from generate_series(1,1000) s(i);
+  
+    SELECT hyperloglog_theta_estimate(hyperloglog_theta_merge(a, b)) = hyperloglog_theta_estimate(c) merge_equality from (SELECT hyperloglog_theta_accum(i) a from generate_series(1,100000) s(i) where i % 2 = 0) t1, (SELECT hyperloglog_theta_accum(i) b from generate_series(1,100000) s(i) where i % 2 = 1) t2, (SELECT hyperloglog_theta_accum(i) c from generate_series(1,100000) s(i)) t3;
+  
+    SELECT hyperloglog_theta_estimate(hyperloglog_theta_merge(c)) = (SELECT hyperloglog_theta_estimate(hyperloglog_theta_accum(i)) from generate_series(1,100000) s(i)) merge_agg_equality from (SELECT hyperloglog_theta_accum(i) c from generate_series(1,100000) s(i) group by i % 10) t;
+  
+    SELECT hyperloglog_theta_estimate(hyperloglog_theta_intersect(a, b))::numeric(30,10) intersect_estimate from (SELECT hyperloglog_theta_accum(i) a from generate_series(1,100000) s(i)) t1, (SELECT hyperloglog_theta_accum(i) b from generate_series(50001,150000) s(i)) t2;
+  
+    SELECT hyperloglog_theta_estimate(hyperloglog_theta_a_not_b(a, b))::numeric(30,10) a_not_b_estimate, hyperloglog_theta_estimate(hyperloglog_theta_a_not_b(a, a)) a_not_a from (SELECT hyperloglog_theta_accum(i) a from generate_series(1,100000) s(i)) t1, (SELECT hyperloglog_theta_accum(i) b from generate_series(50001,150000) s(i)) t2;
+  
+    SELECT hyperloglog_theta_estimate(hyperloglog_theta_intersect(c))::numeric(30,10) intersect_agg from (SELECT hyperloglog_theta_accum(i) c from generate_series(1,10) g(j), generate_series(j * 1000, j * 1000 + 100000) s(i) group by j) t;
+  
+    SELECT hyperloglog_theta_estimate(c::text::hyperloglog_theta) = hyperloglog_theta_estimate(c) text_equality from (SELECT hyperloglog_theta_accum(i) c from generate_series(1,100000) s(i)) t;
+  
+    SELECT hyperloglog_theta_estimate(hyperloglog_theta_add(hyperloglog_theta_init(), 42)) single_item;
+  
+    SELECT hyperloglog_theta_accum(NULL::int) IS NULL null_items from generate_series(1,10) s(i);
+
+ROLLBACK;
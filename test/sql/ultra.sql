@@ -0,0 +1,25 @@
+SET search_path = public, pg_catalog;
+
+BEGIN;
+
+    SELECT hyperloglog_ultra_get_estimate(hyperloglog_ultra_accum(i))::numeric(30,10) ultra_estimate from generate_series(1,100000) s(i);
+  
+    SELECT hyperloglog_ultra_distinct(i) = hyperloglog_ultra_get_estimate(hyperloglog_ultra_accum(i)) distinct_equality from generate_series(1,100000) s(i);
+  
+    SELECT hyperloglog_ultra_get_estimate(hyperloglog_ultra_merge(a, b)) = hyperloglog_ultra_get_estimate(c) merge_equality from (SELECT hyperloglog_ultra_accum(i) a from generate_series(1,100000) s(i) where i % 2 = 0) t1, (SELECT hyperloglog_ultra_accum(i) b from generate_series(1,100000) s(i) where i % 2 = 1) t2, (SELECT hyperloglog_ultra_accum(i) c from generate_series(1,100000) s(i)) t3;
+  
+    SELECT hyperloglog_ultra_get_estimate(hyperloglog_ultra_merge(c)) = (SELECT hyperloglog_ultra_get_estimate(hyperloglog_ultra_accum(i)) from generate_series(1,100000) s(i)) merge_agg_equality from (SELECT hyperloglog_ultra_accum(i) c from generate_series(1,100000) s(i) group by i % 10) t;
+  
+    SELECT hyperloglog_ultra_get_estimate(c::text::hyperloglog_ultra) = hyperloglog_ultra_get_estimate(c) text_equality from (SELECT hyperloglog_ultra_accum(i) c from generate_series(1,100000) s(i)) t;
+  
+    SELECT hyperloglog_get_estimate(hyperloglog_ultra_counter(hyperloglog_ultra_accum(i))) = hyperloglog_get_estimate(hyperloglog_accum(i, 0.0115)) counter_equality from generate_series(1,100000) s(i);
+  
+    SELECT hyperloglog_ultra_get_estimate(hyperloglog_accum(i)::hyperloglog_ultra)::numeric(30,10) from_counter from generate_series(1,100000) s(i);
+  
+    SELECT hyperloglog_ultra_get_estimate(hyperloglog_ultra_add(hyperloglog_ultra_init(), 42))::numeric(30,10) single_item;
+  
+    SELECT pg_column_size(hyperloglog_ultra_accum(i)) ultra_size, pg_column_size(hyperloglog_ultra_accum(i)) < pg_column_size(hyperloglog_accum(i)) smaller from generate_series(1,100000) s(i);
+  
+    SELECT hyperloglog_ultra_accum(NULL::int) IS NULL null_items from generate_series(1,10) s(i);
+
+ROLLBACK;
@@ -28,4 +28,12 @@ BEGIN;
 
     SELECT hyperloglog_get_estimate(hyperloglog_update(dense_decomp::hyperloglog_estimator))::numeric(30,10) dense_decomp_v1_update FROM version1_counters;
 
+    CREATE TEMP TABLE version2_counters AS SELECT
+        pg_catalog.decode(E'f206020064000000aa4c7007986a253a97032c6404aa607706b0580c3c0b0920a512966c8a0b04b4b27bba2814aafa740150b006c8540418e711aa2eb808087805c2760bfa8c17aa503902d8e408262b07c44a04aafe64083c7e051480071e6a076a3625649a1c3ca2031a9c0daaa2b207dc5d02d47602443907a672020316a20d96d992f209aab0690ca8ba236685129a0a09a6769c09f878135463bc6104aa9afc0b3e3c06d65205ccd10aaa008512443c017c8e05a0a00daa166639d2c2044e311784fc04a6c45d0aaceb0314f756490faac6850368d912ccf513345e07aa42160d2c6b10c6f902a4f421aa444909467811082103b4830eaa043410e0781c201c09643a05a6921f07606f013a575acd049a52a707d85c902101c2bc26a6448e01d634028224b81601aaacda13ea5f0246790876c01569d26ac0de023aeb0ebe4c6a035aa9','hex') sparse_100
+    ;
+
+    SELECT hyperloglog_get_estimate(hyperloglog_update(sparse_100::hyperloglog_estimator))::numeric(30,10) sparse_v2_update FROM version2_counters;
+
+    SELECT hyperloglog_update(sparse_100::hyperloglog_estimator) = sparse_100::hyperloglog_estimator sparse_v2_update_equal FROM version2_counters;
+
 ROLLBACK;